@@ -2,6 +2,18 @@
 #define ALLOW_IMPLICIT_CONVERSIONS
 
 #include "../LinearAlgebraLatest/vector.h"
+#include "../LinearAlgebraLatest/vector_batch.h"
+#include "../LinearAlgebraLatest/mapped_vector.h"
+#include "../LinearAlgebraLatest/random.h"
+#include "../LinearAlgebraLatest/matrix.h"
+#include "../LinearAlgebraLatest/rotation.h"
+#include "../LinearAlgebraLatest/sparse_vector.h"
+#include "../LinearAlgebraLatest/similarity.h"
+#include "../LinearAlgebraLatest/knn_index.h"
+
+#include <cstdint>
+#include <memory_resource>
+#include <random>
 
 // Only tests for disabled dynamic extent, because this constructor exists only in such cases
 // Constructor number 1
@@ -555,6 +567,96 @@ TEST(OperatorOverloading, Division) {
 }
 
 
+TEST(OperatorOverloading, Expressions) {
+	MathLbr::vector<double> a{ {1,2,3,4} };
+	MathLbr::vector<double> b{ {1,1,1} };
+	MathLbr::vector<double> c{ {2,2,2,2,2} };
+
+	// 1. Check that the result is the same as the one computed with the compound operators
+	MathLbr::vector<double> expected = a;
+	MathLbr::vector<double> temp = b;
+	temp *= 2.0;
+	expected += temp;
+	expected -= c;
+	MathLbr::vector<double> result = a + b * 2.0 - c;
+	EXPECT_EQ(result, expected);
+	EXPECT_EQ(result.size(), 4);
+
+	// 2. Check that expressions referring to the assigned vector are evaluated correctly
+	MathLbr::vector<double> expected2{ {2,4,6,8} };
+	a = 2 * a;
+	EXPECT_EQ(a, expected2);
+
+	// 3. Check that the size changes when the leftmost vector has a different size
+	MathLbr::vector<double> expected3{ {3,3,3,2,2} };
+	b = c + b;
+	EXPECT_EQ(b, expected3);
+
+	// 4. Check compound operators accepting expressions
+	MathLbr::vector<double> expected4{ {11,13,15,14} };
+	a += b * 3.0 - 0.0;
+	EXPECT_EQ(a, expected4);
+
+	// 5. Check that temporaries are kept alive by the expression
+	auto expr = MathLbr::vector<int, 3>{ {1,2,3} } * 3;
+	MathLbr::vector<int, 3> expected5{ {3,6,9} };
+	EXPECT_EQ(expr.eval(), expected5);
+	EXPECT_EQ(expr[2], 9);
+
+	// 6. Check that expressions can be evaluated at compile time
+	constexpr int value = [] {
+		MathLbr::vector<int, 3> x{ {1,2,3} };
+		MathLbr::vector<int, 3> y = -x + x * 2;
+		return y[2];
+	}();
+	EXPECT_EQ(value, 3);
+}
+
+TEST(OperatorOverloading, ExpressionArguments) {
+	MathLbr::vector<double> a{ {1,2,3,4} };
+	MathLbr::vector<double> b{ {1,1,1,1} };
+	const MathLbr::vector<double> sum = a + b;
+
+	// 1. Free functions of MathLbr::Vector evaluate their expression arguments
+	EXPECT_EQ(MathLbr::Vector::inner_product(a + b, a), MathLbr::Vector::inner_product(sum, a));
+	EXPECT_EQ(MathLbr::Vector::inner_product(a, a + b), MathLbr::Vector::inner_product(a, sum));
+	EXPECT_EQ(MathLbr::Vector::inner_product(MathLbr::execution::par, a + b, a), MathLbr::Vector::inner_product(sum, a));
+	EXPECT_EQ(MathLbr::Vector::normalize(a + b), MathLbr::Vector::normalize(sum));
+	EXPECT_TRUE(MathLbr::Vector::are_parallel(a * 2.0, a));
+	EXPECT_FALSE(MathLbr::Vector::are_perpendicular(a + b, a - b));
+
+	MathLbr::vector<int, 3> c{ {1,2,3} };
+	MathLbr::vector<int, 3> d{ {3,1,2} };
+	const MathLbr::vector<int, 3> twice = c + c;
+	EXPECT_EQ(MathLbr::Vector::cross_product(c + c, d), MathLbr::Vector::cross_product(twice, d));
+	EXPECT_EQ(MathLbr::Vector::cross_product(d, c + c), MathLbr::Vector::cross_product(d, twice));
+	EXPECT_EQ(MathLbr::Vector::scalar_triple_product(c + c, d, c), MathLbr::Vector::scalar_triple_product(twice, d, c));
+	EXPECT_EQ(MathLbr::Vector::vector_triple_product(c, d, c + c), MathLbr::Vector::vector_triple_product(c, d, twice));
+
+	// 2. Member functions can be called on expressions, and accept them as arguments
+	EXPECT_EQ((a + b).norm(), sum.norm());
+	EXPECT_EQ((a + b).norm<MathLbr::Norm::L1>(), sum.norm<MathLbr::Norm::L1>());
+	EXPECT_EQ((a + b).angle_between_radians(a), sum.angle_between_radians(a));
+	EXPECT_EQ(a.angle_between_radians(a + b), a.angle_between_radians(sum));
+	EXPECT_EQ((a + b).angle_between_degrees(a - b), sum.angle_between_degrees(a - b));
+	EXPECT_EQ((a + b).normalize(), MathLbr::Vector::normalize(sum));
+	EXPECT_EQ((c + c).cross_product(d), MathLbr::Vector::cross_product(twice, d));
+	EXPECT_EQ((a + b).y(), 3.0);
+
+	MathLbr::vector<int, 3> e = c;
+	e.cross_product(d - c);
+	EXPECT_EQ(e, MathLbr::Vector::cross_product(c, MathLbr::vector<int, 3>{ {2,-1,-1} }));
+
+	// 3. Complex vectors keep the choice of the antilinear argument
+	using C = std::complex<double>;
+	MathLbr::vector<C> f{ {C{1,2}, C{3,-1}} };
+	MathLbr::vector<C> g{ {C{0,1}, C{2,2}} };
+	const MathLbr::vector<C> fg = f + g;
+	EXPECT_EQ(MathLbr::Vector::inner_product<MathLbr::ComplexInnerProduct::ANTILINEAR_SECOND_ARGUMENT>(f + g, f),
+		MathLbr::Vector::inner_product<MathLbr::ComplexInnerProduct::ANTILINEAR_SECOND_ARGUMENT>(fg, f));
+	EXPECT_EQ((f + g).angle_between_radians(f), fg.angle_between_radians(f));
+}
+
 TEST(Modifiers, CrossProduct) {
 	/* DYNAMIC EXTENT DISABLED */
 	// 1. Check no implicit conversion correctness 
@@ -618,6 +720,35 @@ TEST(Modifiers, InnerProduct) {
 		"Dynamic sizes of both lhs and rhs must be equal to perform certain operations!");
 }
 
+TEST(Modifiers, InnerProductSimd) {
+	// Vectorized kernels must match the generic algorithms, including the remainders of odd sizes
+	for (std::size_t size : { 1, 7, 16, 33, 100, 1023 }) {
+		MathLbr::vector<double> a(size);
+		MathLbr::vector<double> b(size);
+		MathLbr::vector<std::complex<float>> c(size);
+		MathLbr::vector<std::complex<float>> d(size);
+		for (std::size_t i = 0; i < size; ++i) {
+			a[i] = std::sin(i * 0.5);
+			b[i] = std::cos(i * 0.3);
+			c[i] = { static_cast<float>(std::sin(i * 0.1)), static_cast<float>(std::cos(i * 0.7)) };
+			d[i] = { static_cast<float>(std::cos(i * 0.2)), static_cast<float>(std::sin(i * 0.9)) };
+		}
+
+		EXPECT_NEAR(MathLbr::Vector::inner_product(a, b), std::inner_product(a.begin(), a.end(), b.begin(), 0.), 1E-9);
+
+		std::complex<float> expected{};
+		for (std::size_t i = 0; i < size; ++i) {
+			expected += std::conj(c[i]) * d[i];
+		}
+		const auto result = MathLbr::Vector::inner_product(c, d);
+		EXPECT_NEAR(result.real(), expected.real(), 1E-3);
+		EXPECT_NEAR(result.imag(), expected.imag(), 1E-3);
+		const auto result2 = MathLbr::Vector::inner_product<MathLbr::ComplexInnerProduct::ANTILINEAR_SECOND_ARGUMENT>(c, d);
+		EXPECT_NEAR(result2.real(), expected.real(), 1E-3);
+		EXPECT_NEAR(result2.imag(), -expected.imag(), 1E-3);
+	}
+}
+
 TEST(Modifiers, complexDotProduct) {
 	EXPECT_EQ(MathLbr::Vector::complex_inner_product(std::complex<int>(3, -4), std::complex<double>(-4, 3)), -24);
 }
@@ -858,3 +989,984 @@ TEST(Modifiers, rotation) {
 	EXPECT_NEAR(c[1], -11.59552, 1E-4);
 	EXPECT_EQ(c[2], -3);
 }
+
+TEST(Storage, SplitComplex) {
+	MathLbr::split_complex_vector<double> a{ { {1, 2}, {3, 4}, {-1, 0} } };
+	MathLbr::vector<std::complex<double>> b{ { {0, 1}, {2, 2}, {5, -3} } };
+	EXPECT_EQ(a.real_data()[1], 3);
+	EXPECT_EQ(a.imag_data()[1], 4);
+
+	// element access goes through a proxy writing to both arrays
+	a[2] = std::complex<double>{ 7, 8 };
+	a[0] *= 2.0;
+	EXPECT_EQ(a[2], std::complex<double>(7, 8));
+	EXPECT_EQ(a.imag_data()[0], 4);
+
+	// split kernels must match the interleaved ones
+	MathLbr::vector<std::complex<double>> a_interleaved(a.begin(), a.end());
+	MathLbr::split_complex_vector<double> b_split(b.begin(), b.end());
+	const auto expected = MathLbr::Vector::inner_product(a_interleaved, b);
+	const auto result = MathLbr::Vector::inner_product(a, b_split);
+	EXPECT_NEAR(result.real(), expected.real(), 1E-9);
+	EXPECT_NEAR(result.imag(), expected.imag(), 1E-9);
+	EXPECT_NEAR(a.norm(), a_interleaved.norm(), 1E-9);
+
+	MathLbr::split_complex_vector<double> c = a + b;
+	for (std::size_t i = 0; i < c.size(); ++i) {
+		EXPECT_EQ(c[i], a_interleaved[i] + b[i]);
+	}
+
+	MathLbr::split_complex_vector<float, 3> d{ { {1, 0}, {0, 1} } };
+	MathLbr::split_complex_vector<float, 3> e{ { {0, 1}, {1, 0} } };
+	MathLbr::vector<std::complex<float>, 3> d_interleaved{ { {1, 0}, {0, 1} } };
+	MathLbr::vector<std::complex<float>, 3> e_interleaved{ { {0, 1}, {1, 0} } };
+	const auto cross = MathLbr::Vector::cross_product(d, e);
+	const auto expected_cross = MathLbr::Vector::cross_product(d_interleaved, e_interleaved);
+	for (std::size_t i = 0; i < 3; ++i) {
+		EXPECT_EQ(cross[i], expected_cross[i]);
+	}
+}
+
+TEST(Batch, VectorBatch) {
+	std::vector<MathLbr::vector<double, 3>> a{ MathLbr::vector<double, 3>{ {1, 2, 3} }, MathLbr::vector<double, 3>{ {-4, 0.5, 2} },
+		MathLbr::vector<double, 3>{ {1, 0, 0} } };
+	std::vector<MathLbr::vector<double, 3>> b{ MathLbr::vector<double, 3>{ {3, 2, 1} }, MathLbr::vector<double, 3>{ {-8, 1, 4} },
+		MathLbr::vector<double, 3>{ {0, 1, 0} } };
+	std::vector<MathLbr::vector<double, 3>> c{ MathLbr::vector<double, 3>{ {0, 1, 5} }, MathLbr::vector<double, 3>{ {2, 2, 2} },
+		MathLbr::vector<double, 3>{ {1, 1, 0} } };
+
+	// AoS -> SoA -> AoS
+	MathLbr::vector_batch<double, 3> batch_a(a.begin(), a.end());
+	MathLbr::vector_batch<double, 3> batch_b(b.begin(), b.end());
+	MathLbr::vector_batch<double, 3> batch_c(c.begin(), c.end());
+	EXPECT_EQ(batch_a.size(), 3);
+	EXPECT_EQ(batch_a.y()[1], 0.5);
+	EXPECT_EQ(batch_a.to_vectors(), a);
+
+	const auto cross = MathLbr::Vector::cross_product(batch_a, batch_b);
+	const auto inner = MathLbr::Vector::inner_product(batch_a, batch_b);
+	const auto triple = MathLbr::Vector::scalar_triple_product(batch_a, batch_b, batch_c);
+	const auto norms = batch_a.norm();
+	const auto normalized = MathLbr::Vector::normalize(batch_a);
+	const auto parallel = MathLbr::Vector::are_parallel(batch_a, batch_b);
+	const auto perpendicular = MathLbr::Vector::are_perpendicular(batch_a, batch_b);
+	const auto coplanar = MathLbr::Vector::are_coplanar(batch_a, batch_b, batch_c);
+	for (std::size_t i = 0; i < a.size(); ++i) {
+		EXPECT_EQ(cross[i], MathLbr::Vector::cross_product(a[i], b[i]));
+		EXPECT_NEAR(inner[i], MathLbr::Vector::inner_product(a[i], b[i]), 1E-12);
+		EXPECT_NEAR(triple[i], MathLbr::Vector::scalar_triple_product(a[i], b[i], c[i]), 1E-12);
+		EXPECT_NEAR(norms[i], a[i].norm(), 1E-12);
+		for (std::size_t d = 0; d < 3; ++d) {
+			EXPECT_NEAR(normalized[i][d], MathLbr::Vector::normalize(a[i])[d], 1E-12);
+		}
+		EXPECT_EQ(parallel[i], MathLbr::Vector::are_parallel(a[i], b[i]));
+		EXPECT_EQ(perpendicular[i], MathLbr::Vector::are_perpendicular(a[i], b[i]));
+		EXPECT_EQ(coplanar[i], MathLbr::Vector::are_coplanar(a[i], b[i], c[i]));
+	}
+	EXPECT_TRUE(parallel[1]);
+	EXPECT_TRUE(perpendicular[2]);
+	EXPECT_TRUE(coplanar[2]);
+
+	batch_a.set(0, MathLbr::vector<int, 3>{ {7, 8, 9} });
+	EXPECT_EQ(batch_a[0], (MathLbr::vector<double, 3>{ {7, 8, 9} }));
+}
+
+TEST(Execution, ParallelPolicy) {
+	// Small chunks and no threshold, so that even small vectors are split between threads
+	const MathLbr::execution::parallel_policy policy{ 4, 0, 7 };
+	MathLbr::vector<int> a(1000);
+	MathLbr::vector<int> b(1000);
+	for (int i = 0; i < 1000; ++i) {
+		a[i] = i % 13 - 6;
+		b[i] = i % 7;
+	}
+
+	EXPECT_EQ(MathLbr::Vector::inner_product(policy, a, b), MathLbr::Vector::inner_product(a, b));
+	EXPECT_EQ(a.norm<MathLbr::Norm::L0>(policy), a.norm<MathLbr::Norm::L0>());
+	EXPECT_EQ(a.norm<MathLbr::Norm::L1>(policy), a.norm<MathLbr::Norm::L1>());
+	EXPECT_EQ(a.norm<MathLbr::Norm::LINF>(policy), a.norm<MathLbr::Norm::LINF>());
+	EXPECT_NEAR(a.norm(policy), a.norm(), 1E-9);
+	EXPECT_NEAR(a.p_norm<3>(policy), a.p_norm<3>(), 1E-9);
+
+	auto parallel = a;
+	auto serial = a;
+	parallel.plus_assign(policy, b).multiplies_assign(policy, 3).minus_assign(policy, 2).divides_assign(policy, 2);
+	serial += b;
+	serial *= 3;
+	serial -= 2;
+	serial /= 2;
+	EXPECT_EQ(parallel, serial);
+	parallel.apply_foreach(policy, [](int& x) { x = -x; });
+	serial.apply_foreach([](int& x) { x = -x; });
+	EXPECT_EQ(parallel, serial);
+
+	// Reductions don't depend on the number of threads
+	MathLbr::vector<double> c(1000);
+	for (int i = 0; i < 1000; ++i) {
+		c[i] = 1.0 / (i + 1);
+	}
+	const MathLbr::execution::parallel_policy single_thread{ 1, 0, 7 };
+	EXPECT_EQ(MathLbr::Vector::inner_product(policy, c, c), MathLbr::Vector::inner_product(single_thread, c, c));
+	EXPECT_EQ(c.norm(policy), c.norm(single_thread));
+	EXPECT_EQ(c.norm(MathLbr::execution::seq), c.norm());
+}
+
+TEST(Storage, PmrAllocator) {
+	// Every allocation must come from the arena: the upstream resource throws
+	std::byte buffer[4096];
+	std::pmr::monotonic_buffer_resource arena(buffer, sizeof buffer, std::pmr::null_memory_resource());
+
+	MathLbr::pmr::vector<double> a({ 1.0, 2.0, 3.0 }, &arena);
+	MathLbr::pmr::vector<double> b(3, &arena);
+	b[0] = 4;
+	b[1] = 5;
+	b[2] = 6;
+	EXPECT_EQ(a.get_allocator().resource(), &arena);
+
+	// Expressions, copies and converting constructors propagate the allocator
+	MathLbr::pmr::vector<double> c = a + b * 2.0;
+	const auto cross = MathLbr::Vector::cross_product(a, b);
+	const auto normalized = MathLbr::Vector::normalize(c);
+	MathLbr::pmr::vector<float> d({ 1.f, 2.f }, &arena);
+	MathLbr::pmr::vector<double> e(d);
+	MathLbr::pmr::vector<double> random(1.0, 2.0, 10, &arena);
+	EXPECT_EQ(c.get_allocator().resource(), &arena);
+	EXPECT_EQ(cross.get_allocator().resource(), &arena);
+	EXPECT_EQ(normalized.get_allocator().resource(), &arena);
+	EXPECT_EQ(e.get_allocator().resource(), &arena);
+	EXPECT_EQ(random.get_allocator().resource(), &arena);
+
+	EXPECT_EQ(c, (MathLbr::pmr::vector<double>({ 9.0, 12.0, 15.0 }, &arena)));
+	EXPECT_EQ(cross, (MathLbr::pmr::vector<double>({ -3.0, 6.0, -3.0 }, &arena)));
+	EXPECT_EQ(e[1], 2.0);
+}
+
+TEST(Storage, SmallBuffer) {
+	MathLbr::small_vector<double, 4> a{ {1, 2, 3} };
+	MathLbr::small_vector<double, 4> b(3);
+	b[0] = 4;
+	b[1] = 5;
+	b[2] = 6;
+	EXPECT_EQ(a.underlying_data().capacity(), 4);
+
+	MathLbr::small_vector<double, 4> c = a + b * 2.0;
+	EXPECT_EQ(c, (MathLbr::small_vector<double, 4>{ {9, 12, 15} }));
+	EXPECT_EQ(MathLbr::Vector::cross_product(a, b), (MathLbr::small_vector<double, 4>{ {-3, 6, -3} }));
+	EXPECT_EQ(MathLbr::Vector::inner_product(a, b), 32);
+
+	// Spills to the heap beyond the inline capacity, elements are kept
+	for (int i = 0; i < 10; ++i) {
+		a.add(i);
+	}
+	EXPECT_EQ(a.size(), 13);
+	EXPECT_GT(a.underlying_data().capacity(), 4);
+	EXPECT_EQ(a[2], 3);
+	EXPECT_EQ(a[12], 9);
+
+	auto copy = a;
+	const auto moved = std::move(copy);
+	EXPECT_EQ(moved, a);
+	EXPECT_EQ(std::accumulate(moved.begin(), moved.end(), 0.0), 51);
+}
+
+TEST(Storage, Aligned) {
+	MathLbr::aligned_vector<double> a(100);
+	MathLbr::aligned_vector<double> b(100);
+	for (int i = 0; i < 100; ++i) {
+		a[i] = i;
+		b[i] = 2;
+	}
+	static_assert(decltype(a)::alignment == 64);
+	static_assert(MathLbr::vector<double>::alignment == alignof(double));
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.data()) % 64, 0);
+
+	MathLbr::aligned_vector<double> c = a + b * 2.0;
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c.data()) % 64, 0);
+	EXPECT_EQ(c[99], 103);
+	EXPECT_EQ(MathLbr::Vector::inner_product(a, b), 9900);
+
+	MathLbr::aligned_vector<float, 3, 32> d{ {1, 2, 3} };
+	static_assert(alignof(decltype(d)) == 32);
+	EXPECT_EQ(d + d, (MathLbr::aligned_vector<float, 3, 32>{ {2, 4, 6} }));
+
+	MathLbr::vector<double, MathLbr::dynamic_extent, MathLbr::aligned<64, true>> huge(std::size_t{ 1 } << 19);
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(huge.data()) % (std::size_t{ 1 } << 21), 0);
+}
+
+TEST(View, VectorView) {
+	std::vector<double> buffer{ 3, 4, 0 };
+	const std::vector<double> other{ 1, 0, 0 };
+	MathLbr::vector_view<double> v(buffer);
+	MathLbr::vector_view<const double> c(other);
+	EXPECT_EQ(v.data(), buffer.data());
+	EXPECT_EQ(v.norm(), 5);
+	EXPECT_EQ(MathLbr::Vector::inner_product(v, c), 3);
+
+	// Functions returning a new vector don't touch the viewed elements
+	const auto normalized = MathLbr::Vector::normalize(v);
+	static_assert(std::is_same_v<std::remove_const_t<decltype(normalized)>, MathLbr::vector<double>>);
+	EXPECT_DOUBLE_EQ(normalized[0], 0.6);
+	EXPECT_DOUBLE_EQ(normalized[1], 0.8);
+	EXPECT_EQ(MathLbr::Vector::cross_product(v, c), (MathLbr::vector<double>{ {0, 0, -4} }));
+	EXPECT_EQ(buffer, (std::vector<double>{ 3, 4, 0 }));
+
+	// In-place operations write to the buffer
+	v += c;
+	v *= 2.0;
+	EXPECT_EQ(buffer, (std::vector<double>{ 8, 8, 0 }));
+	MathLbr::vector<double> ones{ {1, 1, 1} };
+	v = v + ones * 2.0;
+	EXPECT_EQ(buffer, (std::vector<double>{ 10, 10, 2 }));
+	MathLbr::vector<double> sum = v + c;
+	EXPECT_EQ(sum, (MathLbr::vector<double>{ {11, 10, 2} }));
+
+	double array[3]{ 0, 3, 4 };
+	MathLbr::vector_view<double, 3> fixed(array, 3);
+	fixed.normalize();
+	EXPECT_DOUBLE_EQ(array[2], 0.8);
+	MathLbr::vector_view<double> of_vector(ones);
+	of_vector /= 2.0;
+	EXPECT_EQ(ones[1], 0.5);
+}
+
+TEST(Persistence, MappedVector) {
+	const auto path = std::filesystem::temp_directory_path() / "mathlbr_mapped_vector_test.bin";
+	const MathLbr::vector<float> saved{ {3, 4, 0} };
+	MathLbr::save(path, saved);
+	{
+		const MathLbr::mapped_vector<float> mapped(path);
+		EXPECT_EQ(mapped.size(), 3);
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(mapped.data()) % 64, 0);
+		EXPECT_EQ(mapped.view().norm(), 5);
+		EXPECT_EQ(MathLbr::vector<float>(mapped.view()), saved);
+		EXPECT_THROW(MathLbr::mapped_vector<double>{ path }, std::runtime_error);
+	}
+	{
+		auto mapped = MathLbr::mapped_vector<double, MathLbr::mapping_mode::read_write>::create(path, 4);
+		auto view = mapped.view();
+		view += 1.0;
+		view[3] = 7;
+		mapped.flush();
+	}
+	const MathLbr::mapped_vector<double> reopened(path);
+	EXPECT_EQ(reopened.view(), (MathLbr::vector<double>{ {1, 1, 1, 7} }));
+	std::filesystem::remove(path);
+}
+
+TEST(Random, PhiloxFill) {
+	// Known answers of Philox4x32-10 (Random123)
+	EXPECT_EQ(detail::random::philox({ 0, 0, 0, 0 }, 0), (detail::random::block{ 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 }));
+	EXPECT_EQ(detail::random::philox({ 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, 0x299f31d0a4093822),
+		(detail::random::block{ 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }));
+
+	MathLbr::random::philox_engine engine(7, 3), skipped(7, 3);
+	for (int i = 0; i < 5; ++i) engine();
+	skipped.discard(5);
+	EXPECT_EQ(engine(), skipped());
+
+	const MathLbr::random::normal_distribution<double> normal{ 1.0, 2.0 };
+	MathLbr::vector<double> serial(100'003), parallel(100'003), prefix(1000);
+	MathLbr::random::fill(serial, normal, 42);
+	MathLbr::random::fill(MathLbr::execution::parallel_policy{ 4, 1000, 999 }, parallel, normal, 42);
+	MathLbr::random::fill(prefix, normal, 42);
+	EXPECT_EQ(serial, parallel);
+	EXPECT_TRUE(std::equal(prefix.begin(), prefix.end(), serial.begin()));
+	double mean = 0;
+	for (double x : serial) mean += x;
+	EXPECT_NEAR(mean / serial.size(), 1.0, 0.05);
+
+	MathLbr::vector<std::complex<float>, 3> a, b;
+	MathLbr::random::fill(a, MathLbr::random::uniform_distribution<std::complex<float>>{ -1.0f, 1.0f }, 42, 1);
+	MathLbr::random::fill(b, MathLbr::random::uniform_distribution<std::complex<float>>{ -1.0f, 1.0f }, 42, 2);
+	EXPECT_NE(a, b);
+	for (const auto& z : a)
+	{
+		EXPECT_TRUE(z.real() >= -1.0f and z.real() < 1.0f and z.imag() >= -1.0f and z.imag() < 1.0f);
+	}
+}
+
+TEST(Modifiers, NormalizeExtremeMagnitudes) {
+	MathLbr::vector<double> huge{ {3e200, 4e200} }, tiny{ {3e-200, 4e-200} };
+	EXPECT_DOUBLE_EQ(huge.norm(), 5e200);
+	EXPECT_DOUBLE_EQ(tiny.norm(), 5e-200);
+	huge.normalize();
+	tiny.normalize();
+	EXPECT_DOUBLE_EQ(huge[0], 0.6);
+	EXPECT_DOUBLE_EQ(tiny[1], 0.8);
+
+	MathLbr::vector<std::complex<float>> complex{ {{3e30f, 0}, {0, 4e30f}} };
+	complex.normalize();
+	EXPECT_FLOAT_EQ(complex[1].imag(), 0.8f);
+
+	MathLbr::vector_batch<double, 3> batch{ MathLbr::vector<double, 3>{ {3e200, 4e200, 0} }, MathLbr::vector<double, 3>{ {1, 2, 2} } };
+	batch.normalize();
+	EXPECT_DOUBLE_EQ(batch.x()[0], 0.6);
+	EXPECT_DOUBLE_EQ(batch.z()[1], 2.0 / 3);
+}
+
+TEST(Accuracy, SummationPolicies) {
+	MathLbr::vector<float> tenths(1'000'003);
+	std::fill(tenths.begin(), tenths.end(), 0.1f);
+	const double exact = 1'000'003 * double(0.1f);
+	EXPECT_GT(std::abs(tenths.norm<MathLbr::Norm::L1>() - exact), 100);
+	EXPECT_EQ(tenths.norm<MathLbr::Norm::L1>(MathLbr::summation::sequential), tenths.norm<MathLbr::Norm::L1>());
+	EXPECT_NEAR(tenths.norm<MathLbr::Norm::L1>(MathLbr::summation::pairwise), exact, 1);
+	EXPECT_NEAR(tenths.norm<MathLbr::Norm::L1>(MathLbr::summation::kahan), exact, 0.125);
+	EXPECT_NEAR(tenths.norm<MathLbr::Norm::L1>(MathLbr::summation::neumaier), exact, 0.125);
+	EXPECT_NEAR(tenths.p_norm<2>(MathLbr::summation::pairwise), std::sqrt(1'000'003 * double(0.1f) * double(0.1f)), 1e-3);
+
+	const MathLbr::vector<double> cancelling{ {1e16, 1, -1e16, 1} }, ones{ {1, 1, 1, 1} };
+	EXPECT_EQ(MathLbr::Vector::inner_product(MathLbr::summation::neumaier, cancelling, ones), 2);
+
+	const MathLbr::vector<double> huge{ {3e200, 4e200} };
+	EXPECT_DOUBLE_EQ(huge.norm(MathLbr::summation::kahan), 5e200);
+	const MathLbr::vector<std::complex<double>> complex{ {{3, 4}, {0, 12}} };
+	EXPECT_DOUBLE_EQ(complex.norm(MathLbr::summation::neumaier), 13);
+
+	// A NaN element gives a NaN norm: the scaled fallback would skip it
+	MathLbr::vector<double> not_a_number(1000);
+	not_a_number[500] = std::numeric_limits<double>::quiet_NaN();
+	EXPECT_TRUE(std::isnan(not_a_number.norm(MathLbr::summation::kahan)));
+	EXPECT_TRUE(std::isnan(not_a_number.norm(MathLbr::execution::parallel_policy{ 4, 0, 1 })));
+	const MathLbr::vector<int> integers{ {1, -2, 3} };
+	EXPECT_EQ(integers.norm<MathLbr::Norm::L1>(MathLbr::summation::pairwise), 6);
+}
+
+TEST(Constexpr, FixedSizeMath) {
+	constexpr MathLbr::vector<double, 3> v{ {3.0, 4.0, 12.0} };
+	static_assert(v.norm() == 13);
+	static_assert(v.p_norm<2>() == 13);
+	constexpr auto unit = [v] { auto u = v; u.normalize(); return u; }();
+	static_assert(unit[2] > 0.923 and unit[2] < 0.924);
+	constexpr auto rotated = [] { MathLbr::vector<double, 3> u{ {1.0, 0.0, 0.0} }; u.rotate_around_z(std::numbers::pi / 2); return u; }();
+	static_assert(rotated[0] < 1e-15 and rotated[1] == 1);
+	constexpr double angle = MathLbr::vector<double, 3>{ {1.0, 0.0, 0.0} }.angle_between_degrees(MathLbr::vector<double, 3>{ {1.0, 1.0, 0.0} });
+	static_assert(angle > 44.999999 and angle < 45.000001);
+	constexpr auto polar = MathLbr::vector<double, 2>{ {3.0, 4.0} }.to_polar_coords();
+	static_assert(polar[0] == 5 and polar[1] > 0.9272952 and polar[1] < 0.9272953);
+	constexpr MathLbr::vector<std::complex<double>, 2> complex{ {{3.0, 4.0}, {0.0, 12.0}} };
+	static_assert(complex.norm() == 13);
+
+	// Same results as at runtime, up to an ulp
+	MathLbr::vector<double, 3> runtime = v;
+	runtime.rotate_around_x(0.7);
+	constexpr auto folded = [v] { auto u = v; u.rotate_around_x(0.7); return u; }();
+	EXPECT_DOUBLE_EQ(runtime[1], folded[1]);
+	EXPECT_DOUBLE_EQ(runtime[2], folded[2]);
+	EXPECT_DOUBLE_EQ(v.to_spherical_coords()[2], std::acos(12.0 / 13));
+	constexpr auto spherical = v.to_spherical_coords();
+	EXPECT_DOUBLE_EQ(spherical[1], std::atan2(4.0, 3.0));
+	EXPECT_DOUBLE_EQ(v.p_norm<3>(), std::pow(27.0 + 64 + 1728, 1.0 / 3));
+
+	// Large angles are reduced exactly, up to the largest double (6381956970095103 * 2^797 is very close to a multiple of pi / 2)
+	constexpr double large_sin = detail::math::sin(1e15);
+	constexpr double huge_sin = detail::math::sin(1e22);
+	constexpr double largest_cos = detail::math::cos(std::numeric_limits<double>::max());
+	constexpr double hard_cos = detail::math::cos(0x1.6ac5b262ca1ffp849);
+	constexpr float large_float_sin = detail::math::sin(3e38f);
+	EXPECT_DOUBLE_EQ(large_sin, std::sin(1e15));
+	EXPECT_DOUBLE_EQ(huge_sin, std::sin(1e22));
+	EXPECT_DOUBLE_EQ(largest_cos, std::cos(std::numeric_limits<double>::max()));
+	EXPECT_DOUBLE_EQ(hard_cos, std::cos(0x1.6ac5b262ca1ffp849));
+	EXPECT_FLOAT_EQ(large_float_sin, std::sin(3e38f));
+	constexpr double large_exp = detail::math::exp(700.5);
+	EXPECT_DOUBLE_EQ(large_exp, std::exp(700.5));
+
+	// Exponents beyond the range of long long are even integers
+	static_assert(detail::math::pow(0.5, 1e30) == 0 and detail::math::pow(-2.0, 1e30) == std::numeric_limits<double>::infinity());
+	static_assert(detail::math::pow(-1.0, 0x1p53 + 2) == 1 and detail::math::pow(-1.0, 0x1p52 + 1) == -1);
+	static_assert(detail::math::pow(-2.0f, -1e20f) == 0 and detail::math::pow(2.0, -0.5) > 0.7071 and detail::math::pow(-2.0, 1.5) != detail::math::pow(-2.0, 1.5));
+
+	constexpr auto random = [] { MathLbr::vector<double, 4> u; MathLbr::random::fill(u, MathLbr::random::normal_distribution<double>{}, 42); return u; }();
+	MathLbr::vector<double, 4> drawn;
+	MathLbr::random::fill(drawn, MathLbr::random::normal_distribution<double>{}, 42);
+	for (std::size_t i = 0; i < 4; ++i) EXPECT_DOUBLE_EQ(random[i], drawn[i]);
+}
+
+TEST(Products, SmallFixedVectors) {
+	// 2D/3D/4D float and double vectors use unrolled kernels: same results as the generic paths
+	const MathLbr::vector<double, 3> a{ {1.5, -2.0, 4.0} }, b{ {3.0, 0.5, -1.25} };
+	const MathLbr::vector<double> dynamic_a{ {1.5, -2.0, 4.0} }, dynamic_b{ {3.0, 0.5, -1.25} };
+	EXPECT_DOUBLE_EQ(MathLbr::Vector::inner_product(a, b), MathLbr::Vector::inner_product(dynamic_a, dynamic_b));
+	EXPECT_DOUBLE_EQ(a.norm(), dynamic_a.norm());
+	const auto unit = MathLbr::Vector::normalize(a);
+	const auto dynamic_unit = MathLbr::Vector::normalize(dynamic_a);
+	for (std::size_t i = 0; i < 3; ++i) EXPECT_DOUBLE_EQ(unit[i], dynamic_unit[i]);
+
+	const MathLbr::vector<float, 4> c{ {1.0f, 2.0f, 2.0f, 4.0f} };
+	EXPECT_FLOAT_EQ(c.norm(), 5.0f);
+	EXPECT_FLOAT_EQ(MathLbr::Vector::inner_product(c, c), 25.0f);
+	const MathLbr::vector<float, 2> d{ {3e20f, 4e20f} };
+	EXPECT_FLOAT_EQ(d.norm(), 5e20f);
+	EXPECT_FLOAT_EQ(MathLbr::Vector::normalize(d)[1], 0.8f);
+	static_assert(MathLbr::Vector::inner_product(MathLbr::vector<double, 2>{ {3.0, 4.0} }, MathLbr::vector<double, 2>{ {3.0, 4.0} }) == 25);
+}
+
+TEST(Matrix, Gemm) {
+	constexpr MathLbr::matrix<int, 2, 3> small{ {1, 2, 3}, {4, 5, 6} };
+	constexpr auto square = small * small.transpose();
+	static_assert(square == MathLbr::matrix<int, 2, 2>{ {14, 32}, {32, 77} });
+	static_assert(MathLbr::matrix<double, 3, 3>::identity() * MathLbr::matrix<double, 3, 3>::identity() == MathLbr::matrix<double, 3, 3>::identity());
+
+	// Blocked and naive products agree for every layout, including the edges of the tiles
+	for (std::size_t n : { 1, 7, 65, 301 }) {
+		const std::size_t m = n + 5, k = 2 * n + 3;
+		MathLbr::matrix<double> a(m, k), b(k, n);
+		std::mt19937 engine(42);
+		std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+		for (auto& value : a) value = distribution(engine);
+		for (auto& value : b) value = distribution(engine);
+		const MathLbr::matrix<double, MathLbr::dynamic_extent, MathLbr::dynamic_extent, MathLbr::Layout::COLUMN_MAJOR> b_columns(b);
+		const auto c = a * b;
+		const auto c_columns = MathLbr::Matrix::multiply(a, b_columns);
+		const auto c_parallel = MathLbr::Matrix::multiply(MathLbr::execution::parallel_policy{ 4, 0, 1 }, a, b_columns);
+		ASSERT_EQ(c.rows(), m);
+		ASSERT_EQ(c.cols(), n);
+		EXPECT_TRUE(c_parallel == c_columns);
+		for (std::size_t i = 0; i < m; ++i) {
+			for (std::size_t j = 0; j < n; ++j) {
+				double expected = 0;
+				for (std::size_t p = 0; p < k; ++p) expected += a(i, p) * b(p, j);
+				EXPECT_NEAR(c(i, j), expected, 1e-12);
+				EXPECT_NEAR(c_columns(i, j), expected, 1e-12);
+			}
+		}
+	}
+
+	const MathLbr::matrix<float, 40, 30, MathLbr::Layout::COLUMN_MAJOR> f(40, 30, 0.5f);
+	const auto product = f.transpose() * f;
+	EXPECT_FLOAT_EQ(product(29, 0), 10.0f);
+	EXPECT_EQ(sizeof(MathLbr::matrix<double, 4, 4>), 16 * sizeof(double));
+}
+
+TEST(Matrix, Gemv) {
+	constexpr MathLbr::matrix<int, 2, 3> small{ {1, 2, 3}, {4, 5, 6} };
+	static_assert((small * MathLbr::vector<int, 3>{ {1, 1, 1} })[1] == 15);
+
+	// Both kernels (rows or columns contiguous), with tails, against the definition
+	for (std::size_t n : { 1, 6, 37, 513 }) {
+		const std::size_t m = n + 3;
+		std::mt19937 engine(7);
+		std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+		MathLbr::matrix<double> a(m, n);
+		for (auto& value : a) value = distribution(engine);
+		const MathLbr::matrix<double, MathLbr::dynamic_extent, MathLbr::dynamic_extent, MathLbr::Layout::COLUMN_MAJOR> a_columns(a);
+		MathLbr::vector<double> x(n), x_transposed(m), y(m), y_transposed(n);
+		for (auto& value : x) value = distribution(engine);
+		for (auto& value : x_transposed) value = distribution(engine);
+		for (auto& value : y) value = distribution(engine);
+		for (auto& value : y_transposed) value = distribution(engine);
+
+		auto y_rows = y, y_columns = y, y_parallel = y;
+		MathLbr::Matrix::gemv(2.0, a, x, 0.5, y_rows);
+		MathLbr::Matrix::gemv(2.0, a_columns, x, 0.5, y_columns);
+		MathLbr::Matrix::gemv(MathLbr::execution::parallel_policy{ 3, 0, 64 }, 2.0, a_columns, x, 0.5, y_parallel);
+		for (std::size_t i = 0; i < m; ++i) {
+			double expected = 0;
+			for (std::size_t j = 0; j < n; ++j) expected += a(i, j) * x[j];
+			EXPECT_NEAR(y_rows[i], 2 * expected + 0.5 * y[i], 1e-12);
+			EXPECT_NEAR(y_columns[i], 2 * expected + 0.5 * y[i], 1e-12);
+			EXPECT_EQ(y_parallel[i], y_columns[i]);
+		}
+
+		auto y_rows_transposed = y_transposed, y_columns_transposed = y_transposed;
+		MathLbr::Matrix::gemv_transposed(-1.0, a, x_transposed, 3.0, y_rows_transposed);
+		MathLbr::Matrix::gemv_transposed(-1.0, a_columns, x_transposed, 3.0, y_columns_transposed);
+		for (std::size_t j = 0; j < n; ++j) {
+			double expected = 0;
+			for (std::size_t i = 0; i < m; ++i) expected += a(i, j) * x_transposed[i];
+			EXPECT_NEAR(y_rows_transposed[j], -expected + 3 * y_transposed[j], 1e-12);
+			EXPECT_NEAR(y_columns_transposed[j], -expected + 3 * y_transposed[j], 1e-12);
+		}
+	}
+
+	// beta == 0: y is only written
+	MathLbr::vector<double> y{ {std::nan(""), std::nan("")} };
+	MathLbr::Matrix::gemv(1.0, MathLbr::matrix<double>(2, 2, 1.0), MathLbr::vector<double>{ {1.0, 2.0} }, 0.0, y);
+	EXPECT_EQ(y[0], 3.0);
+	const MathLbr::matrix<std::complex<double>> complex(1, 2, { 0.0, 1.0 });
+	EXPECT_EQ((complex * MathLbr::vector<std::complex<double>>{ {{1.0, 0.0}, {0.0, 1.0}} })[0], std::complex<double>(-1.0, 1.0));
+}
+
+TEST(Rotation, MatricesAndQuaternions) {
+	const MathLbr::vector<double, 3> v{ {1.0, 2.0, 3.0} };
+	MathLbr::vector<double, 3> expected = v;
+	expected.rotate_around_x(0.3);
+	expected.rotate_around_y(-1.1);
+	expected.rotate_around_z(2.0);
+
+	// Compositions apply the right operand first, like matrix products
+	const auto matrix = MathLbr::rotation<double>::around_z(2.0) * MathLbr::rotation<double>::around_y(-1.1) * MathLbr::rotation<double>::around_x(0.3);
+	const auto quaternion = MathLbr::quaternion<double>::around_z(2.0) * MathLbr::quaternion<double>::around_y(-1.1) * MathLbr::quaternion<double>::around_x(0.3);
+	const auto from_matrix = matrix.to_quaternion().rotate(v);
+	const auto from_quaternion = quaternion.to_rotation().rotate(v);
+	const auto back = matrix.inverse().rotate(matrix.rotate(v));
+	for (std::size_t i = 0; i < 3; ++i) {
+		EXPECT_NEAR(matrix.rotate(v)[i], expected[i], 1e-14);
+		EXPECT_NEAR(quaternion.rotate(v)[i], expected[i], 1e-14);
+		EXPECT_NEAR(from_matrix[i], expected[i], 1e-14);
+		EXPECT_NEAR(from_quaternion[i], expected[i], 1e-14);
+		EXPECT_NEAR(back[i], v[i], 1e-14);
+	}
+	const auto axis = MathLbr::rotation<double>::around_axis(MathLbr::vector<double, 3>{ {0.0, 0.0, 5.0} }, 2.0).rotate(v);
+	EXPECT_NEAR(axis[0], MathLbr::rotation<double>::around_z(2.0).rotate(v)[0], 1e-15);
+
+	// Batches and ranges give the same results as single vectors
+	MathLbr::vector_batch<double, 3> batch(300);
+	std::vector<MathLbr::vector<double, 3>> points(300);
+	for (std::size_t i = 0; i < 300; ++i) {
+		points[i] = MathLbr::vector<double, 3>{ {double(i), 1.0, -0.5 * i} };
+		batch.set(i, points[i]);
+	}
+	matrix.rotate(batch);
+	quaternion.rotate(points.begin(), points.end());
+	for (std::size_t i = 0; i < 300; i += 37) {
+		const auto single = matrix.rotate(MathLbr::vector<double, 3>{ {double(i), 1.0, -0.5 * i} });
+		for (std::size_t d = 0; d < 3; ++d) {
+			EXPECT_DOUBLE_EQ(batch[i][d], single[d]);
+			EXPECT_NEAR(points[i][d], single[d], 1e-12);
+		}
+	}
+
+	// Ranges of dynamic vectors (and of another element type) are rotated in place as well
+	std::vector<MathLbr::vector<double>> dynamic_points(5, MathLbr::vector<double>{ {1.0, 2.0, 3.0} });
+	std::vector<MathLbr::vector<float, 3>> float_points(5, MathLbr::vector<float, 3>{ {1.0f, 2.0f, 3.0f} });
+	matrix.rotate(dynamic_points.begin(), dynamic_points.end());
+	quaternion.rotate(float_points.begin(), float_points.end());
+	for (std::size_t i = 0; i < 5; ++i) {
+		EXPECT_EQ(dynamic_points[i].size(), 3);
+		for (std::size_t d = 0; d < 3; ++d) {
+			EXPECT_NEAR(dynamic_points[i][d], expected[d], 1e-14);
+			EXPECT_NEAR(float_points[i][d], expected[d], 1e-5);
+		}
+	}
+
+	// Slerp: constant angular velocity, shortest path (q and -q are the same orientation)
+	const auto quarter = MathLbr::Rotation::slerp(MathLbr::quaternion<double>{}, MathLbr::quaternion<double>::around_z(1.0), 0.25);
+	EXPECT_NEAR(quarter.w(), std::cos(0.125), 1e-15);
+	EXPECT_NEAR(quarter.z(), std::sin(0.125), 1e-15);
+	const MathLbr::quaternion<double> opposite(-1.0, 0.0, 0.0, 0.0);
+	EXPECT_NEAR(MathLbr::Rotation::slerp(MathLbr::quaternion<double>::around_z(0.2), opposite, 0.5).z(), std::sin(0.05), 1e-15);
+	constexpr auto rotated = MathLbr::rotation<double>::around_z(0.5).rotate(MathLbr::vector<double, 3>{ {1.0, 0.0, 0.0} });
+	static_assert(rotated[1] > 0.4794255 and rotated[1] < 0.4794256);
+}
+
+TEST(Batch, CoordinateConversions) {
+	// 301 points: full blocks, small blocks and a padded tail. Large angles and infinities go through <cmath>
+	std::mt19937 engine(7);
+	std::uniform_real_distribution<double> distribution(-50.0, 50.0);
+	MathLbr::vector_batch<double, 3> points(301);
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		points.set(i, MathLbr::vector<double, 3>{ {distribution(engine), distribution(engine), distribution(engine)} });
+	}
+	const auto spherical = points.to_spherical_coords();
+	const auto cylindrical = points.to_cylindrical_coords();
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		const auto single = points[i].to_spherical_coords();
+		const auto single_cylindrical = points[i].to_cylindrical_coords();
+		for (std::size_t d = 0; d < 3; ++d) {
+			EXPECT_NEAR(spherical[i][d], single[d], 1e-13);
+			EXPECT_NEAR(cylindrical[i][d], single_cylindrical[d], 1e-13);
+		}
+	}
+
+	MathLbr::vector_batch<double, 3> back = spherical;
+	back.from_spherical(back);
+	MathLbr::vector_batch<double, 3> back_cylindrical;
+	back_cylindrical.from_cylindrical(cylindrical);
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		for (std::size_t d = 0; d < 3; ++d) {
+			EXPECT_NEAR(back[i][d], points[i][d], 1e-12);
+			EXPECT_NEAR(back_cylindrical[i][d], points[i][d], 1e-12);
+		}
+	}
+
+	MathLbr::vector_batch<float, 2> polar{ MathLbr::vector<float, 2>{ {2.f, 1e4f} }, MathLbr::vector<float, 2>{ {-1.f, 0.5f} },
+		MathLbr::vector<float, 2>{ {3.f, std::numeric_limits<float>::infinity()} } };
+	MathLbr::vector_batch<float, 2> cartesian;
+	cartesian.from_polar(polar);
+	EXPECT_FLOAT_EQ(cartesian[0][0], 2.f * std::cos(1e4f));
+	EXPECT_FLOAT_EQ(cartesian[1][1], -1.f * std::sin(0.5f));
+	EXPECT_TRUE(std::isnan(cartesian[2][0]));
+	cartesian.set(2, MathLbr::vector<float, 2>{ {-1.f, -0.f} });
+	cartesian.to_polar_coords(cartesian);
+	EXPECT_FLOAT_EQ(cartesian[0][0], 2.f);
+	EXPECT_FLOAT_EQ(cartesian[2][1], -std::numbers::pi_v<float>);
+}
+
+TEST(Accuracy, FastMath) {
+	// Relative errors stay far below the documented bounds (2e-8 for double, 4 ulp for float)
+	std::mt19937 engine(11);
+	std::uniform_real_distribution<double> distribution(-20.0, 20.0);
+	for (int i = 0; i < 1000; ++i) {
+		const MathLbr::vector<double, 3> a{ {distribution(engine), distribution(engine), distribution(engine)} };
+		const MathLbr::vector<double, 3> b{ {distribution(engine), distribution(engine), distribution(engine)} };
+		const double angle = a.angle_between_radians(b);
+		EXPECT_NEAR(a.angle_between_radians(MathLbr::precision::fast, b), angle, 2e-8 * angle);
+		EXPECT_EQ(a.angle_between_radians(MathLbr::precision::exact, b), angle);
+
+		const auto spherical = a.to_spherical_coords();
+		const auto fast_spherical = a.to_spherical_coords(MathLbr::precision::fast);
+		for (std::size_t d = 0; d < 3; ++d) {
+			EXPECT_NEAR(fast_spherical[d], spherical[d], 2e-8 * std::abs(spherical[d]));
+		}
+
+		const double rotation_angle = distribution(engine);
+		MathLbr::vector<double, 3> rotated = a;
+		MathLbr::vector<double, 3> fast_rotated = a;
+		rotated.rotate_around_y(rotation_angle);
+		fast_rotated.rotate_around_y(MathLbr::precision::fast, rotation_angle);
+		MathLbr::vector<double, 3> back;
+		back.from_spherical(MathLbr::precision::fast, spherical[0], spherical[1], spherical[2]);
+		for (std::size_t d = 0; d < 3; ++d) {
+			EXPECT_NEAR(fast_rotated[d], rotated[d], 1e-6);
+			EXPECT_NEAR(back[d], a[d], 1e-6);
+		}
+
+		const MathLbr::vector<float, 2> c{ {static_cast<float>(distribution(engine)), static_cast<float>(distribution(engine))} };
+		const float direction = c.direction_radians_x();
+		EXPECT_NEAR(c.direction_radians_x(MathLbr::precision::fast), direction, 4 * std::numeric_limits<float>::epsilon() * std::abs(direction));
+	}
+
+	// Batches: vectorized fast kernels, with the same handling of infinities
+	MathLbr::vector_batch<float, 3> points(100);
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		points.set(i, MathLbr::vector<float, 3>{ {static_cast<float>(distribution(engine)), static_cast<float>(distribution(engine)),
+			static_cast<float>(distribution(engine))} });
+	}
+	const auto spherical = points.to_spherical_coords();
+	const auto fast_spherical = points.to_spherical_coords(MathLbr::precision::fast);
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		for (std::size_t d = 0; d < 3; ++d) {
+			EXPECT_NEAR(fast_spherical[i][d], spherical[i][d], 8 * std::numeric_limits<float>::epsilon() * std::abs(spherical[i][d]));
+		}
+	}
+	MathLbr::vector_batch<float, 3> back;
+	back.from_spherical(MathLbr::precision::fast, fast_spherical);
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		for (std::size_t d = 0; d < 3; ++d) {
+			EXPECT_NEAR(back[i][d], points[i][d], 1e-4f);
+		}
+	}
+
+	MathLbr::vector<double, 2> infinite{ {std::numeric_limits<double>::infinity(), 1.0} };
+	EXPECT_EQ(infinite.direction_radians_x(MathLbr::precision::fast), 0.0);
+}
+
+TEST(Sparse, SparseVector) {
+	// Unsorted indices, duplicates (summed) and zeros (dropped)
+	MathLbr::sparse_vector<double> a(1000, { {700, 2.0}, {10, 1.0}, {700, 1.0}, {30, 0.0} });
+	EXPECT_EQ(a.size(), 1000ULL);
+	EXPECT_EQ(a.non_zeros(), 2ULL);
+	EXPECT_EQ(a.indices(), (std::vector<std::size_t>{ 10, 700 }));
+	EXPECT_EQ(a[700], 3.0);
+	EXPECT_EQ(a[30], 0.0);
+
+	MathLbr::vector<double> dense(1000);
+	std::mt19937 engine(3);
+	std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+	for (auto& element : dense) element = distribution(engine);
+	MathLbr::sparse_vector<double> b(1000);
+	for (std::size_t i = 5; i < 1000; i += 7) b.set(i, distribution(engine));
+
+	// Same results as the dense operations
+	const auto a_dense = a.to_dense();
+	const auto b_dense = b.to_dense();
+	EXPECT_DOUBLE_EQ(MathLbr::Vector::inner_product(a, b), MathLbr::Vector::inner_product(a_dense, b_dense));
+	EXPECT_DOUBLE_EQ(MathLbr::Vector::inner_product(b, a), MathLbr::Vector::inner_product(a_dense, b_dense));
+	EXPECT_DOUBLE_EQ(MathLbr::Vector::inner_product(b, b), MathLbr::Vector::inner_product(b_dense, b_dense));
+	EXPECT_NEAR(MathLbr::Vector::inner_product(b, dense), MathLbr::Vector::inner_product(b_dense, dense), 1e-12);
+	EXPECT_NEAR(MathLbr::Vector::inner_product(dense, b), MathLbr::Vector::inner_product(b_dense, dense), 1e-12);
+	EXPECT_NEAR(b.norm(), b_dense.norm(), 1e-12);
+	EXPECT_NEAR(b.norm<MathLbr::Norm::L1>(), b_dense.norm<MathLbr::Norm::L1>(), 1e-12);
+	EXPECT_EQ(b.norm<MathLbr::Norm::L0>(), b_dense.norm<MathLbr::Norm::L0>());
+	EXPECT_EQ(b.norm<MathLbr::Norm::LINF>(), b_dense.norm<MathLbr::Norm::LINF>());
+
+	const auto sum = a + b;
+	const auto difference = a - b;
+	const auto sum_dense = dense + b;
+	for (std::size_t i = 0; i < 1000; ++i) {
+		EXPECT_EQ(sum[i], a_dense[i] + b_dense[i]);
+		EXPECT_EQ(difference[i], a_dense[i] - b_dense[i]);
+		EXPECT_EQ(sum_dense[i], dense[i] + b_dense[i]);
+	}
+	EXPECT_TRUE((a - a).is_empty());
+	EXPECT_TRUE((a * 0.0).is_empty());
+	EXPECT_EQ((2.0 * a)[10], 2.0);
+
+	const auto projected = MathLbr::Vector::projection(b, dense);
+	const auto projected_dense = MathLbr::Vector::projection(b_dense, dense);
+	for (std::size_t i = 0; i < 1000; ++i) {
+		EXPECT_NEAR(projected[i], projected_dense[i], 1e-12);
+	}
+
+	// Density thresholds
+	EXPECT_EQ(MathLbr::sparse_vector<double>(a_dense), a);
+	EXPECT_TRUE(MathLbr::Vector::to_sparse(a_dense).has_value());
+	EXPECT_FALSE(MathLbr::Vector::to_sparse(dense).has_value());
+	EXPECT_FALSE(MathLbr::Vector::to_dense(a).has_value());
+	EXPECT_TRUE(MathLbr::Vector::to_dense(b, 0.1).has_value());
+
+	// Scaled norm: the sum of squares overflows
+	MathLbr::sparse_vector<double> huge(10, { {1, 3e200}, {9, 4e200} });
+	EXPECT_DOUBLE_EQ(huge.norm(), 5e200);
+}
+
+TEST(Similarity, AllPairs) {
+	// Several tiles in both directions, rows of b repeat rows of a: parallel (scaled) and perpendicular pairs
+	const std::size_t m = 150, n = 300, k = 20;
+	MathLbr::matrix<double> a(m, k), b(n, k);
+	std::mt19937 engine(42);
+	std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+	for (auto& value : a) value = distribution(engine);
+	for (auto& value : b) value = distribution(engine);
+	for (std::size_t p = 0; p < k; ++p) {
+		b(7, p) = -2 * a(3, p);
+		b(250, p) = p == 0 ? 0.0 : a(140, p);
+	}
+	for (std::size_t p = 0; p < k; ++p) a(140, p) = p == 0 ? 1.0 : 0.0;
+	const auto row = [k](const MathLbr::matrix<double>& matrix, std::size_t i) {
+		MathLbr::vector<double> result(k);
+		for (std::size_t p = 0; p < k; ++p) result[p] = matrix(i, p);
+		return result;
+	};
+
+	const auto cosines = MathLbr::Similarity::cosine_matrix(a, b);
+	const auto angles = MathLbr::Similarity::angle_matrix(a, b);
+	EXPECT_TRUE(MathLbr::Similarity::cosine_matrix(MathLbr::execution::parallel_policy{ 4, 0, 1 }, a, b) == cosines);
+	std::vector<std::pair<std::size_t, std::size_t>> parallel, perpendicular;
+	for (std::size_t i = 0; i < m; ++i) {
+		const auto first = row(a, i);
+		for (std::size_t j = 0; j < n; ++j) {
+			const auto second = row(b, j);
+			const double cosine = MathLbr::Vector::inner_product(first, second) / (first.norm() * second.norm());
+			EXPECT_NEAR(cosines(i, j), cosine, 1e-12);
+			// Cosines rounded beyond -1 or 1 are clamped
+			EXPECT_NEAR(angles(i, j), std::abs(cosine) < 1 ? first.angle_between_radians(second) : std::acos(std::round(cosine)), 1e-7);
+			if (MathLbr::Vector::are_parallel(first, second)) parallel.emplace_back(i, j);
+			if (MathLbr::Vector::are_perpendicular(first, second)) perpendicular.emplace_back(i, j);
+		}
+	}
+	ASSERT_EQ(parallel.size(), 1);
+	EXPECT_EQ(MathLbr::Similarity::parallel_pairs(a, b), parallel);
+	EXPECT_EQ(MathLbr::Similarity::parallel_pairs(MathLbr::execution::parallel_policy{ 4, 0, 1 }, a, b), parallel);
+	EXPECT_EQ(MathLbr::Similarity::perpendicular_pairs(a, b), perpendicular);
+	EXPECT_EQ(perpendicular.front(), std::make_pair(std::size_t{ 140 }, std::size_t{ 250 }));
+	EXPECT_DOUBLE_EQ(cosines(3, 7), -1.0);
+
+	// Near duplicates among the rows of a single matrix: pairs (i, j) with i < j
+	MathLbr::matrix<double> rows(300, k);
+	for (auto& value : rows) value = distribution(engine);
+	for (std::size_t p = 0; p < k; ++p) {
+		rows(290, p) = 3 * rows(10, p);
+		rows(200, p) = rows(199, p) + 1e-9;
+	}
+	const auto duplicates = MathLbr::Similarity::similar_pairs(rows, 0.999);
+	ASSERT_EQ(duplicates.size(), 2);
+	EXPECT_EQ(duplicates[0].first, 10);
+	EXPECT_EQ(duplicates[0].second, 290);
+	EXPECT_NEAR(duplicates[0].cosine, 1.0, 1e-12);
+	EXPECT_EQ(duplicates[1].first, 199);
+	EXPECT_EQ(duplicates[1].second, 200);
+	EXPECT_EQ(MathLbr::Similarity::similar_pairs(MathLbr::execution::parallel_policy{ 4, 0, 1 }, rows, 0.999), duplicates);
+	EXPECT_EQ(MathLbr::Similarity::similar_pairs(a, b, 0.999).size(), 0);
+
+	// Every pair is visited once
+	std::size_t visited = 0;
+	MathLbr::Similarity::for_each_tile(a, b, [&](const MathLbr::Similarity::tile<double>& tile) { visited += tile.rows() * tile.cols(); });
+	EXPECT_EQ(visited, m * n);
+}
+
+TEST(Search, KnnIndex) {
+	const std::size_t count = 2000, dimension = 16, k = 10;
+	std::mt19937 engine(7);
+	std::normal_distribution<float> distribution;
+	MathLbr::matrix<float> points(count, dimension), queries(100, dimension);
+	for (auto& value : points) value = distribution(engine);
+	for (auto& value : queries) value = distribution(engine);
+	const auto row = [dimension](const MathLbr::matrix<float>& matrix, std::size_t i) {
+		MathLbr::vector<float> result(dimension);
+		for (std::size_t p = 0; p < dimension; ++p) result[p] = matrix(i, p);
+		return result;
+	};
+
+	// Exact search against a sort of all the distances
+	MathLbr::flat_index<float> flat(dimension);
+	flat.add(points);
+	ASSERT_EQ(flat.size(), count);
+	const auto query = row(queries, 0);
+	std::vector<std::pair<double, std::size_t>> expected;
+	for (std::size_t i = 0; i < count; ++i) {
+		double squared = 0;
+		for (std::size_t p = 0; p < dimension; ++p) squared += std::pow(double{ query[p] } - points(i, p), 2);
+		expected.emplace_back(squared, i);
+	}
+	std::sort(expected.begin(), expected.end());
+	const auto found = flat.search(query, k);
+	ASSERT_EQ(found.size(), k);
+	for (std::size_t i = 0; i < k; ++i) {
+		EXPECT_EQ(found[i].index, expected[i].second);
+		EXPECT_NEAR(found[i].distance, expected[i].first, 1e-4);
+	}
+	EXPECT_EQ(flat.search(MathLbr::execution::parallel_policy{ 4, 0, 128 }, query, k), found);
+
+	// Batched queries (GEMM tiles) find the same neighbours, whatever the number of threads
+	const auto batch = flat.search(queries, k);
+	EXPECT_EQ(flat.search(MathLbr::execution::parallel_policy{ 4, 0, 1 }, queries, k), batch);
+	for (std::size_t i = 0; i < queries.rows(); ++i) {
+		const auto single = flat.search(row(queries, i), k);
+		for (std::size_t j = 0; j < k; ++j) {
+			EXPECT_EQ(batch[i][j].index, single[j].index);
+			EXPECT_NEAR(batch[i][j].distance, single[j].distance, 1e-4);
+		}
+	}
+
+	MathLbr::flat_index<float> cosine(dimension, MathLbr::Metric::COSINE);
+	cosine.add(points);
+	const auto itself = cosine.search(MathLbr::vector<float>(3.0f * row(points, 42)), 1);
+	EXPECT_EQ(itself[0].index, 42);
+	EXPECT_NEAR(itself[0].distance, 0.0f, 1e-6);
+	MathLbr::flat_index<float> inner(dimension, MathLbr::Metric::INNER_PRODUCT);
+	inner.add(points);
+	EXPECT_FLOAT_EQ(inner.search(query, 1)[0].distance, -MathLbr::Vector::inner_product(query, row(points, inner.search(query, 1)[0].index)));
+
+	// Approximate search: recall of the 10 nearest neighbours
+	MathLbr::hnsw_index<float> hnsw(dimension, MathLbr::Metric::L2, { 16, 100 });
+	hnsw.add(points);
+	const auto approximate = hnsw.search(queries, k);
+	std::size_t recalled = 0;
+	for (std::size_t i = 0; i < queries.rows(); ++i) {
+		for (const auto& neighbour : approximate[i]) {
+			recalled += std::count_if(batch[i].begin(), batch[i].end(), [&](const auto& exact) { return exact.index == neighbour.index; });
+		}
+	}
+	EXPECT_GE(recalled, queries.rows() * k * 95 / 100);
+	EXPECT_EQ(hnsw.search(MathLbr::execution::parallel_policy{ 4, 0, 1 }, queries, k), approximate);
+
+	// Incremental insertion
+	const auto added = hnsw.add(row(queries, 5));
+	EXPECT_EQ(added, count);
+	EXPECT_EQ(hnsw.search(row(queries, 5), 1)[0].index, count);
+	EXPECT_EQ(MathLbr::vector<float>(hnsw[added]), row(queries, 5));
+
+	// Save and load
+	const auto path = std::filesystem::temp_directory_path() / "mathlbr_knn_index_test.bin";
+	hnsw.save(path);
+	const auto loaded = MathLbr::hnsw_index<float>::load(path);
+	EXPECT_EQ(loaded.size(), hnsw.size());
+	EXPECT_EQ(loaded.search(queries, k), hnsw.search(queries, k));
+	EXPECT_THROW(MathLbr::flat_index<float>::load(path), std::runtime_error);
+	EXPECT_THROW(MathLbr::hnsw_index<double>::load(path), std::runtime_error);
+	flat.save(path);
+	EXPECT_EQ(MathLbr::flat_index<float>::load(path).search(queries, k), batch);
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+	EXPECT_THROW(MathLbr::flat_index<float>::load(path), std::runtime_error);
+
+	// Corrupted graph parameters (after the 64 bytes header and the rows): a max_level above the level of the entry point,
+	// and an entry point in an empty index
+	const auto increment_parameter = [&path](std::size_t offset) {
+		std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+		std::uint64_t value = 0;
+		file.seekg(static_cast<std::streamoff>(offset));
+		file.read(reinterpret_cast<char*>(&value), sizeof(value));
+		++value;
+		file.seekp(static_cast<std::streamoff>(offset));
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	};
+	hnsw.save(path);
+	increment_parameter(64 + hnsw.size() * dimension * sizeof(float) + 5 * sizeof(std::uint64_t));
+	EXPECT_THROW(MathLbr::hnsw_index<float>::load(path), std::runtime_error);
+	MathLbr::hnsw_index<float>(dimension).save(path);
+	EXPECT_EQ(MathLbr::hnsw_index<float>::load(path).size(), 0);
+	increment_parameter(64 + 4 * sizeof(std::uint64_t));
+	EXPECT_THROW(MathLbr::hnsw_index<float>::load(path), std::runtime_error);
+	std::filesystem::remove(path);
+}
+
+TEST(HalfPrecision, StorageAndFloatAccumulation) {
+	// Conversions: round to nearest even, overflow to infinity, subnormals
+	EXPECT_EQ(sizeof(MathLbr::float16), 2);
+	EXPECT_EQ(MathLbr::float16(1.0f).bits(), 0x3C00);
+	EXPECT_EQ(MathLbr::float16(-2.5).bits(), 0xC100);
+	EXPECT_EQ(MathLbr::float16(1.0f + 0x1p-11f).bits(), 0x3C00);
+	EXPECT_EQ(MathLbr::float16(1.0f + 0x1.8p-11f).bits(), 0x3C01);
+	EXPECT_EQ(MathLbr::float16(65504.0f).bits(), 0x7BFF);
+	EXPECT_TRUE(std::isinf(static_cast<float>(MathLbr::float16(65520.0f))));
+	EXPECT_EQ(MathLbr::float16(0x1p-24f).bits(), 0x0001);
+	EXPECT_EQ(MathLbr::float16(0x1p-25f).bits(), 0x0000);
+	EXPECT_TRUE(std::isnan(static_cast<float>(MathLbr::float16(std::numeric_limits<float>::quiet_NaN()))));
+	for (std::uint32_t bits = 0; bits < 0x10000; ++bits) {
+		const auto value = MathLbr::float16::from_bits(static_cast<std::uint16_t>(bits));
+		if (not std::isnan(static_cast<float>(value))) {
+			EXPECT_EQ(MathLbr::float16(static_cast<float>(value)).bits(), bits);
+		}
+	}
+	EXPECT_EQ(MathLbr::bfloat16(1.0f + 0x1p-8f).bits(), 0x3F80);
+	EXPECT_EQ(MathLbr::bfloat16(1.0f + 0x1.8p-8f).bits(), 0x3F81);
+	EXPECT_EQ(MathLbr::bfloat16(3.3895e38f).bits(), std::numeric_limits<MathLbr::bfloat16>::max().bits());
+	EXPECT_TRUE(std::isinf(static_cast<float>(MathLbr::bfloat16(std::numeric_limits<float>::max()))));
+	EXPECT_EQ(static_cast<float>(std::numeric_limits<MathLbr::float16>::max()), 65504.0f);
+	EXPECT_EQ(static_cast<float>(std::numeric_limits<MathLbr::float16>::epsilon()), 0x1p-10f);
+	EXPECT_EQ(std::numeric_limits<MathLbr::bfloat16>::has_denorm, std::denorm_present);
+
+	// Doubles are rounded once: through float, 1 + 2^-11 + 2^-40 would be a tie rounded down
+	EXPECT_EQ(MathLbr::float16(1.0 + 0x1p-11 + 0x1p-40).bits(), 0x3C01);
+	EXPECT_EQ(MathLbr::float16(-(1.0 + 0x1p-11 + 0x1p-40)).bits(), 0xBC01);
+	EXPECT_EQ(MathLbr::bfloat16(1.0 + 0x1p-8 + 0x1p-30).bits(), 0x3F81);
+	EXPECT_EQ(static_cast<float>(MathLbr::bfloat16(2147483648LL + 8388608LL + 1)), 0x1p31f + 0x1p24f);
+	EXPECT_TRUE(std::isinf(static_cast<float>(MathLbr::bfloat16(1e300))));
+	EXPECT_EQ(MathLbr::float16(0x1p-25 + 0x1p-60).bits(), 0x0001);
+
+	// Sums are done in float: a float16 accumulator would stop at 2048
+	MathLbr::vector<MathLbr::float16> ones(4097);
+	std::fill(ones.begin(), ones.end(), MathLbr::float16(1.0f));
+	static_assert(std::is_same_v<decltype(MathLbr::Vector::inner_product(ones, ones)), float>);
+	EXPECT_EQ(MathLbr::Vector::inner_product(ones, ones), 4097.0f);
+	EXPECT_FLOAT_EQ(ones.norm(), std::sqrt(4097.0f));
+	EXPECT_EQ(ones.norm<MathLbr::Norm::L1>(), 4097.0f);
+	EXPECT_EQ(MathLbr::Vector::inner_product(MathLbr::execution::parallel_policy{ 4, 0, 100 }, ones, ones), 4097.0f);
+
+	// Same results as float vectors holding the same values
+	std::mt19937 generator(7);
+	std::normal_distribution<float> distribution;
+	for (const std::size_t count : { 1, 7, 33, 1000 }) {
+		MathLbr::vector<float> a(count), b(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			a[i] = MathLbr::float16(distribution(generator));
+			b[i] = MathLbr::bfloat16(distribution(generator));
+		}
+		const MathLbr::vector<MathLbr::float16> half(a);
+		const MathLbr::vector<MathLbr::bfloat16> brain(b);
+		const MathLbr::vector<float> brain_as_float(brain);
+		EXPECT_EQ(MathLbr::vector<float>(half), a);
+		EXPECT_NEAR(MathLbr::Vector::inner_product(half, half), MathLbr::Vector::inner_product(a, a), 1e-5 * count);
+		EXPECT_NEAR(MathLbr::Vector::inner_product(brain, brain), MathLbr::Vector::inner_product(brain_as_float, brain_as_float), 1e-5 * count);
+		EXPECT_NEAR(half.norm(), a.norm(), 1e-5 * a.norm());
+
+		auto normalized = half;
+		normalized.normalize();
+		const float norm = a.norm();
+		for (std::size_t i = 0; i < count; ++i) {
+			EXPECT_EQ(normalized[i].bits(), MathLbr::float16(a[i] * (1 / norm)).bits());
+		}
+		EXPECT_NEAR(normalized.norm(), 1.0f, 1e-3);
+	}
+
+	// bfloat16 has the range of float: squares overflow, the norm doesn't
+	MathLbr::vector<MathLbr::bfloat16> large(100);
+	std::fill(large.begin(), large.end(), MathLbr::bfloat16(1e30f));
+	EXPECT_NEAR(large.norm(), 1e31f, 1e29f);
+	large.normalize();
+	EXPECT_NEAR(static_cast<float>(large[0]), 0.1f, 1e-3);
+
+	// Files keep the format of the elements
+	const auto path = std::filesystem::temp_directory_path() / "mathlbr_half_test.bin";
+	MathLbr::save(path, ones);
+	{
+		const MathLbr::mapped_vector<MathLbr::float16> mapped(path);
+		EXPECT_EQ(MathLbr::Vector::inner_product(mapped.view(), mapped.view()), 4097.0f);
+		EXPECT_THROW(MathLbr::mapped_vector<MathLbr::bfloat16>{ path }, std::runtime_error);
+		EXPECT_THROW(MathLbr::mapped_vector<std::uint16_t>{ path }, std::runtime_error);
+	}
+	std::filesystem::remove(path);
+}
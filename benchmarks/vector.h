@@ -1 +1,1428 @@
-/* todo: redo benchmarks */
+#include <benchmark/benchmark.h>
+
+#include "../LinearAlgebraLatest/vector.h"
+#include "../LinearAlgebraLatest/random.h"
+#include "../LinearAlgebraLatest/vector_batch.h"
+#include "../LinearAlgebraLatest/matrix.h"
+#include "../LinearAlgebraLatest/rotation.h"
+#include "../LinearAlgebraLatest/sparse_vector.h"
+#include "../LinearAlgebraLatest/similarity.h"
+#include "../LinearAlgebraLatest/knn_index.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+/*
+	Benchmarks of the public operations of MathLbr::vector, based on Google Benchmark.
+	Every family has a "Naive" counterpart written with plain loops over std::vector (or std::array), which is the
+	baseline MathLbr must match or beat. Machine readable results:
+		./benchmarks --benchmark_out=results.json --benchmark_out_format=json
+	Dynamic sizes go from 3 to MATHLBR_BENCHMARK_MAX_SIZE elements (10^8 by default: two vectors of std::complex<double>
+	then need 3.2GB). See documentation/benchmarks.md.
+*/
+
+#ifndef MATHLBR_BENCHMARK_MAX_SIZE
+#define MATHLBR_BENCHMARK_MAX_SIZE 100'000'000
+#endif
+
+namespace bench
+{
+	// T for real types, T::value_type for std::complex
+	template<typename T>
+	struct real_type
+	{
+		using type = T;
+	};
+
+	template<typename T>
+	struct real_type<std::complex<T>>
+	{
+		using type = T;
+	};
+
+	template<typename T>
+	using real_t = typename real_type<T>::type;
+
+	// Deterministic values in [1, 2.5], never zero so that divisions and normalizations are always valid
+	template<typename T>
+	T element(std::size_t index)
+	{
+		const auto x = static_cast<real_t<T>>(1.0 + static_cast<double>(index % 7) * 0.25);
+		if constexpr (concepts::is_complex<T>::value)
+		{
+			return T(x, static_cast<real_t<T>>(3.5) - x);
+		}
+		else return x;
+	}
+
+	template<typename T>
+	std::vector<T> make_std(std::size_t count, std::size_t offset = 0)
+	{
+		std::vector<T> result(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			result[i] = element<T>(i + offset);
+		}
+		return result;
+	}
+
+	template<typename T, std::size_t Size = MathLbr::dynamic_extent>
+	MathLbr::vector<T, Size> make(std::size_t count, std::size_t offset = 0)
+	{
+		const auto values = make_std<T>(count, offset);
+		if constexpr (Size == MathLbr::dynamic_extent)
+		{
+			return MathLbr::vector<T, Size>(values.begin(), values.end());
+		}
+		else
+		{
+			MathLbr::vector<T, Size> result{};
+			std::copy(values.begin(), values.end(), result.begin());
+			return result;
+		}
+	}
+
+	inline void dynamic_sizes(benchmark::internal::Benchmark* benchmark)
+	{
+		for (const std::int64_t size : { 3, 100, 10'000, 1'000'000, 100'000'000 })
+		{
+			if (size <= MATHLBR_BENCHMARK_MAX_SIZE) benchmark->Arg(size);
+		}
+	}
+
+	template<typename T>
+	void set_processed(benchmark::State& state, std::size_t count, std::size_t vectors_read)
+	{
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+		state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * count * sizeof(T) * vectors_read));
+	}
+}
+
+
+// Constructors
+template<typename T>
+void BM_ConstructCount(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	for (auto _ : state)
+	{
+		MathLbr::vector<T> v(count);
+		benchmark::DoNotOptimize(v.data());
+	}
+	bench::set_processed<T>(state, count, 0);
+}
+
+template<typename T>
+void BM_ConstructIterators(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto source = bench::make_std<T>(count);
+	for (auto _ : state)
+	{
+		MathLbr::vector<T> v(source.begin(), source.end());
+		benchmark::DoNotOptimize(v.data());
+	}
+	bench::set_processed<T>(state, count, 1);
+}
+
+template<typename T>
+void BM_ConstructIteratorsNaive(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto source = bench::make_std<T>(count);
+	for (auto _ : state)
+	{
+		std::vector<T> v(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			v[i] = source[i];
+		}
+		benchmark::DoNotOptimize(v.data());
+	}
+	bench::set_processed<T>(state, count, 1);
+}
+
+template<typename T>
+void BM_ConstructRandom(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	using R = bench::real_t<T>;
+	for (auto _ : state)
+	{
+		MathLbr::vector<T> v(R(-1), R(1), count);
+		benchmark::DoNotOptimize(v.data());
+	}
+	bench::set_processed<T>(state, count, 0);
+}
+
+template<typename T, std::size_t Size>
+void BM_FixedConstructRandom(benchmark::State& state)
+{
+	using R = bench::real_t<T>;
+	for (auto _ : state)
+	{
+		MathLbr::vector<T, Size> v(R(-1), R(1));
+		benchmark::DoNotOptimize(v.data());
+	}
+	bench::set_processed<T>(state, Size, 0);
+}
+
+template<typename T>
+void BM_FillRandom(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	using R = bench::real_t<T>;
+	MathLbr::vector<T> v(count);
+	std::uint64_t seed = 0;
+	for (auto _ : state)
+	{
+		MathLbr::random::fill(v, MathLbr::random::uniform_distribution<T>{ R(-1), R(1) }, ++seed);
+		benchmark::DoNotOptimize(v.data());
+	}
+	bench::set_processed<T>(state, count, 0);
+}
+
+template<typename T>
+void BM_FillRandomNormal(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	MathLbr::vector<T> v(count);
+	std::uint64_t seed = 0;
+	for (auto _ : state)
+	{
+		MathLbr::random::fill(v, MathLbr::random::normal_distribution<T>{}, ++seed);
+		benchmark::DoNotOptimize(v.data());
+	}
+	bench::set_processed<T>(state, count, 0);
+}
+
+template<typename T>
+void BM_FillRandomNormalNaive(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	std::vector<T> v(count);
+	std::mt19937_64 engine(0);
+	std::normal_distribution<T> normal;
+	for (auto _ : state)
+	{
+		for (auto& x : v) x = normal(engine);
+		benchmark::DoNotOptimize(v.data());
+	}
+	bench::set_processed<T>(state, count, 0);
+}
+
+template<typename T>
+void BM_FixedConstructArray(benchmark::State& state)
+{
+	T x = bench::element<T>(1);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(x);
+		MathLbr::vector<T, 3> v{ {x, x, x} };
+		benchmark::DoNotOptimize(v.data());
+	}
+	bench::set_processed<T>(state, 3, 0);
+}
+
+BENCHMARK_TEMPLATE(BM_ConstructCount, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_ConstructIterators, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_ConstructIteratorsNaive, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_ConstructRandom, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_ConstructRandom, std::complex<double>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_FixedConstructRandom, double, 3);
+BENCHMARK_TEMPLATE(BM_FixedConstructRandom, std::complex<double>, 3);
+BENCHMARK_TEMPLATE(BM_FillRandom, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_FillRandom, std::complex<double>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_FillRandomNormal, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_FillRandomNormalNaive, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_FixedConstructArray, double);
+BENCHMARK_TEMPLATE(BM_FixedConstructArray, std::complex<double>);
+
+
+// Arithmetic operators
+template<typename T>
+void BM_Add(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make<T>(count);
+	const auto b = bench::make<T>(count, 3);
+	MathLbr::vector<T> c(count);
+	for (auto _ : state)
+	{
+		c = a + b;
+		benchmark::DoNotOptimize(c.data());
+		benchmark::ClobberMemory();
+	}
+	bench::set_processed<T>(state, count, 2);
+}
+
+template<typename T>
+void BM_AddNaive(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make_std<T>(count);
+	const auto b = bench::make_std<T>(count, 3);
+	std::vector<T> c(count);
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			c[i] = a[i] + b[i];
+		}
+		benchmark::DoNotOptimize(c.data());
+		benchmark::ClobberMemory();
+	}
+	bench::set_processed<T>(state, count, 2);
+}
+
+// Fused lazy expression: a single pass, no temporaries
+template<typename T>
+void BM_Expression(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make<T>(count);
+	const auto b = bench::make<T>(count, 3);
+	const auto c = bench::make<T>(count, 5);
+	MathLbr::vector<T> d(count);
+	for (auto _ : state)
+	{
+		d = a + b * T(2) - c / T(4);
+		benchmark::DoNotOptimize(d.data());
+		benchmark::ClobberMemory();
+	}
+	bench::set_processed<T>(state, count, 3);
+}
+
+template<typename T>
+void BM_ExpressionNaive(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make_std<T>(count);
+	const auto b = bench::make_std<T>(count, 3);
+	const auto c = bench::make_std<T>(count, 5);
+	std::vector<T> d(count);
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			d[i] = a[i] + b[i] * T(2) - c[i] / T(4);
+		}
+		benchmark::DoNotOptimize(d.data());
+		benchmark::ClobberMemory();
+	}
+	bench::set_processed<T>(state, count, 3);
+}
+
+template<typename T>
+void BM_CompoundAssign(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	auto a = bench::make<T>(count);
+	const auto b = bench::make<T>(count, 3);
+	for (auto _ : state)
+	{
+		a += b;
+		a -= b;
+		a *= T(1);
+		benchmark::DoNotOptimize(a.data());
+		benchmark::ClobberMemory();
+	}
+	bench::set_processed<T>(state, count, 2);
+}
+
+template<typename T>
+void BM_CompoundAssignNaive(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	auto a = bench::make_std<T>(count);
+	const auto b = bench::make_std<T>(count, 3);
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < count; ++i) a[i] += b[i];
+		for (std::size_t i = 0; i < count; ++i) a[i] -= b[i];
+		for (std::size_t i = 0; i < count; ++i) a[i] *= T(1);
+		benchmark::DoNotOptimize(a.data());
+		benchmark::ClobberMemory();
+	}
+	bench::set_processed<T>(state, count, 2);
+}
+
+template<typename T, std::size_t Size>
+void BM_FixedExpression(benchmark::State& state)
+{
+	auto a = bench::make<T, Size>(Size);
+	const auto b = bench::make<T, Size>(Size, 3);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a);
+		MathLbr::vector<T, Size> c = a + b * T(2) - a / T(4);
+		benchmark::DoNotOptimize(c);
+	}
+	bench::set_processed<T>(state, Size, 2);
+}
+
+BENCHMARK_TEMPLATE(BM_Add, float)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_AddNaive, float)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Add, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_AddNaive, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Add, std::complex<double>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_AddNaive, std::complex<double>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Expression, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_ExpressionNaive, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Expression, std::complex<double>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_ExpressionNaive, std::complex<double>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_CompoundAssign, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_CompoundAssignNaive, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_FixedExpression, double, 3);
+BENCHMARK_TEMPLATE(BM_FixedExpression, double, 4);
+BENCHMARK_TEMPLATE(BM_FixedExpression, double, 1024);
+BENCHMARK_TEMPLATE(BM_FixedExpression, std::complex<double>, 3);
+
+
+// Products
+template<typename T>
+void BM_InnerProduct(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make<T>(count);
+	const auto b = bench::make<T>(count, 3);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(MathLbr::Vector::inner_product(a, b));
+	}
+	bench::set_processed<T>(state, count, 2);
+}
+
+template<typename T>
+void BM_InnerProductNaive(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make_std<T>(count);
+	const auto b = bench::make_std<T>(count, 3);
+	for (auto _ : state)
+	{
+		T sum{};
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			if constexpr (concepts::is_complex<T>::value) sum += std::conj(a[i]) * b[i];
+			else sum += a[i] * b[i];
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	bench::set_processed<T>(state, count, 2);
+}
+
+template<typename T, typename Summation>
+void BM_InnerProductSummation(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make<T>(count);
+	const auto b = bench::make<T>(count, 3);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(MathLbr::Vector::inner_product(Summation{}, a, b));
+	}
+	bench::set_processed<T>(state, count, 2);
+}
+
+template<typename T, std::size_t Size>
+void BM_FixedInnerProduct(benchmark::State& state)
+{
+	auto a = bench::make<T, Size>(Size);
+	const auto b = bench::make<T, Size>(Size, 3);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a);
+		benchmark::DoNotOptimize(MathLbr::Vector::inner_product(a, b));
+	}
+	bench::set_processed<T>(state, Size, 2);
+}
+
+// 3D products: fixed (std::array) and dynamic (std::vector) extents
+template<typename T, std::size_t Size>
+void BM_CrossProduct(benchmark::State& state)
+{
+	auto a = bench::make<T, Size>(3);
+	const auto b = bench::make<T, Size>(3, 3);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a);
+		auto c = MathLbr::Vector::cross_product(a, b);
+		benchmark::DoNotOptimize(c);
+	}
+	bench::set_processed<T>(state, 3, 2);
+}
+
+template<typename T>
+void BM_CrossProductNaive(benchmark::State& state)
+{
+	std::array<T, 3> a{ bench::element<T>(0), bench::element<T>(1), bench::element<T>(2) };
+	const std::array<T, 3> b{ bench::element<T>(3), bench::element<T>(4), bench::element<T>(5) };
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a);
+		const std::array<T, 3> c{ a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+		benchmark::DoNotOptimize(c);
+	}
+	bench::set_processed<T>(state, 3, 2);
+}
+
+template<typename T, std::size_t Size>
+void BM_ScalarTripleProduct(benchmark::State& state)
+{
+	auto a = bench::make<T, Size>(3);
+	const auto b = bench::make<T, Size>(3, 3);
+	const auto c = bench::make<T, Size>(3, 1);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a);
+		benchmark::DoNotOptimize(MathLbr::Vector::scalar_triple_product(a, b, c));
+	}
+	bench::set_processed<T>(state, 3, 3);
+}
+
+template<typename T, std::size_t Size>
+void BM_VectorTripleProduct(benchmark::State& state)
+{
+	auto a = bench::make<T, Size>(3);
+	const auto b = bench::make<T, Size>(3, 3);
+	const auto c = bench::make<T, Size>(3, 1);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a);
+		auto d = MathLbr::Vector::vector_triple_product(a, b, c);
+		benchmark::DoNotOptimize(d);
+	}
+	bench::set_processed<T>(state, 3, 3);
+}
+
+BENCHMARK_TEMPLATE(BM_InnerProduct, float)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_InnerProductNaive, float)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_InnerProduct, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_InnerProductNaive, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_InnerProduct, MathLbr::float16)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_InnerProduct, MathLbr::bfloat16)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_InnerProduct, std::complex<float>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_InnerProductNaive, std::complex<float>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_InnerProduct, std::complex<double>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_InnerProductNaive, std::complex<double>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_InnerProductSummation, float, MathLbr::summation::pairwise_policy)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_InnerProductSummation, float, MathLbr::summation::kahan_policy)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_InnerProductSummation, float, MathLbr::summation::neumaier_policy)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_FixedInnerProduct, double, 3);
+BENCHMARK_TEMPLATE(BM_FixedInnerProduct, double, 4);
+BENCHMARK_TEMPLATE(BM_FixedInnerProduct, float, 3);
+BENCHMARK_TEMPLATE(BM_FixedInnerProduct, float, 4);
+BENCHMARK_TEMPLATE(BM_FixedInnerProduct, double, 1024);
+BENCHMARK_TEMPLATE(BM_FixedInnerProduct, std::complex<double>, 3);
+BENCHMARK_TEMPLATE(BM_CrossProduct, double, 3);
+BENCHMARK_TEMPLATE(BM_CrossProduct, double, MathLbr::dynamic_extent);
+BENCHMARK_TEMPLATE(BM_CrossProduct, std::complex<double>, 3);
+BENCHMARK_TEMPLATE(BM_CrossProductNaive, double);
+BENCHMARK_TEMPLATE(BM_ScalarTripleProduct, double, 3);
+BENCHMARK_TEMPLATE(BM_ScalarTripleProduct, double, MathLbr::dynamic_extent);
+BENCHMARK_TEMPLATE(BM_ScalarTripleProduct, std::complex<double>, 3);
+BENCHMARK_TEMPLATE(BM_VectorTripleProduct, double, 3);
+BENCHMARK_TEMPLATE(BM_VectorTripleProduct, double, MathLbr::dynamic_extent);
+
+
+// Norms
+template<typename T, MathLbr::Norm Norm>
+void BM_Norm(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make<T>(count);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a.template norm<Norm>());
+	}
+	bench::set_processed<T>(state, count, 1);
+}
+
+template<typename T, MathLbr::Norm Norm, typename Summation>
+void BM_NormSummation(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make<T>(count);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a.template norm<Norm>(Summation{}));
+	}
+	bench::set_processed<T>(state, count, 1);
+}
+
+template<typename T>
+void BM_NormL2Naive(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make_std<T>(count);
+	for (auto _ : state)
+	{
+		bench::real_t<T> sum{};
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			sum += std::norm(a[i]);
+		}
+		benchmark::DoNotOptimize(std::sqrt(sum));
+	}
+	bench::set_processed<T>(state, count, 1);
+}
+
+template<typename T, std::size_t P>
+void BM_PNorm(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make<T>(count);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a.template p_norm<P>());
+	}
+	bench::set_processed<T>(state, count, 1);
+}
+
+template<typename T, std::size_t Size>
+void BM_FixedNormL2(benchmark::State& state)
+{
+	auto a = bench::make<T, Size>(Size);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a);
+		benchmark::DoNotOptimize(a.norm());
+	}
+	bench::set_processed<T>(state, Size, 1);
+}
+
+BENCHMARK_TEMPLATE(BM_Norm, double, MathLbr::Norm::L0)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Norm, double, MathLbr::Norm::L1)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Norm, double, MathLbr::Norm::L2)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Norm, double, MathLbr::Norm::LINF)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_NormL2Naive, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Norm, float, MathLbr::Norm::L2)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_NormL2Naive, float)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Norm, MathLbr::float16, MathLbr::Norm::L2)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Norm, MathLbr::bfloat16, MathLbr::Norm::L2)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Norm, float, MathLbr::Norm::L1)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_NormSummation, float, MathLbr::Norm::L1, MathLbr::summation::pairwise_policy)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_NormSummation, float, MathLbr::Norm::L1, MathLbr::summation::kahan_policy)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_NormSummation, float, MathLbr::Norm::L1, MathLbr::summation::neumaier_policy)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_NormSummation, float, MathLbr::Norm::L2, MathLbr::summation::kahan_policy)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Norm, std::complex<double>, MathLbr::Norm::L0)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Norm, std::complex<double>, MathLbr::Norm::L1)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Norm, std::complex<double>, MathLbr::Norm::L2)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_NormL2Naive, std::complex<double>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_PNorm, double, 3)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_PNorm, std::complex<double>, 3)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_FixedNormL2, double, 3);
+BENCHMARK_TEMPLATE(BM_FixedNormL2, double, 4);
+BENCHMARK_TEMPLATE(BM_FixedNormL2, float, 3);
+BENCHMARK_TEMPLATE(BM_FixedNormL2, double, 1024);
+BENCHMARK_TEMPLATE(BM_FixedNormL2, std::complex<double>, 3);
+
+
+// Normalization and projections
+template<typename T>
+void BM_Normalize(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	auto a = bench::make<T>(count);
+	for (auto _ : state)
+	{
+		a.normalize();
+		benchmark::DoNotOptimize(a.data());
+		benchmark::ClobberMemory();
+	}
+	bench::set_processed<T>(state, count, 1);
+}
+
+template<typename T>
+void BM_NormalizeNaive(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	auto a = bench::make_std<T>(count);
+	for (auto _ : state)
+	{
+		bench::real_t<T> sum{};
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			sum += std::norm(a[i]);
+		}
+		const auto inverse = 1 / std::sqrt(sum);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			a[i] *= inverse;
+		}
+		benchmark::DoNotOptimize(a.data());
+		benchmark::ClobberMemory();
+	}
+	bench::set_processed<T>(state, count, 1);
+}
+
+template<typename T, std::size_t Size>
+void BM_NormalizeCopy(benchmark::State& state)
+{
+	auto a = bench::make<T, Size>(3);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a);
+		auto b = MathLbr::Vector::normalize(a);
+		benchmark::DoNotOptimize(b);
+	}
+	bench::set_processed<T>(state, 3, 1);
+}
+
+// Normalizes `count` vectors of dimension Dim stored in a vector_batch
+template<typename T, std::size_t Dim>
+void BM_BatchNormalize(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	MathLbr::vector_batch<T, Dim> batch(count);
+	for (std::size_t d = 0; d < Dim; ++d)
+	{
+		std::fill_n(batch.component(d), count, bench::element<T>(d));
+	}
+	for (auto _ : state)
+	{
+		batch.normalize();
+		benchmark::DoNotOptimize(batch.component(0));
+		benchmark::ClobberMemory();
+	}
+	bench::set_processed<T>(state, count * Dim, 1);
+}
+
+template<typename T>
+void BM_Projection(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make<T>(count);
+	const auto b = bench::make<T>(count, 3);
+	for (auto _ : state)
+	{
+		auto c = MathLbr::Vector::projection(a, b);
+		benchmark::DoNotOptimize(c.data());
+	}
+	bench::set_processed<T>(state, count, 2);
+}
+
+template<typename T, std::size_t Size>
+void BM_FixedProjection(benchmark::State& state)
+{
+	auto a = bench::make<T, Size>(Size);
+	const auto b = bench::make<T, Size>(Size, 3);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a);
+		auto c = MathLbr::Vector::projection(a, b);
+		benchmark::DoNotOptimize(c);
+	}
+	bench::set_processed<T>(state, Size, 2);
+}
+
+BENCHMARK_TEMPLATE(BM_Normalize, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_NormalizeNaive, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Normalize, float)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Normalize, MathLbr::float16)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Normalize, MathLbr::bfloat16)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Normalize, std::complex<double>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_NormalizeNaive, std::complex<double>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_BatchNormalize, double, 3)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_NormalizeCopy, double, 3);
+BENCHMARK_TEMPLATE(BM_NormalizeCopy, double, MathLbr::dynamic_extent);
+BENCHMARK_TEMPLATE(BM_NormalizeCopy, float, 3);
+BENCHMARK_TEMPLATE(BM_Projection, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_Projection, std::complex<double>)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_FixedProjection, double, 3);
+BENCHMARK_TEMPLATE(BM_FixedProjection, std::complex<double>, 3);
+
+
+// Coordinate conversions and rotations (2D/3D only, real types only)
+template<typename T>
+void BM_ToPolar(benchmark::State& state)
+{
+	auto a = bench::make<T>(2);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a);
+		auto polar = a.to_polar_coords();
+		benchmark::DoNotOptimize(polar);
+	}
+}
+
+template<typename T, std::size_t Size>
+void BM_ToSpherical(benchmark::State& state)
+{
+	auto a = bench::make<T, Size>(3);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a);
+		auto spherical = a.to_spherical_coords();
+		benchmark::DoNotOptimize(spherical);
+	}
+}
+
+template<typename T, std::size_t Size>
+void BM_ToCylindrical(benchmark::State& state)
+{
+	auto a = bench::make<T, Size>(3);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a);
+		auto cylindrical = a.to_cylindrical_coords();
+		benchmark::DoNotOptimize(cylindrical);
+	}
+}
+
+template<typename T, std::size_t Size>
+void BM_FromSpherical(benchmark::State& state)
+{
+	auto a = bench::make<T, Size>(3);
+	T radius = 2, beta = T(0.5), theta = T(0.25);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(radius);
+		benchmark::DoNotOptimize(theta);
+		a.from_spherical(radius, beta, theta);
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+template<typename T, std::size_t Size>
+void BM_FromCylindrical(benchmark::State& state)
+{
+	auto a = bench::make<T, Size>(3);
+	T magnitude = 2, angle = T(0.5), z = 1;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(magnitude);
+		benchmark::DoNotOptimize(angle);
+		a.from_cylindrical(magnitude, angle, z);
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+template<typename T>
+void BM_FromPolar(benchmark::State& state)
+{
+	auto a = bench::make<T>(2);
+	T radius = 2, angle = T(0.5);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(radius);
+		benchmark::DoNotOptimize(angle);
+		a.from_polar(radius, angle);
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+template<typename T, std::size_t Size>
+void BM_Rotate(benchmark::State& state)
+{
+	auto a = bench::make<T, Size>(3);
+	T angle = T(0.01);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(angle);
+		a.rotate_around_x(angle);
+		a.rotate_around_y(angle);
+		a.rotate_around_z(angle);
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+template<typename T>
+void BM_RotateNaive(benchmark::State& state)
+{
+	std::array<T, 3> a{ bench::element<T>(0), bench::element<T>(1), bench::element<T>(2) };
+	T angle = T(0.01);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(angle);
+		const T cos = std::cos(angle), sin = std::sin(angle);
+		a = { a[0], a[1] * cos - a[2] * sin, a[1] * sin + a[2] * cos };
+		a = { a[0] * cos + a[2] * sin, a[1], -a[0] * sin + a[2] * cos };
+		a = { a[0] * cos - a[1] * sin, a[0] * sin + a[1] * cos, a[2] };
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+BENCHMARK_TEMPLATE(BM_ToPolar, double);
+BENCHMARK_TEMPLATE(BM_FromPolar, double);
+BENCHMARK_TEMPLATE(BM_ToSpherical, double, 3);
+BENCHMARK_TEMPLATE(BM_ToSpherical, double, MathLbr::dynamic_extent);
+BENCHMARK_TEMPLATE(BM_ToCylindrical, double, 3);
+BENCHMARK_TEMPLATE(BM_ToCylindrical, double, MathLbr::dynamic_extent);
+BENCHMARK_TEMPLATE(BM_FromSpherical, double, 3);
+BENCHMARK_TEMPLATE(BM_FromCylindrical, double, 3);
+BENCHMARK_TEMPLATE(BM_Rotate, float, 3);
+BENCHMARK_TEMPLATE(BM_Rotate, double, 3);
+BENCHMARK_TEMPLATE(BM_Rotate, double, MathLbr::dynamic_extent);
+// Point clouds: `count` points rotated around x, y and z, per point with rotate_around_* or with a precomputed rotation
+template<typename T>
+void BM_RotatePoints(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	std::vector<MathLbr::vector<T, 3>> points(count, bench::make<T, 3>(3));
+	T angle = T(0.01);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(angle);
+		for (auto& point : points)
+		{
+			point.rotate_around_x(angle);
+			point.rotate_around_y(angle);
+			point.rotate_around_z(angle);
+		}
+		benchmark::DoNotOptimize(points.data());
+	}
+	bench::set_processed<T>(state, count * 3, 1);
+}
+
+template<typename T>
+void BM_RotationPoints(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	std::vector<MathLbr::vector<T, 3>> points(count, bench::make<T, 3>(3));
+	T angle = T(0.01);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(angle);
+		const auto rotation = MathLbr::rotation<T>::around_z(angle) * MathLbr::rotation<T>::around_y(angle) * MathLbr::rotation<T>::around_x(angle);
+		rotation.rotate(points.begin(), points.end());
+		benchmark::DoNotOptimize(points.data());
+	}
+	bench::set_processed<T>(state, count * 3, 1);
+}
+
+template<typename T>
+void BM_RotationBatch(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	MathLbr::vector_batch<T, 3> batch(count);
+	for (std::size_t d = 0; d < 3; ++d)
+	{
+		std::fill_n(batch.component(d), count, bench::element<T>(d));
+	}
+	T angle = T(0.01);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(angle);
+		const auto rotation = MathLbr::quaternion<T>::around_z(angle) * MathLbr::quaternion<T>::around_y(angle) * MathLbr::quaternion<T>::around_x(angle);
+		rotation.rotate(batch);
+		benchmark::DoNotOptimize(batch.component(0));
+		benchmark::ClobberMemory();
+	}
+	bench::set_processed<T>(state, count * 3, 1);
+}
+
+// Point clouds converted between cartesian and spherical coordinates: per point, or a whole vector_batch at once
+template<typename T>
+MathLbr::vector_batch<T, 3> make_point_cloud(std::size_t count)
+{
+	MathLbr::vector_batch<T, 3> batch(count);
+	for (std::size_t d = 0; d < 3; ++d)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			batch.component(d)[i] = bench::element<T>(d) + static_cast<T>(i % 1000) / 100 - T(4.995);
+		}
+	}
+	return batch;
+}
+
+template<typename T, typename Precision = MathLbr::precision::exact_policy>
+void BM_SphericalPoints(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto points = make_point_cloud<T>(count).to_vectors();
+	std::vector<decltype(points[0].to_spherical_coords())> converted(count);
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			converted[i] = points[i].to_spherical_coords(Precision{});
+		}
+		benchmark::DoNotOptimize(converted.data());
+		benchmark::ClobberMemory();
+	}
+	bench::set_processed<T>(state, count * 3, 1);
+}
+
+template<typename T, typename Precision = MathLbr::precision::exact_policy>
+void BM_SphericalBatch(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto points = make_point_cloud<T>(count);
+	MathLbr::vector_batch<T, 3> converted;
+	for (auto _ : state)
+	{
+		points.to_spherical_coords(Precision{}, converted);
+		benchmark::DoNotOptimize(converted.component(0));
+		benchmark::ClobberMemory();
+	}
+	bench::set_processed<T>(state, count * 3, 1);
+}
+
+template<typename T, typename Precision = MathLbr::precision::exact_policy>
+void BM_FromSphericalBatch(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto spherical = make_point_cloud<T>(count).to_spherical_coords();
+	MathLbr::vector_batch<T, 3> converted;
+	for (auto _ : state)
+	{
+		converted.from_spherical(Precision{}, spherical);
+		benchmark::DoNotOptimize(converted.component(0));
+		benchmark::ClobberMemory();
+	}
+	bench::set_processed<T>(state, count * 3, 1);
+}
+
+BENCHMARK_TEMPLATE(BM_RotateNaive, double);
+BENCHMARK_TEMPLATE(BM_RotatePoints, float)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_RotationPoints, float)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_RotationBatch, float)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_RotatePoints, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_RotationPoints, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_RotationBatch, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_SphericalPoints, float)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_SphericalBatch, float)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_FromSphericalBatch, float)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_SphericalPoints, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_SphericalBatch, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_FromSphericalBatch, double)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_SphericalPoints, float, MathLbr::precision::fast_policy)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_SphericalBatch, float, MathLbr::precision::fast_policy)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_FromSphericalBatch, float, MathLbr::precision::fast_policy)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_SphericalPoints, double, MathLbr::precision::fast_policy)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_SphericalBatch, double, MathLbr::precision::fast_policy)->Apply(bench::dynamic_sizes);
+BENCHMARK_TEMPLATE(BM_FromSphericalBatch, double, MathLbr::precision::fast_policy)->Apply(bench::dynamic_sizes);
+
+
+// Matrix products: n x n matrices, items are floating point operations (2 * n^3 per product)
+namespace bench
+{
+	inline void matrix_sizes(benchmark::internal::Benchmark* benchmark)
+	{
+		for (const std::int64_t size : { 4, 64, 256, 1024 })
+		{
+			benchmark->Arg(size);
+		}
+	}
+
+	template<typename T, MathLbr::Layout Order = MathLbr::Layout::ROW_MAJOR>
+	MathLbr::matrix<T, MathLbr::dynamic_extent, MathLbr::dynamic_extent, Order> make_matrix(std::size_t size, std::size_t offset = 0)
+	{
+		MathLbr::matrix<T, MathLbr::dynamic_extent, MathLbr::dynamic_extent, Order> result(size, size);
+		std::size_t index = offset;
+		for (auto& value : result)
+		{
+			value = element<T>(index++);
+		}
+		return result;
+	}
+
+	inline void set_flops(benchmark::State& state, std::size_t size)
+	{
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * 2 * size * size * size));
+	}
+}
+
+template<typename T, MathLbr::Layout Order>
+void BM_Gemm(benchmark::State& state)
+{
+	const auto size = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make_matrix<T, Order>(size);
+	const auto b = bench::make_matrix<T, Order>(size, 3);
+	for (auto _ : state)
+	{
+		auto c = a * b;
+		benchmark::DoNotOptimize(c.data());
+	}
+	bench::set_flops(state, size);
+}
+
+template<typename T>
+void BM_GemmParallel(benchmark::State& state)
+{
+	const auto size = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make_matrix<T>(size);
+	const auto b = bench::make_matrix<T>(size, 3);
+	for (auto _ : state)
+	{
+		auto c = MathLbr::Matrix::multiply(MathLbr::execution::par, a, b);
+		benchmark::DoNotOptimize(c.data());
+	}
+	bench::set_flops(state, size);
+}
+
+template<typename T, std::size_t Size>
+void BM_FixedGemm(benchmark::State& state)
+{
+	MathLbr::matrix<T, Size, Size> a{}, b{};
+	for (std::size_t i = 0; i < Size * Size; ++i)
+	{
+		a.data()[i] = bench::element<T>(i);
+		b.data()[i] = bench::element<T>(i + 3);
+	}
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(a);
+		auto c = a * b;
+		benchmark::DoNotOptimize(c);
+	}
+	bench::set_flops(state, Size);
+}
+
+// Row-major std::vector, i-k-j loop order (the cache friendly naive order)
+template<typename T>
+void BM_GemmNaive(benchmark::State& state)
+{
+	const auto size = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make_std<T>(size * size);
+	const auto b = bench::make_std<T>(size * size, 3);
+	for (auto _ : state)
+	{
+		std::vector<T> c(size * size);
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			for (std::size_t k = 0; k < size; ++k)
+			{
+				const T value = a[i * size + k];
+				for (std::size_t j = 0; j < size; ++j)
+				{
+					c[i * size + j] += value * b[k * size + j];
+				}
+			}
+		}
+		benchmark::DoNotOptimize(c.data());
+	}
+	bench::set_flops(state, size);
+}
+
+BENCHMARK_TEMPLATE(BM_Gemm, float, MathLbr::Layout::ROW_MAJOR)->Apply(bench::matrix_sizes);
+BENCHMARK_TEMPLATE(BM_Gemm, double, MathLbr::Layout::ROW_MAJOR)->Apply(bench::matrix_sizes);
+BENCHMARK_TEMPLATE(BM_Gemm, double, MathLbr::Layout::COLUMN_MAJOR)->Apply(bench::matrix_sizes);
+BENCHMARK_TEMPLATE(BM_GemmParallel, double)->Apply(bench::matrix_sizes);
+BENCHMARK_TEMPLATE(BM_GemmNaive, float)->Apply(bench::matrix_sizes);
+BENCHMARK_TEMPLATE(BM_GemmNaive, double)->Apply(bench::matrix_sizes);
+BENCHMARK_TEMPLATE(BM_FixedGemm, double, 4);
+
+
+// Matrix-vector products: n x n matrices, items are floating point operations (2 * n^2 per product)
+namespace bench
+{
+	inline void gemv_sizes(benchmark::internal::Benchmark* benchmark)
+	{
+		for (const std::int64_t size : { 4, 64, 256, 1024, 4096 })
+		{
+			benchmark->Arg(size);
+		}
+	}
+}
+
+template<typename T, MathLbr::Layout Order, bool Transposed>
+void BM_Gemv(benchmark::State& state)
+{
+	const auto size = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make_matrix<T, Order>(size);
+	const auto x = bench::make<T>(size);
+	auto y = bench::make<T>(size, 3);
+	for (auto _ : state)
+	{
+		if constexpr (Transposed) MathLbr::Matrix::gemv_transposed(T{ 1 }, a, x, T{}, y);
+		else MathLbr::Matrix::gemv(T{ 1 }, a, x, T{}, y);
+		benchmark::DoNotOptimize(y.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * 2 * size * size));
+}
+
+template<typename T>
+void BM_GemvParallel(benchmark::State& state)
+{
+	const auto size = static_cast<std::size_t>(state.range(0));
+	const auto a = bench::make_matrix<T>(size);
+	const auto x = bench::make<T>(size);
+	auto y = bench::make<T>(size, 3);
+	for (auto _ : state)
+	{
+		MathLbr::Matrix::gemv(MathLbr::execution::par, T{ 1 }, a, x, T{}, y);
+		benchmark::DoNotOptimize(y.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * 2 * size * size));
+}
+
+// One Vector::inner_product per row of a std::vector of rows
+template<typename T>
+void BM_GemvNaive(benchmark::State& state)
+{
+	const auto size = static_cast<std::size_t>(state.range(0));
+	std::vector<MathLbr::vector<T>> rows;
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		rows.push_back(bench::make<T>(size, i * size));
+	}
+	const auto x = bench::make<T>(size);
+	std::vector<T> y(size);
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			y[i] = MathLbr::Vector::inner_product(rows[i], x);
+		}
+		benchmark::DoNotOptimize(y.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * 2 * size * size));
+}
+
+BENCHMARK_TEMPLATE(BM_Gemv, float, MathLbr::Layout::ROW_MAJOR, false)->Apply(bench::gemv_sizes);
+BENCHMARK_TEMPLATE(BM_Gemv, double, MathLbr::Layout::ROW_MAJOR, false)->Apply(bench::gemv_sizes);
+BENCHMARK_TEMPLATE(BM_Gemv, double, MathLbr::Layout::COLUMN_MAJOR, false)->Apply(bench::gemv_sizes);
+BENCHMARK_TEMPLATE(BM_Gemv, double, MathLbr::Layout::ROW_MAJOR, true)->Apply(bench::gemv_sizes);
+BENCHMARK_TEMPLATE(BM_GemvParallel, double)->Apply(bench::gemv_sizes);
+BENCHMARK_TEMPLATE(BM_GemvNaive, float)->Apply(bench::gemv_sizes);
+BENCHMARK_TEMPLATE(BM_GemvNaive, double)->Apply(bench::gemv_sizes);
+
+
+// Sparse vectors: 10^6 dimensions, state.range(0) non-zeros (feature vectors). Items are non-zero elements of the first vector
+namespace bench
+{
+	inline constexpr std::size_t sparse_dimension = 1'000'000;
+
+	template<typename T>
+	MathLbr::sparse_vector<T> make_sparse(std::size_t non_zeros, std::uint32_t seed)
+	{
+		std::mt19937 engine(seed);
+		std::uniform_int_distribution<std::size_t> index(0, sparse_dimension - 1);
+		typename MathLbr::sparse_vector<T>::index_container indices(non_zeros);
+		typename MathLbr::sparse_vector<T>::value_container values(non_zeros);
+		for (std::size_t k = 0; k < non_zeros; ++k)
+		{
+			indices[k] = index(engine);
+			values[k] = static_cast<T>(k % 7 + 1);
+		}
+		return MathLbr::sparse_vector<T>(sparse_dimension, std::move(indices), std::move(values));
+	}
+
+	inline void sparse_sizes(benchmark::internal::Benchmark* benchmark)
+	{
+		for (const std::int64_t non_zeros : { 100, 10'000 })
+		{
+			benchmark->Arg(non_zeros);
+		}
+	}
+}
+
+template<typename T>
+void BM_SparseInnerProduct(benchmark::State& state)
+{
+	const auto a = bench::make_sparse<T>(static_cast<std::size_t>(state.range(0)), 1);
+	const auto b = bench::make_sparse<T>(static_cast<std::size_t>(state.range(0)), 2);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(MathLbr::Vector::inner_product(a, b));
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * a.non_zeros()));
+}
+
+template<typename T>
+void BM_SparseDenseInnerProduct(benchmark::State& state)
+{
+	const auto a = bench::make_sparse<T>(static_cast<std::size_t>(state.range(0)), 1);
+	const auto b = bench::make<T>(bench::sparse_dimension);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(MathLbr::Vector::inner_product(a, b));
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * a.non_zeros()));
+}
+
+// Baseline: the same vectors stored densely
+template<typename T>
+void BM_SparseAsDenseInnerProduct(benchmark::State& state)
+{
+	const auto a = bench::make_sparse<T>(static_cast<std::size_t>(state.range(0)), 1).to_dense();
+	const auto b = bench::make_sparse<T>(static_cast<std::size_t>(state.range(0)), 2).to_dense();
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(MathLbr::Vector::inner_product(a, b));
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * state.range(0)));
+}
+
+BENCHMARK_TEMPLATE(BM_SparseInnerProduct, double)->Apply(bench::sparse_sizes);
+BENCHMARK_TEMPLATE(BM_SparseDenseInnerProduct, double)->Apply(bench::sparse_sizes);
+BENCHMARK_TEMPLATE(BM_SparseAsDenseInnerProduct, double)->Apply(bench::sparse_sizes);
+
+
+// All-pairs similarities between state.range(0) vectors of similarity_dimension elements (rows of a matrix). Items are pairs
+namespace bench
+{
+	inline constexpr std::size_t similarity_dimension = 128;
+
+	template<typename T>
+	MathLbr::matrix<T> make_rows(std::size_t rows)
+	{
+		std::mt19937 engine(5);
+		std::normal_distribution<T> distribution;
+		MathLbr::matrix<T> result(rows, similarity_dimension);
+		for (auto& value : result)
+		{
+			value = distribution(engine);
+		}
+		return result;
+	}
+
+	inline void similarity_sizes(benchmark::internal::Benchmark* benchmark)
+	{
+		for (const std::int64_t rows : { 1'000, 4'000 })
+		{
+			benchmark->Arg(rows);
+		}
+	}
+
+	inline void set_pairs(benchmark::State& state)
+	{
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * state.range(0) * (state.range(0) - 1) / 2));
+	}
+}
+
+template<typename T>
+void BM_SimilarPairs(benchmark::State& state)
+{
+	const auto rows = bench::make_rows<T>(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(MathLbr::Similarity::similar_pairs(rows, T{ 0.9 }));
+	}
+	bench::set_pairs(state);
+}
+
+template<typename T>
+void BM_SimilarPairsParallel(benchmark::State& state)
+{
+	const auto rows = bench::make_rows<T>(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(MathLbr::Similarity::similar_pairs(MathLbr::execution::par, rows, T{ 0.9 }));
+	}
+	bench::set_pairs(state);
+}
+
+// Baseline: one inner product and two norms per pair of vectors
+template<typename T>
+void BM_SimilarPairsNaive(benchmark::State& state)
+{
+	const auto matrix = bench::make_rows<T>(static_cast<std::size_t>(state.range(0)));
+	std::vector<MathLbr::vector<T>> rows(matrix.rows(), MathLbr::vector<T>(bench::similarity_dimension));
+	for (std::size_t i = 0; i < rows.size(); ++i)
+	{
+		std::copy_n(matrix.data() + i * bench::similarity_dimension, bench::similarity_dimension, rows[i].begin());
+	}
+	for (auto _ : state)
+	{
+		std::vector<std::pair<std::size_t, std::size_t>> pairs;
+		for (std::size_t i = 0; i < rows.size(); ++i)
+		{
+			for (std::size_t j = i + 1; j < rows.size(); ++j)
+			{
+				if (MathLbr::Vector::inner_product(rows[i], rows[j]) / (rows[i].norm() * rows[j].norm()) >= T{ 0.9 })
+				{
+					pairs.emplace_back(i, j);
+				}
+			}
+		}
+		benchmark::DoNotOptimize(pairs.data());
+	}
+	bench::set_pairs(state);
+}
+
+BENCHMARK_TEMPLATE(BM_SimilarPairs, float)->Apply(bench::similarity_sizes);
+BENCHMARK_TEMPLATE(BM_SimilarPairs, double)->Apply(bench::similarity_sizes);
+BENCHMARK_TEMPLATE(BM_SimilarPairsParallel, double)->Apply(bench::similarity_sizes);
+BENCHMARK_TEMPLATE(BM_SimilarPairsNaive, double)->Apply(bench::similarity_sizes);
+
+
+// Nearest neighbours (k = 10) of 100 queries among state.range(0) vectors of similarity_dimension floats. Items are queries
+namespace bench
+{
+	inline constexpr std::size_t knn_queries = 100;
+	inline constexpr std::size_t knn_k = 10;
+
+	inline void knn_sizes(benchmark::internal::Benchmark* benchmark)
+	{
+		for (const std::int64_t rows : { 10'000, 100'000 })
+		{
+			benchmark->Arg(rows);
+		}
+	}
+}
+
+template<typename T>
+void BM_FlatSearch(benchmark::State& state)
+{
+	MathLbr::flat_index<T> index(bench::similarity_dimension);
+	index.add(bench::make_rows<T>(static_cast<std::size_t>(state.range(0))));
+	const auto queries = bench::make_rows<T>(bench::knn_queries);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(index.search(queries, bench::knn_k));
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * bench::knn_queries));
+}
+
+template<typename T>
+void BM_HnswSearch(benchmark::State& state)
+{
+	MathLbr::hnsw_index<T> index(bench::similarity_dimension);
+	index.add(bench::make_rows<T>(static_cast<std::size_t>(state.range(0))));
+	const auto queries = bench::make_rows<T>(bench::knn_queries);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(index.search(queries, bench::knn_k));
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * bench::knn_queries));
+}
+
+// Baseline: Vector::inner_product and norm for every vector, then a partial sort
+template<typename T>
+void BM_KnnNaive(benchmark::State& state)
+{
+	const auto matrix = bench::make_rows<T>(static_cast<std::size_t>(state.range(0)));
+	std::vector<MathLbr::vector<T>> rows(matrix.rows(), MathLbr::vector<T>(bench::similarity_dimension));
+	for (std::size_t i = 0; i < rows.size(); ++i)
+	{
+		std::copy_n(matrix.data() + i * bench::similarity_dimension, bench::similarity_dimension, rows[i].begin());
+	}
+	const auto queries = bench::make_rows<T>(bench::knn_queries);
+	MathLbr::vector<T> query(bench::similarity_dimension);
+	for (auto _ : state)
+	{
+		for (std::size_t q = 0; q < bench::knn_queries; ++q)
+		{
+			std::copy_n(queries.data() + q * bench::similarity_dimension, bench::similarity_dimension, query.begin());
+			std::vector<std::pair<T, std::size_t>> distances;
+			for (std::size_t i = 0; i < rows.size(); ++i)
+			{
+				const T norm = rows[i].norm();
+				distances.emplace_back(query.norm() * query.norm() + norm * norm - 2 * MathLbr::Vector::inner_product(query, rows[i]), i);
+			}
+			std::partial_sort(distances.begin(), distances.begin() + bench::knn_k, distances.end());
+			benchmark::DoNotOptimize(distances.data());
+		}
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * bench::knn_queries));
+}
+
+BENCHMARK_TEMPLATE(BM_FlatSearch, float)->Apply(bench::knn_sizes);
+BENCHMARK_TEMPLATE(BM_HnswSearch, float)->Apply(bench::knn_sizes);
+BENCHMARK_TEMPLATE(BM_KnnNaive, float)->Apply(bench::knn_sizes);
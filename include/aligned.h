@@ -0,0 +1,100 @@
+#ifndef ALIGNED_HEADER
+#define ALIGNED_HEADER
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+
+namespace MathLbr
+{
+	/*
+		Allocator returning memory aligned to (at least) Alignment bytes.
+		If HugePages is true, allocations of at least huge_page_size bytes are aligned to huge_page_size and
+		marked with madvise(MADV_HUGEPAGE) so that Linux backs them with transparent huge pages (no-op elsewhere).
+	*/
+	template<typename T, std::size_t Alignment, bool HugePages = false>
+	class aligned_allocator
+	{
+		static_assert(Alignment > 0 and (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two!");
+
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using propagate_on_container_move_assignment = std::true_type;
+		using is_always_equal = std::true_type;
+
+		template<typename U>
+		struct rebind
+		{
+			using other = aligned_allocator<U, Alignment, HugePages>;
+		};
+
+		static constexpr std::size_t alignment = Alignment < alignof(T) ? alignof(T) : Alignment;
+		static constexpr std::size_t huge_page_size = std::size_t{ 1 } << 21;
+
+		constexpr aligned_allocator() noexcept = default;
+
+		template<typename U>
+		constexpr aligned_allocator(const aligned_allocator<U, Alignment, HugePages>&) noexcept
+		{
+		}
+
+		[[nodiscard]] T* allocate(size_type count)
+		{
+			if (count > std::numeric_limits<size_type>::max() / sizeof(T))
+			{
+				throw std::bad_array_new_length();
+			}
+			const size_type bytes = count * sizeof(T);
+			void* memory = ::operator new(bytes, std::align_val_t{ allocation_alignment(bytes) });
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+			if constexpr (HugePages)
+			{
+				if (bytes >= huge_page_size)
+				{
+					// Only a hint: failures are harmless
+					::madvise(memory, bytes, MADV_HUGEPAGE);
+				}
+			}
+#endif
+			return static_cast<T*>(memory);
+		}
+
+		void deallocate(T* memory, size_type count) noexcept
+		{
+			::operator delete(memory, std::align_val_t{ allocation_alignment(count * sizeof(T)) });
+		}
+
+		friend constexpr bool operator==(const aligned_allocator&, const aligned_allocator&) noexcept
+		{
+			return true;
+		}
+
+	private:
+		static constexpr std::size_t allocation_alignment(size_type bytes) noexcept
+		{
+			if constexpr (HugePages)
+			{
+				if (bytes >= huge_page_size) return huge_page_size > alignment ? huge_page_size : alignment;
+			}
+			return alignment;
+		}
+	};
+
+
+	// std::array whose first element is aligned to Alignment bytes
+	template<typename T, std::size_t Size, std::size_t Alignment>
+	struct alignas(Alignment < alignof(T) ? alignof(T) : Alignment) aligned_array : std::array<T, Size>
+	{
+	};
+}
+
+#endif
@@ -0,0 +1,519 @@
+#ifndef CONSTEXPR_MATH_HEADER
+#define CONSTEXPR_MATH_HEADER
+
+#include "utility.h"
+
+#include <cmath>
+#include <complex>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <type_traits>
+
+
+/*
+	Math functions usable in constant expressions: same signatures and return types as their <cmath> counterparts, which
+	are called at runtime. During constant evaluation the result is computed in long double (range reduction + series)
+	and rounded to the result type, so it may differ from the runtime result by an ulp.
+	Signed zeros and errno aren't handled during constant evaluation.
+*/
+namespace detail::math
+{
+	namespace impl
+	{
+		using wide = long double;
+
+		inline constexpr wide pi = std::numbers::pi_v<wide>;
+		inline constexpr wide ln2 = std::numbers::ln2_v<wide>;
+		inline constexpr wide sqrt3 = std::numbers::sqrt3_v<wide>;
+
+		template<std::floating_point R>
+		constexpr bool is_nan(R x) noexcept
+		{
+			return x != x;
+		}
+
+		template<std::floating_point R>
+		constexpr bool is_inf(R x) noexcept
+		{
+			return x == std::numeric_limits<R>::infinity() or x == -std::numeric_limits<R>::infinity();
+		}
+
+		// x = mantissa * 2^exponent with mantissa in [1, 2), for finite x > 0
+		constexpr wide split(wide x, int& exponent) noexcept
+		{
+			exponent = 0;
+			for (; x >= 0x1p64L; exponent += 64) x *= 0x1p-64L;
+			for (; x < 0x1p-64L; exponent -= 64) x *= 0x1p64L;
+			for (; x >= 2; ++exponent) x /= 2;
+			for (; x < 1; --exponent) x *= 2;
+			return x;
+		}
+
+		// x * 2^exponent
+		constexpr wide scale(wide x, int exponent) noexcept
+		{
+			for (; exponent >= 64; exponent -= 64) x *= 0x1p64L;
+			for (; exponent <= -64; exponent += 64) x *= 0x1p-64L;
+			for (; exponent > 0; --exponent) x *= 2;
+			for (; exponent < 0; ++exponent) x /= 2;
+			return x;
+		}
+
+		// Finite x > 0
+		constexpr wide sqrt(wide x) noexcept
+		{
+			int exponent = 0;
+			wide mantissa = split(x, exponent);
+			if (exponent % 2 != 0)
+			{
+				mantissa *= 2;
+				--exponent;
+			}
+			// mantissa in [1, 4): Newton's iterations converge quadratically from (1 + mantissa) / 2
+			wide root = (1 + mantissa) / 2;
+			for (int i = 0; i < 8; ++i) root = (root + mantissa / root) / 2;
+			return scale(root, exponent / 2);
+		}
+
+		// Finite x >= 0
+		constexpr wide sqrt_or_zero(wide x) noexcept
+		{
+			return x > 0 ? sqrt(x) : 0;
+		}
+
+		// Finite x > 0
+		constexpr wide log(wide x) noexcept
+		{
+			int exponent = 0;
+			wide mantissa = split(x, exponent);
+			if (mantissa > std::numbers::sqrt2_v<wide>)
+			{
+				mantissa /= 2;
+				++exponent;
+			}
+			// log(m) = 2 atanh(s), |s| < 0.18
+			const wide s = (mantissa - 1) / (mantissa + 1);
+			const wide s2 = s * s;
+			wide term = s, sum = 0, previous = -1;
+			for (int k = 1; sum != previous; k += 2)
+			{
+				previous = sum;
+				sum += term / k;
+				term *= s2;
+			}
+			return 2 * sum + exponent * ln2;
+		}
+
+		// Not NaN
+		constexpr wide exp(wide x) noexcept
+		{
+			if (x > 11357) return std::numeric_limits<wide>::infinity();
+			if (x < -11400) return 0;
+			// exp(x) = 2^k exp(r), |r| <= ln2 / 2, |k| < 2^15. ln2 = ln2_high + ln2_low, where ln2_high has 33 significant
+			// bits: k * ln2_high is exact, and r doesn't lose the precision of ln2 as k grows
+			constexpr wide ln2_high = 0x1.62e42feep-1L;
+			constexpr wide ln2_low = 1.90821492927058781614426568075500134e-10L;
+			const auto k = static_cast<long long>(x / ln2 + (x < 0 ? -0.5L : 0.5L));
+			const wide r = (x - k * ln2_high) - k * ln2_low;
+			wide term = 1, sum = 0, previous = -1;
+			for (int n = 1; sum != previous; ++n)
+			{
+				previous = sum;
+				sum += term;
+				term *= r / n;
+			}
+			return scale(sum, static_cast<int>(k));
+		}
+
+		// Series of sin(r) and cos(r), |r| <= pi / 4
+		constexpr wide sin_series(wide r) noexcept
+		{
+			wide term = r, sum = 0, previous = -1;
+			for (int n = 2; sum != previous; n += 2)
+			{
+				previous = sum;
+				sum += term;
+				term *= -r * r / (n * (n + 1));
+			}
+			return sum;
+		}
+
+		constexpr wide cos_series(wide r) noexcept
+		{
+			wide term = 1, sum = 0, previous = -1;
+			for (int n = 1; sum != previous; n += 2)
+			{
+				previous = sum;
+				sum += term;
+				term *= -r * r / (n * (n + 1));
+			}
+			return sum;
+		}
+
+		// 2 / pi in chunks of 24 bits, most significant first (1584 bits, as in fdlibm)
+		inline constexpr std::uint32_t two_over_pi[] = {
+			0xA2F983, 0x6E4E44, 0x1529FC, 0x2757D1, 0xF534DD, 0xC0DB62, 0x95993C, 0x439041, 0xFE5163, 0xABDEBB, 0xC561B7,
+			0x246E3A, 0x424DD2, 0xE00649, 0x2EEA09, 0xD1921C, 0xFE1DEB, 0x1CB129, 0xA73EE8, 0x8235F5, 0x2EBB44, 0x84E99C,
+			0x7026B4, 0x5F7E41, 0x3991D6, 0x398353, 0x39F49C, 0x845F8B, 0xBDF928, 0x3B1FF8, 0x97FFDE, 0x05980F, 0xEF2F11,
+			0x8B5A0A, 0x6D1F6D, 0x367ECF, 0x27CB09, 0xB74F46, 0x3F669E, 0x5FEA2D, 0x7527BA, 0xC7EBE5, 0xF17B3D, 0x0739F7,
+			0x8A5292, 0xEA6BFB, 0x5FB11F, 0x8D5D08, 0x560330, 0x46FC7B, 0x6BABF0, 0xCFBC20, 0x9AF436, 0x1DA9E3, 0x91615E,
+			0xE61B08, 0x659985, 0x5F14A0, 0x68408D, 0xFFD880, 0x4D7327, 0x310606, 0x1556CA, 0x73A8C9, 0x60E27B, 0xC08C6B };
+
+		// 64 bits of a little endian array of 32 bits limbs, starting at bit first (missing bits are zeros)
+		template<std::size_t Limbs>
+		constexpr std::uint64_t bits_at(const std::uint32_t (&limbs)[Limbs], int first) noexcept
+		{
+			std::uint64_t result = 0;
+			for (int bit = 63; bit >= 0; --bit)
+			{
+				const int position = first + bit;
+				const bool set = position >= 0 and position < static_cast<int>(Limbs * 32)
+					and ((limbs[position / 32] >> (position % 32)) & 1u) != 0;
+				result = (result << 1) | (set ? 1u : 0u);
+			}
+			return result;
+		}
+
+		/*
+			x = r + quadrant * pi / 2, |r| <= pi / 4, for |x| <= the largest double (only quadrant modulo 4 is meaningful).
+			Payne-Hanek reduction: x = mantissa * 2^exponent, with an integral mantissa of 64 bits, is multiplied exactly
+			(in integers) by the 288 bits of 2 / pi following those whose products with x are multiples of 4. The integral
+			part of the product gives the quadrant, its fractional part r. The bits of 2 / pi left out change the fraction
+			by less than 2^-198, while it's never smaller than about 2^-64 (for x far from 0): r keeps its precision
+			whatever the magnitude of x.
+		*/
+		constexpr wide reduce_angle(wide x, long long& quadrant) noexcept
+		{
+			if (x < 0)
+			{
+				const wide r = reduce_angle(-x, quadrant);
+				quadrant = -quadrant;
+				return -r;
+			}
+			if (x <= pi / 4)
+			{
+				quadrant = 0;
+				return x;
+			}
+
+			int exponent = 0;
+			const auto mantissa = static_cast<std::uint64_t>(scale(split(x, exponent), 63));
+			exponent -= 63;
+			constexpr int chunks = 12;
+			const int first = exponent >= 26 ? (exponent - 2) / 24 : 0;
+
+			// product += value * 2^offset, value < 2^56
+			std::uint32_t product[12] = {};
+			const auto add = [&product](std::uint64_t value, int offset)
+			{
+				const int shift = offset % 32;
+				for (int limb = offset / 32, part = 0; part < 2; ++limb, ++part)
+				{
+					std::uint64_t carry = ((part == 0 ? value & 0xFFFFFFFFu : value >> 32)) << shift;
+					for (int i = limb; carry != 0 and i < 12; ++i)
+					{
+						const std::uint64_t sum = product[i] + (carry & 0xFFFFFFFFu);
+						product[i] = static_cast<std::uint32_t>(sum);
+						carry = (carry >> 32) + (sum >> 32);
+					}
+				}
+			};
+			for (int j = 0; j < chunks; ++j)
+			{
+				const std::uint64_t chunk = two_over_pi[first + j];
+				const int offset = 24 * (chunks - 1 - j);
+				add((mantissa & 0xFFFFFFFFu) * chunk, offset);
+				add((mantissa >> 32) * chunk, offset + 32);
+			}
+
+			// x * 2 / pi = product * 2^-point (modulo 4)
+			const int point = 24 * (first + chunks) - exponent;
+			quadrant = static_cast<long long>(bits_at(product, point) & 3u);
+			std::uint64_t high = bits_at(product, point - 64);
+			std::uint64_t low = bits_at(product, point - 128);
+			const bool rounded_up = (high >> 63) != 0;
+			if (rounded_up)
+			{
+				// Fractional part >= 1 / 2: r = -(1 - fraction) * pi / 2
+				++quadrant;
+				low = ~low + 1;
+				high = ~high + (low == 0 ? 1u : 0u);
+			}
+			const wide fraction = (static_cast<wide>(high) + static_cast<wide>(low) * 0x1p-64L) * 0x1p-64L;
+			return rounded_up ? -fraction * (pi / 2) : fraction * (pi / 2);
+		}
+
+		constexpr wide sin(wide x) noexcept
+		{
+			long long quadrant = 0;
+			const wide r = reduce_angle(x, quadrant);
+			switch (quadrant & 3)
+			{
+			case 0: return sin_series(r);
+			case 1: return cos_series(r);
+			case 2: return -sin_series(r);
+			default: return -cos_series(r);
+			}
+		}
+
+		constexpr wide cos(wide x) noexcept
+		{
+			long long quadrant = 0;
+			const wide r = reduce_angle(x, quadrant);
+			switch (quadrant & 3)
+			{
+			case 0: return cos_series(r);
+			case 1: return -sin_series(r);
+			case 2: return -cos_series(r);
+			default: return sin_series(r);
+			}
+		}
+
+		// Series of atan(x), |x| <= 0.27
+		constexpr wide atan_series(wide x) noexcept
+		{
+			const wide x2 = x * x;
+			wide term = x, sum = 0, previous = -1;
+			for (int n = 1; sum != previous; n += 2)
+			{
+				previous = sum;
+				sum += term / n;
+				term *= -x2;
+			}
+			return sum;
+		}
+
+		// Any x but NaN
+		constexpr wide atan(wide x) noexcept
+		{
+			if (x < 0) return -atan(-x);
+			if (x > 1) return pi / 2 - atan(1 / x);
+			// atan(x) = pi / 6 + atan((sqrt(3) x - 1) / (x + sqrt(3))), whose argument is in [-0.01, 2 - sqrt(3)]
+			if (x > 0.27L) return pi / 6 + atan_series((sqrt3 * x - 1) / (x + sqrt3));
+			return atan_series(x);
+		}
+
+		// Neither y nor x is NaN
+		constexpr wide atan2(wide y, wide x) noexcept
+		{
+			if (is_inf(y))
+			{
+				const wide angle = is_inf(x) ? (x > 0 ? pi / 4 : 3 * pi / 4) : pi / 2;
+				return y > 0 ? angle : -angle;
+			}
+			if (is_inf(x))
+			{
+				if (x > 0) return 0;
+				return y < 0 ? -pi : pi;
+			}
+			if (x > 0) return atan(y / x);
+			if (x < 0) return y < 0 ? atan(y / x) - pi : atan(y / x) + pi;
+			if (y == 0) return 0;
+			return y > 0 ? pi / 2 : -pi / 2;
+		}
+
+		// Integral power by squaring
+		template<typename R>
+		constexpr R integral_pow(R base, unsigned long long exponent) noexcept
+		{
+			R result = 1;
+			for (; exponent != 0; exponent /= 2)
+			{
+				if (exponent % 2 != 0) result *= base;
+				base *= base;
+			}
+			return result;
+		}
+	}
+
+
+	// Same return type as std::abs: complex numbers give their modulus
+	template<typename T>
+	constexpr auto abs(const T& x) -> decltype(std::abs(x))
+	{
+		using R = decltype(std::abs(x));
+		if (std::is_constant_evaluated())
+		{
+			if constexpr (concepts::is_complex<T>::value)
+			{
+				const impl::wide a = x.real() < 0 ? -impl::wide(x.real()) : impl::wide(x.real());
+				const impl::wide b = x.imag() < 0 ? -impl::wide(x.imag()) : impl::wide(x.imag());
+				if (impl::is_nan(a) or impl::is_nan(b)) return std::numeric_limits<R>::quiet_NaN();
+				const impl::wide largest = a < b ? b : a;
+				const impl::wide smallest = a < b ? a : b;
+				if (largest == 0 or impl::is_inf(largest)) return static_cast<R>(largest);
+				const impl::wide ratio = smallest / largest;
+				return static_cast<R>(largest * impl::sqrt(1 + ratio * ratio));
+			}
+			// R{} - value turns -0.0 into +0.0
+			else return x <= 0 ? R{} - static_cast<R>(x) : static_cast<R>(x);
+		}
+		return std::abs(x);
+	}
+
+	template<concepts::arithmetic_char_const_excluded T>
+	constexpr auto sqrt(T x) -> decltype(std::sqrt(x))
+	{
+		using R = decltype(std::sqrt(x));
+		if (std::is_constant_evaluated())
+		{
+			const R value = static_cast<R>(x);
+			if (impl::is_nan(value) or value == 0 or value == std::numeric_limits<R>::infinity()) return value;
+			if (value < 0) return std::numeric_limits<R>::quiet_NaN();
+			return static_cast<R>(impl::sqrt(value));
+		}
+		return std::sqrt(x);
+	}
+
+	template<concepts::arithmetic_char_const_excluded T, concepts::arithmetic_char_const_excluded T2>
+	constexpr auto pow(T base, T2 exponent) -> decltype(std::pow(base, exponent))
+	{
+		using R = decltype(std::pow(base, exponent));
+		if (std::is_constant_evaluated())
+		{
+			const R x = static_cast<R>(base);
+			const R y = static_cast<R>(exponent);
+			if (y == 0 or x == 1) return 1;
+			if (impl::is_nan(x) or impl::is_nan(y)) return std::numeric_limits<R>::quiet_NaN();
+
+			// From 2^digits on, floating point numbers are even integers. Smaller exponents fit in an unsigned long long
+			constexpr int digits = std::numeric_limits<R>::digits < 64 ? std::numeric_limits<R>::digits : 64;
+			constexpr R even_integers = impl::integral_pow<R>(2, digits);
+			const R magnitude = y < 0 ? -y : y;
+			const bool huge_exponent = not impl::is_inf(y) and magnitude >= even_integers;
+			const unsigned long long integral_part = impl::is_inf(y) or huge_exponent ? 0 : static_cast<unsigned long long>(magnitude);
+			const bool integral_exponent = huge_exponent or (not impl::is_inf(y) and static_cast<R>(integral_part) == magnitude);
+			if (integral_exponent and magnitude <= 64)
+			{
+				const impl::wide power = impl::integral_pow<impl::wide>(x, integral_part);
+				return static_cast<R>(y < 0 ? 1 / power : power);
+			}
+			if (x < 0)
+			{
+				if (not integral_exponent) return std::numeric_limits<R>::quiet_NaN();
+				const bool odd = integral_part % 2 != 0;
+				const impl::wide power = impl::exp(y * impl::log(-impl::wide(x)));
+				return static_cast<R>(odd ? -power : power);
+			}
+			if (x == 0) return y > 0 ? R{} : std::numeric_limits<R>::infinity();
+			if (impl::is_inf(x)) return y > 0 ? x : R{};
+			if (impl::is_inf(y)) return (x < 1) == (y > 0) ? R{} : std::numeric_limits<R>::infinity();
+			return static_cast<R>(impl::exp(y * impl::log(x)));
+		}
+		return std::pow(base, exponent);
+	}
+
+	template<concepts::arithmetic_char_const_excluded T>
+	constexpr auto exp(T x) -> decltype(std::exp(x))
+	{
+		using R = decltype(std::exp(x));
+		if (std::is_constant_evaluated())
+		{
+			const R value = static_cast<R>(x);
+			if (impl::is_nan(value)) return value;
+			return static_cast<R>(impl::exp(value));
+		}
+		return std::exp(x);
+	}
+
+	template<concepts::arithmetic_char_const_excluded T>
+	constexpr auto log(T x) -> decltype(std::log(x))
+	{
+		using R = decltype(std::log(x));
+		if (std::is_constant_evaluated())
+		{
+			const R value = static_cast<R>(x);
+			if (impl::is_nan(value) or value < 0) return std::numeric_limits<R>::quiet_NaN();
+			if (value == 0) return -std::numeric_limits<R>::infinity();
+			if (impl::is_inf(value)) return value;
+			return static_cast<R>(impl::log(value));
+		}
+		return std::log(x);
+	}
+
+	template<concepts::arithmetic_char_const_excluded T>
+	constexpr auto sin(T x) -> decltype(std::sin(x))
+	{
+		using R = decltype(std::sin(x));
+		if (std::is_constant_evaluated())
+		{
+			const R value = static_cast<R>(x);
+			if (impl::is_nan(value) or impl::is_inf(value)) return std::numeric_limits<R>::quiet_NaN();
+			assert((value < 0 ? -value : value) <= std::numeric_limits<double>::max()
+				&& "Constant evaluation supports angles up to the largest double!");
+			return static_cast<R>(impl::sin(value));
+		}
+		return std::sin(x);
+	}
+
+	template<concepts::arithmetic_char_const_excluded T>
+	constexpr auto cos(T x) -> decltype(std::cos(x))
+	{
+		using R = decltype(std::cos(x));
+		if (std::is_constant_evaluated())
+		{
+			const R value = static_cast<R>(x);
+			if (impl::is_nan(value) or impl::is_inf(value)) return std::numeric_limits<R>::quiet_NaN();
+			assert((value < 0 ? -value : value) <= std::numeric_limits<double>::max()
+				&& "Constant evaluation supports angles up to the largest double!");
+			return static_cast<R>(impl::cos(value));
+		}
+		return std::cos(x);
+	}
+
+	template<concepts::arithmetic_char_const_excluded T>
+	constexpr auto atan(T x) -> decltype(std::atan(x))
+	{
+		using R = decltype(std::atan(x));
+		if (std::is_constant_evaluated())
+		{
+			const R value = static_cast<R>(x);
+			if (impl::is_nan(value)) return value;
+			return static_cast<R>(impl::atan(value));
+		}
+		return std::atan(x);
+	}
+
+	template<concepts::arithmetic_char_const_excluded T, concepts::arithmetic_char_const_excluded T2>
+	constexpr auto atan2(T y, T2 x) -> decltype(std::atan2(y, x))
+	{
+		using R = decltype(std::atan2(y, x));
+		if (std::is_constant_evaluated())
+		{
+			if (impl::is_nan(static_cast<R>(y)) or impl::is_nan(static_cast<R>(x))) return std::numeric_limits<R>::quiet_NaN();
+			return static_cast<R>(impl::atan2(static_cast<R>(y), static_cast<R>(x)));
+		}
+		return std::atan2(y, x);
+	}
+
+	template<concepts::arithmetic_char_const_excluded T>
+	constexpr auto acos(T x) -> decltype(std::acos(x))
+	{
+		using R = decltype(std::acos(x));
+		if (std::is_constant_evaluated())
+		{
+			const impl::wide value = static_cast<R>(x);
+			if (impl::is_nan(value) or value < -1 or value > 1) return std::numeric_limits<R>::quiet_NaN();
+			return static_cast<R>(impl::atan2(impl::sqrt_or_zero((1 - value) * (1 + value)), value));
+		}
+		return std::acos(x);
+	}
+
+	template<concepts::arithmetic_char_const_excluded T>
+	constexpr auto asin(T x) -> decltype(std::asin(x))
+	{
+		using R = decltype(std::asin(x));
+		if (std::is_constant_evaluated())
+		{
+			const impl::wide value = static_cast<R>(x);
+			if (impl::is_nan(value) or value < -1 or value > 1) return std::numeric_limits<R>::quiet_NaN();
+			return static_cast<R>(impl::atan2(value, impl::sqrt_or_zero((1 - value) * (1 + value))));
+		}
+		return std::asin(x);
+	}
+}
+
+#endif
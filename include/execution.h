@@ -0,0 +1,142 @@
+#ifndef EXECUTION_HEADER
+#define EXECUTION_HEADER
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace MathLbr::execution
+{
+	// Same behaviour as the overloads without a policy
+	struct sequenced_policy {};
+
+	/*
+		Splits the work in chunks of chunk_size consecutive elements, processed by up to `threads` threads.
+		Reductions combine the partial result of every chunk in chunk order, so results only depend on chunk_size,
+		never on the number of threads or on scheduling.
+		Vectors with less than `threshold` elements use the serial path.
+	*/
+	struct parallel_policy
+	{
+		std::size_t threads = 0; // 0: std::thread::hardware_concurrency()
+		std::size_t threshold = std::size_t{ 1 } << 17;
+		std::size_t chunk_size = std::size_t{ 1 } << 16;
+	};
+
+	inline constexpr sequenced_policy seq{};
+	inline constexpr parallel_policy par{};
+}
+
+
+namespace concepts
+{
+	template<typename T>
+	concept execution_policy = std::is_same_v<std::remove_cvref_t<T>, MathLbr::execution::sequenced_policy>
+		or std::is_same_v<std::remove_cvref_t<T>, MathLbr::execution::parallel_policy>;
+
+	template<typename T>
+	concept parallel_execution_policy = std::is_same_v<std::remove_cvref_t<T>, MathLbr::execution::parallel_policy>;
+}
+
+
+namespace detail::execution
+{
+	inline bool use_serial_path(const MathLbr::execution::parallel_policy& policy, std::size_t count) noexcept
+	{
+		return count < policy.threshold or count == 0;
+	}
+
+	inline std::size_t chunk_size(const MathLbr::execution::parallel_policy& policy) noexcept
+	{
+		return std::max<std::size_t>(policy.chunk_size, 1);
+	}
+
+	inline std::size_t chunk_count(const MathLbr::execution::parallel_policy& policy, std::size_t count) noexcept
+	{
+		return (count + chunk_size(policy) - 1) / chunk_size(policy);
+	}
+
+	// Calls task(chunk_index) for every chunk in [0, chunks), distributing chunks dynamically between threads.
+	// The first exception thrown by a task is rethrown in the calling thread.
+	template<typename Task>
+	void run_chunks(const MathLbr::execution::parallel_policy& policy, std::size_t chunks, Task task)
+	{
+		const std::size_t hardware = policy.threads != 0 ? policy.threads
+			: std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+		const std::size_t thread_count = std::min(hardware, chunks);
+
+		std::atomic<std::size_t> next_chunk{ 0 };
+		std::exception_ptr exception;
+		std::mutex exception_mutex;
+		const auto worker = [&]()
+		{
+			try
+			{
+				for (std::size_t chunk = next_chunk++; chunk < chunks; chunk = next_chunk++)
+				{
+					task(chunk);
+				}
+			}
+			catch (...)
+			{
+				const std::lock_guard lock(exception_mutex);
+				if (not exception) exception = std::current_exception();
+				next_chunk = chunks;
+			}
+		};
+
+		std::vector<std::thread> threads;
+		threads.reserve(thread_count > 0 ? thread_count - 1 : 0);
+		for (std::size_t i = 1; i < thread_count; ++i)
+		{
+			threads.emplace_back(worker);
+		}
+		worker(); // the calling thread works as well
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+		if (exception) std::rethrow_exception(exception);
+	}
+
+	// Calls function(first, last) on consecutive index ranges covering [0, count)
+	template<typename Function>
+	void for_each_chunk(const MathLbr::execution::parallel_policy& policy, std::size_t count, Function function)
+	{
+		const std::size_t size = chunk_size(policy);
+		run_chunks(policy, chunk_count(policy, count), [&](std::size_t chunk)
+			{
+				const std::size_t first = chunk * size;
+				function(first, std::min(first + size, count));
+			});
+	}
+
+	// Reduces the partial results function(first, last) of every chunk, in chunk order
+	template<typename Result, typename Function, typename Combine>
+	Result reduce_chunks(const MathLbr::execution::parallel_policy& policy, std::size_t count, Result init,
+		Function function, Combine combine)
+	{
+		const std::size_t size = chunk_size(policy);
+		std::vector<Result> partials(chunk_count(policy, count), init);
+		run_chunks(policy, partials.size(), [&](std::size_t chunk)
+			{
+				const std::size_t first = chunk * size;
+				partials[chunk] = function(first, std::min(first + size, count));
+			});
+
+		Result result = init;
+		for (const auto& partial : partials)
+		{
+			result = combine(result, partial);
+		}
+		return result;
+	}
+}
+
+#endif
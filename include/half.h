@@ -0,0 +1,271 @@
+#ifndef HALF_HEADER
+#define HALF_HEADER
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+
+/*
+	16 bits floating point numbers: IEEE 754 binary16 (MathLbr::float16) and bfloat16 (MathLbr::bfloat16, the upper
+	16 bits of a float). They are a storage format: they convert implicitly to float, so every operation on them is
+	done in float, and only the results stored back into them are rounded (to nearest, ties to even).
+	Vectors of them take half the memory and bandwidth of float vectors, and their inner products and norms are
+	accumulated in float (see simd.h for the F16C/AVX-512 kernels).
+*/
+
+namespace detail::half
+{
+	// IEEE 754 binary16: 1 sign bit, 5 exponent bits, 10 mantissa bits
+	struct binary16
+	{
+		static constexpr std::uint16_t min_bits = 0x0400, lowest_bits = 0xFBFF, max_bits = 0x7BFF, epsilon_bits = 0x1400,
+			round_error_bits = 0x3800, infinity_bits = 0x7C00, quiet_nan_bits = 0x7E00, signaling_nan_bits = 0x7D00,
+			denorm_min_bits = 0x0001;
+		static constexpr int digits = 11, digits10 = 3, max_digits10 = 5, min_exponent = -13, min_exponent10 = -4,
+			max_exponent = 16, max_exponent10 = 4;
+		static constexpr bool is_iec559 = true;
+
+		static constexpr float to_float(std::uint16_t bits) noexcept
+		{
+			const std::uint32_t sign = static_cast<std::uint32_t>(bits & 0x8000u) << 16;
+			const std::uint32_t exponent = (bits >> 10) & 0x1Fu;
+			const std::uint32_t mantissa = bits & 0x3FFu;
+			if (exponent == 0x1F)
+			{
+				// Infinities, and NaNs made quiet like F16C does (payload kept)
+				return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13) | (mantissa != 0 ? 0x400000u : 0));
+			}
+			if (exponent == 0)
+			{
+				// Zeros and subnormals: mantissa * 2^-24, exact in float
+				const float magnitude = static_cast<float>(mantissa) * 0x1p-24f;
+				return sign != 0 ? -magnitude : magnitude;
+			}
+			return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+		}
+
+		static constexpr std::uint16_t from_float(float value) noexcept
+		{
+			const std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+			const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+			const std::uint32_t magnitude = bits & 0x7FFFFFFFu;
+			if (magnitude > 0x7F800000u)
+			{
+				// NaNs stay (quiet) NaNs
+				return static_cast<std::uint16_t>(sign | 0x7E00u | ((magnitude >> 13) & 0x3FFu));
+			}
+			if (magnitude >= 0x477FF000u)
+			{
+				// 65520 and above round to infinity
+				return static_cast<std::uint16_t>(sign | 0x7C00u);
+			}
+			if (magnitude >= 0x38800000u)
+			{
+				// Normal numbers: rebias the exponent, then round the 13 dropped mantissa bits (a carry increments the exponent)
+				const std::uint32_t rebiased = magnitude - 0x38000000u;
+				return static_cast<std::uint16_t>(sign | ((rebiased + 0xFFFu + ((rebiased >> 13) & 1u)) >> 13));
+			}
+			if (magnitude < 0x33000000u)
+			{
+				// Below 2^-25: rounds to zero
+				return sign;
+			}
+			// Subnormals: the mantissa (with its implicit bit) in units of 2^-24
+			const std::uint32_t shift = 126 - (magnitude >> 23);
+			const std::uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+			const std::uint32_t remainder = mantissa & ((1u << shift) - 1);
+			const std::uint32_t halfway = 1u << (shift - 1);
+			std::uint32_t result = mantissa >> shift;
+			if (remainder > halfway or (remainder == halfway and (result & 1u) != 0)) ++result;
+			return static_cast<std::uint16_t>(sign | result);
+		}
+	};
+
+	// bfloat16: 1 sign bit, 8 exponent bits, 7 mantissa bits. Same range as float
+	struct brain16
+	{
+		static constexpr std::uint16_t min_bits = 0x0080, lowest_bits = 0xFF7F, max_bits = 0x7F7F, epsilon_bits = 0x3C00,
+			round_error_bits = 0x3F00, infinity_bits = 0x7F80, quiet_nan_bits = 0x7FC0, signaling_nan_bits = 0x7FA0,
+			denorm_min_bits = 0x0001;
+		static constexpr int digits = 8, digits10 = 2, max_digits10 = 4, min_exponent = -125, min_exponent10 = -37,
+			max_exponent = 128, max_exponent10 = 38;
+		static constexpr bool is_iec559 = false;
+
+		static constexpr float to_float(std::uint16_t bits) noexcept
+		{
+			return std::bit_cast<float>(static_cast<std::uint32_t>(bits) << 16);
+		}
+
+		static constexpr std::uint16_t from_float(float value) noexcept
+		{
+			const std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+			if ((bits & 0x7FFFFFFFu) > 0x7F800000u)
+			{
+				return static_cast<std::uint16_t>((bits >> 16) | 0x40u);
+			}
+			return static_cast<std::uint16_t>((bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16);
+		}
+	};
+
+	// Rounds to float, to odd: an inexact result gets its last bit set. float has more than 2 bits more than
+	// both formats, so rounding this float to nearest gives the correctly rounded double (no double rounding)
+	constexpr float round_to_odd(double value) noexcept
+	{
+		const double magnitude = value < 0 ? -value : value;
+		if (magnitude > std::numeric_limits<float>::max() and magnitude != std::numeric_limits<double>::infinity())
+		{
+			return value < 0 ? -std::numeric_limits<float>::max() : std::numeric_limits<float>::max();
+		}
+		const float rounded = static_cast<float>(value);
+		if (value != value or static_cast<double>(rounded) == value)
+		{
+			return rounded;
+		}
+		std::uint32_t bits = std::bit_cast<std::uint32_t>(rounded);
+		if ((rounded < 0 ? -static_cast<double>(rounded) : static_cast<double>(rounded)) > magnitude) --bits;
+		return std::bit_cast<float>(bits | 1u);
+	}
+}
+
+
+namespace MathLbr
+{
+	template<typename Format>
+	class half_precision;
+
+	using float16 = half_precision<detail::half::binary16>;
+	using bfloat16 = half_precision<detail::half::brain16>;
+}
+
+
+namespace concepts
+{
+	template<typename T>
+	struct is_half_precision : std::false_type {};
+
+	template<typename Format>
+	struct is_half_precision<MathLbr::half_precision<Format>> : std::true_type {};
+
+	template<typename T>
+	concept half_precision_type = is_half_precision<T>::value;
+}
+
+
+namespace MathLbr
+{
+	template<typename Format>
+	class half_precision
+	{
+	public:
+		using format_type = Format;
+
+		constexpr half_precision() noexcept = default;
+
+		// Rounded once from float and double. long doubles, and integers above 2^53, are converted to double first
+		template<typename U>
+		requires (std::is_arithmetic_v<U>)
+		constexpr half_precision(U value) noexcept
+			: _bits(Format::from_float(std::is_same_v<U, float> ? static_cast<float>(value)
+				: detail::half::round_to_odd(static_cast<double>(value))))
+		{
+		}
+
+		constexpr operator float() const noexcept
+		{
+			return Format::to_float(_bits);
+		}
+
+		static constexpr half_precision from_bits(std::uint16_t bits) noexcept
+		{
+			half_precision result;
+			result._bits = bits;
+			return result;
+		}
+
+		constexpr std::uint16_t bits() const noexcept
+		{
+			return _bits;
+		}
+
+		// Computed in float (or in double for double operands), then rounded once
+		template<typename U>
+		requires (std::is_arithmetic_v<U> or concepts::half_precision_type<U>)
+		constexpr half_precision& operator+=(const U& value) noexcept
+		{
+			return *this = half_precision(static_cast<float>(*this) + value);
+		}
+
+		template<typename U>
+		requires (std::is_arithmetic_v<U> or concepts::half_precision_type<U>)
+		constexpr half_precision& operator-=(const U& value) noexcept
+		{
+			return *this = half_precision(static_cast<float>(*this) - value);
+		}
+
+		template<typename U>
+		requires (std::is_arithmetic_v<U> or concepts::half_precision_type<U>)
+		constexpr half_precision& operator*=(const U& value) noexcept
+		{
+			return *this = half_precision(static_cast<float>(*this) * value);
+		}
+
+		template<typename U>
+		requires (std::is_arithmetic_v<U> or concepts::half_precision_type<U>)
+		constexpr half_precision& operator/=(const U& value) noexcept
+		{
+			return *this = half_precision(static_cast<float>(*this) / value);
+		}
+
+	private:
+		std::uint16_t _bits = 0;
+	};
+
+	static_assert(sizeof(float16) == 2 and sizeof(bfloat16) == 2
+		and std::is_trivially_copyable_v<float16> and std::is_trivially_copyable_v<bfloat16>);
+}
+
+
+template<typename Format>
+class std::numeric_limits<MathLbr::half_precision<Format>>
+{
+	using type = MathLbr::half_precision<Format>;
+
+public:
+	static constexpr bool is_specialized = true;
+	static constexpr bool is_signed = true;
+	static constexpr bool is_integer = false;
+	static constexpr bool is_exact = false;
+	static constexpr bool has_infinity = true;
+	static constexpr bool has_quiet_NaN = true;
+	static constexpr bool has_signaling_NaN = true;
+	static constexpr std::float_denorm_style has_denorm = std::denorm_present;
+	static constexpr bool has_denorm_loss = false;
+	static constexpr bool is_iec559 = Format::is_iec559;
+	static constexpr bool is_bounded = true;
+	static constexpr bool is_modulo = false;
+	static constexpr bool traps = false;
+	static constexpr bool tinyness_before = false;
+	static constexpr std::float_round_style round_style = std::round_to_nearest;
+	static constexpr int radix = 2;
+	static constexpr int digits = Format::digits;
+	static constexpr int digits10 = Format::digits10;
+	static constexpr int max_digits10 = Format::max_digits10;
+	static constexpr int min_exponent = Format::min_exponent;
+	static constexpr int min_exponent10 = Format::min_exponent10;
+	static constexpr int max_exponent = Format::max_exponent;
+	static constexpr int max_exponent10 = Format::max_exponent10;
+
+	static constexpr type min() noexcept { return type::from_bits(Format::min_bits); }
+	static constexpr type lowest() noexcept { return type::from_bits(Format::lowest_bits); }
+	static constexpr type max() noexcept { return type::from_bits(Format::max_bits); }
+	static constexpr type epsilon() noexcept { return type::from_bits(Format::epsilon_bits); }
+	static constexpr type round_error() noexcept { return type::from_bits(Format::round_error_bits); }
+	static constexpr type infinity() noexcept { return type::from_bits(Format::infinity_bits); }
+	static constexpr type quiet_NaN() noexcept { return type::from_bits(Format::quiet_nan_bits); }
+	static constexpr type signaling_NaN() noexcept { return type::from_bits(Format::signaling_nan_bits); }
+	static constexpr type denorm_min() noexcept { return type::from_bits(Format::denorm_min_bits); }
+};
+
+#endif
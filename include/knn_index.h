@@ -0,0 +1,1143 @@
+#ifndef KNN_INDEX_HEADER
+#define KNN_INDEX_HEADER
+
+#include "vector.h"
+#include "matrix.h"
+#include "similarity.h"
+#include "mapped_vector.h"
+#include "random.h"
+#include "execution.h"
+#include "simd.h"
+#include "aligned.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+/*
+	Nearest neighbour search over collections of float or double vectors of the same dimension, stored contiguously
+	(one row of dimension() elements per vector, 64 bytes aligned), with their squared and inverse norms.
+	- flat_index: exact search, every vector is compared with the query (AVX2/AVX-512 inner products). Batches of queries
+	  are compared with the vectors tile by tile with the GEMM kernels of matrix.h.
+	- hnsw_index: approximate search in a hierarchical navigable small world graph (Malkov and Yashunin, 2016).
+	Distances are computed from inner products: smaller is closer (see Metric). Neighbours are sorted by distance, then
+	by index, so results never depend on the order in which the candidates are found nor on the number of threads.
+	Both indices can be saved to and loaded from a file (the format is described in documentation/knn/knn_index.md).
+*/
+
+namespace MathLbr
+{
+	enum class Metric
+	{
+		L2,            // squared euclidean distance: |q|^2 + |x|^2 - 2 q . x
+		INNER_PRODUCT, // -(q . x)
+		COSINE         // 1 - cos(q, x). Zero vectors are at distance 1 from everything
+	};
+
+	template<concepts::simd_real_type T>
+	struct neighbour
+	{
+		std::size_t index;
+		T distance;
+
+		constexpr bool operator==(const neighbour&) const = default;
+	};
+
+	struct hnsw_parameters
+	{
+		std::size_t connections = 16;      // links per node on the upper levels, twice as many on level 0 (M)
+		std::size_t ef_construction = 200; // candidates examined when a vector is inserted
+		std::size_t ef_search = 64;        // candidates examined by a search (at least k)
+		std::uint64_t seed = 42;           // levels of the nodes (a node's level only depends on its index and the seed)
+	};
+
+	template<concepts::simd_real_type T>
+	class flat_index;
+
+	template<concepts::simd_real_type T>
+	class hnsw_index;
+}
+
+
+namespace detail::knn
+{
+	template<typename T>
+	constexpr bool closer(const MathLbr::neighbour<T>& lhs, const MathLbr::neighbour<T>& rhs) noexcept
+	{
+		return lhs.distance < rhs.distance or (lhs.distance == rhs.distance and lhs.index < rhs.index);
+	}
+
+	template<typename T>
+	constexpr bool farther(const MathLbr::neighbour<T>& lhs, const MathLbr::neighbour<T>& rhs) noexcept
+	{
+		return closer(rhs, lhs);
+	}
+
+	// The k closest candidates pushed so far, in a heap whose top is the farthest of them
+	template<typename T>
+	class top_k
+	{
+		std::size_t _k;
+		std::vector<MathLbr::neighbour<T>> _heap;
+
+	public:
+		explicit top_k(std::size_t k)
+			: _k{ k }
+		{
+			_heap.reserve(k);
+		}
+
+		void push(const MathLbr::neighbour<T>& candidate)
+		{
+			if (_heap.size() < _k)
+			{
+				_heap.push_back(candidate);
+				std::push_heap(_heap.begin(), _heap.end(), closer<T>);
+			}
+			else if (_k != 0 and closer(candidate, _heap.front()))
+			{
+				std::pop_heap(_heap.begin(), _heap.end(), closer<T>);
+				_heap.back() = candidate;
+				std::push_heap(_heap.begin(), _heap.end(), closer<T>);
+			}
+		}
+
+		// Distance a candidate must be below to enter, when candidates are pushed in increasing index order
+		T bound() const noexcept
+		{
+			if (_k == 0) return -std::numeric_limits<T>::infinity();
+			return _heap.size() < _k ? std::numeric_limits<T>::infinity() : _heap.front().distance;
+		}
+
+		std::vector<MathLbr::neighbour<T>> sorted() &&
+		{
+			std::sort_heap(_heap.begin(), _heap.end(), closer<T>);
+			return std::move(_heap);
+		}
+	};
+
+	// The k closest neighbours of two sorted lists
+	template<typename T>
+	std::vector<MathLbr::neighbour<T>> merge(const std::vector<MathLbr::neighbour<T>>& lhs, const std::vector<MathLbr::neighbour<T>>& rhs, std::size_t k)
+	{
+		std::vector<MathLbr::neighbour<T>> result(lhs.size() + rhs.size());
+		std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), result.begin(), closer<T>);
+		result.resize(std::min(k, result.size()));
+		return result;
+	}
+
+	template<typename T>
+	using aligned_buffer = std::vector<T, MathLbr::aligned_allocator<T, 64>>;
+
+	// Vector compared with the stored ones: its elements and norms
+	template<typename T>
+	struct query_view
+	{
+		const T* values;
+		T squared_norm;
+		T inverse_norm;
+	};
+
+	template<typename T>
+	T inverse_norm(T squared_norm) noexcept
+	{
+		return squared_norm > 0 ? T{ 1 } / std::sqrt(squared_norm) : T{};
+	}
+
+	template<typename T>
+	T distance(MathLbr::Metric metric, T product, T squared_lhs, T inverse_lhs, T squared_rhs, T inverse_rhs) noexcept
+	{
+		switch (metric)
+		{
+		case MathLbr::Metric::INNER_PRODUCT: return -product;
+		case MathLbr::Metric::COSINE: return 1 - std::clamp(product * inverse_lhs * inverse_rhs, T{ -1 }, T{ 1 });
+		default: return std::max(squared_lhs + squared_rhs - 2 * product, T{});
+		}
+	}
+
+	// Replaces the inner products of a vector with `count` queries by their distances (same formulas as distance())
+	template<typename T>
+	void distances(MathLbr::Metric metric, T* products, std::size_t count, const query_view<T>& vector,
+		const T* squared_norms, const T* inverse_norms) noexcept
+	{
+		switch (metric)
+		{
+		case MathLbr::Metric::INNER_PRODUCT:
+			for (std::size_t j = 0; j < count; ++j)
+			{
+				products[j] = -products[j];
+			}
+			break;
+		case MathLbr::Metric::COSINE:
+			for (std::size_t j = 0; j < count; ++j)
+			{
+				products[j] = 1 - std::clamp(products[j] * inverse_norms[j] * vector.inverse_norm, T{ -1 }, T{ 1 });
+			}
+			break;
+		default:
+			for (std::size_t j = 0; j < count; ++j)
+			{
+				products[j] = std::max(squared_norms[j] + vector.squared_norm - 2 * products[j], T{});
+			}
+		}
+	}
+
+	// Contiguous rows of `dimension` elements and their norms
+	template<typename T>
+	class vector_store
+	{
+		std::size_t _dimension;
+		MathLbr::Metric _metric;
+		aligned_buffer<T> _data;
+		std::vector<T> _squared_norms;
+		std::vector<T> _inverse_norms;
+
+	public:
+		vector_store(std::size_t dimension, MathLbr::Metric metric)
+			: _dimension{ dimension }, _metric{ metric }
+		{
+			assert(dimension > 0 and "Vectors need at least one element!");
+		}
+
+		std::size_t size() const noexcept
+		{
+			return _squared_norms.size();
+		}
+
+		std::size_t dimension() const noexcept
+		{
+			return _dimension;
+		}
+
+		MathLbr::Metric metric() const noexcept
+		{
+			return _metric;
+		}
+
+		const T* data() const noexcept
+		{
+			return _data.data();
+		}
+
+		const T* squared_norms() const noexcept
+		{
+			return _squared_norms.data();
+		}
+
+		const T* inverse_norms() const noexcept
+		{
+			return _inverse_norms.data();
+		}
+
+		const T* row(std::size_t index) const noexcept
+		{
+			assert(index < size() and "Index out of bounds!");
+			return _data.data() + index * _dimension;
+		}
+
+		query_view<T> view(std::size_t index) const noexcept
+		{
+			return { row(index), _squared_norms[index], _inverse_norms[index] };
+		}
+
+		void reserve(std::size_t count)
+		{
+			_data.reserve(count * _dimension);
+			_squared_norms.reserve(count);
+			_inverse_norms.reserve(count);
+		}
+
+		// Appends the vector whose element p is element(p)
+		template<typename Element>
+		void push_back(Element element)
+		{
+			const std::size_t first = _data.size();
+			_data.resize(first + _dimension);
+			for (std::size_t p = 0; p < _dimension; ++p)
+			{
+				_data[first + p] = static_cast<T>(element(p));
+			}
+			const T squared = detail::simd::dot(_data.data() + first, _data.data() + first, _dimension);
+			_squared_norms.push_back(squared);
+			_inverse_norms.push_back(inverse_norm(squared));
+		}
+
+		// Replaces the contents by `count` rows read by read(data, bytes)
+		template<typename Read>
+		void read(std::size_t count, Read read)
+		{
+			_data.resize(count * _dimension);
+			read(_data.data(), _data.size() * sizeof(T));
+			_squared_norms.clear();
+			_inverse_norms.clear();
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const T* values = _data.data() + i * _dimension;
+				const T squared = detail::simd::dot(values, values, _dimension);
+				_squared_norms.push_back(squared);
+				_inverse_norms.push_back(inverse_norm(squared));
+			}
+		}
+
+		T distance(const query_view<T>& query, std::size_t index) const noexcept
+		{
+			return distance(query, index, detail::simd::dot(query.values, row(index), _dimension));
+		}
+
+		// Distance from the inner product of query and row index
+		T distance(const query_view<T>& query, std::size_t index, T product) const noexcept
+		{
+			return detail::knn::distance(_metric, product, query.squared_norm, query.inverse_norm, _squared_norms[index], _inverse_norms[index]);
+		}
+	};
+
+	// A query converted to T, in a buffer of the calling thread
+	template<typename T, typename Element>
+	query_view<T> make_query(std::size_t dimension, Element element)
+	{
+		thread_local aligned_buffer<T> buffer;
+		buffer.resize(dimension);
+		for (std::size_t p = 0; p < dimension; ++p)
+		{
+			buffer[p] = static_cast<T>(element(p));
+		}
+		const T squared = detail::simd::dot(buffer.data(), buffer.data(), dimension);
+		return { buffer.data(), squared, inverse_norm(squared) };
+	}
+
+	// Nodes visited by a graph search: a node is visited if its mark is the current epoch
+	class visited_list
+	{
+		std::vector<std::uint32_t> _marks;
+		std::uint32_t _epoch = 0;
+
+	public:
+		// List of the calling thread, cleared
+		static visited_list& local(std::size_t size)
+		{
+			thread_local visited_list list;
+			if (list._marks.size() < size) list._marks.resize(size);
+			if (++list._epoch == 0)
+			{
+				std::fill(list._marks.begin(), list._marks.end(), 0);
+				list._epoch = 1;
+			}
+			return list;
+		}
+
+		// false if the node was already visited
+		bool insert(std::size_t node) noexcept
+		{
+			if (_marks[node] == _epoch) return false;
+			_marks[node] = _epoch;
+			return true;
+		}
+	};
+
+
+	/*
+		File format of the indices: a 64 bytes header, the rows of the vectors, then (hnsw_index only) the graph.
+		Like save(), numbers are stored in the native byte order.
+	*/
+	enum class index_type : std::uint32_t
+	{
+		flat,
+		hnsw
+	};
+
+	struct index_header
+	{
+		static constexpr char expected_magic[8] = { 'M', 'L', 'B', 'R', 'K', 'N', 'N', '\0' };
+		static constexpr std::uint32_t current_version = 1;
+
+		char magic[8]{};
+		std::uint32_t version = current_version;
+		std::uint32_t byte_order = MathLbr::mapped_header::native_byte_order;
+		MathLbr::element_kind kind{};
+		std::uint32_t element_size = 0;
+		index_type type{};
+		std::uint32_t metric = 0;
+		std::uint64_t dimension = 0;
+		std::uint64_t count = 0;
+		std::uint8_t reserved[16]{};
+	};
+
+	static_assert(sizeof(index_header) == 64 and std::is_trivially_copyable_v<index_header>);
+
+	template<typename T>
+	void write(std::ofstream& file, const T* data, std::size_t count)
+	{
+		file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+	}
+
+	template<typename T>
+	void write_header(std::ofstream& file, index_type type, const vector_store<T>& vectors)
+	{
+		index_header header;
+		std::copy(std::begin(index_header::expected_magic), std::end(index_header::expected_magic), std::begin(header.magic));
+		header.kind = detail::mapped::kind_of<T>();
+		header.element_size = sizeof(T);
+		header.type = type;
+		header.metric = static_cast<std::uint32_t>(vectors.metric());
+		header.dimension = vectors.dimension();
+		header.count = vectors.size();
+		write(file, &header, 1);
+		write(file, vectors.data(), vectors.size() * vectors.dimension());
+	}
+
+	class index_reader
+	{
+		std::ifstream _file;
+		std::uint64_t _remaining;
+
+	public:
+		explicit index_reader(const std::filesystem::path& path)
+			: _file(path, std::ios::binary)
+		{
+			if (not _file) throw std::runtime_error("Cannot open the index file!");
+			_remaining = std::filesystem::file_size(path);
+		}
+
+		// Throws std::runtime_error if the file ends before `bytes` bytes
+		void read(void* data, std::uint64_t bytes)
+		{
+			if (bytes > _remaining or not _file.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes)))
+			{
+				throw std::runtime_error("The index file is truncated or corrupted!");
+			}
+			_remaining -= bytes;
+		}
+
+		template<typename T>
+		T read()
+		{
+			T value;
+			read(&value, sizeof(T));
+			return value;
+		}
+
+		// Reads the header and the vectors of an index of the given type
+		template<typename T>
+		vector_store<T> read_vectors(index_type type)
+		{
+			const auto header = read<index_header>();
+			if (std::memcmp(header.magic, index_header::expected_magic, sizeof(header.magic)) != 0)
+			{
+				throw std::runtime_error("Not a MathLbr index file!");
+			}
+			if (header.byte_order != MathLbr::mapped_header::native_byte_order)
+			{
+				throw std::runtime_error("The index file was written with a different endianness!");
+			}
+			if (header.version != index_header::current_version)
+			{
+				throw std::runtime_error("Unsupported index file version!");
+			}
+			if (header.kind != detail::mapped::kind_of<T>() or header.element_size != sizeof(T))
+			{
+				throw std::runtime_error("The element type of the index file doesn't match T!");
+			}
+			if (header.type != type)
+			{
+				throw std::runtime_error("The index file holds another type of index!");
+			}
+			if (header.metric > static_cast<std::uint32_t>(MathLbr::Metric::COSINE) or header.dimension == 0
+				or header.count > _remaining / sizeof(T) / header.dimension)
+			{
+				throw std::runtime_error("The index file is truncated or corrupted!");
+			}
+			vector_store<T> vectors(header.dimension, static_cast<MathLbr::Metric>(header.metric));
+			vectors.read(header.count, [this](void* data, std::uint64_t bytes) { read(data, bytes); });
+			return vectors;
+		}
+	};
+
+	inline std::ofstream open_index_file(const std::filesystem::path& path)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (not file) throw std::runtime_error("Cannot open the index file for writing!");
+		return file;
+	}
+
+	inline void close_index_file(std::ofstream& file)
+	{
+		if (not file.flush()) throw std::runtime_error("Cannot write the index file!");
+	}
+
+	// Element p of row `row` of a matrix, as a function of p
+	template<typename Matrix>
+	auto row_elements(const Matrix& matrix, std::size_t row)
+	{
+		return [rows = detail::gemm::make_strided(matrix), row](std::size_t p) { return rows(row, p); };
+	}
+
+	template<typename Vector>
+	auto elements(const Vector& vector)
+	{
+		return [&vector](std::size_t p) { return vector[p]; };
+	}
+}
+
+
+namespace MathLbr
+{
+	template<concepts::simd_real_type T>
+	class flat_index
+	{
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using result_type = std::vector<neighbour<T>>;
+
+	private:
+		detail::knn::vector_store<T> _vectors;
+
+		explicit flat_index(detail::knn::vector_store<T>&& vectors)
+			: _vectors{ std::move(vectors) }
+		{
+		}
+
+		// The k closest vectors among [first, last)
+		result_type scan(const detail::knn::query_view<T>& query, size_type first, size_type last, size_type k) const
+		{
+			detail::knn::top_k<T> best(std::min(k, last - first));
+			T bound = best.bound();
+			for (size_type i = first; i < last; ++i)
+			{
+				const T distance = _vectors.distance(query, i);
+				if (distance < bound)
+				{
+					best.push({ i, distance });
+					bound = best.bound();
+				}
+			}
+			return std::move(best).sorted();
+		}
+
+		// The k closest vectors among [first, last) to every query
+		std::vector<result_type> scan(const detail::knn::vector_store<T>& queries, size_type first, size_type last, size_type k) const
+		{
+			using block = detail::gemm::blocking<T>;
+			const detail::gemm::strided<const T> rows{ data(), dimension(), 1 };
+			const detail::gemm::strided<const T> query_rows{ queries.data(), dimension(), 1 };
+			thread_local std::vector<T> distances(block::mc * block::nc);
+
+			// Tiles of mc vectors x nc queries: every vector is packed once per block of nc queries
+			std::vector<result_type> result(queries.size());
+			for (size_type query = 0; query < queries.size(); query += block::nc)
+			{
+				const size_type count = std::min(block::nc, queries.size() - query);
+				std::vector<detail::knn::top_k<T>> best(count, detail::knn::top_k<T>(std::min(k, last - first)));
+				std::vector<T> bounds(count, best.front().bound());
+				for (size_type row = first; row < last; row += block::mc)
+				{
+					const size_type height = std::min(block::mc, last - row);
+					std::fill_n(distances.data(), height * count, T{});
+					detail::similarity::inner_products(dimension(), rows, query_rows, detail::gemm::strided<T>{ distances.data(), count, 1 },
+						row, height, query, count);
+					for (size_type i = 0; i < height; ++i)
+					{
+						T* line = distances.data() + i * count;
+						detail::knn::distances(metric(), line, count, _vectors.view(row + i),
+							queries.squared_norms() + query, queries.inverse_norms() + query);
+						for (size_type j = 0; j < count; ++j)
+						{
+							if (line[j] < bounds[j])
+							{
+								best[j].push({ row + i, line[j] });
+								bounds[j] = best[j].bound();
+							}
+						}
+					}
+				}
+				for (size_type j = 0; j < count; ++j)
+				{
+					result[query + j] = std::move(best[j]).sorted();
+				}
+			}
+			return result;
+		}
+
+		template<typename Policy>
+		result_type search(const Policy& policy, const detail::knn::query_view<T>& query, size_type k) const
+		{
+			if constexpr (concepts::parallel_execution_policy<Policy>)
+			{
+				if (not detail::execution::use_serial_path(policy, size()))
+				{
+					return detail::execution::reduce_chunks(policy, size(), result_type{},
+						[&](size_type first, size_type last) { return scan(query, first, last, k); },
+						[k](const result_type& lhs, const result_type& rhs) { return detail::knn::merge(lhs, rhs, k); });
+				}
+			}
+			return scan(query, 0, size(), k);
+		}
+
+	public:
+		explicit flat_index(size_type dimension, Metric metric = Metric::L2)
+			: _vectors{ dimension, metric }
+		{
+		}
+
+		size_type size() const noexcept
+		{
+			return _vectors.size();
+		}
+
+		bool is_empty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		size_type dimension() const noexcept
+		{
+			return _vectors.dimension();
+		}
+
+		Metric metric() const noexcept
+		{
+			return _vectors.metric();
+		}
+
+		// size() rows of dimension() elements
+		const T* data() const noexcept
+		{
+			return _vectors.data();
+		}
+
+		vector_view<const T> operator[](size_type index) const noexcept
+		{
+			return vector_view<const T>(_vectors.row(index), dimension());
+		}
+
+		void reserve(size_type count)
+		{
+			_vectors.reserve(count);
+		}
+
+		// Copies the vector at the end of the index, returns its index
+		template<concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		size_type add(const vector<T2, Size, Storage>& other)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, T>)
+		{
+			detail::assert_same_value<Size>(other.size(), dimension());
+			_vectors.push_back(detail::knn::elements(other));
+			return size() - 1;
+		}
+
+		// Every row is a vector
+		template<concepts::underlying_vector_type T2, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage>
+		void add(const matrix<T2, Rows, Cols, Order, Storage>& rows)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, T>)
+		{
+			detail::assert_same_value<Cols>(rows.cols(), dimension());
+			reserve(size() + rows.rows());
+			for (size_type i = 0; i < rows.rows(); ++i)
+			{
+				_vectors.push_back(detail::knn::row_elements(rows, i));
+			}
+		}
+
+		/*
+			The min(k, size()) vectors closest to query, closest first. With MathLbr::execution::par, chunks of
+			policy.chunk_size vectors are scanned in parallel.
+		*/
+		template<concepts::execution_policy Policy, concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		result_type search(Policy&& policy, const vector<T2, Size, Storage>& query, size_type k) const
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, T>)
+		{
+			detail::assert_same_value<Size>(query.size(), dimension());
+			return search(policy, detail::knn::make_query<T>(dimension(), detail::knn::elements(query)), k);
+		}
+
+		template<concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		result_type search(const vector<T2, Size, Storage>& query, size_type k) const
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, T>)
+		{
+			return search(execution::seq, query, k);
+		}
+
+		/*
+			Neighbours of every row of queries. The inner products between the queries and the vectors are computed tile by
+			tile with the GEMM kernels. With MathLbr::execution::par, chunks of policy.chunk_size vectors are scanned in parallel.
+		*/
+		template<concepts::execution_policy Policy,
+			concepts::underlying_vector_type T2, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage>
+		std::vector<result_type> search(Policy&& policy, const matrix<T2, Rows, Cols, Order, Storage>& queries, size_type k) const
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, T>)
+		{
+			detail::assert_same_value<Cols>(queries.cols(), dimension());
+
+			// Queries converted to T, with their norms
+			detail::knn::vector_store<T> converted(dimension(), metric());
+			converted.reserve(queries.rows());
+			for (size_type i = 0; i < queries.rows(); ++i)
+			{
+				converted.push_back(detail::knn::row_elements(queries, i));
+			}
+
+			if constexpr (concepts::parallel_execution_policy<Policy>)
+			{
+				if (not detail::execution::use_serial_path(policy, size()))
+				{
+					return detail::execution::reduce_chunks(policy, size(), std::vector<result_type>{},
+						[&](size_type first, size_type last) { return scan(converted, first, last, k); },
+						[k](const std::vector<result_type>& lhs, const std::vector<result_type>& rhs)
+						{
+							if (lhs.empty()) return rhs;
+							std::vector<result_type> merged(lhs.size());
+							for (size_type i = 0; i < lhs.size(); ++i)
+							{
+								merged[i] = detail::knn::merge(lhs[i], rhs[i], k);
+							}
+							return merged;
+						});
+				}
+			}
+			return scan(converted, 0, size(), k);
+		}
+
+		template<concepts::underlying_vector_type T2, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage>
+		std::vector<result_type> search(const matrix<T2, Rows, Cols, Order, Storage>& queries, size_type k) const
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, T>)
+		{
+			return search(execution::seq, queries, k);
+		}
+
+		// Writes the index to path (the file is replaced if it exists)
+		void save(const std::filesystem::path& path) const
+		{
+			auto file = detail::knn::open_index_file(path);
+			detail::knn::write_header(file, detail::knn::index_type::flat, _vectors);
+			detail::knn::close_index_file(file);
+		}
+
+		// Throws std::runtime_error if the file wasn't written by flat_index<T>::save or is corrupted
+		static flat_index load(const std::filesystem::path& path)
+		{
+			detail::knn::index_reader reader(path);
+			return flat_index(reader.read_vectors<T>(detail::knn::index_type::flat));
+		}
+	};
+
+
+	/*
+		Every vector is a node of a layered graph: all the nodes are on level 0, and each level keeps a random fraction
+		1 / connections of the nodes of the level below. A search goes down greedily from the single node of the top level,
+		then explores the closest ef_search candidates of level 0. Links are chosen with the heuristic of the paper, which
+		keeps links in diverse directions.
+		Insertions are incremental; they must not run concurrently with searches. Searches are thread-safe.
+	*/
+	template<concepts::simd_real_type T>
+	class hnsw_index
+	{
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using result_type = std::vector<neighbour<T>>;
+
+	private:
+		using node_type = std::uint32_t;
+		using candidates_type = std::vector<neighbour<T>>;
+
+		detail::knn::vector_store<T> _vectors;
+		hnsw_parameters _parameters;
+		std::vector<node_type> _levels;          // top level of every node
+		std::vector<size_type> _first_list;      // links of node i on level l: _links[_first_list[i] + l]
+		std::vector<std::vector<node_type>> _links;
+		node_type _entry_point = 0;
+		node_type _max_level = 0;
+
+		hnsw_index(detail::knn::vector_store<T>&& vectors, const hnsw_parameters& parameters)
+			: _vectors{ std::move(vectors) }, _parameters{ parameters }
+		{
+		}
+
+		std::vector<node_type>& links(size_type node, size_type level) noexcept
+		{
+			return _links[_first_list[node] + level];
+		}
+
+		const std::vector<node_type>& links(size_type node, size_type level) const noexcept
+		{
+			return _links[_first_list[node] + level];
+		}
+
+		size_type capacity(size_type level) const noexcept
+		{
+			return level == 0 ? 2 * _parameters.connections : _parameters.connections;
+		}
+
+		// -ln(u) / ln(connections), u uniform in (0, 1]
+		node_type random_level(size_type node) const noexcept
+		{
+			const auto words = detail::random::philox({ static_cast<std::uint32_t>(node), static_cast<std::uint32_t>(node >> 32), 0, 0 },
+				_parameters.seed);
+			const double uniform = 1 - detail::random::canonical<double>(words.data());
+			const double level = -std::log(uniform) / std::log(static_cast<double>(std::max<size_type>(_parameters.connections, 2)));
+			return static_cast<node_type>(std::min(level, 31.0));
+		}
+
+		// Closest node to query on a level, walking from entry as long as a link is closer
+		neighbour<T> greedy_search(const detail::knn::query_view<T>& query, neighbour<T> entry, size_type level) const
+		{
+			for (bool moved = true; moved; )
+			{
+				moved = false;
+				for (const node_type next : links(entry.index, level))
+				{
+					const neighbour<T> candidate{ next, _vectors.distance(query, next) };
+					if (detail::knn::closer(candidate, entry))
+					{
+						entry = candidate;
+						moved = true;
+					}
+				}
+			}
+			return entry;
+		}
+
+		// The ef closest nodes to query found from the entry points on a level, closest first
+		candidates_type search_level(const detail::knn::query_view<T>& query, const candidates_type& entry_points, size_type ef, size_type level) const
+		{
+			auto& visited = detail::knn::visited_list::local(size());
+			// Candidates to expand, the closest on top; results, the farthest on top
+			std::priority_queue<neighbour<T>, candidates_type, decltype(&detail::knn::farther<T>)> candidates(&detail::knn::farther<T>);
+			std::priority_queue<neighbour<T>, candidates_type, decltype(&detail::knn::closer<T>)> results(&detail::knn::closer<T>);
+			for (const auto& entry : entry_points)
+			{
+				visited.insert(entry.index);
+				candidates.push(entry);
+				results.push(entry);
+				if (results.size() > ef) results.pop();
+			}
+
+			while (not candidates.empty())
+			{
+				const neighbour<T> current = candidates.top();
+				if (results.size() >= ef and detail::knn::closer(results.top(), current))
+				{
+					break;
+				}
+				candidates.pop();
+				for (const node_type next : links(current.index, level))
+				{
+					if (not visited.insert(next)) continue;
+					const neighbour<T> candidate{ next, _vectors.distance(query, next) };
+					if (results.size() < ef or detail::knn::closer(candidate, results.top()))
+					{
+						candidates.push(candidate);
+						results.push(candidate);
+						if (results.size() > ef) results.pop();
+					}
+				}
+			}
+
+			candidates_type result(results.size());
+			for (auto it = result.rbegin(); it != result.rend(); ++it)
+			{
+				*it = results.top();
+				results.pop();
+			}
+			return result;
+		}
+
+		// At most count of the sorted candidates: a candidate is kept if it's closer to the query than to every kept one
+		candidates_type select_links(const candidates_type& candidates, size_type count) const
+		{
+			candidates_type selected;
+			selected.reserve(count);
+			for (const auto& candidate : candidates)
+			{
+				if (selected.size() == count) break;
+				const auto view = _vectors.view(candidate.index);
+				const bool diverse = std::none_of(selected.begin(), selected.end(), [&](const neighbour<T>& kept)
+					{
+						return _vectors.distance(view, kept.index) < candidate.distance;
+					});
+				if (diverse) selected.push_back(candidate);
+			}
+			return selected;
+		}
+
+		// Adds a link from target to node, at the given distance. Full lists are pruned with select_links
+		void connect(node_type target, node_type node, T distance, size_type level)
+		{
+			auto& list = links(target, level);
+			if (list.size() < capacity(level))
+			{
+				list.push_back(node);
+				return;
+			}
+			const auto view = _vectors.view(target);
+			candidates_type candidates{ { node, distance } };
+			for (const node_type linked : list)
+			{
+				candidates.push_back({ linked, _vectors.distance(view, linked) });
+			}
+			std::sort(candidates.begin(), candidates.end(), detail::knn::closer<T>);
+			const auto selected = select_links(candidates, capacity(level));
+			list.clear();
+			for (const auto& kept : selected)
+			{
+				list.push_back(static_cast<node_type>(kept.index));
+			}
+		}
+
+		// Links the last vector of _vectors into the graph
+		void insert()
+		{
+			const auto node = static_cast<node_type>(_levels.size());
+			const node_type level = random_level(node);
+			_levels.push_back(level);
+			_first_list.push_back(_links.size());
+			_links.resize(_links.size() + level + 1);
+			if (node == 0)
+			{
+				_entry_point = node;
+				_max_level = level;
+				return;
+			}
+
+			const auto query = _vectors.view(node);
+			neighbour<T> entry{ _entry_point, _vectors.distance(query, _entry_point) };
+			for (size_type current = _max_level; current > level; --current)
+			{
+				entry = greedy_search(query, entry, current);
+			}
+
+			candidates_type entry_points{ entry };
+			const size_type ef = std::max(_parameters.ef_construction, _parameters.connections);
+			for (size_type current = std::min(level, _max_level) + 1; current-- > 0; )
+			{
+				auto candidates = search_level(query, entry_points, ef, current);
+				const auto selected = select_links(candidates, _parameters.connections);
+				for (const auto& linked : selected)
+				{
+					links(node, current).push_back(static_cast<node_type>(linked.index));
+					connect(static_cast<node_type>(linked.index), node, linked.distance, current);
+				}
+				entry_points = std::move(candidates);
+			}
+
+			if (level > _max_level)
+			{
+				_max_level = level;
+				_entry_point = node;
+			}
+		}
+
+		result_type search(const detail::knn::query_view<T>& query, size_type k) const
+		{
+			if (is_empty() or k == 0) return {};
+			neighbour<T> entry{ _entry_point, _vectors.distance(query, _entry_point) };
+			for (size_type level = _max_level; level > 0; --level)
+			{
+				entry = greedy_search(query, entry, level);
+			}
+			auto result = search_level(query, { entry }, std::max(_parameters.ef_search, k), 0);
+			result.resize(std::min(k, result.size()));
+			return result;
+		}
+
+	public:
+		explicit hnsw_index(size_type dimension, Metric metric = Metric::L2, const hnsw_parameters& parameters = {})
+			: _vectors{ dimension, metric }, _parameters{ parameters }
+		{
+			assert(parameters.connections > 0 and "Nodes need at least one link!");
+		}
+
+		size_type size() const noexcept
+		{
+			return _vectors.size();
+		}
+
+		bool is_empty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		size_type dimension() const noexcept
+		{
+			return _vectors.dimension();
+		}
+
+		Metric metric() const noexcept
+		{
+			return _vectors.metric();
+		}
+
+		const hnsw_parameters& parameters() const noexcept
+		{
+			return _parameters;
+		}
+
+		// Trades speed for recall; not thread-safe with concurrent searches
+		void set_ef_search(size_type ef) noexcept
+		{
+			_parameters.ef_search = ef;
+		}
+
+		const T* data() const noexcept
+		{
+			return _vectors.data();
+		}
+
+		vector_view<const T> operator[](size_type index) const noexcept
+		{
+			return vector_view<const T>(_vectors.row(index), dimension());
+		}
+
+		void reserve(size_type count)
+		{
+			_vectors.reserve(count);
+			_levels.reserve(count);
+			_first_list.reserve(count);
+		}
+
+		// Inserts a copy of the vector in the graph, returns its index
+		template<concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		size_type add(const vector<T2, Size, Storage>& other)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, T>)
+		{
+			detail::assert_same_value<Size>(other.size(), dimension());
+			assert(size() < std::numeric_limits<node_type>::max() and "Too many vectors!");
+			_vectors.push_back(detail::knn::elements(other));
+			insert();
+			return size() - 1;
+		}
+
+		template<concepts::underlying_vector_type T2, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage>
+		void add(const matrix<T2, Rows, Cols, Order, Storage>& rows)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, T>)
+		{
+			detail::assert_same_value<Cols>(rows.cols(), dimension());
+			reserve(size() + rows.rows());
+			for (size_type i = 0; i < rows.rows(); ++i)
+			{
+				_vectors.push_back(detail::knn::row_elements(rows, i));
+				insert();
+			}
+		}
+
+		// Approximately the min(k, size()) vectors closest to query, closest first
+		template<concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		result_type search(const vector<T2, Size, Storage>& query, size_type k) const
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, T>)
+		{
+			detail::assert_same_value<Size>(query.size(), dimension());
+			return search(detail::knn::make_query<T>(dimension(), detail::knn::elements(query)), k);
+		}
+
+		// Neighbours of every row of queries. With MathLbr::execution::par, queries are searched in parallel
+		template<concepts::execution_policy Policy,
+			concepts::underlying_vector_type T2, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage>
+		std::vector<result_type> search(Policy&& policy, const matrix<T2, Rows, Cols, Order, Storage>& queries, size_type k) const
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, T>)
+		{
+			detail::assert_same_value<Cols>(queries.cols(), dimension());
+			std::vector<result_type> result(queries.rows());
+			const auto search_query = [&](size_type i)
+			{
+				result[i] = search(detail::knn::make_query<T>(dimension(), detail::knn::row_elements(queries, i)), k);
+			};
+			if constexpr (concepts::parallel_execution_policy<Policy>)
+			{
+				if (queries.rows() > 1)
+				{
+					detail::execution::run_chunks(policy, queries.rows(), search_query);
+					return result;
+				}
+			}
+			for (size_type i = 0; i < queries.rows(); ++i)
+			{
+				search_query(i);
+			}
+			return result;
+		}
+
+		template<concepts::underlying_vector_type T2, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage>
+		std::vector<result_type> search(const matrix<T2, Rows, Cols, Order, Storage>& queries, size_type k) const
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, T>)
+		{
+			return search(execution::seq, queries, k);
+		}
+
+		// Writes the vectors and the graph to path (the file is replaced if it exists)
+		void save(const std::filesystem::path& path) const
+		{
+			auto file = detail::knn::open_index_file(path);
+			detail::knn::write_header(file, detail::knn::index_type::hnsw, _vectors);
+			const std::uint64_t parameters[] = { _parameters.connections, _parameters.ef_construction, _parameters.ef_search,
+				_parameters.seed, _entry_point, _max_level };
+			detail::knn::write(file, parameters, std::size(parameters));
+			detail::knn::write(file, _levels.data(), _levels.size());
+			for (const auto& list : _links)
+			{
+				const auto count = static_cast<node_type>(list.size());
+				detail::knn::write(file, &count, 1);
+				detail::knn::write(file, list.data(), list.size());
+			}
+			detail::knn::close_index_file(file);
+		}
+
+		// Throws std::runtime_error if the file wasn't written by hnsw_index<T>::save or is corrupted
+		static hnsw_index load(const std::filesystem::path& path)
+		{
+			detail::knn::index_reader reader(path);
+			auto vectors = reader.read_vectors<T>(detail::knn::index_type::hnsw);
+			const size_type count = vectors.size();
+
+			std::uint64_t parameters[6];
+			reader.read(parameters, sizeof(parameters));
+			hnsw_index result(std::move(vectors), { parameters[0], parameters[1], parameters[2], parameters[3] });
+			if (parameters[0] == 0 or (count != 0 and (parameters[4] >= count or parameters[5] > 31))
+				or (count == 0 and (parameters[4] != 0 or parameters[5] != 0)))
+			{
+				throw std::runtime_error("The index file is truncated or corrupted!");
+			}
+			result._entry_point = static_cast<node_type>(parameters[4]);
+			result._max_level = static_cast<node_type>(parameters[5]);
+
+			result._levels.resize(count);
+			reader.read(result._levels.data(), count * sizeof(node_type));
+			// Searches start at the entry point on every level up to max_level
+			if (count != 0 and result._levels[result._entry_point] != result._max_level)
+			{
+				throw std::runtime_error("The index file is truncated or corrupted!");
+			}
+			result._first_list.reserve(count);
+			for (const node_type level : result._levels)
+			{
+				if (level > result._max_level) throw std::runtime_error("The index file is truncated or corrupted!");
+				result._first_list.push_back(result._links.size());
+				for (size_type current = 0; current <= level; ++current)
+				{
+					const auto links = reader.read<node_type>();
+					if (links > result.capacity(current)) throw std::runtime_error("The index file is truncated or corrupted!");
+					auto& list = result._links.emplace_back(links);
+					reader.read(list.data(), list.size() * sizeof(node_type));
+					if (std::any_of(list.begin(), list.end(), [&](node_type node) { return node >= count or result._levels[node] < current; }))
+					{
+						throw std::runtime_error("The index file is truncated or corrupted!");
+					}
+				}
+			}
+			return result;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,320 @@
+#ifndef MAPPED_VECTOR_HEADER
+#define MAPPED_VECTOR_HEADER
+
+#include "vector.h"
+
+#include <cerrno>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MATHLBR_HAS_MMAP 1
+#endif
+
+
+namespace MathLbr
+{
+	/*
+		File format shared by save() and mapped_vector: a 64 bytes header followed by the elements, stored contiguously in the
+		native byte order of the machine that wrote them (so that they can be mapped without any conversion).
+		Complex numbers are stored interleaved (re0 im0 re1 im1 ...).
+	*/
+	enum class element_kind : std::uint32_t
+	{
+		signed_integer,
+		unsigned_integer,
+		floating_point,
+		complex_floating_point,
+		// bfloat16 (MathLbr::bfloat16). MathLbr::float16 is a floating_point element of 2 bytes
+		brain_floating_point
+	};
+
+	struct mapped_header
+	{
+		static constexpr char expected_magic[8] = { 'M', 'L', 'B', 'R', 'V', 'E', 'C', '\0' };
+		static constexpr std::uint32_t current_version = 1;
+		static constexpr std::uint32_t native_byte_order = 0x01020304; // reads 0x04030201 on the other endianness
+
+		char magic[8]{};
+		std::uint32_t version = current_version;
+		std::uint32_t byte_order = native_byte_order;
+		element_kind kind{};
+		std::uint32_t element_size = 0;
+		std::uint64_t count = 0;
+		std::uint64_t data_offset = 0;
+		std::uint8_t reserved[24]{};
+	};
+
+	static_assert(sizeof(mapped_header) == 64 and std::is_trivially_copyable_v<mapped_header>);
+
+	enum class mapping_mode
+	{
+		read_only,
+		read_write
+	};
+}
+
+
+namespace detail::mapped
+{
+	template<typename T>
+	constexpr MathLbr::element_kind kind_of() noexcept
+	{
+		if constexpr (concepts::is_complex<T>::value) return MathLbr::element_kind::complex_floating_point;
+		else if constexpr (std::is_same_v<T, MathLbr::bfloat16>) return MathLbr::element_kind::brain_floating_point;
+		else if constexpr (std::is_floating_point_v<T> or std::is_same_v<T, MathLbr::float16>) return MathLbr::element_kind::floating_point;
+		else if constexpr (std::is_signed_v<T>) return MathLbr::element_kind::signed_integer;
+		else return MathLbr::element_kind::unsigned_integer;
+	}
+
+	template<typename T>
+	constexpr MathLbr::mapped_header make_header(std::uint64_t count) noexcept
+	{
+		MathLbr::mapped_header header;
+		std::copy(std::begin(MathLbr::mapped_header::expected_magic), std::end(MathLbr::mapped_header::expected_magic),
+			std::begin(header.magic));
+		header.kind = kind_of<T>();
+		header.element_size = sizeof(T);
+		header.count = count;
+		header.data_offset = sizeof(MathLbr::mapped_header);
+		return header;
+	}
+
+	// Throws std::runtime_error if the header doesn't describe `file_size` bytes of T elements
+	template<typename T>
+	void validate_header(const MathLbr::mapped_header& header, std::uint64_t file_size)
+	{
+		if (std::memcmp(header.magic, MathLbr::mapped_header::expected_magic, sizeof(header.magic)) != 0)
+		{
+			throw std::runtime_error("Not a MathLbr vector file!");
+		}
+		if (header.byte_order != MathLbr::mapped_header::native_byte_order)
+		{
+			throw std::runtime_error("The vector file was written with a different endianness!");
+		}
+		if (header.version != MathLbr::mapped_header::current_version)
+		{
+			throw std::runtime_error("Unsupported vector file version!");
+		}
+		if (header.kind != kind_of<T>() or header.element_size != sizeof(T))
+		{
+			throw std::runtime_error("The element type of the vector file doesn't match T!");
+		}
+		if (header.data_offset < sizeof(MathLbr::mapped_header) or header.data_offset % alignof(T) != 0
+			or header.data_offset > file_size or (file_size - header.data_offset) / sizeof(T) < header.count)
+		{
+			throw std::runtime_error("The vector file is truncated or corrupted!");
+		}
+	}
+
+	[[noreturn]] inline void throw_errno(const char* what)
+	{
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+}
+
+
+namespace MathLbr
+{
+	// Writes other to path in the format read by mapped_vector (the file is replaced if it exists)
+	template<concepts::underlying_vector_type T, std::size_t Size, typename Storage>
+	void save(const std::filesystem::path& path, const vector<T, Size, Storage>& other)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (not file) throw std::runtime_error("Cannot open the vector file for writing!");
+
+		const mapped_header header = detail::mapped::make_header<T>(other.size());
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		if constexpr (requires { other.data(); })
+		{
+			file.write(reinterpret_cast<const char*>(other.data()), static_cast<std::streamsize>(other.size() * sizeof(T)));
+		}
+		else
+		{
+			// e.g. split storages: elements are written one by one, interleaved
+			for (const T value : other)
+			{
+				file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+			}
+		}
+		if (not file.flush()) throw std::runtime_error("Cannot write the vector file!");
+	}
+
+#if defined(MATHLBR_HAS_MMAP)
+	/*
+		Dynamic vector whose elements live in a memory-mapped file written by save() (or created by create()).
+		Opening only reads the header: elements are paged in lazily by the OS when accessed, and never copied.
+		view() returns a vector_view (read-only for mapping_mode::read_only) usable with every vector operation.
+		With mapping_mode::read_write, modifications are written back to the file (see flush()).
+		The mapping is released by the destructor: views must not outlive their mapped_vector.
+	*/
+	template<concepts::underlying_vector_type T, mapping_mode Mode = mapping_mode::read_only>
+	class mapped_vector
+	{
+	public:
+		using size_type = std::size_t;
+		using value_type = T;
+		using element_type = std::conditional_t<Mode == mapping_mode::read_only, const T, T>;
+		using view_type = vector_view<element_type>;
+		using const_view_type = vector_view<const T>;
+
+	private:
+		void* _mapping = nullptr;
+		size_type _mapping_size = 0;
+		element_type* _data = nullptr;
+		size_type _size = 0;
+
+		static constexpr int protection = Mode == mapping_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+
+		struct file_descriptor
+		{
+			int fd;
+
+			~file_descriptor()
+			{
+				if (fd >= 0) ::close(fd); // the mapping stays valid after closing
+			}
+		};
+
+		void map(int fd, size_type mapping_size)
+		{
+			if (mapping_size == 0) return;
+			void* mapping = ::mmap(nullptr, mapping_size, protection, MAP_SHARED, fd, 0);
+			if (mapping == MAP_FAILED) detail::mapped::throw_errno("mmap failed");
+			_mapping = mapping;
+			_mapping_size = mapping_size;
+		}
+
+		void release() noexcept
+		{
+			if (_mapping) ::munmap(_mapping, _mapping_size);
+			_mapping = nullptr;
+			_mapping_size = 0;
+			_data = nullptr;
+			_size = 0;
+		}
+
+		mapped_vector() noexcept = default;
+
+	public:
+		explicit mapped_vector(const std::filesystem::path& path)
+		{
+			const file_descriptor file{ ::open(path.c_str(), Mode == mapping_mode::read_only ? O_RDONLY : O_RDWR) };
+			if (file.fd < 0) detail::mapped::throw_errno("Cannot open the vector file");
+
+			struct ::stat status{};
+			if (::fstat(file.fd, &status) != 0) detail::mapped::throw_errno("fstat failed");
+			const auto file_size = static_cast<std::uint64_t>(status.st_size);
+			if (file_size < sizeof(mapped_header)) throw std::runtime_error("The vector file is truncated or corrupted!");
+
+			map(file.fd, static_cast<size_type>(file_size));
+			try
+			{
+				mapped_header header;
+				std::memcpy(&header, _mapping, sizeof(header));
+				detail::mapped::validate_header<T>(header, file_size);
+				_data = reinterpret_cast<element_type*>(static_cast<std::byte*>(_mapping) + header.data_offset);
+				_size = static_cast<size_type>(header.count);
+			}
+			catch (...)
+			{
+				release();
+				throw;
+			}
+		}
+
+		// Creates (or replaces) path with count value-initialized elements, mapped for writing
+		static mapped_vector create(const std::filesystem::path& path, size_type count)
+		requires (Mode == mapping_mode::read_write)
+		{
+			const file_descriptor file{ ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644) };
+			if (file.fd < 0) detail::mapped::throw_errno("Cannot create the vector file");
+
+			const mapped_header header = detail::mapped::make_header<T>(count);
+			const size_type file_size = sizeof(header) + count * sizeof(T);
+			if (::ftruncate(file.fd, static_cast<off_t>(file_size)) != 0) detail::mapped::throw_errno("ftruncate failed");
+
+			// ftruncate fills the file with zeros, which is the value-initialized representation of every T
+			mapped_vector result;
+			result.map(file.fd, file_size);
+			std::memcpy(result._mapping, &header, sizeof(header));
+			result._data = reinterpret_cast<T*>(static_cast<std::byte*>(result._mapping) + header.data_offset);
+			result._size = count;
+			return result;
+		}
+
+		mapped_vector(const mapped_vector&) = delete;
+		mapped_vector& operator=(const mapped_vector&) = delete;
+
+		mapped_vector(mapped_vector&& other) noexcept
+			: _mapping(std::exchange(other._mapping, nullptr)), _mapping_size(std::exchange(other._mapping_size, 0)),
+			_data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0))
+		{
+		}
+
+		mapped_vector& operator=(mapped_vector&& other) noexcept
+		{
+			if (this != &other)
+			{
+				release();
+				_mapping = std::exchange(other._mapping, nullptr);
+				_mapping_size = std::exchange(other._mapping_size, 0);
+				_data = std::exchange(other._data, nullptr);
+				_size = std::exchange(other._size, 0);
+			}
+			return *this;
+		}
+
+		~mapped_vector()
+		{
+			release();
+		}
+
+		size_type size() const noexcept
+		{
+			return _size;
+		}
+
+		element_type* data() noexcept
+		{
+			return _data;
+		}
+
+		const T* data() const noexcept
+		{
+			return _data;
+		}
+
+		view_type view() noexcept
+		{
+			return view_type(_data, _size);
+		}
+
+		const_view_type view() const noexcept
+		{
+			return const_view_type(_data, _size);
+		}
+
+		// Blocks until the modifications are written to the file
+		void flush() const
+		requires (Mode == mapping_mode::read_write)
+		{
+			if (_mapping and ::msync(_mapping, _mapping_size, MS_SYNC) != 0) detail::mapped::throw_errno("msync failed");
+		}
+	};
+#endif
+}
+
+#endif
@@ -0,0 +1,1325 @@
+#ifndef MATRIX_HEADER
+#define MATRIX_HEADER
+
+#include "vector.h"
+#include "utility.h"
+#include "storage.h"
+#include "execution.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+
+/*
+	matrix<T, Rows, Cols, Order, Storage> stores its elements in a single contiguous container, row by row
+	(Layout::ROW_MAJOR) or column by column (Layout::COLUMN_MAJOR).
+	Like MathLbr::vector, std::array is used when both extents are known at compile time, std::vector otherwise
+	(or the containers of the Storage policy). Rows and Cols can be dynamic_extent independently.
+*/
+
+namespace MathLbr
+{
+	enum class Layout
+	{
+		ROW_MAJOR, COLUMN_MAJOR
+	};
+
+	template<concepts::underlying_vector_type T, std::size_t Rows = dynamic_extent, std::size_t Cols = dynamic_extent,
+		Layout Order = Layout::ROW_MAJOR, typename Storage = default_storage>
+	class matrix;
+}
+
+
+namespace concepts
+{
+	template<typename T>
+	struct is_matrix : std::false_type {};
+
+	template<typename T, std::size_t Rows, std::size_t Cols, MathLbr::Layout Order, typename Storage>
+	struct is_matrix<MathLbr::matrix<T, Rows, Cols, Order, Storage>> : std::true_type {};
+}
+
+
+namespace detail
+{
+	// Number of elements of a matrix, dynamic_extent unless both extents are known at compile time
+	template<std::size_t Rows, std::size_t Cols>
+	inline constexpr std::size_t matrix_extent = concepts::are_sizes_compiletime<Rows, Cols> ? Rows * Cols : MathLbr::dynamic_extent;
+
+	// Runtime value of an extent: an empty class if the extent is known at compile time.
+	// Dimension distinguishes the rows from the columns, so that two empty extents don't need distinct addresses
+	template<std::size_t Extent, std::size_t Dimension>
+	struct extent_storage
+	{
+		static constexpr std::size_t value() noexcept
+		{
+			return Extent;
+		}
+
+		constexpr void set([[maybe_unused]] std::size_t value) noexcept
+		{
+			assert(value == Extent and "Size mismatch: the matrix has a compile time extent!");
+		}
+	};
+
+	template<std::size_t Dimension>
+	struct extent_storage<MathLbr::dynamic_extent, Dimension>
+	{
+		std::size_t _value = 0;
+
+		constexpr std::size_t value() const noexcept
+		{
+			return _value;
+		}
+
+		constexpr void set(std::size_t value) noexcept
+		{
+			_value = value;
+		}
+	};
+
+	template<std::size_t Extent, std::size_t OtherExtent>
+	constexpr void assert_same_extent([[maybe_unused]] std::size_t extent, [[maybe_unused]] std::size_t other_extent)
+	{
+		if constexpr (concepts::are_sizes_compiletime<Extent, OtherExtent>)
+		{
+			static_assert(Extent == OtherExtent, "Size mismatch: the extents of both matrices must be equal!");
+		}
+		else
+		{
+			assert(extent == other_extent and "Size mismatch: the extents of both matrices must be equal!");
+		}
+	}
+}
+
+
+namespace MathLbr
+{
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage>
+	class matrix
+	{
+		static_assert(concepts::vector_storage<Storage, T, detail::matrix_extent<Rows, Cols>>, "Storage must be a valid storage policy!");
+		static_assert(concepts::contiguous_container<typename Storage::template container<T, detail::matrix_extent<Rows, Cols>>>
+			and concepts::owning_container<typename Storage::template container<T, detail::matrix_extent<Rows, Cols>>>,
+			"Matrices need an owning, contiguous storage!");
+
+	public:
+		using size_type = std::size_t;
+		using value_type = T;
+		using underlying_container = typename Storage::template container<T, detail::matrix_extent<Rows, Cols>>;
+		using reference_type = T&;
+		using const_reference_type = const T&;
+		using pointer_type = T*;
+		using const_pointer_type = const T*;
+		using storage_type = Storage;
+		using transpose_type = matrix<T, Cols, Rows, Order, Storage>;
+
+		static constexpr size_type rows_extent = Rows;
+		static constexpr size_type cols_extent = Cols;
+		static constexpr Layout layout = Order;
+
+	private:
+		template<concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2>
+		friend class matrix;
+
+		underlying_container _matrix{};
+		[[no_unique_address]] detail::extent_storage<Rows, 0> _rows{};
+		[[no_unique_address]] detail::extent_storage<Cols, 1> _cols{};
+
+		constexpr size_type index_of(size_type row, size_type col) const noexcept
+		{
+			assert(row < rows() and col < cols() and "Index out of bounds!");
+			if constexpr (Order == Layout::ROW_MAJOR) return row * cols() + col;
+			else return col * rows() + row;
+		}
+
+	public:
+		// Zero matrix: rows x cols, or 0 x 0 for dynamic extents
+		constexpr matrix() = default;
+
+		// rows x cols zero matrix. Compile time extents must match the given ones
+		constexpr matrix(size_type rows, size_type cols)
+		requires (concepts::dynamic_extent_enabled<detail::matrix_extent<Rows, Cols>>)
+		{
+			_rows.set(rows);
+			_cols.set(cols);
+			_matrix.resize(rows * cols);
+		}
+
+		constexpr matrix(size_type rows, size_type cols, const value_type& value)
+		{
+			_rows.set(rows);
+			_cols.set(cols);
+			if constexpr (concepts::dynamic_extent_enabled<detail::matrix_extent<Rows, Cols>>)
+			{
+				_matrix.resize(rows * cols);
+			}
+			std::fill(begin(), end(), value);
+		}
+
+		// One list per row, whatever the layout: matrix<double, 2, 3>{ {1, 2, 3}, {4, 5, 6} }
+		constexpr matrix(std::initializer_list<std::initializer_list<value_type>> list)
+		{
+			const size_type rows = list.size();
+			const size_type cols = rows != 0 ? list.begin()->size() : 0;
+			_rows.set(rows);
+			_cols.set(cols);
+			if constexpr (concepts::dynamic_extent_enabled<detail::matrix_extent<Rows, Cols>>)
+			{
+				_matrix.resize(rows * cols);
+			}
+			size_type row = 0;
+			for (const auto& row_list : list)
+			{
+				assert(row_list.size() == cols and "Every row must have the same number of elements!");
+				size_type col = 0;
+				for (const value_type& value : row_list)
+				{
+					(*this)(row, col++) = value;
+				}
+				++row;
+			}
+		}
+
+		template<concepts::underlying_vector_type T2, Layout Order2, typename Storage2>
+		constexpr explicit(not concepts::allow_implicit_conversions::value) matrix(const matrix<T2, Rows, Cols, Order2, Storage2>& other)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>
+		and (not std::is_same_v<matrix<T2, Rows, Cols, Order2, Storage2>, matrix>))
+		{
+			_rows.set(other.rows());
+			_cols.set(other.cols());
+			if constexpr (concepts::dynamic_extent_enabled<detail::matrix_extent<Rows, Cols>>)
+			{
+				_matrix.resize(other.size());
+			}
+			for (size_type row = 0; row < rows(); ++row)
+			{
+				for (size_type col = 0; col < cols(); ++col)
+				{
+					(*this)(row, col) = static_cast<value_type>(other(row, col));
+				}
+			}
+		}
+
+		static constexpr matrix identity()
+		requires (concepts::are_sizes_compiletime<Rows, Cols> and Rows == Cols)
+		{
+			matrix result{};
+			for (size_type i = 0; i < Rows; ++i)
+			{
+				result(i, i) = value_type{ 1 };
+			}
+			return result;
+		}
+
+		static constexpr matrix identity(size_type size)
+		requires (concepts::dynamic_extent_enabled<detail::matrix_extent<Rows, Cols>>)
+		{
+			matrix result(size, size);
+			for (size_type i = 0; i < size; ++i)
+			{
+				result(i, i) = value_type{ 1 };
+			}
+			return result;
+		}
+
+		constexpr size_type rows() const noexcept
+		{
+			return _rows.value();
+		}
+
+		constexpr size_type cols() const noexcept
+		{
+			return _cols.value();
+		}
+
+		constexpr size_type size() const noexcept
+		{
+			return rows() * cols();
+		}
+
+		constexpr bool is_empty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		// Distance between the first elements of two consecutive rows (ROW_MAJOR) or columns (COLUMN_MAJOR)
+		constexpr size_type leading_dimension() const noexcept
+		{
+			if constexpr (Order == Layout::ROW_MAJOR) return cols();
+			else return rows();
+		}
+
+		constexpr reference_type operator()(size_type row, size_type col) noexcept
+		{
+			return _matrix[index_of(row, col)];
+		}
+
+		constexpr const_reference_type operator()(size_type row, size_type col) const noexcept
+		{
+			return _matrix[index_of(row, col)];
+		}
+
+		constexpr pointer_type data() noexcept
+		{
+			return _matrix.data();
+		}
+
+		constexpr const_pointer_type data() const noexcept
+		{
+			return _matrix.data();
+		}
+
+		// Iterators traverse the elements in memory order
+		constexpr auto begin() noexcept
+		{
+			return _matrix.begin();
+		}
+
+		constexpr auto begin() const noexcept
+		{
+			return _matrix.begin();
+		}
+
+		constexpr auto end() noexcept
+		{
+			return _matrix.begin() + size();
+		}
+
+		constexpr auto end() const noexcept
+		{
+			return _matrix.begin() + size();
+		}
+
+		constexpr transpose_type transpose() const
+		{
+			transpose_type result{};
+			result._rows.set(cols());
+			result._cols.set(rows());
+			if constexpr (concepts::dynamic_extent_enabled<detail::matrix_extent<Rows, Cols>>)
+			{
+				result._matrix.resize(size());
+			}
+			for (size_type row = 0; row < rows(); ++row)
+			{
+				for (size_type col = 0; col < cols(); ++col)
+				{
+					result(col, row) = (*this)(row, col);
+				}
+			}
+			return result;
+		}
+
+		template<concepts::underlying_vector_type T2, Layout Order2, typename Storage2>
+		constexpr matrix& operator+=(const matrix<T2, Rows, Cols, Order2, Storage2>& rhs)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
+		{
+			detail::assert_same_extent<Rows, Rows>(rows(), rhs.rows());
+			detail::assert_same_extent<Cols, Cols>(cols(), rhs.cols());
+			if constexpr (Order == Order2)
+			{
+				std::transform(begin(), end(), rhs.begin(), begin(), [](const value_type& lhs, const T2& value) { return lhs + value; });
+			}
+			else
+			{
+				for (size_type row = 0; row < rows(); ++row)
+				{
+					for (size_type col = 0; col < cols(); ++col)
+					{
+						(*this)(row, col) += rhs(row, col);
+					}
+				}
+			}
+			return *this;
+		}
+
+		template<concepts::underlying_vector_type T2, Layout Order2, typename Storage2>
+		constexpr matrix& operator-=(const matrix<T2, Rows, Cols, Order2, Storage2>& rhs)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
+		{
+			detail::assert_same_extent<Rows, Rows>(rows(), rhs.rows());
+			detail::assert_same_extent<Cols, Cols>(cols(), rhs.cols());
+			if constexpr (Order == Order2)
+			{
+				std::transform(begin(), end(), rhs.begin(), begin(), [](const value_type& lhs, const T2& value) { return lhs - value; });
+			}
+			else
+			{
+				for (size_type row = 0; row < rows(); ++row)
+				{
+					for (size_type col = 0; col < cols(); ++col)
+					{
+						(*this)(row, col) -= rhs(row, col);
+					}
+				}
+			}
+			return *this;
+		}
+
+		template<concepts::underlying_vector_type T2>
+		constexpr matrix& operator*=(const T2& scalar)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
+		{
+			for (auto& value : *this)
+			{
+				value *= scalar;
+			}
+			return *this;
+		}
+
+		template<concepts::underlying_vector_type T2>
+		constexpr matrix& operator/=(const T2& scalar)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
+		{
+			detail::assert_div_byzero<T2>(scalar);
+			for (auto& value : *this)
+			{
+				value /= scalar;
+			}
+			return *this;
+		}
+
+		constexpr matrix operator-() const
+		{
+			matrix result = *this;
+			for (auto& value : result)
+			{
+				value = -value;
+			}
+			return result;
+		}
+
+		friend constexpr matrix operator+(matrix lhs, const matrix& rhs)
+		{
+			return lhs += rhs;
+		}
+
+		friend constexpr matrix operator-(matrix lhs, const matrix& rhs)
+		{
+			return lhs -= rhs;
+		}
+
+		friend constexpr matrix operator*(matrix lhs, const value_type& scalar)
+		{
+			return lhs *= scalar;
+		}
+
+		friend constexpr matrix operator*(const value_type& scalar, matrix rhs)
+		{
+			return rhs *= scalar;
+		}
+
+		friend constexpr matrix operator/(matrix lhs, const value_type& scalar)
+		{
+			return lhs /= scalar;
+		}
+
+		template<concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2>
+		constexpr bool operator==(const matrix<T2, Rows2, Cols2, Order2, Storage2>& rhs) const
+		{
+			if (rows() != rhs.rows() or cols() != rhs.cols()) return false;
+			if constexpr (Order == Order2)
+			{
+				return std::equal(begin(), end(), rhs.begin());
+			}
+			else
+			{
+				for (size_type row = 0; row < rows(); ++row)
+				{
+					for (size_type col = 0; col < cols(); ++col)
+					{
+						if (not ((*this)(row, col) == rhs(row, col))) return false;
+					}
+				}
+				return true;
+			}
+		}
+
+		// One line per row, whatever the layout
+		friend std::ostream& operator<< (std::ostream& stream, const matrix& rhs)
+		{
+			for (size_type row = 0; row < rhs.rows(); ++row)
+			{
+				for (size_type col = 0; col < rhs.cols(); ++col)
+				{
+					stream << rhs(row, col) << ' ';
+				}
+				stream << '\n';
+			}
+			return stream;
+		}
+	};
+}
+
+
+/*
+	Matrix multiplication (GEMM), blocked like GotoBLAS/BLIS:
+	- C is split in tiles of mc x nc elements, which are independent tasks (the parallel overloads distribute them
+	  between threads). Every element of C is computed by exactly one task, always in the same order: the results
+	  don't depend on the number of threads.
+	- For every block of kc columns of A/rows of B, a task packs its kc x nc block of B in panels of nr columns
+	  and its mc x kc block of A in panels of mr rows (zero padded), so that the micro-kernel reads both contiguously:
+	  a B panel stays in L1, the packed A block in L2.
+	- The micro-kernel computes an mr x nr block of C in registers: explicit AVX2/FMA kernels for float and double
+	  (also used on AVX-512 CPUs), a portable loop otherwise.
+	Products smaller than small_product use a plain triple loop, as does constant evaluation.
+*/
+namespace detail::gemm
+{
+	template<typename T>
+	struct blocking
+	{
+		static constexpr std::size_t mr = 4;
+		static constexpr std::size_t nr = 4;
+		static constexpr std::size_t mc = 64;
+		static constexpr std::size_t kc = 128;
+		static constexpr std::size_t nc = 128;
+	};
+
+	// 6 x 2 accumulators of 256 bits: 12 of the 16 AVX2 registers
+	template<concepts::simd_real_type T>
+	struct blocking<T>
+	{
+		static constexpr std::size_t mr = 6;
+		static constexpr std::size_t nr = 64 / sizeof(T);
+		static constexpr std::size_t mc = 96;
+		static constexpr std::size_t kc = 256;
+		static constexpr std::size_t nc = 256;
+	};
+
+	// m * n * k below which the packing costs more than it saves
+	inline constexpr std::size_t small_product = 16 * 16 * 16;
+
+	// Element (row, col) of a matrix is data[row * row_stride + col * col_stride]
+	template<typename T>
+	struct strided
+	{
+		T* data;
+		std::size_t row_stride;
+		std::size_t col_stride;
+
+		constexpr T& operator()(std::size_t row, std::size_t col) const noexcept
+		{
+			return data[row * row_stride + col * col_stride];
+		}
+	};
+
+	template<typename T, std::size_t Rows, std::size_t Cols, MathLbr::Layout Order, typename Storage>
+	constexpr auto make_strided(const MathLbr::matrix<T, Rows, Cols, Order, Storage>& matrix) noexcept
+	{
+		if constexpr (Order == MathLbr::Layout::ROW_MAJOR) return strided<const T>{ matrix.data(), matrix.leading_dimension(), 1 };
+		else return strided<const T>{ matrix.data(), 1, matrix.leading_dimension() };
+	}
+
+	template<typename T, std::size_t Rows, std::size_t Cols, MathLbr::Layout Order, typename Storage>
+	constexpr auto make_strided(MathLbr::matrix<T, Rows, Cols, Order, Storage>& matrix) noexcept
+	{
+		if constexpr (Order == MathLbr::Layout::ROW_MAJOR) return strided<T>{ matrix.data(), matrix.leading_dimension(), 1 };
+		else return strided<T>{ matrix.data(), 1, matrix.leading_dimension() };
+	}
+
+	// c += a * b. Every element of c accumulates its products in k order; the innermost loop runs along a row of c
+	template<typename R, typename A, typename B>
+	constexpr void naive(std::size_t m, std::size_t n, std::size_t k, strided<A> a, strided<B> b, strided<R> c)
+	{
+		for (std::size_t i = 0; i < m; ++i)
+		{
+			for (std::size_t p = 0; p < k; ++p)
+			{
+				const R value = static_cast<R>(a(i, p));
+				for (std::size_t j = 0; j < n; ++j)
+				{
+					c(i, j) += value * static_cast<R>(b(p, j));
+				}
+			}
+		}
+	}
+
+	// Rows [row, row + rows) and columns [col, col + cols) of a, as panels of mr rows: panel[p * mr + r] = a(r, p)
+	template<typename R, typename A>
+	void pack_a(strided<A> a, std::size_t row, std::size_t rows, std::size_t col, std::size_t cols, R* packed)
+	{
+		constexpr std::size_t mr = blocking<R>::mr;
+		for (std::size_t first = 0; first < rows; first += mr)
+		{
+			const std::size_t height = std::min(mr, rows - first);
+			for (std::size_t p = 0; p < cols; ++p)
+			{
+				for (std::size_t r = 0; r < height; ++r)
+				{
+					packed[r] = static_cast<R>(a(row + first + r, col + p));
+				}
+				for (std::size_t r = height; r < mr; ++r)
+				{
+					packed[r] = R{};
+				}
+				packed += mr;
+			}
+		}
+	}
+
+	// Rows [row, row + rows) and columns [col, col + cols) of b, as panels of nr columns: panel[p * nr + c] = b(p, c)
+	template<typename R, typename B>
+	void pack_b(strided<B> b, std::size_t row, std::size_t rows, std::size_t col, std::size_t cols, R* packed)
+	{
+		constexpr std::size_t nr = blocking<R>::nr;
+		for (std::size_t first = 0; first < cols; first += nr)
+		{
+			const std::size_t width = std::min(nr, cols - first);
+			for (std::size_t p = 0; p < rows; ++p)
+			{
+				for (std::size_t c = 0; c < width; ++c)
+				{
+					packed[c] = static_cast<R>(b(row + p, col + first + c));
+				}
+				for (std::size_t c = width; c < nr; ++c)
+				{
+					packed[c] = R{};
+				}
+				packed += nr;
+			}
+		}
+	}
+
+	// tile[r * nr + c] = sum(a[p * mr + r] * b[p * nr + c]) for p in [0, k)
+	template<typename R>
+	void kernel_portable(std::size_t k, const R* a, const R* b, R* tile)
+	{
+		constexpr std::size_t mr = blocking<R>::mr;
+		constexpr std::size_t nr = blocking<R>::nr;
+		R accumulators[mr * nr]{};
+		for (std::size_t p = 0; p < k; ++p)
+		{
+			for (std::size_t r = 0; r < mr; ++r)
+			{
+				const R value = a[r];
+				for (std::size_t c = 0; c < nr; ++c)
+				{
+					accumulators[r * nr + c] += value * b[c];
+				}
+			}
+			a += mr;
+			b += nr;
+		}
+		std::copy_n(accumulators, mr * nr, tile);
+	}
+
+#if MATHLBR_SIMD_X86
+	MATHLBR_TARGET("avx2,fma") inline void kernel_avx2(std::size_t k, const double* a, const double* b, double* tile) noexcept
+	{
+		__m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd(), c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+		__m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd(), c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+		__m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd(), c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+		for (std::size_t p = 0; p < k; ++p)
+		{
+			const __m256d b0 = _mm256_load_pd(b);
+			const __m256d b1 = _mm256_load_pd(b + 4);
+			__m256d value = _mm256_broadcast_sd(a);
+			c00 = _mm256_fmadd_pd(value, b0, c00);
+			c01 = _mm256_fmadd_pd(value, b1, c01);
+			value = _mm256_broadcast_sd(a + 1);
+			c10 = _mm256_fmadd_pd(value, b0, c10);
+			c11 = _mm256_fmadd_pd(value, b1, c11);
+			value = _mm256_broadcast_sd(a + 2);
+			c20 = _mm256_fmadd_pd(value, b0, c20);
+			c21 = _mm256_fmadd_pd(value, b1, c21);
+			value = _mm256_broadcast_sd(a + 3);
+			c30 = _mm256_fmadd_pd(value, b0, c30);
+			c31 = _mm256_fmadd_pd(value, b1, c31);
+			value = _mm256_broadcast_sd(a + 4);
+			c40 = _mm256_fmadd_pd(value, b0, c40);
+			c41 = _mm256_fmadd_pd(value, b1, c41);
+			value = _mm256_broadcast_sd(a + 5);
+			c50 = _mm256_fmadd_pd(value, b0, c50);
+			c51 = _mm256_fmadd_pd(value, b1, c51);
+			a += 6;
+			b += 8;
+		}
+		_mm256_storeu_pd(tile, c00);
+		_mm256_storeu_pd(tile + 4, c01);
+		_mm256_storeu_pd(tile + 8, c10);
+		_mm256_storeu_pd(tile + 12, c11);
+		_mm256_storeu_pd(tile + 16, c20);
+		_mm256_storeu_pd(tile + 20, c21);
+		_mm256_storeu_pd(tile + 24, c30);
+		_mm256_storeu_pd(tile + 28, c31);
+		_mm256_storeu_pd(tile + 32, c40);
+		_mm256_storeu_pd(tile + 36, c41);
+		_mm256_storeu_pd(tile + 40, c50);
+		_mm256_storeu_pd(tile + 44, c51);
+	}
+
+	MATHLBR_TARGET("avx2,fma") inline void kernel_avx2(std::size_t k, const float* a, const float* b, float* tile) noexcept
+	{
+		__m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps(), c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+		__m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps(), c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+		__m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps(), c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+		for (std::size_t p = 0; p < k; ++p)
+		{
+			const __m256 b0 = _mm256_load_ps(b);
+			const __m256 b1 = _mm256_load_ps(b + 8);
+			__m256 value = _mm256_broadcast_ss(a);
+			c00 = _mm256_fmadd_ps(value, b0, c00);
+			c01 = _mm256_fmadd_ps(value, b1, c01);
+			value = _mm256_broadcast_ss(a + 1);
+			c10 = _mm256_fmadd_ps(value, b0, c10);
+			c11 = _mm256_fmadd_ps(value, b1, c11);
+			value = _mm256_broadcast_ss(a + 2);
+			c20 = _mm256_fmadd_ps(value, b0, c20);
+			c21 = _mm256_fmadd_ps(value, b1, c21);
+			value = _mm256_broadcast_ss(a + 3);
+			c30 = _mm256_fmadd_ps(value, b0, c30);
+			c31 = _mm256_fmadd_ps(value, b1, c31);
+			value = _mm256_broadcast_ss(a + 4);
+			c40 = _mm256_fmadd_ps(value, b0, c40);
+			c41 = _mm256_fmadd_ps(value, b1, c41);
+			value = _mm256_broadcast_ss(a + 5);
+			c50 = _mm256_fmadd_ps(value, b0, c50);
+			c51 = _mm256_fmadd_ps(value, b1, c51);
+			a += 6;
+			b += 16;
+		}
+		_mm256_storeu_ps(tile, c00);
+		_mm256_storeu_ps(tile + 8, c01);
+		_mm256_storeu_ps(tile + 16, c10);
+		_mm256_storeu_ps(tile + 24, c11);
+		_mm256_storeu_ps(tile + 32, c20);
+		_mm256_storeu_ps(tile + 40, c21);
+		_mm256_storeu_ps(tile + 48, c30);
+		_mm256_storeu_ps(tile + 56, c31);
+		_mm256_storeu_ps(tile + 64, c40);
+		_mm256_storeu_ps(tile + 72, c41);
+		_mm256_storeu_ps(tile + 80, c50);
+		_mm256_storeu_ps(tile + 88, c51);
+	}
+#endif
+
+	template<typename R>
+	void kernel(std::size_t k, const R* a, const R* b, R* tile)
+	{
+#if MATHLBR_SIMD_X86
+		if constexpr (concepts::simd_real_type<R>)
+		{
+			const auto level = detail::simd::simd_level();
+			if (level == MathLbr::SimdLevel::AVX2 or level == MathLbr::SimdLevel::AVX512)
+			{
+				return kernel_avx2(k, a, b, tile);
+			}
+		}
+#endif
+		kernel_portable(k, a, b, tile);
+	}
+
+	// Packing buffers, reused by every product computed on the same thread. Panels are aligned for the kernels
+	template<typename R>
+	struct workspace
+	{
+		std::vector<R, MathLbr::aligned_allocator<R, 64>> a;
+		std::vector<R, MathLbr::aligned_allocator<R, 64>> b;
+
+		static workspace& local()
+		{
+			thread_local workspace buffers{ std::vector<R, MathLbr::aligned_allocator<R, 64>>(blocking<R>::mc * blocking<R>::kc),
+				std::vector<R, MathLbr::aligned_allocator<R, 64>>(blocking<R>::kc * blocking<R>::nc) };
+			return buffers;
+		}
+	};
+
+	// c += a * b on the tile of c made of rows [row, row + rows) and columns [col, col + cols)
+	template<typename R, typename A, typename B>
+	void multiply_tile(std::size_t k, strided<A> a, strided<B> b, strided<R> c,
+		std::size_t row, std::size_t rows, std::size_t col, std::size_t cols)
+	{
+		using block = blocking<R>;
+		auto& buffers = workspace<R>::local();
+		R tile[block::mr * block::nr];
+
+		for (std::size_t depth = 0; depth < k; depth += block::kc)
+		{
+			const std::size_t kc = std::min(block::kc, k - depth);
+			pack_b(b, depth, kc, col, cols, buffers.b.data());
+			pack_a(a, row, rows, depth, kc, buffers.a.data());
+
+			for (std::size_t j = 0; j < cols; j += block::nr)
+			{
+				const std::size_t width = std::min(block::nr, cols - j);
+				const R* b_panel = buffers.b.data() + j * kc;
+				for (std::size_t i = 0; i < rows; i += block::mr)
+				{
+					const std::size_t height = std::min(block::mr, rows - i);
+					kernel(kc, buffers.a.data() + i * kc, b_panel, tile);
+					for (std::size_t r = 0; r < height; ++r)
+					{
+						for (std::size_t s = 0; s < width; ++s)
+						{
+							c(row + i + r, col + j + s) += tile[r * block::nr + s];
+						}
+					}
+				}
+			}
+		}
+	}
+
+	inline std::size_t tile_count(std::size_t m, std::size_t n, std::size_t mc, std::size_t nc) noexcept
+	{
+		return ((m + mc - 1) / mc) * ((n + nc - 1) / nc);
+	}
+
+	// c += a * b, c is m x n, the inner dimension is k
+	template<typename R, typename A, typename B>
+	void multiply(std::size_t m, std::size_t n, std::size_t k, strided<A> a, strided<B> b, strided<R> c)
+	{
+		using block = blocking<R>;
+		if (m * n * k < small_product)
+		{
+			return naive(m, n, k, a, b, c);
+		}
+		for (std::size_t col = 0; col < n; col += block::nc)
+		{
+			for (std::size_t row = 0; row < m; row += block::mc)
+			{
+				multiply_tile(k, a, b, c, row, std::min(block::mc, m - row), col, std::min(block::nc, n - col));
+			}
+		}
+	}
+
+	template<typename R, typename A, typename B>
+	void multiply(const MathLbr::execution::parallel_policy& policy,
+		std::size_t m, std::size_t n, std::size_t k, strided<A> a, strided<B> b, strided<R> c)
+	{
+		using block = blocking<R>;
+		if (detail::execution::use_serial_path(policy, m * n) or m * n * k < small_product)
+		{
+			return multiply(m, n, k, a, b, c);
+		}
+		const std::size_t row_tiles = (m + block::mc - 1) / block::mc;
+		detail::execution::run_chunks(policy, tile_count(m, n, block::mc, block::nc), [&](std::size_t index)
+			{
+				const std::size_t row = index % row_tiles * block::mc;
+				const std::size_t col = index / row_tiles * block::nc;
+				multiply_tile(k, a, b, c, row, std::min(block::mc, m - row), col, std::min(block::nc, n - col));
+			});
+	}
+}
+
+
+/*
+	Matrix-vector products (GEMV): y = alpha * op(A) * x + beta * y, op(A) being A or its transpose.
+	Depending on the layout, op(A) is read in one of two ways:
+	- its rows are contiguous (ROW_MAJOR A, or the transpose of a COLUMN_MAJOR A): y[i] is the inner product of a row
+	  and x. Four rows are processed at once, so every load of x is shared by four rows;
+	- its columns are contiguous: y is updated by alpha * x[j] * column j, four columns at once, so y is loaded and
+	  stored once every four columns. Rows are processed in blocks that stay in L1 across all the columns.
+	Both are explicit AVX2/FMA kernels for float and double (also used on AVX-512 CPUs), portable loops otherwise.
+	The parallel overloads split y in ranges of rows: every y[i] is computed with the same operations, whatever the
+	range it belongs to, so results don't depend on the number of threads.
+*/
+namespace detail::gemv
+{
+	// Fixed size matrices with at most this many elements use the plain loops, inlined with constant trip counts
+	inline constexpr std::size_t small_matrix = 16 * 16;
+	// Elements of y kept in L1 while the columns are accumulated
+	inline constexpr std::size_t row_block = 2048;
+	// Rows processed at once by both kernels
+	inline constexpr std::size_t group = 4;
+
+	template<typename R>
+	constexpr R update(R alpha, R product, R beta, R y) noexcept
+	{
+		// beta == 0: y is only written, like BLAS (NaN or infinite values in y don't propagate)
+		return beta == R{} ? alpha * product : alpha * product + beta * y;
+	}
+
+	// out[r] = sum(rows[r][j] * x[j]) for j in [0, n)
+	template<std::size_t Count, typename T>
+	void dot_rows_portable(const T* const* rows, const T* x, std::size_t n, T* out) noexcept
+	{
+		T sums[Count]{};
+		for (std::size_t j = 0; j < n; ++j)
+		{
+			for (std::size_t r = 0; r < Count; ++r)
+			{
+				sums[r] += rows[r][j] * x[j];
+			}
+		}
+		std::copy_n(sums, Count, out);
+	}
+
+	// y[i] += sum(columns[c][i] * factors[c]) for i in [0, m), columns in order
+	template<std::size_t Count, typename T>
+	void axpy_columns_portable(const T* const* columns, const T* factors, T* y, std::size_t m) noexcept
+	{
+		for (std::size_t i = 0; i < m; ++i)
+		{
+			T value = y[i];
+			for (std::size_t c = 0; c < Count; ++c)
+			{
+				value += columns[c][i] * factors[c];
+			}
+			y[i] = value;
+		}
+	}
+
+#if MATHLBR_SIMD_X86
+	template<typename T>
+	struct avx2;
+
+	template<>
+	struct avx2<double>
+	{
+		using register_type = __m256d;
+		static constexpr std::size_t width = 4;
+
+		MATHLBR_TARGET("avx2,fma") static __m256d zero() noexcept { return _mm256_setzero_pd(); }
+		MATHLBR_TARGET("avx2,fma") static __m256d broadcast(double value) noexcept { return _mm256_set1_pd(value); }
+		MATHLBR_TARGET("avx2,fma") static __m256d load(const double* data) noexcept { return _mm256_loadu_pd(data); }
+		MATHLBR_TARGET("avx2,fma") static void store(double* data, __m256d value) noexcept { _mm256_storeu_pd(data, value); }
+		MATHLBR_TARGET("avx2,fma") static __m256d fmadd(__m256d a, __m256d b, __m256d c) noexcept { return _mm256_fmadd_pd(a, b, c); }
+		MATHLBR_TARGET("avx2,fma") static __m256d add(__m256d a, __m256d b) noexcept { return _mm256_add_pd(a, b); }
+		MATHLBR_TARGET("avx2,fma") static double sum(__m256d value) noexcept { return detail::simd::hsum_avx(value); }
+
+		// The first min(count, width) lanes
+		MATHLBR_TARGET("avx2,fma") static __m256i mask(std::size_t count) noexcept
+		{
+			return _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(count)), _mm256_setr_epi64x(0, 1, 2, 3));
+		}
+		MATHLBR_TARGET("avx2,fma") static __m256d load(const double* data, __m256i mask) noexcept { return _mm256_maskload_pd(data, mask); }
+		MATHLBR_TARGET("avx2,fma") static void store(double* data, __m256i mask, __m256d value) noexcept { _mm256_maskstore_pd(data, mask, value); }
+	};
+
+	template<>
+	struct avx2<float>
+	{
+		using register_type = __m256;
+		static constexpr std::size_t width = 8;
+
+		MATHLBR_TARGET("avx2,fma") static __m256 zero() noexcept { return _mm256_setzero_ps(); }
+		MATHLBR_TARGET("avx2,fma") static __m256 broadcast(float value) noexcept { return _mm256_set1_ps(value); }
+		MATHLBR_TARGET("avx2,fma") static __m256 load(const float* data) noexcept { return _mm256_loadu_ps(data); }
+		MATHLBR_TARGET("avx2,fma") static void store(float* data, __m256 value) noexcept { _mm256_storeu_ps(data, value); }
+		MATHLBR_TARGET("avx2,fma") static __m256 fmadd(__m256 a, __m256 b, __m256 c) noexcept { return _mm256_fmadd_ps(a, b, c); }
+		MATHLBR_TARGET("avx2,fma") static __m256 add(__m256 a, __m256 b) noexcept { return _mm256_add_ps(a, b); }
+		MATHLBR_TARGET("avx2,fma") static float sum(__m256 value) noexcept { return detail::simd::hsum_avx(value); }
+
+		MATHLBR_TARGET("avx2,fma") static __m256i mask(std::size_t count) noexcept
+		{
+			return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(count < width ? count : width)),
+				_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+		}
+		MATHLBR_TARGET("avx2,fma") static __m256 load(const float* data, __m256i mask) noexcept { return _mm256_maskload_ps(data, mask); }
+		MATHLBR_TARGET("avx2,fma") static void store(float* data, __m256i mask, __m256 value) noexcept { _mm256_maskstore_ps(data, mask, value); }
+	};
+
+	// Two accumulators per row; the tail (less than two registers) is read with masked loads
+	template<std::size_t Count, typename T>
+	MATHLBR_TARGET("avx2,fma") void dot_rows_avx2(const T* const* rows, const T* x, std::size_t n, T* out) noexcept
+	{
+		using ops = avx2<T>;
+		constexpr std::size_t width = ops::width;
+		typename ops::register_type low[Count], high[Count];
+		MATHLBR_UNROLL
+		for (std::size_t r = 0; r < Count; ++r)
+		{
+			low[r] = ops::zero();
+			high[r] = ops::zero();
+		}
+
+		std::size_t j = 0;
+		for (; j + 2 * width <= n; j += 2 * width)
+		{
+			const auto x_low = ops::load(x + j);
+			const auto x_high = ops::load(x + j + width);
+			MATHLBR_UNROLL
+			for (std::size_t r = 0; r < Count; ++r)
+			{
+				low[r] = ops::fmadd(ops::load(rows[r] + j), x_low, low[r]);
+				high[r] = ops::fmadd(ops::load(rows[r] + j + width), x_high, high[r]);
+			}
+		}
+		if (j < n)
+		{
+			const std::size_t remaining = n - j;
+			const auto mask_low = ops::mask(remaining);
+			const auto mask_high = ops::mask(remaining > width ? remaining - width : 0);
+			const auto x_low = ops::load(x + j, mask_low);
+			const auto x_high = ops::load(x + j + width, mask_high);
+			MATHLBR_UNROLL
+			for (std::size_t r = 0; r < Count; ++r)
+			{
+				low[r] = ops::fmadd(ops::load(rows[r] + j, mask_low), x_low, low[r]);
+				high[r] = ops::fmadd(ops::load(rows[r] + j + width, mask_high), x_high, high[r]);
+			}
+		}
+		MATHLBR_UNROLL
+		for (std::size_t r = 0; r < Count; ++r)
+		{
+			out[r] = ops::sum(ops::add(low[r], high[r]));
+		}
+	}
+
+	// The tail is handled with masked loads and stores: every element of y goes through the same fused multiply-adds
+	template<std::size_t Count, typename T>
+	MATHLBR_TARGET("avx2,fma") void axpy_columns_avx2(const T* const* columns, const T* factors, T* y, std::size_t m) noexcept
+	{
+		using ops = avx2<T>;
+		constexpr std::size_t width = ops::width;
+		typename ops::register_type broadcast[Count];
+		MATHLBR_UNROLL
+		for (std::size_t c = 0; c < Count; ++c)
+		{
+			broadcast[c] = ops::broadcast(factors[c]);
+		}
+
+		std::size_t i = 0;
+		for (; i + width <= m; i += width)
+		{
+			auto value = ops::load(y + i);
+			MATHLBR_UNROLL
+			for (std::size_t c = 0; c < Count; ++c)
+			{
+				value = ops::fmadd(ops::load(columns[c] + i), broadcast[c], value);
+			}
+			ops::store(y + i, value);
+		}
+		if (i < m)
+		{
+			const auto mask = ops::mask(m - i);
+			auto value = ops::load(y + i, mask);
+			MATHLBR_UNROLL
+			for (std::size_t c = 0; c < Count; ++c)
+			{
+				value = ops::fmadd(ops::load(columns[c] + i, mask), broadcast[c], value);
+			}
+			ops::store(y + i, mask, value);
+		}
+	}
+#endif
+
+	template<std::size_t Count, typename T>
+	void dot_rows(const T* const* rows, const T* x, std::size_t n, T* out) noexcept
+	{
+#if MATHLBR_SIMD_X86
+		const auto level = detail::simd::simd_level();
+		if (level == MathLbr::SimdLevel::AVX2 or level == MathLbr::SimdLevel::AVX512)
+		{
+			return dot_rows_avx2<Count>(rows, x, n, out);
+		}
+#endif
+		dot_rows_portable<Count>(rows, x, n, out);
+	}
+
+	template<std::size_t Count, typename T>
+	void axpy_columns(const T* const* columns, const T* factors, T* y, std::size_t m) noexcept
+	{
+#if MATHLBR_SIMD_X86
+		const auto level = detail::simd::simd_level();
+		if (level == MathLbr::SimdLevel::AVX2 or level == MathLbr::SimdLevel::AVX512)
+		{
+			return axpy_columns_avx2<Count>(columns, factors, y, m);
+		}
+#endif
+		axpy_columns_portable<Count>(columns, factors, y, m);
+	}
+
+	// y[i] for i in [first, last), row i of op(A) starting at a + i * stride (contiguous, n elements)
+	template<concepts::simd_real_type T>
+	void contiguous_rows(const T* a, std::size_t stride, std::size_t n, const T* x, T alpha, T beta, T* y,
+		std::size_t first, std::size_t last) noexcept
+	{
+		const T* rows[group];
+		T products[group];
+		std::size_t i = first;
+		for (; i + group <= last; i += group)
+		{
+			for (std::size_t r = 0; r < group; ++r)
+			{
+				rows[r] = a + (i + r) * stride;
+			}
+			dot_rows<group>(rows, x, n, products);
+			for (std::size_t r = 0; r < group; ++r)
+			{
+				y[i + r] = update(alpha, products[r], beta, y[i + r]);
+			}
+		}
+		for (; i < last; ++i)
+		{
+			rows[0] = a + i * stride;
+			dot_rows<1>(rows, x, n, products);
+			y[i] = update(alpha, products[0], beta, y[i]);
+		}
+	}
+
+	// y[i] for i in [first, last), column j of op(A) starting at a + j * stride (contiguous)
+	template<concepts::simd_real_type T>
+	void contiguous_columns(const T* a, std::size_t stride, std::size_t n, const T* x, T alpha, T beta, T* y,
+		std::size_t first, std::size_t last) noexcept
+	{
+		for (std::size_t i = first; i < last; ++i)
+		{
+			y[i] = beta == T{} ? T{} : beta * y[i];
+		}
+
+		const T* columns[group];
+		T factors[group];
+		for (std::size_t block = first; block < last; block += row_block)
+		{
+			const std::size_t count = std::min(row_block, last - block);
+			std::size_t j = 0;
+			for (; j + group <= n; j += group)
+			{
+				for (std::size_t c = 0; c < group; ++c)
+				{
+					columns[c] = a + (j + c) * stride + block;
+					factors[c] = alpha * x[j + c];
+				}
+				axpy_columns<group>(columns, factors, y + block, count);
+			}
+			for (; j < n; ++j)
+			{
+				columns[0] = a + j * stride + block;
+				factors[0] = alpha * x[j];
+				axpy_columns<1>(columns, factors, y + block, count);
+			}
+		}
+	}
+
+	// y = alpha * op(A) * x + beta * y on the rows [first, last) of y. op(A) is m x n, stored as `a`
+	template<concepts::simd_real_type T>
+	void multiply(detail::gemm::strided<const T> a, std::size_t n, const T* x, T alpha, T beta, T* y, std::size_t first, std::size_t last) noexcept
+	{
+		if (a.col_stride == 1) contiguous_rows(a.data, a.row_stride, n, x, alpha, beta, y, first, last);
+		else contiguous_columns(a.data, a.col_stride, n, x, alpha, beta, y, first, last);
+	}
+
+	// Any type and storage
+	template<typename R, typename A, typename X, typename Y>
+	constexpr void multiply_generic(detail::gemm::strided<A> a, std::size_t m, std::size_t n, const X& x, R alpha, R beta, Y& y)
+	{
+		for (std::size_t i = 0; i < m; ++i)
+		{
+			R product{};
+			for (std::size_t j = 0; j < n; ++j)
+			{
+				product += static_cast<R>(a(i, j)) * static_cast<R>(x[j]);
+			}
+			y[i] = update<R>(alpha, product, beta, y[i]);
+		}
+	}
+
+	template<typename R, std::size_t Size>
+	constexpr MathLbr::vector<R, Size> make_result(std::size_t size)
+	{
+		if constexpr (concepts::dynamic_extent_enabled<Size>) return MathLbr::vector<R, Size>(size);
+		else return MathLbr::vector<R, Size>{};
+	}
+
+	template<typename T, std::size_t Rows, std::size_t Cols, MathLbr::Layout Order, typename Storage>
+	constexpr auto make_transposed(const MathLbr::matrix<T, Rows, Cols, Order, Storage>& matrix) noexcept
+	{
+		const auto strides = detail::gemm::make_strided(matrix);
+		return detail::gemm::strided<const T>{ strides.data, strides.col_stride, strides.row_stride };
+	}
+
+	// y = alpha * op(A) * x + beta * y, op(A) being m x n
+	template<typename Policy, typename A, typename X, typename Y>
+	constexpr void gemv([[maybe_unused]] const Policy& policy, detail::gemm::strided<const A> a, std::size_t m, std::size_t n,
+		const X& x, typename Y::value_type alpha, typename Y::value_type beta, Y& y, bool small)
+	{
+		using R = typename Y::value_type;
+		if constexpr (std::is_same_v<A, R> and std::is_same_v<typename X::value_type, R> and concepts::simd_real_type<R>
+			and concepts::contiguous_container<typename X::underlying_container>
+			and concepts::contiguous_container<typename Y::underlying_container>)
+		{
+			if (not std::is_constant_evaluated() and not small)
+			{
+				if constexpr (concepts::parallel_execution_policy<Policy>)
+				{
+					if (not detail::execution::use_serial_path(policy, m * n))
+					{
+						// Chunks of policy.chunk_size elements of A, in multiples of 8 rows
+						MathLbr::execution::parallel_policy rows_policy = policy;
+						rows_policy.chunk_size = (std::max<std::size_t>(detail::execution::chunk_size(policy) / std::max<std::size_t>(n, 1), 1) + 7) / 8 * 8;
+						return detail::execution::for_each_chunk(rows_policy, m, [&](std::size_t first, std::size_t last)
+							{
+								multiply(a, n, x.data(), alpha, beta, y.data(), first, last);
+							});
+					}
+				}
+				return multiply(a, n, x.data(), alpha, beta, y.data(), 0, m);
+			}
+		}
+		multiply_generic<R>(a, m, n, x, alpha, beta, y);
+	}
+}
+
+
+namespace MathLbr::Matrix
+{
+	// Type of lhs * rhs: extents Rows x Cols2, layout and storage of lhs
+	template<typename Lhs, typename Rhs>
+	using product_type = MathLbr::matrix<decltype(std::declval<typename Lhs::value_type>() * std::declval<typename Rhs::value_type>()),
+		Lhs::rows_extent, Rhs::cols_extent, Lhs::layout, typename Lhs::storage_type>;
+
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage>
+	constexpr auto transpose(const matrix<T, Rows, Cols, Order, Storage>& matrix)
+	{
+		return matrix.transpose();
+	}
+
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Inner, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Inner2, std::size_t Cols, Layout Order2, typename Storage2>
+	constexpr auto multiply(const matrix<T, Rows, Inner, Order, Storage>& lhs, const matrix<T2, Inner2, Cols, Order2, Storage2>& rhs)
+	{
+		using result_type = product_type<matrix<T, Rows, Inner, Order, Storage>, matrix<T2, Inner2, Cols, Order2, Storage2>>;
+		using R = typename result_type::value_type;
+		detail::assert_same_extent<Inner, Inner2>(lhs.cols(), rhs.rows());
+
+		// Small compile time extents: the plain loops are inlined with constant trip counts
+		constexpr bool small_fixed = concepts::are_sizes_compiletime<Rows, Cols> and concepts::dynamic_extent_disabled<Inner>
+			and Rows * Cols * Inner < detail::gemm::small_product;
+
+		result_type result(lhs.rows(), rhs.cols(), R{});
+		if (small_fixed or std::is_constant_evaluated())
+		{
+			detail::gemm::naive(lhs.rows(), rhs.cols(), lhs.cols(),
+				detail::gemm::make_strided(lhs), detail::gemm::make_strided(rhs), detail::gemm::make_strided(result));
+		}
+		else
+		{
+			detail::gemm::multiply(lhs.rows(), rhs.cols(), lhs.cols(),
+				detail::gemm::make_strided(lhs), detail::gemm::make_strided(rhs), detail::gemm::make_strided(result));
+		}
+		return result;
+	}
+
+	// Tiles of the result are computed in parallel: the result is the same as the serial overload's
+	template<concepts::execution_policy Policy,
+		concepts::underlying_vector_type T, std::size_t Rows, std::size_t Inner, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Inner2, std::size_t Cols, Layout Order2, typename Storage2>
+	auto multiply(Policy&& policy, const matrix<T, Rows, Inner, Order, Storage>& lhs, const matrix<T2, Inner2, Cols, Order2, Storage2>& rhs)
+	{
+		if constexpr (not concepts::parallel_execution_policy<Policy>)
+		{
+			return multiply(lhs, rhs);
+		}
+		else
+		{
+			using result_type = product_type<matrix<T, Rows, Inner, Order, Storage>, matrix<T2, Inner2, Cols, Order2, Storage2>>;
+			using R = typename result_type::value_type;
+			detail::assert_same_extent<Inner, Inner2>(lhs.cols(), rhs.rows());
+
+			result_type result(lhs.rows(), rhs.cols(), R{});
+			detail::gemm::multiply(policy, lhs.rows(), rhs.cols(), lhs.cols(),
+				detail::gemm::make_strided(lhs), detail::gemm::make_strided(rhs), detail::gemm::make_strided(result));
+			return result;
+		}
+	}
+
+	/*
+		y = alpha * A * x + beta * y (BLAS gemv). x needs A.cols() elements, y A.rows(). x and y must not overlap.
+		If beta is zero, y is only written.
+	*/
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Size2, typename Storage2,
+		concepts::underlying_vector_type T3, std::size_t Size3, typename Storage3>
+	constexpr void gemv(const T3& alpha, const matrix<T, Rows, Cols, Order, Storage>& a, const vector<T2, Size2, Storage2>& x,
+		const T3& beta, vector<T3, Size3, Storage3>& y)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<T>() * std::declval<T2>()), T3>)
+	{
+		detail::assert_same_extent<Cols, Size2>(a.cols(), x.size());
+		detail::assert_same_extent<Rows, Size3>(a.rows(), y.size());
+		detail::gemv::gemv(MathLbr::execution::seq, detail::gemm::make_strided(a), a.rows(), a.cols(), x, alpha, beta, y,
+			concepts::are_sizes_compiletime<Rows, Cols> and Rows * Cols <= detail::gemv::small_matrix);
+	}
+
+	// y = alpha * transpose(A) * x + beta * y. x needs A.rows() elements, y A.cols()
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Size2, typename Storage2,
+		concepts::underlying_vector_type T3, std::size_t Size3, typename Storage3>
+	constexpr void gemv_transposed(const T3& alpha, const matrix<T, Rows, Cols, Order, Storage>& a, const vector<T2, Size2, Storage2>& x,
+		const T3& beta, vector<T3, Size3, Storage3>& y)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<T>() * std::declval<T2>()), T3>)
+	{
+		detail::assert_same_extent<Rows, Size2>(a.rows(), x.size());
+		detail::assert_same_extent<Cols, Size3>(a.cols(), y.size());
+		detail::gemv::gemv(MathLbr::execution::seq, detail::gemv::make_transposed(a), a.cols(), a.rows(), x, alpha, beta, y,
+			concepts::are_sizes_compiletime<Rows, Cols> and Rows * Cols <= detail::gemv::small_matrix);
+	}
+
+	// Ranges of rows of y are computed in parallel: the result is the same as the serial overload's
+	template<concepts::execution_policy Policy,
+		concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Size2, typename Storage2,
+		concepts::underlying_vector_type T3, std::size_t Size3, typename Storage3>
+	void gemv(Policy&& policy, const T3& alpha, const matrix<T, Rows, Cols, Order, Storage>& a, const vector<T2, Size2, Storage2>& x,
+		const T3& beta, vector<T3, Size3, Storage3>& y)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<T>() * std::declval<T2>()), T3>)
+	{
+		detail::assert_same_extent<Cols, Size2>(a.cols(), x.size());
+		detail::assert_same_extent<Rows, Size3>(a.rows(), y.size());
+		detail::gemv::gemv(policy, detail::gemm::make_strided(a), a.rows(), a.cols(), x, alpha, beta, y,
+			concepts::are_sizes_compiletime<Rows, Cols> and Rows * Cols <= detail::gemv::small_matrix);
+	}
+
+	template<concepts::execution_policy Policy,
+		concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Size2, typename Storage2,
+		concepts::underlying_vector_type T3, std::size_t Size3, typename Storage3>
+	void gemv_transposed(Policy&& policy, const T3& alpha, const matrix<T, Rows, Cols, Order, Storage>& a, const vector<T2, Size2, Storage2>& x,
+		const T3& beta, vector<T3, Size3, Storage3>& y)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<T>() * std::declval<T2>()), T3>)
+	{
+		detail::assert_same_extent<Rows, Size2>(a.rows(), x.size());
+		detail::assert_same_extent<Cols, Size3>(a.cols(), y.size());
+		detail::gemv::gemv(policy, detail::gemv::make_transposed(a), a.cols(), a.rows(), x, alpha, beta, y,
+			concepts::are_sizes_compiletime<Rows, Cols> and Rows * Cols <= detail::gemv::small_matrix);
+	}
+
+	// A * x, as a vector of A.rows() elements
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Size2, typename Storage2>
+	constexpr auto multiply(const matrix<T, Rows, Cols, Order, Storage>& a, const vector<T2, Size2, Storage2>& x)
+	{
+		using R = decltype(std::declval<T>() * std::declval<T2>());
+		vector<R, Rows> result = detail::gemv::make_result<R, Rows>(a.rows());
+		gemv(R{ 1 }, a, x, R{}, result);
+		return result;
+	}
+
+	template<concepts::execution_policy Policy,
+		concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Size2, typename Storage2>
+	auto multiply(Policy&& policy, const matrix<T, Rows, Cols, Order, Storage>& a, const vector<T2, Size2, Storage2>& x)
+	{
+		using R = decltype(std::declval<T>() * std::declval<T2>());
+		vector<R, Rows> result = detail::gemv::make_result<R, Rows>(a.rows());
+		gemv(policy, R{ 1 }, a, x, R{}, result);
+		return result;
+	}
+}
+
+
+namespace MathLbr
+{
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Inner, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Inner2, std::size_t Cols, Layout Order2, typename Storage2>
+	constexpr auto operator*(const matrix<T, Rows, Inner, Order, Storage>& lhs, const matrix<T2, Inner2, Cols, Order2, Storage2>& rhs)
+	{
+		return Matrix::multiply(lhs, rhs);
+	}
+
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Size2, typename Storage2>
+	constexpr auto operator*(const matrix<T, Rows, Cols, Order, Storage>& lhs, const vector<T2, Size2, Storage2>& rhs)
+	{
+		return Matrix::multiply(lhs, rhs);
+	}
+}
+
+#endif
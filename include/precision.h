@@ -0,0 +1,40 @@
+#ifndef PRECISION_HEADER
+#define PRECISION_HEADER
+
+#include <type_traits>
+
+
+namespace MathLbr::precision
+{
+	// sin, cos, atan2, acos of <cmath> (correctly rounded or close to it)
+	struct exact_policy {};
+
+	/*
+		Short polynomial approximations, inlined and vectorizable, with a bounded error (documentation/vector/fast_math.md):
+		about 1e-8 relative error for double, a few ulp for float. Constant evaluation always uses the exact functions.
+	*/
+	struct fast_policy {};
+
+	inline constexpr exact_policy exact{};
+	inline constexpr fast_policy fast{};
+
+	// Policy of the overloads without a precision policy: define MATHLBR_FAST_MATH to make them fast
+#ifdef MATHLBR_FAST_MATH
+	using default_policy = fast_policy;
+#else
+	using default_policy = exact_policy;
+#endif
+}
+
+
+namespace concepts
+{
+	template<typename T>
+	concept precision_policy = std::is_same_v<std::remove_cvref_t<T>, MathLbr::precision::exact_policy>
+		or std::is_same_v<std::remove_cvref_t<T>, MathLbr::precision::fast_policy>;
+
+	template<typename T>
+	concept fast_precision_policy = std::is_same_v<std::remove_cvref_t<T>, MathLbr::precision::fast_policy>;
+}
+
+#endif
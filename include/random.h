@@ -0,0 +1,354 @@
+#ifndef RANDOM_HEADER
+#define RANDOM_HEADER
+
+#include "vector.h"
+#include "execution.h"
+#include "constexpr_math.h"
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <type_traits>
+
+
+namespace detail::random
+{
+	// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11)
+	inline constexpr std::uint32_t philox_m0 = 0xD2511F53;
+	inline constexpr std::uint32_t philox_m1 = 0xCD9E8D57;
+	inline constexpr std::uint32_t philox_w0 = 0x9E3779B9;
+	inline constexpr std::uint32_t philox_w1 = 0xBB67AE85;
+	inline constexpr std::size_t philox_rounds = 10;
+
+	// Number of consecutive blocks generated together. Lanes are independent, so the loops below are vectorized by the compiler
+	// (smaller batches get fully unrolled instead, which prevents the vectorization of the rounds)
+	inline constexpr std::size_t batch_size = 64;
+
+	using block = std::array<std::uint32_t, 4>;
+
+	constexpr block philox(block counter, std::uint64_t key) noexcept
+	{
+		auto k0 = static_cast<std::uint32_t>(key);
+		auto k1 = static_cast<std::uint32_t>(key >> 32);
+		for (std::size_t round = 0; round < philox_rounds; ++round)
+		{
+			const std::uint64_t p0 = std::uint64_t{ philox_m0 } * counter[0];
+			const std::uint64_t p1 = std::uint64_t{ philox_m1 } * counter[2];
+			counter = { static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^ k0, static_cast<std::uint32_t>(p1),
+				static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^ k1, static_cast<std::uint32_t>(p0) };
+			k0 += philox_w0;
+			k1 += philox_w1;
+		}
+		return counter;
+	}
+
+	// words[w][lane] = word w of philox({ first_block + lane, stream }, key), structure of arrays
+	constexpr void philox_batch(std::uint64_t first_block, std::uint64_t stream, std::uint64_t key,
+		std::uint32_t (&words)[4][batch_size]) noexcept
+	{
+		std::uint32_t c0[batch_size], c1[batch_size], c2[batch_size], c3[batch_size];
+		for (std::size_t lane = 0; lane < batch_size; ++lane)
+		{
+			c0[lane] = static_cast<std::uint32_t>(first_block + lane);
+			c1[lane] = static_cast<std::uint32_t>((first_block + lane) >> 32);
+			c2[lane] = static_cast<std::uint32_t>(stream);
+			c3[lane] = static_cast<std::uint32_t>(stream >> 32);
+		}
+
+		auto k0 = static_cast<std::uint32_t>(key);
+		auto k1 = static_cast<std::uint32_t>(key >> 32);
+		for (std::size_t round = 0; round < philox_rounds; ++round)
+		{
+			for (std::size_t lane = 0; lane < batch_size; ++lane)
+			{
+				const std::uint64_t p0 = std::uint64_t{ philox_m0 } * c0[lane];
+				const std::uint64_t p1 = std::uint64_t{ philox_m1 } * c2[lane];
+				const std::uint32_t n0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1[lane] ^ k0;
+				const std::uint32_t n2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3[lane] ^ k1;
+				c0[lane] = n0;
+				c1[lane] = static_cast<std::uint32_t>(p1);
+				c2[lane] = n2;
+				c3[lane] = static_cast<std::uint32_t>(p0);
+			}
+			k0 += philox_w0;
+			k1 += philox_w1;
+		}
+
+		for (std::size_t lane = 0; lane < batch_size; ++lane)
+		{
+			words[0][lane] = c0[lane];
+			words[1][lane] = c1[lane];
+			words[2][lane] = c2[lane];
+			words[3][lane] = c3[lane];
+		}
+	}
+
+	// 32 bits words needed for one uniform real number: 24 significant bits for float, 53 for double
+	template<typename R>
+	inline constexpr std::size_t words_per_real = sizeof(R) > sizeof(std::uint32_t) ? 2 : 1;
+
+	// Uniform number in [0, 1)
+	template<typename R>
+	constexpr R canonical(const std::uint32_t* words) noexcept
+	{
+		if constexpr (words_per_real<R> == 1)
+		{
+			return static_cast<R>(words[0] >> 8) * static_cast<R>(0x1.0p-24);
+		}
+		else
+		{
+			const std::uint64_t bits = (std::uint64_t{ words[1] } << 32) | words[0];
+			return static_cast<R>(bits >> 11) * static_cast<R>(0x1.0p-53);
+		}
+	}
+
+	template<typename T>
+	struct distribution_real
+	{
+		using type = T;
+	};
+
+	template<typename T>
+	struct distribution_real<std::complex<T>>
+	{
+		using type = T;
+	};
+}
+
+
+namespace concepts
+{
+	template<typename T>
+	concept random_vector_type = std::is_floating_point_v<typename detail::random::distribution_real<T>::type>
+		and (std::is_floating_point_v<T> or is_complex<T>::value);
+
+	// Maps Distribution::words random 32 bits words to a value of type Distribution::result_type
+	template<typename Distribution>
+	concept vector_distribution = requires(const Distribution& distribution, const std::uint32_t* words)
+	{
+		typename Distribution::result_type;
+		{ Distribution::words } -> std::convertible_to<std::size_t>;
+		{ distribution(words) } -> std::convertible_to<typename Distribution::result_type>;
+	} and (4 % Distribution::words == 0);
+}
+
+
+namespace MathLbr::random
+{
+	/*
+		Counter-based random number engine (Philox4x32-10): the n-th number only depends on (seed, stream, n),
+		so streams never overlap and any position can be reached in constant time (discard).
+		Satisfies std::uniform_random_bit_generator, so it can be used with the distributions of <random> as well.
+		Unlike a shared engine, each thread should own its engine (e.g. one stream per thread).
+	*/
+	class philox_engine
+	{
+	public:
+		using result_type = std::uint32_t;
+
+	private:
+		std::uint64_t _seed = 0;
+		std::uint64_t _stream = 0;
+		std::uint64_t _block = 0;
+		detail::random::block _words{};
+		std::size_t _index = 4; // next word of _words, 4: a new block is needed
+
+	public:
+		constexpr philox_engine() noexcept = default;
+
+		constexpr explicit philox_engine(std::uint64_t seed, std::uint64_t stream = 0) noexcept
+			: _seed(seed), _stream(stream)
+		{
+		}
+
+		static constexpr result_type min() noexcept
+		{
+			return 0;
+		}
+
+		static constexpr result_type max() noexcept
+		{
+			return std::numeric_limits<result_type>::max();
+		}
+
+		constexpr result_type operator()() noexcept
+		{
+			if (_index == 4)
+			{
+				_words = block(_block++);
+				_index = 0;
+			}
+			return _words[_index++];
+		}
+
+		constexpr void discard(std::uint64_t count) noexcept
+		{
+			const std::uint64_t position = (_block - (_index == 4 ? 0 : 1)) * 4 + (_index == 4 ? 0 : _index) + count;
+			_block = position / 4;
+			_index = 4;
+			for (std::uint64_t i = 0; i < position % 4; ++i)
+			{
+				(*this)();
+			}
+		}
+
+		// Philox block number `index` of this stream: the words index * 4 to index * 4 + 3 of the sequence
+		constexpr detail::random::block block(std::uint64_t index) const noexcept
+		{
+			return detail::random::philox({ static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32),
+				static_cast<std::uint32_t>(_stream), static_cast<std::uint32_t>(_stream >> 32) }, _seed);
+		}
+
+		constexpr std::uint64_t seed() const noexcept
+		{
+			return _seed;
+		}
+
+		constexpr std::uint64_t stream() const noexcept
+		{
+			return _stream;
+		}
+
+		friend constexpr bool operator==(const philox_engine& lhs, const philox_engine& rhs) noexcept = default;
+	};
+
+
+	// Uniform values in [lower, higher). Complex values: real and imaginary parts are independent and both in [lower, higher)
+	template<concepts::random_vector_type T>
+	struct uniform_distribution
+	{
+		using result_type = T;
+		using real_type = typename detail::random::distribution_real<T>::type;
+		static constexpr std::size_t words = detail::random::words_per_real<real_type> * (concepts::is_complex<T>::value ? 2 : 1);
+
+		real_type lower = 0;
+		real_type higher = 1;
+
+		constexpr result_type operator()(const std::uint32_t* random_words) const noexcept
+		{
+			const auto map = [this](const std::uint32_t* w)
+			{
+				return lower + (higher - lower) * detail::random::canonical<real_type>(w);
+			};
+			if constexpr (concepts::is_complex<T>::value)
+			{
+				return result_type(map(random_words), map(random_words + detail::random::words_per_real<real_type>));
+			}
+			else return map(random_words);
+		}
+	};
+
+	// Normal values of the given mean and standard deviation (Box-Muller transform).
+	// Complex values: real and imaginary parts are independent, each with the given mean and standard deviation
+	template<concepts::random_vector_type T>
+	struct normal_distribution
+	{
+		using result_type = T;
+		using real_type = typename detail::random::distribution_real<T>::type;
+		static constexpr std::size_t words = 2 * detail::random::words_per_real<real_type>;
+
+		real_type mean = 0;
+		real_type stddev = 1;
+
+		constexpr result_type operator()(const std::uint32_t* random_words) const
+		{
+			// 1 - u is in (0, 1], so the logarithm is always finite
+			const real_type u1 = 1 - detail::random::canonical<real_type>(random_words);
+			const real_type u2 = detail::random::canonical<real_type>(random_words + detail::random::words_per_real<real_type>);
+			const real_type radius = stddev * detail::math::sqrt(-2 * detail::math::log(u1));
+			const real_type angle = 2 * std::numbers::pi_v<real_type> * u2;
+			if constexpr (concepts::is_complex<T>::value)
+			{
+				return result_type(mean + radius * detail::math::cos(angle), mean + radius * detail::math::sin(angle));
+			}
+			else return mean + radius * detail::math::cos(angle);
+		}
+	};
+}
+
+
+namespace detail::random
+{
+	// Element i consumes the words [i * words, (i + 1) * words) of the stream, which makes its value independent
+	// from how the vector is split between threads
+	template<typename Vector, typename Distribution>
+	constexpr void fill_range(Vector& vector, const Distribution& distribution, std::uint64_t seed, std::uint64_t stream,
+		std::size_t first, std::size_t last)
+	{
+		constexpr std::size_t words = Distribution::words;
+		constexpr std::size_t per_block = 4 / words;
+		using result_type = typename Distribution::result_type;
+
+		std::uint32_t batch[4][batch_size];
+		result_type values[batch_size * per_block];
+		for (std::size_t i = first; i < last;)
+		{
+			const std::uint64_t first_block = i / per_block;
+			philox_batch(first_block, stream, seed, batch);
+
+			// Lane-wise loops, so that the distribution is vectorized as well
+			for (std::size_t k = 0; k < per_block; ++k)
+			{
+				for (std::size_t lane = 0; lane < batch_size; ++lane)
+				{
+					std::uint32_t element_words[words];
+					for (std::size_t w = 0; w < words; ++w)
+					{
+						element_words[w] = batch[k * words + w][lane];
+					}
+					values[lane * per_block + k] = distribution(element_words);
+				}
+			}
+
+			const std::size_t offset = i - first_block * per_block;
+			const std::size_t count = std::min<std::size_t>(last - i, batch_size * per_block - offset);
+			for (std::size_t j = 0; j < count; ++j)
+			{
+				vector[i + j] = values[offset + j];
+			}
+			i += count;
+		}
+	}
+}
+
+
+namespace MathLbr::random
+{
+	/*
+		Fills other with values drawn from distribution. The result only depends on (seed, stream): the same arguments
+		always give the same vector, with any execution policy and number of threads. Different streams are independent.
+		Usable in constant expressions, e.g. to build tables of random vectors at compile time.
+	*/
+	template<concepts::underlying_vector_type T, std::size_t Size, typename Storage, concepts::vector_distribution Distribution>
+	constexpr void fill(vector<T, Size, Storage>& other, const Distribution& distribution, std::uint64_t seed, std::uint64_t stream = 0)
+	requires (std::is_same_v<typename Distribution::result_type, T>)
+	{
+		detail::random::fill_range(other, distribution, seed, stream, 0, other.size());
+	}
+
+	template<concepts::execution_policy Policy, concepts::underlying_vector_type T, std::size_t Size, typename Storage,
+		concepts::vector_distribution Distribution>
+	void fill(const Policy& policy, vector<T, Size, Storage>& other, const Distribution& distribution, std::uint64_t seed,
+		std::uint64_t stream = 0)
+	requires (std::is_same_v<typename Distribution::result_type, T>)
+	{
+		if constexpr (concepts::parallel_execution_policy<Policy>)
+		{
+			if (not detail::execution::use_serial_path(policy, other.size()))
+			{
+				detail::execution::for_each_chunk(policy, other.size(), [&](std::size_t first, std::size_t last)
+					{
+						detail::random::fill_range(other, distribution, seed, stream, first, last);
+					});
+				return;
+			}
+		}
+		fill(other, distribution, seed, stream);
+	}
+}
+
+#endif
@@ -0,0 +1,373 @@
+#ifndef ROTATION_HEADER
+#define ROTATION_HEADER
+
+#include "matrix.h"
+#include "vector_batch.h"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+#include <type_traits>
+
+
+/*
+	Precomputed rotations of 3D vectors: rotation<T> (a 3x3 orthonormal matrix) and quaternion<T> (a unit quaternion).
+	Sines and cosines are evaluated once, when the rotation is built: applying it is only multiplications and additions,
+	to a single vector, to a range of vectors, or to a vector_batch (vectorized, structure of arrays).
+	Angles are in radians, rotations are counterclockwise around the axis (right-hand rule), like vector::rotate_around_*.
+*/
+
+namespace MathLbr
+{
+	template<std::floating_point T>
+	class quaternion;
+
+	template<std::floating_point T>
+	class rotation
+	{
+	public:
+		using size_type = std::size_t;
+		using value_type = T;
+		using matrix_type = matrix<T, 3, 3>;
+
+	private:
+		matrix_type _matrix = matrix_type::identity();
+
+		static constexpr size_type batch_block_size = 256;
+
+		// Blocked like vector_batch::normalize: length is a constant for the full blocks
+		template<typename Length>
+		void rotate_block(T* x, T* y, T* z, Length length) const noexcept
+		{
+			const T r00 = _matrix(0, 0), r01 = _matrix(0, 1), r02 = _matrix(0, 2);
+			const T r10 = _matrix(1, 0), r11 = _matrix(1, 1), r12 = _matrix(1, 2);
+			const T r20 = _matrix(2, 0), r21 = _matrix(2, 1), r22 = _matrix(2, 2);
+			// The results go to local arrays first: they can't alias the components, so the loop needs no runtime checks
+			T rotated_x[batch_block_size], rotated_y[batch_block_size], rotated_z[batch_block_size];
+			for (size_type i = 0; i < length; ++i)
+			{
+				rotated_x[i] = r00 * x[i] + r01 * y[i] + r02 * z[i];
+				rotated_y[i] = r10 * x[i] + r11 * y[i] + r12 * z[i];
+				rotated_z[i] = r20 * x[i] + r21 * y[i] + r22 * z[i];
+			}
+			std::copy_n(rotated_x, static_cast<size_type>(length), x);
+			std::copy_n(rotated_y, static_cast<size_type>(length), y);
+			std::copy_n(rotated_z, static_cast<size_type>(length), z);
+		}
+
+	public:
+		// Identity
+		constexpr rotation() = default;
+
+		// The matrix must be orthonormal with determinant 1 (this is not checked)
+		constexpr explicit rotation(const matrix_type& matrix) noexcept
+			: _matrix(matrix)
+		{
+		}
+
+		static constexpr rotation around_x(T angle)
+		{
+			const T cos = detail::math::cos(angle), sin = detail::math::sin(angle);
+			return rotation(matrix_type{ {1, 0, 0}, {0, cos, -sin}, {0, sin, cos} });
+		}
+
+		static constexpr rotation around_y(T angle)
+		{
+			const T cos = detail::math::cos(angle), sin = detail::math::sin(angle);
+			return rotation(matrix_type{ {cos, 0, sin}, {0, 1, 0}, {-sin, 0, cos} });
+		}
+
+		static constexpr rotation around_z(T angle)
+		{
+			const T cos = detail::math::cos(angle), sin = detail::math::sin(angle);
+			return rotation(matrix_type{ {cos, -sin, 0}, {sin, cos, 0}, {0, 0, 1} });
+		}
+
+		// Rotation of `angle` around `axis`, which doesn't need to be normalized (but must not be zero)
+		template<concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		static constexpr rotation around_axis(const vector<T2, Size, Storage>& axis, T angle)
+		{
+			return quaternion<T>::around_axis(axis, angle).to_rotation();
+		}
+
+		constexpr const matrix_type& to_matrix() const noexcept
+		{
+			return _matrix;
+		}
+
+		constexpr quaternion<T> to_quaternion() const noexcept
+		{
+			return quaternion<T>::from_rotation(*this);
+		}
+
+		// The inverse of an orthonormal matrix is its transpose
+		constexpr rotation inverse() const noexcept
+		{
+			return rotation(_matrix.transpose());
+		}
+
+		// Composition: (lhs * rhs).rotate(v) == lhs.rotate(rhs.rotate(v))
+		friend constexpr rotation operator*(const rotation& lhs, const rotation& rhs)
+		{
+			return rotation(lhs._matrix * rhs._matrix);
+		}
+
+		template<concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		constexpr vector<T, 3> rotate(const vector<T2, Size, Storage>& other) const
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, T>)
+		{
+			detail::dispatch_assert_equals<Size, 3>(other.size());
+			const T x = other[0], y = other[1], z = other[2];
+			return vector<T, 3>{ {
+				_matrix(0, 0) * x + _matrix(0, 1) * y + _matrix(0, 2) * z,
+				_matrix(1, 0) * x + _matrix(1, 1) * y + _matrix(1, 2) * z,
+				_matrix(2, 0) * x + _matrix(2, 1) * y + _matrix(2, 2) * z } };
+		}
+
+		// Rotates every vector of [first, last) in place. The components are written back one by one,
+		// so the vectors keep their type (dynamic vectors of size 3 included)
+		template<std::forward_iterator Iter>
+		constexpr void rotate(Iter first, Iter last) const
+		requires (concepts::is_vector<typename std::iterator_traits<Iter>::value_type>::value)
+		{
+			using element_type = typename std::iterator_traits<Iter>::value_type::value_type;
+			for (; first != last; ++first)
+			{
+				auto& current = *first;
+				const vector<T, 3> rotated = rotate(current);
+				current[0] = static_cast<element_type>(rotated[0]);
+				current[1] = static_cast<element_type>(rotated[1]);
+				current[2] = static_cast<element_type>(rotated[2]);
+			}
+		}
+
+		// Rotates every vector of the batch in place, by blocks of batch_block_size vectors
+		void rotate(vector_batch<T, 3>& batch) const noexcept
+		{
+			T* x = batch.x();
+			T* y = batch.y();
+			T* z = batch.z();
+			const size_type count = batch.size();
+			size_type first = 0;
+			for (; first + batch_block_size <= count; first += batch_block_size)
+			{
+				rotate_block(x + first, y + first, z + first, std::integral_constant<size_type, batch_block_size>{});
+			}
+			if (first < count) rotate_block(x + first, y + first, z + first, count - first);
+		}
+
+		constexpr bool operator==(const rotation& rhs) const = default;
+
+		friend std::ostream& operator<< (std::ostream& stream, const rotation& rhs)
+		{
+			return stream << rhs._matrix;
+		}
+	};
+
+
+	// Unit quaternion w + xi + yj + zk. Compositions of many rotations drift less than with matrices: see normalize()
+	template<std::floating_point T>
+	class quaternion
+	{
+	public:
+		using value_type = T;
+
+	private:
+		T _w = 1;
+		T _x = 0;
+		T _y = 0;
+		T _z = 0;
+
+	public:
+		// Identity
+		constexpr quaternion() = default;
+
+		constexpr quaternion(T w, T x, T y, T z) noexcept
+			: _w(w), _x(x), _y(y), _z(z)
+		{
+		}
+
+		template<concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		static constexpr quaternion around_axis(const vector<T2, Size, Storage>& axis, T angle)
+		{
+			detail::dispatch_assert_equals<Size, 3>(axis.size());
+			const T length = detail::math::sqrt(static_cast<T>(axis[0]) * axis[0] + static_cast<T>(axis[1]) * axis[1]
+				+ static_cast<T>(axis[2]) * axis[2]);
+			detail::assert_div_byzero<T>(length);
+			const T sin = detail::math::sin(angle / 2) / length;
+			return quaternion(detail::math::cos(angle / 2), sin * axis[0], sin * axis[1], sin * axis[2]);
+		}
+
+		static constexpr quaternion around_x(T angle)
+		{
+			return quaternion(detail::math::cos(angle / 2), detail::math::sin(angle / 2), 0, 0);
+		}
+
+		static constexpr quaternion around_y(T angle)
+		{
+			return quaternion(detail::math::cos(angle / 2), 0, detail::math::sin(angle / 2), 0);
+		}
+
+		static constexpr quaternion around_z(T angle)
+		{
+			return quaternion(detail::math::cos(angle / 2), 0, 0, detail::math::sin(angle / 2));
+		}
+
+		// Shepperd's method: the largest of the four candidates is used, so that the square root is well conditioned
+		static constexpr quaternion from_rotation(const rotation<T>& other) noexcept
+		{
+			const auto& m = other.to_matrix();
+			const T trace = m(0, 0) + m(1, 1) + m(2, 2);
+			if (trace >= m(0, 0) and trace >= m(1, 1) and trace >= m(2, 2))
+			{
+				const T s = 2 * detail::math::sqrt(1 + trace);
+				return quaternion(s / 4, (m(2, 1) - m(1, 2)) / s, (m(0, 2) - m(2, 0)) / s, (m(1, 0) - m(0, 1)) / s);
+			}
+			if (m(0, 0) >= m(1, 1) and m(0, 0) >= m(2, 2))
+			{
+				const T s = 2 * detail::math::sqrt(1 + m(0, 0) - m(1, 1) - m(2, 2));
+				return quaternion((m(2, 1) - m(1, 2)) / s, s / 4, (m(0, 1) + m(1, 0)) / s, (m(0, 2) + m(2, 0)) / s);
+			}
+			if (m(1, 1) >= m(2, 2))
+			{
+				const T s = 2 * detail::math::sqrt(1 + m(1, 1) - m(0, 0) - m(2, 2));
+				return quaternion((m(0, 2) - m(2, 0)) / s, (m(0, 1) + m(1, 0)) / s, s / 4, (m(1, 2) + m(2, 1)) / s);
+			}
+			const T s = 2 * detail::math::sqrt(1 + m(2, 2) - m(0, 0) - m(1, 1));
+			return quaternion((m(1, 0) - m(0, 1)) / s, (m(0, 2) + m(2, 0)) / s, (m(1, 2) + m(2, 1)) / s, s / 4);
+		}
+
+		constexpr T w() const noexcept { return _w; }
+		constexpr T x() const noexcept { return _x; }
+		constexpr T y() const noexcept { return _y; }
+		constexpr T z() const noexcept { return _z; }
+
+		constexpr T norm() const noexcept
+		{
+			return detail::math::sqrt(dot(*this, *this));
+		}
+
+		// Rounding errors of long chains of compositions make the norm drift away from 1
+		constexpr quaternion& normalize() noexcept
+		{
+			const T length = norm();
+			detail::assert_div_byzero<T>(length);
+			_w /= length;
+			_x /= length;
+			_y /= length;
+			_z /= length;
+			return *this;
+		}
+
+		// Inverse rotation (the inverse of a unit quaternion is its conjugate)
+		constexpr quaternion conjugate() const noexcept
+		{
+			return quaternion(_w, -_x, -_y, -_z);
+		}
+
+		friend constexpr T dot(const quaternion& lhs, const quaternion& rhs) noexcept
+		{
+			return lhs._w * rhs._w + lhs._x * rhs._x + lhs._y * rhs._y + lhs._z * rhs._z;
+		}
+
+		// Hamilton product, composition: (lhs * rhs).rotate(v) == lhs.rotate(rhs.rotate(v))
+		friend constexpr quaternion operator*(const quaternion& lhs, const quaternion& rhs) noexcept
+		{
+			return quaternion(
+				lhs._w * rhs._w - lhs._x * rhs._x - lhs._y * rhs._y - lhs._z * rhs._z,
+				lhs._w * rhs._x + lhs._x * rhs._w + lhs._y * rhs._z - lhs._z * rhs._y,
+				lhs._w * rhs._y - lhs._x * rhs._z + lhs._y * rhs._w + lhs._z * rhs._x,
+				lhs._w * rhs._z + lhs._x * rhs._y - lhs._y * rhs._x + lhs._z * rhs._w);
+		}
+
+		// The quaternion must be normalized
+		constexpr rotation<T> to_rotation() const noexcept
+		{
+			const T xx = _x * _x, yy = _y * _y, zz = _z * _z;
+			const T xy = _x * _y, xz = _x * _z, yz = _y * _z;
+			const T wx = _w * _x, wy = _w * _y, wz = _w * _z;
+			return rotation<T>(matrix<T, 3, 3>{
+				{1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy)},
+				{2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx)},
+				{2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy)} });
+		}
+
+		// v + 2w(u x v) + 2u x (u x v), u = (x, y, z): cheaper than building the matrix for a single vector
+		template<concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		constexpr vector<T, 3> rotate(const vector<T2, Size, Storage>& other) const
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, T>)
+		{
+			detail::dispatch_assert_equals<Size, 3>(other.size());
+			const T x = other[0], y = other[1], z = other[2];
+			const T tx = 2 * (_y * z - _z * y);
+			const T ty = 2 * (_z * x - _x * z);
+			const T tz = 2 * (_x * y - _y * x);
+			return vector<T, 3>{ {
+				x + _w * tx + (_y * tz - _z * ty),
+				y + _w * ty + (_z * tx - _x * tz),
+				z + _w * tz + (_x * ty - _y * tx) } };
+		}
+
+		// Many vectors: the matrix is built once
+		template<std::forward_iterator Iter>
+		constexpr void rotate(Iter first, Iter last) const
+		requires (concepts::is_vector<typename std::iterator_traits<Iter>::value_type>::value)
+		{
+			to_rotation().rotate(first, last);
+		}
+
+		void rotate(vector_batch<T, 3>& batch) const noexcept
+		{
+			to_rotation().rotate(batch);
+		}
+
+		constexpr bool operator==(const quaternion& rhs) const = default;
+
+		friend std::ostream& operator<< (std::ostream& stream, const quaternion& rhs)
+		{
+			return stream << rhs._w << ' ' << rhs._x << ' ' << rhs._y << ' ' << rhs._z << '\n';
+		}
+	};
+}
+
+
+namespace MathLbr::Rotation
+{
+	/*
+		Spherical linear interpolation between two unit quaternions: constant angular velocity, from `from` (t = 0)
+		to `to` (t = 1), along the shortest path. Nearly equal orientations are interpolated linearly and normalized,
+		where the sine of the angle between them is too small to divide by.
+	*/
+	template<std::floating_point T>
+	constexpr quaternion<T> slerp(const quaternion<T>& from, const quaternion<T>& to, T t)
+	{
+		T cos = dot(from, to);
+		// q and -q are the same rotation: the shortest path goes to the closest of both
+		const T sign = cos < 0 ? T{ -1 } : T{ 1 };
+		cos *= sign;
+
+		T from_weight = 1 - t;
+		T to_weight = t;
+		if (cos < T{ 0.9995 })
+		{
+			const T angle = detail::math::acos(cos);
+			const T sin = detail::math::sin(angle);
+			from_weight = detail::math::sin((1 - t) * angle) / sin;
+			to_weight = detail::math::sin(t * angle) / sin;
+		}
+		to_weight *= sign;
+		quaternion<T> result(from_weight * from.w() + to_weight * to.w(), from_weight * from.x() + to_weight * to.x(),
+			from_weight * from.y() + to_weight * to.y(), from_weight * from.z() + to_weight * to.z());
+		return result.normalize();
+	}
+
+	template<std::floating_point T>
+	constexpr rotation<T> slerp(const rotation<T>& from, const rotation<T>& to, T t)
+	{
+		return slerp(from.to_quaternion(), to.to_quaternion(), t).to_rotation();
+	}
+}
+
+#endif
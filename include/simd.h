@@ -0,0 +1,1100 @@
+#ifndef SIMD_HEADER
+#define SIMD_HEADER
+
+#include "half.h"
+
+#include <complex>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+/*
+	Explicitly vectorized kernels used internally by MathLbr.
+	Kernels for every instruction set are always compiled (through target attributes), and the best one
+	is selected once at runtime depending on the CPU. Define MATHLBR_DISABLE_SIMD to only use the portable kernels.
+*/
+
+#if !defined(MATHLBR_DISABLE_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#define MATHLBR_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define MATHLBR_TARGET(isa)
+#else
+#define MATHLBR_TARGET(isa) __attribute__((target(isa)))
+#endif
+#else
+#define MATHLBR_SIMD_X86 0
+#define MATHLBR_TARGET(isa)
+#endif
+
+// Fully unrolls the next loop (constant trip count), so that arrays of registers indexed by the loop stay in registers
+#if defined(__GNUC__) || defined(__clang__)
+#define MATHLBR_UNROLL _Pragma("GCC unroll 8")
+#else
+#define MATHLBR_UNROLL
+#endif
+
+// Forces inlining: portable code inlined into a MATHLBR_TARGET function is compiled for that instruction set
+#if defined(_MSC_VER) && !defined(__clang__)
+#define MATHLBR_INLINE __forceinline
+#else
+#define MATHLBR_INLINE inline __attribute__((always_inline))
+#endif
+
+// GCC 12 reports the _mm*_undefined_* values that its AVX-512 intrinsics (reductions, extractions, conversions) start from
+// as uninitialized once they're inlined: false positives, silenced around the AVX-512 kernels only
+#if defined(__GNUC__) && !defined(__clang__)
+#define MATHLBR_AVX512_BEGIN _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wuninitialized\"") \
+	_Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+#define MATHLBR_AVX512_END _Pragma("GCC diagnostic pop")
+#else
+#define MATHLBR_AVX512_BEGIN
+#define MATHLBR_AVX512_END
+#endif
+
+
+namespace MathLbr
+{
+	enum class SimdLevel
+	{
+		SCALAR, SSE2, AVX2, AVX512
+	};
+}
+
+
+namespace concepts
+{
+	template<typename T>
+	concept simd_real_type = std::is_same_v<T, float> or std::is_same_v<T, double>;
+
+	template<typename T>
+	concept simd_complex_type = std::is_same_v<T, std::complex<float>> or std::is_same_v<T, std::complex<double>>;
+
+	template<typename T>
+	concept simd_type = simd_real_type<T> or simd_complex_type<T>;
+
+	// 2D, 3D and 4D float/double vectors use the fixed-size kernels (detail::simd::fixed) instead of the dispatched ones
+	template<typename T, std::size_t Size>
+	concept simd_small_vector = simd_real_type<T> and Size >= 2 and Size <= 4;
+}
+
+
+namespace detail::simd
+{
+	inline MathLbr::SimdLevel detect_simd_level() noexcept
+	{
+#if MATHLBR_SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+		int info[4]{};
+		__cpuid(info, 0);
+		const int max_leaf = info[0];
+		__cpuid(info, 1);
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool fma = (info[2] & (1 << 12)) != 0;
+		const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+		const bool avx_os = (xcr0 & 0x6) == 0x6;
+		const bool avx512_os = (xcr0 & 0xE6) == 0xE6;
+		bool avx2 = false;
+		bool avx512f = false;
+		if (max_leaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+			avx512f = (info[1] & (1 << 16)) != 0;
+		}
+		if (avx512f && avx512_os) return MathLbr::SimdLevel::AVX512;
+		if (avx2 && fma && avx_os) return MathLbr::SimdLevel::AVX2;
+		return MathLbr::SimdLevel::SSE2;
+#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f")) return MathLbr::SimdLevel::AVX512;
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return MathLbr::SimdLevel::AVX2;
+		return MathLbr::SimdLevel::SSE2;
+#endif
+#else
+		return MathLbr::SimdLevel::SCALAR;
+#endif
+	}
+
+	// Detected only once, the result never changes during the execution of the program
+	inline MathLbr::SimdLevel simd_level() noexcept
+	{
+		static const MathLbr::SimdLevel level = detect_simd_level();
+		return level;
+	}
+
+	// F16C converts between float and binary16 (MathLbr::float16). Every CPU with AVX2 has it
+	inline bool detect_f16c() noexcept
+	{
+#if MATHLBR_SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+		int info[4]{};
+		__cpuid(info, 1);
+		return (info[2] & (1 << 29)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("f16c");
+#endif
+#else
+		return false;
+#endif
+	}
+
+	inline bool has_f16c() noexcept
+	{
+		static const bool supported = detect_f16c();
+		return supported;
+	}
+
+
+	// Portable kernels: four independent accumulators break the dependency chain of a sequential sum,
+	// which lets the compiler vectorize/pipeline them even without -ffast-math
+	template<concepts::simd_real_type T>
+	T dot_scalar(const T* lhs, const T* rhs, std::size_t count) noexcept
+	{
+		T acc0{}, acc1{}, acc2{}, acc3{};
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			acc0 += lhs[i] * rhs[i];
+			acc1 += lhs[i + 1] * rhs[i + 1];
+			acc2 += lhs[i + 2] * rhs[i + 2];
+			acc3 += lhs[i + 3] * rhs[i + 3];
+		}
+		for (; i < count; ++i)
+		{
+			acc0 += lhs[i] * rhs[i];
+		}
+		return (acc0 + acc1) + (acc2 + acc3);
+	}
+
+	// Computes sum(conj(lhs[i]) * rhs[i]). Both arrays are the interleaved (real, imag) representation of
+	// `count` std::complex values.
+	template<concepts::simd_real_type T>
+	std::complex<T> conj_dot_scalar(const T* lhs, const T* rhs, std::size_t count) noexcept
+	{
+		T real0{}, real1{}, imag0{}, imag1{};
+		std::size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+		{
+			real0 += lhs[2 * i] * rhs[2 * i] + lhs[2 * i + 1] * rhs[2 * i + 1];
+			imag0 += lhs[2 * i] * rhs[2 * i + 1] - lhs[2 * i + 1] * rhs[2 * i];
+			real1 += lhs[2 * i + 2] * rhs[2 * i + 2] + lhs[2 * i + 3] * rhs[2 * i + 3];
+			imag1 += lhs[2 * i + 2] * rhs[2 * i + 3] - lhs[2 * i + 3] * rhs[2 * i + 2];
+		}
+		for (; i < count; ++i)
+		{
+			real0 += lhs[2 * i] * rhs[2 * i] + lhs[2 * i + 1] * rhs[2 * i + 1];
+			imag0 += lhs[2 * i] * rhs[2 * i + 1] - lhs[2 * i + 1] * rhs[2 * i];
+		}
+		return { real0 + real1, imag0 + imag1 };
+	}
+
+	// Same as conj_dot_scalar, but real and imaginary parts are stored in separate arrays (split_complex_storage)
+	template<concepts::simd_real_type T>
+	std::complex<T> split_conj_dot_scalar(const T* lhs_real, const T* lhs_imag,
+		const T* rhs_real, const T* rhs_imag, std::size_t count) noexcept
+	{
+		T real0{}, real1{}, imag0{}, imag1{};
+		std::size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+		{
+			real0 += lhs_real[i] * rhs_real[i] + lhs_imag[i] * rhs_imag[i];
+			imag0 += lhs_real[i] * rhs_imag[i] - lhs_imag[i] * rhs_real[i];
+			real1 += lhs_real[i + 1] * rhs_real[i + 1] + lhs_imag[i + 1] * rhs_imag[i + 1];
+			imag1 += lhs_real[i + 1] * rhs_imag[i + 1] - lhs_imag[i + 1] * rhs_real[i + 1];
+		}
+		for (; i < count; ++i)
+		{
+			real0 += lhs_real[i] * rhs_real[i] + lhs_imag[i] * rhs_imag[i];
+			imag0 += lhs_real[i] * rhs_imag[i] - lhs_imag[i] * rhs_real[i];
+		}
+		return { real0 + real1, imag0 + imag1 };
+	}
+
+
+	// data[i] *= factor
+	template<concepts::simd_real_type T>
+	void scale_scalar(T* data, std::size_t count, T factor) noexcept
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			data[i] *= factor;
+		}
+	}
+
+	// 16 bits floating point numbers (half.h) are converted to float: products and sums are done in float
+	template<concepts::half_precision_type T>
+	float dot_scalar(const T* lhs, const T* rhs, std::size_t count) noexcept
+	{
+		float acc0{}, acc1{}, acc2{}, acc3{};
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			acc0 += static_cast<float>(lhs[i]) * static_cast<float>(rhs[i]);
+			acc1 += static_cast<float>(lhs[i + 1]) * static_cast<float>(rhs[i + 1]);
+			acc2 += static_cast<float>(lhs[i + 2]) * static_cast<float>(rhs[i + 2]);
+			acc3 += static_cast<float>(lhs[i + 3]) * static_cast<float>(rhs[i + 3]);
+		}
+		for (; i < count; ++i)
+		{
+			acc0 += static_cast<float>(lhs[i]) * static_cast<float>(rhs[i]);
+		}
+		return (acc0 + acc1) + (acc2 + acc3);
+	}
+
+	// data[i] = data[i] * factor, computed in float and rounded once
+	template<concepts::half_precision_type T>
+	void scale_scalar(T* data, std::size_t count, float factor) noexcept
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			data[i] = T(static_cast<float>(data[i]) * factor);
+		}
+	}
+
+
+#if MATHLBR_SIMD_X86
+	/* SSE2 (baseline of every x86-64 CPU) */
+
+	inline float hsum_sse(__m128 v) noexcept
+	{
+		const __m128 shuffled = _mm_movehl_ps(v, v);
+		const __m128 sums = _mm_add_ps(v, shuffled);
+		return _mm_cvtss_f32(_mm_add_ss(sums, _mm_shuffle_ps(sums, sums, 0x55)));
+	}
+
+	inline double hsum_sse(__m128d v) noexcept
+	{
+		return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+	}
+
+	inline float dot_sse2(const float* lhs, const float* rhs, std::size_t count) noexcept
+	{
+		__m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps(), acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(lhs + i), _mm_loadu_ps(rhs + i)));
+			acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(lhs + i + 4), _mm_loadu_ps(rhs + i + 4)));
+			acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(lhs + i + 8), _mm_loadu_ps(rhs + i + 8)));
+			acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(lhs + i + 12), _mm_loadu_ps(rhs + i + 12)));
+		}
+		for (; i + 4 <= count; i += 4)
+		{
+			acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(lhs + i), _mm_loadu_ps(rhs + i)));
+		}
+		float result = hsum_sse(_mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+		for (; i < count; ++i)
+		{
+			result += lhs[i] * rhs[i];
+		}
+		return result;
+	}
+
+	inline double dot_sse2(const double* lhs, const double* rhs, std::size_t count) noexcept
+	{
+		__m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd(), acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(lhs + i), _mm_loadu_pd(rhs + i)));
+			acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(lhs + i + 2), _mm_loadu_pd(rhs + i + 2)));
+			acc2 = _mm_add_pd(acc2, _mm_mul_pd(_mm_loadu_pd(lhs + i + 4), _mm_loadu_pd(rhs + i + 4)));
+			acc3 = _mm_add_pd(acc3, _mm_mul_pd(_mm_loadu_pd(lhs + i + 6), _mm_loadu_pd(rhs + i + 6)));
+		}
+		for (; i + 2 <= count; i += 2)
+		{
+			acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(lhs + i), _mm_loadu_pd(rhs + i)));
+		}
+		double result = hsum_sse(_mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)));
+		for (; i < count; ++i)
+		{
+			result += lhs[i] * rhs[i];
+		}
+		return result;
+	}
+
+	// Complex kernels work on the interleaved representation: the real part is the plain dot product of the
+	// two float arrays, while the imaginary part is the dot product with rhs's (real, imag) pairs swapped,
+	// where even lanes are added and odd lanes are substracted.
+	inline std::complex<float> conj_dot_sse2(const float* lhs, const float* rhs, std::size_t count) noexcept
+	{
+		const std::size_t length = 2 * count;
+		__m128 real0 = _mm_setzero_ps(), real1 = _mm_setzero_ps(), imag0 = _mm_setzero_ps(), imag1 = _mm_setzero_ps();
+		std::size_t i = 0;
+		for (; i + 8 <= length; i += 8)
+		{
+			const __m128 a0 = _mm_loadu_ps(lhs + i), a1 = _mm_loadu_ps(lhs + i + 4);
+			const __m128 b0 = _mm_loadu_ps(rhs + i), b1 = _mm_loadu_ps(rhs + i + 4);
+			real0 = _mm_add_ps(real0, _mm_mul_ps(a0, b0));
+			real1 = _mm_add_ps(real1, _mm_mul_ps(a1, b1));
+			imag0 = _mm_add_ps(imag0, _mm_mul_ps(a0, _mm_shuffle_ps(b0, b0, 0xB1)));
+			imag1 = _mm_add_ps(imag1, _mm_mul_ps(a1, _mm_shuffle_ps(b1, b1, 0xB1)));
+		}
+		const __m128 signs = _mm_setr_ps(1.f, -1.f, 1.f, -1.f);
+		std::complex<float> result{ hsum_sse(_mm_add_ps(real0, real1)), hsum_sse(_mm_mul_ps(_mm_add_ps(imag0, imag1), signs)) };
+		return result + conj_dot_scalar(lhs + i, rhs + i, (length - i) / 2);
+	}
+
+	inline std::complex<double> conj_dot_sse2(const double* lhs, const double* rhs, std::size_t count) noexcept
+	{
+		const std::size_t length = 2 * count;
+		__m128d real0 = _mm_setzero_pd(), real1 = _mm_setzero_pd(), imag0 = _mm_setzero_pd(), imag1 = _mm_setzero_pd();
+		std::size_t i = 0;
+		for (; i + 4 <= length; i += 4)
+		{
+			const __m128d a0 = _mm_loadu_pd(lhs + i), a1 = _mm_loadu_pd(lhs + i + 2);
+			const __m128d b0 = _mm_loadu_pd(rhs + i), b1 = _mm_loadu_pd(rhs + i + 2);
+			real0 = _mm_add_pd(real0, _mm_mul_pd(a0, b0));
+			real1 = _mm_add_pd(real1, _mm_mul_pd(a1, b1));
+			imag0 = _mm_add_pd(imag0, _mm_mul_pd(a0, _mm_shuffle_pd(b0, b0, 0x1)));
+			imag1 = _mm_add_pd(imag1, _mm_mul_pd(a1, _mm_shuffle_pd(b1, b1, 0x1)));
+		}
+		const __m128d imag = _mm_add_pd(imag0, imag1);
+		std::complex<double> result{ hsum_sse(_mm_add_pd(real0, real1)),
+			_mm_cvtsd_f64(_mm_sub_sd(imag, _mm_unpackhi_pd(imag, imag))) };
+		return result + conj_dot_scalar(lhs + i, rhs + i, (length - i) / 2);
+	}
+
+
+	// Split kernels need no shuffle at all: every lane holds the same component of a different element
+	inline std::complex<float> split_conj_dot_sse2(const float* lhs_real, const float* lhs_imag,
+		const float* rhs_real, const float* rhs_imag, std::size_t count) noexcept
+	{
+		__m128 real0 = _mm_setzero_ps(), real1 = _mm_setzero_ps(), imag0 = _mm_setzero_ps(), imag1 = _mm_setzero_ps();
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 ar = _mm_loadu_ps(lhs_real + i), ai = _mm_loadu_ps(lhs_imag + i);
+			const __m128 br = _mm_loadu_ps(rhs_real + i), bi = _mm_loadu_ps(rhs_imag + i);
+			real0 = _mm_add_ps(real0, _mm_mul_ps(ar, br));
+			real1 = _mm_add_ps(real1, _mm_mul_ps(ai, bi));
+			imag0 = _mm_add_ps(imag0, _mm_mul_ps(ar, bi));
+			imag1 = _mm_add_ps(imag1, _mm_mul_ps(ai, br));
+		}
+		std::complex<float> result{ hsum_sse(_mm_add_ps(real0, real1)), hsum_sse(_mm_sub_ps(imag0, imag1)) };
+		return result + split_conj_dot_scalar(lhs_real + i, lhs_imag + i, rhs_real + i, rhs_imag + i, count - i);
+	}
+
+	inline std::complex<double> split_conj_dot_sse2(const double* lhs_real, const double* lhs_imag,
+		const double* rhs_real, const double* rhs_imag, std::size_t count) noexcept
+	{
+		__m128d real0 = _mm_setzero_pd(), real1 = _mm_setzero_pd(), imag0 = _mm_setzero_pd(), imag1 = _mm_setzero_pd();
+		std::size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+		{
+			const __m128d ar = _mm_loadu_pd(lhs_real + i), ai = _mm_loadu_pd(lhs_imag + i);
+			const __m128d br = _mm_loadu_pd(rhs_real + i), bi = _mm_loadu_pd(rhs_imag + i);
+			real0 = _mm_add_pd(real0, _mm_mul_pd(ar, br));
+			real1 = _mm_add_pd(real1, _mm_mul_pd(ai, bi));
+			imag0 = _mm_add_pd(imag0, _mm_mul_pd(ar, bi));
+			imag1 = _mm_add_pd(imag1, _mm_mul_pd(ai, br));
+		}
+		std::complex<double> result{ hsum_sse(_mm_add_pd(real0, real1)), hsum_sse(_mm_sub_pd(imag0, imag1)) };
+		return result + split_conj_dot_scalar(lhs_real + i, lhs_imag + i, rhs_real + i, rhs_imag + i, count - i);
+	}
+
+
+	inline void scale_sse2(float* data, std::size_t count, float factor) noexcept
+	{
+		const __m128 f = _mm_set1_ps(factor);
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), f));
+			_mm_storeu_ps(data + i + 4, _mm_mul_ps(_mm_loadu_ps(data + i + 4), f));
+		}
+		scale_scalar(data + i, count - i, factor);
+	}
+
+	inline void scale_sse2(double* data, std::size_t count, double factor) noexcept
+	{
+		const __m128d f = _mm_set1_pd(factor);
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			_mm_storeu_pd(data + i, _mm_mul_pd(_mm_loadu_pd(data + i), f));
+			_mm_storeu_pd(data + i + 2, _mm_mul_pd(_mm_loadu_pd(data + i + 2), f));
+		}
+		scale_scalar(data + i, count - i, factor);
+	}
+
+
+	/* AVX2 + FMA */
+
+	MATHLBR_TARGET("avx2,fma") inline float hsum_avx(__m256 v) noexcept
+	{
+		return hsum_sse(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+	}
+
+	MATHLBR_TARGET("avx2,fma") inline double hsum_avx(__m256d v) noexcept
+	{
+		return hsum_sse(_mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));
+	}
+
+	MATHLBR_TARGET("avx2,fma") inline float dot_avx2(const float* lhs, const float* rhs, std::size_t count) noexcept
+	{
+		__m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+		std::size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(lhs + i), _mm256_loadu_ps(rhs + i), acc0);
+			acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(lhs + i + 8), _mm256_loadu_ps(rhs + i + 8), acc1);
+			acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(lhs + i + 16), _mm256_loadu_ps(rhs + i + 16), acc2);
+			acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(lhs + i + 24), _mm256_loadu_ps(rhs + i + 24), acc3);
+		}
+		for (; i + 8 <= count; i += 8)
+		{
+			acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(lhs + i), _mm256_loadu_ps(rhs + i), acc0);
+		}
+		float result = hsum_avx(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+		for (; i < count; ++i)
+		{
+			result += lhs[i] * rhs[i];
+		}
+		return result;
+	}
+
+	MATHLBR_TARGET("avx2,fma") inline double dot_avx2(const double* lhs, const double* rhs, std::size_t count) noexcept
+	{
+		__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd(), acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(lhs + i), _mm256_loadu_pd(rhs + i), acc0);
+			acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(lhs + i + 4), _mm256_loadu_pd(rhs + i + 4), acc1);
+			acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(lhs + i + 8), _mm256_loadu_pd(rhs + i + 8), acc2);
+			acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(lhs + i + 12), _mm256_loadu_pd(rhs + i + 12), acc3);
+		}
+		for (; i + 4 <= count; i += 4)
+		{
+			acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(lhs + i), _mm256_loadu_pd(rhs + i), acc0);
+		}
+		double result = hsum_avx(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+		for (; i < count; ++i)
+		{
+			result += lhs[i] * rhs[i];
+		}
+		return result;
+	}
+
+	MATHLBR_TARGET("avx2,fma") inline std::complex<float> conj_dot_avx2(const float* lhs, const float* rhs, std::size_t count) noexcept
+	{
+		const std::size_t length = 2 * count;
+		__m256 real0 = _mm256_setzero_ps(), real1 = _mm256_setzero_ps(), imag0 = _mm256_setzero_ps(), imag1 = _mm256_setzero_ps();
+		std::size_t i = 0;
+		for (; i + 16 <= length; i += 16)
+		{
+			const __m256 a0 = _mm256_loadu_ps(lhs + i), a1 = _mm256_loadu_ps(lhs + i + 8);
+			const __m256 b0 = _mm256_loadu_ps(rhs + i), b1 = _mm256_loadu_ps(rhs + i + 8);
+			real0 = _mm256_fmadd_ps(a0, b0, real0);
+			real1 = _mm256_fmadd_ps(a1, b1, real1);
+			imag0 = _mm256_fmadd_ps(a0, _mm256_permute_ps(b0, 0xB1), imag0);
+			imag1 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b1, 0xB1), imag1);
+		}
+		const __m256 signs = _mm256_setr_ps(1.f, -1.f, 1.f, -1.f, 1.f, -1.f, 1.f, -1.f);
+		std::complex<float> result{ hsum_avx(_mm256_add_ps(real0, real1)), hsum_avx(_mm256_mul_ps(_mm256_add_ps(imag0, imag1), signs)) };
+		return result + conj_dot_scalar(lhs + i, rhs + i, (length - i) / 2);
+	}
+
+	MATHLBR_TARGET("avx2,fma") inline std::complex<double> conj_dot_avx2(const double* lhs, const double* rhs, std::size_t count) noexcept
+	{
+		const std::size_t length = 2 * count;
+		__m256d real0 = _mm256_setzero_pd(), real1 = _mm256_setzero_pd(), imag0 = _mm256_setzero_pd(), imag1 = _mm256_setzero_pd();
+		std::size_t i = 0;
+		for (; i + 8 <= length; i += 8)
+		{
+			const __m256d a0 = _mm256_loadu_pd(lhs + i), a1 = _mm256_loadu_pd(lhs + i + 4);
+			const __m256d b0 = _mm256_loadu_pd(rhs + i), b1 = _mm256_loadu_pd(rhs + i + 4);
+			real0 = _mm256_fmadd_pd(a0, b0, real0);
+			real1 = _mm256_fmadd_pd(a1, b1, real1);
+			imag0 = _mm256_fmadd_pd(a0, _mm256_permute_pd(b0, 0x5), imag0);
+			imag1 = _mm256_fmadd_pd(a1, _mm256_permute_pd(b1, 0x5), imag1);
+		}
+		const __m256d signs = _mm256_setr_pd(1., -1., 1., -1.);
+		std::complex<double> result{ hsum_avx(_mm256_add_pd(real0, real1)), hsum_avx(_mm256_mul_pd(_mm256_add_pd(imag0, imag1), signs)) };
+		return result + conj_dot_scalar(lhs + i, rhs + i, (length - i) / 2);
+	}
+
+
+	MATHLBR_TARGET("avx2,fma") inline std::complex<float> split_conj_dot_avx2(const float* lhs_real, const float* lhs_imag,
+		const float* rhs_real, const float* rhs_imag, std::size_t count) noexcept
+	{
+		__m256 real0 = _mm256_setzero_ps(), real1 = _mm256_setzero_ps(), imag0 = _mm256_setzero_ps(), imag1 = _mm256_setzero_ps();
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			const __m256 ar0 = _mm256_loadu_ps(lhs_real + i), ai0 = _mm256_loadu_ps(lhs_imag + i);
+			const __m256 br0 = _mm256_loadu_ps(rhs_real + i), bi0 = _mm256_loadu_ps(rhs_imag + i);
+			const __m256 ar1 = _mm256_loadu_ps(lhs_real + i + 8), ai1 = _mm256_loadu_ps(lhs_imag + i + 8);
+			const __m256 br1 = _mm256_loadu_ps(rhs_real + i + 8), bi1 = _mm256_loadu_ps(rhs_imag + i + 8);
+			real0 = _mm256_fmadd_ps(ai0, bi0, _mm256_fmadd_ps(ar0, br0, real0));
+			imag0 = _mm256_fnmadd_ps(ai0, br0, _mm256_fmadd_ps(ar0, bi0, imag0));
+			real1 = _mm256_fmadd_ps(ai1, bi1, _mm256_fmadd_ps(ar1, br1, real1));
+			imag1 = _mm256_fnmadd_ps(ai1, br1, _mm256_fmadd_ps(ar1, bi1, imag1));
+		}
+		std::complex<float> result{ hsum_avx(_mm256_add_ps(real0, real1)), hsum_avx(_mm256_add_ps(imag0, imag1)) };
+		return result + split_conj_dot_scalar(lhs_real + i, lhs_imag + i, rhs_real + i, rhs_imag + i, count - i);
+	}
+
+	MATHLBR_TARGET("avx2,fma") inline std::complex<double> split_conj_dot_avx2(const double* lhs_real, const double* lhs_imag,
+		const double* rhs_real, const double* rhs_imag, std::size_t count) noexcept
+	{
+		__m256d real0 = _mm256_setzero_pd(), real1 = _mm256_setzero_pd(), imag0 = _mm256_setzero_pd(), imag1 = _mm256_setzero_pd();
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256d ar0 = _mm256_loadu_pd(lhs_real + i), ai0 = _mm256_loadu_pd(lhs_imag + i);
+			const __m256d br0 = _mm256_loadu_pd(rhs_real + i), bi0 = _mm256_loadu_pd(rhs_imag + i);
+			const __m256d ar1 = _mm256_loadu_pd(lhs_real + i + 4), ai1 = _mm256_loadu_pd(lhs_imag + i + 4);
+			const __m256d br1 = _mm256_loadu_pd(rhs_real + i + 4), bi1 = _mm256_loadu_pd(rhs_imag + i + 4);
+			real0 = _mm256_fmadd_pd(ai0, bi0, _mm256_fmadd_pd(ar0, br0, real0));
+			imag0 = _mm256_fnmadd_pd(ai0, br0, _mm256_fmadd_pd(ar0, bi0, imag0));
+			real1 = _mm256_fmadd_pd(ai1, bi1, _mm256_fmadd_pd(ar1, br1, real1));
+			imag1 = _mm256_fnmadd_pd(ai1, br1, _mm256_fmadd_pd(ar1, bi1, imag1));
+		}
+		std::complex<double> result{ hsum_avx(_mm256_add_pd(real0, real1)), hsum_avx(_mm256_add_pd(imag0, imag1)) };
+		return result + split_conj_dot_scalar(lhs_real + i, lhs_imag + i, rhs_real + i, rhs_imag + i, count - i);
+	}
+
+
+	MATHLBR_TARGET("avx2,fma") inline void scale_avx2(float* data, std::size_t count, float factor) noexcept
+	{
+		const __m256 f = _mm256_set1_ps(factor);
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			_mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), f));
+			_mm256_storeu_ps(data + i + 8, _mm256_mul_ps(_mm256_loadu_ps(data + i + 8), f));
+		}
+		scale_scalar(data + i, count - i, factor);
+	}
+
+	MATHLBR_TARGET("avx2,fma") inline void scale_avx2(double* data, std::size_t count, double factor) noexcept
+	{
+		const __m256d f = _mm256_set1_pd(factor);
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			_mm256_storeu_pd(data + i, _mm256_mul_pd(_mm256_loadu_pd(data + i), f));
+			_mm256_storeu_pd(data + i + 4, _mm256_mul_pd(_mm256_loadu_pd(data + i + 4), f));
+		}
+		scale_scalar(data + i, count - i, factor);
+	}
+
+
+	/* AVX-512F: tails are handled with masked loads instead of a scalar loop */
+
+MATHLBR_AVX512_BEGIN
+
+	MATHLBR_TARGET("avx512f") inline float dot_avx512(const float* lhs, const float* rhs, std::size_t count) noexcept
+	{
+		__m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps(), acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+		std::size_t i = 0;
+		for (; i + 64 <= count; i += 64)
+		{
+			acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(lhs + i), _mm512_loadu_ps(rhs + i), acc0);
+			acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(lhs + i + 16), _mm512_loadu_ps(rhs + i + 16), acc1);
+			acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(lhs + i + 32), _mm512_loadu_ps(rhs + i + 32), acc2);
+			acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(lhs + i + 48), _mm512_loadu_ps(rhs + i + 48), acc3);
+		}
+		for (; i + 16 <= count; i += 16)
+		{
+			acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(lhs + i), _mm512_loadu_ps(rhs + i), acc0);
+		}
+		if (i < count)
+		{
+			const __mmask16 mask = static_cast<__mmask16>((1u << (count - i)) - 1);
+			acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, lhs + i), _mm512_maskz_loadu_ps(mask, rhs + i), acc1);
+		}
+		return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+	}
+
+	MATHLBR_TARGET("avx512f") inline double dot_avx512(const double* lhs, const double* rhs, std::size_t count) noexcept
+	{
+		__m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd(), acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+		std::size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(lhs + i), _mm512_loadu_pd(rhs + i), acc0);
+			acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(lhs + i + 8), _mm512_loadu_pd(rhs + i + 8), acc1);
+			acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(lhs + i + 16), _mm512_loadu_pd(rhs + i + 16), acc2);
+			acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(lhs + i + 24), _mm512_loadu_pd(rhs + i + 24), acc3);
+		}
+		for (; i + 8 <= count; i += 8)
+		{
+			acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(lhs + i), _mm512_loadu_pd(rhs + i), acc0);
+		}
+		if (i < count)
+		{
+			const __mmask8 mask = static_cast<__mmask8>((1u << (count - i)) - 1);
+			acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, lhs + i), _mm512_maskz_loadu_pd(mask, rhs + i), acc1);
+		}
+		return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+	}
+
+	MATHLBR_TARGET("avx512f") inline std::complex<float> conj_dot_avx512(const float* lhs, const float* rhs, std::size_t count) noexcept
+	{
+		const std::size_t length = 2 * count;
+		__m512 real0 = _mm512_setzero_ps(), real1 = _mm512_setzero_ps(), imag0 = _mm512_setzero_ps(), imag1 = _mm512_setzero_ps();
+		std::size_t i = 0;
+		for (; i + 32 <= length; i += 32)
+		{
+			const __m512 a0 = _mm512_loadu_ps(lhs + i), a1 = _mm512_loadu_ps(lhs + i + 16);
+			const __m512 b0 = _mm512_loadu_ps(rhs + i), b1 = _mm512_loadu_ps(rhs + i + 16);
+			real0 = _mm512_fmadd_ps(a0, b0, real0);
+			real1 = _mm512_fmadd_ps(a1, b1, real1);
+			imag0 = _mm512_fmadd_ps(a0, _mm512_permute_ps(b0, 0xB1), imag0);
+			imag1 = _mm512_fmadd_ps(a1, _mm512_permute_ps(b1, 0xB1), imag1);
+		}
+		if (i < length)
+		{
+			const __mmask16 mask = static_cast<__mmask16>((1u << (length - i < 16 ? length - i : 16)) - 1);
+			const __m512 a0 = _mm512_maskz_loadu_ps(mask, lhs + i);
+			const __m512 b0 = _mm512_maskz_loadu_ps(mask, rhs + i);
+			real0 = _mm512_fmadd_ps(a0, b0, real0);
+			imag0 = _mm512_fmadd_ps(a0, _mm512_permute_ps(b0, 0xB1), imag0);
+			i += 16;
+		}
+		const __m512 signs = _mm512_castsi512_ps(_mm512_set1_epi64(static_cast<long long>(0xBF8000003F800000ULL)));
+		std::complex<float> result{ _mm512_reduce_add_ps(_mm512_add_ps(real0, real1)),
+			_mm512_reduce_add_ps(_mm512_mul_ps(_mm512_add_ps(imag0, imag1), signs)) };
+		return i < length ? result + conj_dot_scalar(lhs + i, rhs + i, (length - i) / 2) : result;
+	}
+
+	MATHLBR_TARGET("avx512f") inline std::complex<double> conj_dot_avx512(const double* lhs, const double* rhs, std::size_t count) noexcept
+	{
+		const std::size_t length = 2 * count;
+		__m512d real0 = _mm512_setzero_pd(), real1 = _mm512_setzero_pd(), imag0 = _mm512_setzero_pd(), imag1 = _mm512_setzero_pd();
+		std::size_t i = 0;
+		for (; i + 16 <= length; i += 16)
+		{
+			const __m512d a0 = _mm512_loadu_pd(lhs + i), a1 = _mm512_loadu_pd(lhs + i + 8);
+			const __m512d b0 = _mm512_loadu_pd(rhs + i), b1 = _mm512_loadu_pd(rhs + i + 8);
+			real0 = _mm512_fmadd_pd(a0, b0, real0);
+			real1 = _mm512_fmadd_pd(a1, b1, real1);
+			imag0 = _mm512_fmadd_pd(a0, _mm512_permute_pd(b0, 0x55), imag0);
+			imag1 = _mm512_fmadd_pd(a1, _mm512_permute_pd(b1, 0x55), imag1);
+		}
+		if (i < length)
+		{
+			const __mmask8 mask = static_cast<__mmask8>((1u << (length - i < 8 ? length - i : 8)) - 1);
+			const __m512d a0 = _mm512_maskz_loadu_pd(mask, lhs + i);
+			const __m512d b0 = _mm512_maskz_loadu_pd(mask, rhs + i);
+			real0 = _mm512_fmadd_pd(a0, b0, real0);
+			imag0 = _mm512_fmadd_pd(a0, _mm512_permute_pd(b0, 0x55), imag0);
+			i += 8;
+		}
+		const __m512d signs = _mm512_setr_pd(1., -1., 1., -1., 1., -1., 1., -1.);
+		std::complex<double> result{ _mm512_reduce_add_pd(_mm512_add_pd(real0, real1)),
+			_mm512_reduce_add_pd(_mm512_mul_pd(_mm512_add_pd(imag0, imag1), signs)) };
+		return i < length ? result + conj_dot_scalar(lhs + i, rhs + i, (length - i) / 2) : result;
+	}
+
+	MATHLBR_TARGET("avx512f") inline std::complex<float> split_conj_dot_avx512(const float* lhs_real, const float* lhs_imag,
+		const float* rhs_real, const float* rhs_imag, std::size_t count) noexcept
+	{
+		__m512 real0 = _mm512_setzero_ps(), real1 = _mm512_setzero_ps(), imag0 = _mm512_setzero_ps(), imag1 = _mm512_setzero_ps();
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			const __m512 ar = _mm512_loadu_ps(lhs_real + i), ai = _mm512_loadu_ps(lhs_imag + i);
+			const __m512 br = _mm512_loadu_ps(rhs_real + i), bi = _mm512_loadu_ps(rhs_imag + i);
+			real0 = _mm512_fmadd_ps(ar, br, real0);
+			real1 = _mm512_fmadd_ps(ai, bi, real1);
+			imag0 = _mm512_fmadd_ps(ar, bi, imag0);
+			imag1 = _mm512_fmadd_ps(ai, br, imag1);
+		}
+		if (i < count)
+		{
+			const __mmask16 mask = static_cast<__mmask16>((1u << (count - i)) - 1);
+			const __m512 ar = _mm512_maskz_loadu_ps(mask, lhs_real + i), ai = _mm512_maskz_loadu_ps(mask, lhs_imag + i);
+			const __m512 br = _mm512_maskz_loadu_ps(mask, rhs_real + i), bi = _mm512_maskz_loadu_ps(mask, rhs_imag + i);
+			real0 = _mm512_fmadd_ps(ar, br, real0);
+			real1 = _mm512_fmadd_ps(ai, bi, real1);
+			imag0 = _mm512_fmadd_ps(ar, bi, imag0);
+			imag1 = _mm512_fmadd_ps(ai, br, imag1);
+		}
+		return { _mm512_reduce_add_ps(_mm512_add_ps(real0, real1)), _mm512_reduce_add_ps(_mm512_sub_ps(imag0, imag1)) };
+	}
+
+	MATHLBR_TARGET("avx512f") inline std::complex<double> split_conj_dot_avx512(const double* lhs_real, const double* lhs_imag,
+		const double* rhs_real, const double* rhs_imag, std::size_t count) noexcept
+	{
+		__m512d real0 = _mm512_setzero_pd(), real1 = _mm512_setzero_pd(), imag0 = _mm512_setzero_pd(), imag1 = _mm512_setzero_pd();
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m512d ar = _mm512_loadu_pd(lhs_real + i), ai = _mm512_loadu_pd(lhs_imag + i);
+			const __m512d br = _mm512_loadu_pd(rhs_real + i), bi = _mm512_loadu_pd(rhs_imag + i);
+			real0 = _mm512_fmadd_pd(ar, br, real0);
+			real1 = _mm512_fmadd_pd(ai, bi, real1);
+			imag0 = _mm512_fmadd_pd(ar, bi, imag0);
+			imag1 = _mm512_fmadd_pd(ai, br, imag1);
+		}
+		if (i < count)
+		{
+			const __mmask8 mask = static_cast<__mmask8>((1u << (count - i)) - 1);
+			const __m512d ar = _mm512_maskz_loadu_pd(mask, lhs_real + i), ai = _mm512_maskz_loadu_pd(mask, lhs_imag + i);
+			const __m512d br = _mm512_maskz_loadu_pd(mask, rhs_real + i), bi = _mm512_maskz_loadu_pd(mask, rhs_imag + i);
+			real0 = _mm512_fmadd_pd(ar, br, real0);
+			real1 = _mm512_fmadd_pd(ai, bi, real1);
+			imag0 = _mm512_fmadd_pd(ar, bi, imag0);
+			imag1 = _mm512_fmadd_pd(ai, br, imag1);
+		}
+		return { _mm512_reduce_add_pd(_mm512_add_pd(real0, real1)), _mm512_reduce_add_pd(_mm512_sub_pd(imag0, imag1)) };
+	}
+
+	MATHLBR_TARGET("avx512f") inline void scale_avx512(float* data, std::size_t count, float factor) noexcept
+	{
+		const __m512 f = _mm512_set1_ps(factor);
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			_mm512_storeu_ps(data + i, _mm512_mul_ps(_mm512_loadu_ps(data + i), f));
+		}
+		if (i < count)
+		{
+			const __mmask16 mask = static_cast<__mmask16>((1u << (count - i)) - 1);
+			_mm512_mask_storeu_ps(data + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, data + i), f));
+		}
+	}
+
+	MATHLBR_TARGET("avx512f") inline void scale_avx512(double* data, std::size_t count, double factor) noexcept
+	{
+		const __m512d f = _mm512_set1_pd(factor);
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			_mm512_storeu_pd(data + i, _mm512_mul_pd(_mm512_loadu_pd(data + i), f));
+		}
+		if (i < count)
+		{
+			const __mmask8 mask = static_cast<__mmask8>((1u << (count - i)) - 1);
+			_mm512_mask_storeu_pd(data + i, mask, _mm512_mul_pd(_mm512_maskz_loadu_pd(mask, data + i), f));
+		}
+	}
+
+MATHLBR_AVX512_END
+
+
+	/*
+		16 bits floating point numbers: loaded as float (F16C for binary16, a 16 bits shift for bfloat16), computed in float,
+		and rounded to nearest even when stored. The AVX2 and AVX-512 kernels are only used when the CPU has F16C.
+		Tails are copied to a zeroed buffer, masked loads of 16 bits elements would need AVX-512BW.
+	*/
+
+	inline __m128 load_sse2_low(const MathLbr::bfloat16* data) noexcept
+	{
+		return _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data))));
+	}
+
+	inline __m128 load_sse2_high(const MathLbr::bfloat16* data) noexcept
+	{
+		return _mm_castsi128_ps(_mm_unpackhi_epi16(_mm_setzero_si128(), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data))));
+	}
+
+	// SSE2 has no binary16 conversions, only bfloat16 is vectorized
+	inline float dot_sse2(const MathLbr::bfloat16* lhs, const MathLbr::bfloat16* rhs, std::size_t count) noexcept
+	{
+		__m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps(), acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			acc0 = _mm_add_ps(acc0, _mm_mul_ps(load_sse2_low(lhs + i), load_sse2_low(rhs + i)));
+			acc1 = _mm_add_ps(acc1, _mm_mul_ps(load_sse2_high(lhs + i), load_sse2_high(rhs + i)));
+			acc2 = _mm_add_ps(acc2, _mm_mul_ps(load_sse2_low(lhs + i + 8), load_sse2_low(rhs + i + 8)));
+			acc3 = _mm_add_ps(acc3, _mm_mul_ps(load_sse2_high(lhs + i + 8), load_sse2_high(rhs + i + 8)));
+		}
+		for (; i + 8 <= count; i += 8)
+		{
+			acc0 = _mm_add_ps(acc0, _mm_mul_ps(load_sse2_low(lhs + i), load_sse2_low(rhs + i)));
+			acc1 = _mm_add_ps(acc1, _mm_mul_ps(load_sse2_high(lhs + i), load_sse2_high(rhs + i)));
+		}
+		return hsum_sse(_mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3))) + dot_scalar(lhs + i, rhs + i, count - i);
+	}
+
+
+	MATHLBR_TARGET("avx2,fma,f16c") MATHLBR_INLINE __m256 load_avx2(const MathLbr::float16* data) noexcept
+	{
+		return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+	}
+
+	MATHLBR_TARGET("avx2,fma,f16c") MATHLBR_INLINE __m256 load_avx2(const MathLbr::bfloat16* data) noexcept
+	{
+		return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data))), 16));
+	}
+
+	MATHLBR_TARGET("avx2,fma,f16c") MATHLBR_INLINE void store_avx2(MathLbr::float16* data, __m256 values) noexcept
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT));
+	}
+
+	MATHLBR_TARGET("avx2,fma,f16c") MATHLBR_INLINE void store_avx2(MathLbr::bfloat16* data, __m256 values) noexcept
+	{
+		// Same rounding as bfloat16's constructor: bits + 0x7FFF + (lowest kept bit), NaNs are made quiet instead
+		const __m256i bits = _mm256_castps_si256(values);
+		const __m256i upper = _mm256_srli_epi32(bits, 16);
+		const __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(bits, _mm256_set1_epi32(0x7FFF)),
+			_mm256_and_si256(upper, _mm256_set1_epi32(1))), 16);
+		const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(values, values, _CMP_UNORD_Q));
+		const __m256i result = _mm256_blendv_epi8(rounded, _mm256_or_si256(upper, _mm256_set1_epi32(0x40)), nan);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data),
+			_mm_packus_epi32(_mm256_castsi256_si128(result), _mm256_extracti128_si256(result, 1)));
+	}
+
+	template<concepts::half_precision_type T>
+	MATHLBR_TARGET("avx2,fma,f16c") inline float dot_avx2(const T* lhs, const T* rhs, std::size_t count) noexcept
+	{
+		__m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+		std::size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			acc0 = _mm256_fmadd_ps(load_avx2(lhs + i), load_avx2(rhs + i), acc0);
+			acc1 = _mm256_fmadd_ps(load_avx2(lhs + i + 8), load_avx2(rhs + i + 8), acc1);
+			acc2 = _mm256_fmadd_ps(load_avx2(lhs + i + 16), load_avx2(rhs + i + 16), acc2);
+			acc3 = _mm256_fmadd_ps(load_avx2(lhs + i + 24), load_avx2(rhs + i + 24), acc3);
+		}
+		for (; i + 8 <= count; i += 8)
+		{
+			acc0 = _mm256_fmadd_ps(load_avx2(lhs + i), load_avx2(rhs + i), acc0);
+		}
+		if (i < count)
+		{
+			T lhs_tail[8]{}, rhs_tail[8]{};
+			std::memcpy(lhs_tail, lhs + i, (count - i) * sizeof(T));
+			std::memcpy(rhs_tail, rhs + i, (count - i) * sizeof(T));
+			acc1 = _mm256_fmadd_ps(load_avx2(lhs_tail), load_avx2(rhs_tail), acc1);
+		}
+		return hsum_avx(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+	}
+
+	template<concepts::half_precision_type T>
+	MATHLBR_TARGET("avx2,fma,f16c") inline void scale_avx2(T* data, std::size_t count, float factor) noexcept
+	{
+		const __m256 f = _mm256_set1_ps(factor);
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			store_avx2(data + i, _mm256_mul_ps(load_avx2(data + i), f));
+		}
+		if (i < count)
+		{
+			T tail[8]{};
+			std::memcpy(tail, data + i, (count - i) * sizeof(T));
+			store_avx2(tail, _mm256_mul_ps(load_avx2(tail), f));
+			std::memcpy(data + i, tail, (count - i) * sizeof(T));
+		}
+	}
+
+MATHLBR_AVX512_BEGIN
+
+	MATHLBR_TARGET("avx512f") MATHLBR_INLINE __m512 load_avx512(const MathLbr::float16* data) noexcept
+	{
+		return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)));
+	}
+
+	MATHLBR_TARGET("avx512f") MATHLBR_INLINE __m512 load_avx512(const MathLbr::bfloat16* data) noexcept
+	{
+		return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data))), 16));
+	}
+
+	MATHLBR_TARGET("avx512f") MATHLBR_INLINE void store_avx512(MathLbr::float16* data, __m512 values) noexcept
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data), _mm512_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT));
+	}
+
+	MATHLBR_TARGET("avx512f") MATHLBR_INLINE void store_avx512(MathLbr::bfloat16* data, __m512 values) noexcept
+	{
+		const __m512i bits = _mm512_castps_si512(values);
+		const __m512i upper = _mm512_srli_epi32(bits, 16);
+		const __m512i rounded = _mm512_srli_epi32(_mm512_add_epi32(_mm512_add_epi32(bits, _mm512_set1_epi32(0x7FFF)),
+			_mm512_and_si512(upper, _mm512_set1_epi32(1))), 16);
+		const __mmask16 nan = _mm512_cmp_ps_mask(values, values, _CMP_UNORD_Q);
+		const __m512i result = _mm512_mask_blend_epi32(nan, rounded, _mm512_or_si512(upper, _mm512_set1_epi32(0x40)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data), _mm512_cvtepi32_epi16(result));
+	}
+
+	template<concepts::half_precision_type T>
+	MATHLBR_TARGET("avx512f") inline float dot_avx512(const T* lhs, const T* rhs, std::size_t count) noexcept
+	{
+		__m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps(), acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+		std::size_t i = 0;
+		for (; i + 64 <= count; i += 64)
+		{
+			acc0 = _mm512_fmadd_ps(load_avx512(lhs + i), load_avx512(rhs + i), acc0);
+			acc1 = _mm512_fmadd_ps(load_avx512(lhs + i + 16), load_avx512(rhs + i + 16), acc1);
+			acc2 = _mm512_fmadd_ps(load_avx512(lhs + i + 32), load_avx512(rhs + i + 32), acc2);
+			acc3 = _mm512_fmadd_ps(load_avx512(lhs + i + 48), load_avx512(rhs + i + 48), acc3);
+		}
+		for (; i + 16 <= count; i += 16)
+		{
+			acc0 = _mm512_fmadd_ps(load_avx512(lhs + i), load_avx512(rhs + i), acc0);
+		}
+		if (i < count)
+		{
+			T lhs_tail[16]{}, rhs_tail[16]{};
+			std::memcpy(lhs_tail, lhs + i, (count - i) * sizeof(T));
+			std::memcpy(rhs_tail, rhs + i, (count - i) * sizeof(T));
+			acc1 = _mm512_fmadd_ps(load_avx512(lhs_tail), load_avx512(rhs_tail), acc1);
+		}
+		return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+	}
+
+	template<concepts::half_precision_type T>
+	MATHLBR_TARGET("avx512f") inline void scale_avx512(T* data, std::size_t count, float factor) noexcept
+	{
+		const __m512 f = _mm512_set1_ps(factor);
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			store_avx512(data + i, _mm512_mul_ps(load_avx512(data + i), f));
+		}
+		if (i < count)
+		{
+			T tail[16]{};
+			std::memcpy(tail, data + i, (count - i) * sizeof(T));
+			store_avx512(tail, _mm512_mul_ps(load_avx512(tail), f));
+			std::memcpy(data + i, tail, (count - i) * sizeof(T));
+		}
+	}
+
+MATHLBR_AVX512_END
+#endif
+
+
+	// Dispatchers
+	template<concepts::simd_real_type T>
+	T dot(const T* lhs, const T* rhs, std::size_t count) noexcept
+	{
+#if MATHLBR_SIMD_X86
+		switch (simd_level())
+		{
+		case MathLbr::SimdLevel::AVX512: return dot_avx512(lhs, rhs, count);
+		case MathLbr::SimdLevel::AVX2: return dot_avx2(lhs, rhs, count);
+		case MathLbr::SimdLevel::SSE2: return dot_sse2(lhs, rhs, count);
+		default: break;
+		}
+#endif
+		return dot_scalar(lhs, rhs, count);
+	}
+
+	// sum(conj(lhs[i]) * rhs[i])
+	template<concepts::simd_real_type T>
+	std::complex<T> conj_dot(const std::complex<T>* lhs, const std::complex<T>* rhs, std::size_t count) noexcept
+	{
+		// std::complex<T> is guaranteed to be layout compatible with T[2]
+		const T* lhs_flat = reinterpret_cast<const T*>(lhs);
+		const T* rhs_flat = reinterpret_cast<const T*>(rhs);
+#if MATHLBR_SIMD_X86
+		switch (simd_level())
+		{
+		case MathLbr::SimdLevel::AVX512: return conj_dot_avx512(lhs_flat, rhs_flat, count);
+		case MathLbr::SimdLevel::AVX2: return conj_dot_avx2(lhs_flat, rhs_flat, count);
+		case MathLbr::SimdLevel::SSE2: return conj_dot_sse2(lhs_flat, rhs_flat, count);
+		default: break;
+		}
+#endif
+		return conj_dot_scalar(lhs_flat, rhs_flat, count);
+	}
+
+	template<concepts::simd_real_type T>
+	std::complex<T> split_conj_dot(const T* lhs_real, const T* lhs_imag, const T* rhs_real, const T* rhs_imag, std::size_t count) noexcept
+	{
+#if MATHLBR_SIMD_X86
+		switch (simd_level())
+		{
+		case MathLbr::SimdLevel::AVX512: return split_conj_dot_avx512(lhs_real, lhs_imag, rhs_real, rhs_imag, count);
+		case MathLbr::SimdLevel::AVX2: return split_conj_dot_avx2(lhs_real, lhs_imag, rhs_real, rhs_imag, count);
+		case MathLbr::SimdLevel::SSE2: return split_conj_dot_sse2(lhs_real, lhs_imag, rhs_real, rhs_imag, count);
+		default: break;
+		}
+#endif
+		return split_conj_dot_scalar(lhs_real, lhs_imag, rhs_real, rhs_imag, count);
+	}
+
+	// data[i] *= factor
+	template<concepts::simd_real_type T>
+	void scale(T* data, std::size_t count, T factor) noexcept
+	{
+#if MATHLBR_SIMD_X86
+		switch (simd_level())
+		{
+		case MathLbr::SimdLevel::AVX512: return scale_avx512(data, count, factor);
+		case MathLbr::SimdLevel::AVX2: return scale_avx2(data, count, factor);
+		case MathLbr::SimdLevel::SSE2: return scale_sse2(data, count, factor);
+		default: break;
+		}
+#endif
+		scale_scalar(data, count, factor);
+	}
+
+	// Inner product of 16 bits floating point numbers, accumulated in float
+	template<concepts::half_precision_type T>
+	float dot(const T* lhs, const T* rhs, std::size_t count) noexcept
+	{
+#if MATHLBR_SIMD_X86
+		if (has_f16c())
+		{
+			switch (simd_level())
+			{
+			case MathLbr::SimdLevel::AVX512: return dot_avx512(lhs, rhs, count);
+			case MathLbr::SimdLevel::AVX2: return dot_avx2(lhs, rhs, count);
+			default: break;
+			}
+		}
+		if constexpr (std::is_same_v<T, MathLbr::bfloat16>)
+		{
+			if (simd_level() != MathLbr::SimdLevel::SCALAR) return dot_sse2(lhs, rhs, count);
+		}
+#endif
+		return dot_scalar(lhs, rhs, count);
+	}
+
+	// data[i] = data[i] * factor, computed in float
+	template<concepts::half_precision_type T>
+	void scale(T* data, std::size_t count, float factor) noexcept
+	{
+#if MATHLBR_SIMD_X86
+		if (has_f16c())
+		{
+			switch (simd_level())
+			{
+			case MathLbr::SimdLevel::AVX512: return scale_avx512(data, count, factor);
+			case MathLbr::SimdLevel::AVX2: return scale_avx2(data, count, factor);
+			default: break;
+			}
+		}
+#endif
+		scale_scalar(data, count, factor);
+	}
+}
+
+
+/*
+	Kernels for 2D, 3D and 4D vectors. At these sizes the runtime dispatch (an indirect branch, loops with a tail) costs more
+	than the arithmetic: these are inlined and fully unrolled, so the compiler keeps the operands in registers and packs
+	them into SIMD registers itself. The operations are done in the same order as the generic loops.
+*/
+namespace detail::simd::fixed
+{
+	template<std::size_t Size, concepts::simd_real_type T>
+	constexpr T dot(const T* lhs, const T* rhs) noexcept
+	{
+		return [lhs, rhs]<std::size_t... I>(std::index_sequence<I...>) { return (T{} + ... + (lhs[I] * rhs[I])); }
+			(std::make_index_sequence<Size>{});
+	}
+
+	// data[i] /= denominator
+	template<std::size_t Size, concepts::simd_real_type T>
+	constexpr void divide(T* data, T denominator) noexcept
+	{
+		[data, denominator]<std::size_t... I>(std::index_sequence<I...>) { ((data[I] /= denominator), ...); }
+			(std::make_index_sequence<Size>{});
+	}
+}
+
+#endif
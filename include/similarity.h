@@ -0,0 +1,493 @@
+#ifndef SIMILARITY_HEADER
+#define SIMILARITY_HEADER
+
+#include "matrix.h"
+#include "execution.h"
+#include "precision.h"
+#include "vectorized_math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+
+/*
+	All-pairs similarities between the rows of two matrices a (m x d) and b (n x d), every row being a vector.
+	The inner products of all the pairs are the product a * transpose(b): they are computed by the GEMM kernels of
+	matrix.h, one tile of detail::gemm::blocking<R>::mc x nc pairs at a time, and the norms of all the rows are computed
+	once beforehand. Every tile is turned into cosines, angles or parallel / perpendicular pairs while it is still in
+	cache, so that the m x n matrix never needs to be stored: for_each_tile and the *_pairs functions only keep what
+	they report. The overloads taking a single matrix compare its rows with each other and skip the tiles below the
+	diagonal. Tiles are computed in parallel with MathLbr::execution::par.
+*/
+
+namespace MathLbr::Similarity
+{
+	// Pair of rows (first of a, second of b) whose cosine similarity was reported by similar_pairs
+	template<std::floating_point R>
+	struct similar_pair
+	{
+		std::size_t first;
+		std::size_t second;
+		R cosine;
+
+		constexpr bool operator==(const similar_pair&) const = default;
+	};
+
+	/*
+		Inner products between rows [first_row(), first_row() + rows()) of a and rows [first_col(), first_col() + cols())
+		of b, with the norms of these rows. Indices passed to the member functions are relative to the tile.
+	*/
+	template<std::floating_point R>
+	class tile
+	{
+	public:
+		using value_type = R;
+		using size_type = std::size_t;
+
+	private:
+		const R* _inner_products;
+		size_type _stride;
+		size_type _first_row;
+		size_type _rows;
+		size_type _first_col;
+		size_type _cols;
+		const R* _squared_norms_a;
+		const R* _squared_norms_b;
+		const R* _inverse_norms_a;
+		const R* _inverse_norms_b;
+
+	public:
+		constexpr tile(const R* inner_products, size_type stride, size_type first_row, size_type rows, size_type first_col, size_type cols,
+			const R* squared_norms_a, const R* squared_norms_b, const R* inverse_norms_a, const R* inverse_norms_b) noexcept
+			: _inner_products{ inner_products }, _stride{ stride }, _first_row{ first_row }, _rows{ rows }, _first_col{ first_col },
+			_cols{ cols }, _squared_norms_a{ squared_norms_a }, _squared_norms_b{ squared_norms_b },
+			_inverse_norms_a{ inverse_norms_a }, _inverse_norms_b{ inverse_norms_b }
+		{
+		}
+
+		constexpr size_type first_row() const noexcept
+		{
+			return _first_row;
+		}
+
+		constexpr size_type rows() const noexcept
+		{
+			return _rows;
+		}
+
+		constexpr size_type first_col() const noexcept
+		{
+			return _first_col;
+		}
+
+		constexpr size_type cols() const noexcept
+		{
+			return _cols;
+		}
+
+		constexpr R inner_product(size_type row, size_type col) const noexcept
+		{
+			assert(row < _rows and col < _cols and "Index out of bounds!");
+			return _inner_products[row * _stride + col];
+		}
+
+		// Clamped to [-1, 1]. NaN if one of the two rows is the zero vector
+		constexpr R cosine(size_type row, size_type col) const noexcept
+		{
+			return std::clamp(inner_product(row, col) * _inverse_norms_a[row] * _inverse_norms_b[col], R{ -1 }, R{ 1 });
+		}
+
+		template<concepts::precision_policy Precision>
+		constexpr R angle(Precision precision, size_type row, size_type col) const noexcept
+		{
+			return detail::math::acos(precision, cosine(row, col));
+		}
+
+		constexpr R angle(size_type row, size_type col) const noexcept
+		{
+			return angle(MathLbr::precision::default_policy{}, row, col);
+		}
+
+		// Same criterion as Vector::are_parallel in dimensions other than 3: |a|^2 * |b|^2 - (a . b)^2 near zero
+		bool are_parallel(size_type row, size_type col, double epsilon = 1E-6) const noexcept
+		{
+			const R product = inner_product(row, col);
+			return detail::is_near_zero(_squared_norms_a[row] * _squared_norms_b[col] - product * product, epsilon);
+		}
+
+		bool are_perpendicular(size_type row, size_type col, double epsilon = 1E-6) const noexcept
+		{
+			return detail::is_near_zero(inner_product(row, col), epsilon);
+		}
+	};
+}
+
+
+namespace detail::similarity
+{
+	template<typename R>
+	struct row_norms
+	{
+		std::vector<R> squared;
+		std::vector<R> inverse;
+	};
+
+	// Squared norms and inverse norms of the m rows of a, of k elements each
+	template<typename R, typename A>
+	row_norms<R> norms(detail::gemm::strided<A> a, std::size_t m, std::size_t k)
+	{
+		row_norms<R> result{ std::vector<R>(m), std::vector<R>(m) };
+		for (std::size_t i = 0; i < m; ++i)
+		{
+			R sum{};
+			for (std::size_t p = 0; p < k; ++p)
+			{
+				const R value = static_cast<R>(a(i, p));
+				sum += value * value;
+			}
+			result.squared[i] = sum;
+			result.inverse[i] = R{ 1 } / std::sqrt(sum);
+		}
+		return result;
+	}
+
+	// Rows of b as the columns of transpose(b)
+	template<typename B>
+	constexpr detail::gemm::strided<B> transposed(detail::gemm::strided<B> b) noexcept
+	{
+		return { b.data, b.col_stride, b.row_stride };
+	}
+
+	// c = a * transpose(b) on rows [row, row + rows) of a and [col, col + cols) of b. c starts at the first element of the tile
+	template<typename R, typename A, typename B>
+	void inner_products(std::size_t k, detail::gemm::strided<A> a, detail::gemm::strided<B> b, detail::gemm::strided<R> c,
+		std::size_t row, std::size_t rows, std::size_t col, std::size_t cols)
+	{
+		const detail::gemm::strided<A> a_rows{ a.data + row * a.row_stride, a.row_stride, a.col_stride };
+		const detail::gemm::strided<B> b_rows{ b.data + col * b.row_stride, b.row_stride, b.col_stride };
+		detail::gemm::multiply_tile(k, a_rows, transposed(b_rows), c, 0, rows, 0, cols);
+	}
+
+	// Calls function(row, rows, col, cols) for every tile. symmetric: a and b are the same rows, tiles below the diagonal are skipped
+	template<typename R, typename Function>
+	void for_each_tile(std::size_t m, std::size_t n, bool symmetric, Function function)
+	{
+		using block = detail::gemm::blocking<R>;
+		const std::size_t col_tiles = (n + block::nc - 1) / block::nc;
+		for (std::size_t index = 0; index < detail::gemm::tile_count(m, n, block::mc, block::nc); ++index)
+		{
+			const std::size_t row = index / col_tiles * block::mc;
+			const std::size_t col = index % col_tiles * block::nc;
+			const std::size_t cols = std::min(block::nc, n - col);
+			if (not symmetric or col + cols > row + 1)
+			{
+				function(row, std::min(block::mc, m - row), col, cols);
+			}
+		}
+	}
+
+	template<typename R, typename Function>
+	void for_each_tile(const MathLbr::execution::parallel_policy& policy, std::size_t m, std::size_t n, bool symmetric, Function function)
+	{
+		using block = detail::gemm::blocking<R>;
+		if (detail::execution::use_serial_path(policy, m * n))
+		{
+			return detail::similarity::for_each_tile<R>(m, n, symmetric, function);
+		}
+		const std::size_t col_tiles = (n + block::nc - 1) / block::nc;
+		detail::execution::run_chunks(policy, detail::gemm::tile_count(m, n, block::mc, block::nc), [&](std::size_t index)
+			{
+				const std::size_t row = index / col_tiles * block::mc;
+				const std::size_t col = index % col_tiles * block::nc;
+				const std::size_t cols = std::min(block::nc, n - col);
+				if (not symmetric or col + cols > row + 1)
+				{
+					function(row, std::min(block::mc, m - row), col, cols);
+				}
+			});
+	}
+
+	template<typename R, typename Policy, typename Function>
+	void dispatch(const Policy& policy, std::size_t m, std::size_t n, bool symmetric, Function function)
+	{
+		if constexpr (concepts::parallel_execution_policy<Policy>) detail::similarity::for_each_tile<R>(policy, m, n, symmetric, function);
+		else detail::similarity::for_each_tile<R>(m, n, symmetric, function);
+	}
+
+	// Inner products of every tile, computed in a buffer of the calling thread, passed to function(MathLbr::Similarity::tile<R>)
+	template<typename R, typename Policy, typename A, typename B, typename Function>
+	void stream_tiles(const Policy& policy, detail::gemm::strided<A> a, std::size_t m, detail::gemm::strided<B> b, std::size_t n,
+		std::size_t k, bool symmetric, Function function)
+	{
+		const row_norms<R> norms_a = norms<R>(a, m, k);
+		const row_norms<R> norms_b = symmetric ? norms_a : norms<R>(b, n, k);
+		dispatch<R>(policy, m, n, symmetric, [&](std::size_t row, std::size_t rows, std::size_t col, std::size_t cols)
+			{
+				thread_local std::vector<R> buffer(detail::gemm::blocking<R>::mc * detail::gemm::blocking<R>::nc);
+				std::fill_n(buffer.data(), rows * cols, R{});
+				inner_products(k, a, b, detail::gemm::strided<R>{ buffer.data(), cols, 1 }, row, rows, col, cols);
+				function(MathLbr::Similarity::tile<R>{ buffer.data(), cols, row, rows, col, cols,
+					norms_a.squared.data() + row, norms_b.squared.data() + col, norms_a.inverse.data() + row, norms_b.inverse.data() + col });
+			});
+	}
+
+	// Pairs (i, j) of tiles for which select(tile, row, col) is true, as make(i, j, tile, row, col), sorted. symmetric: j > i only
+	template<typename Pair, typename R, typename Policy, typename A, typename B, typename Select, typename Make>
+	std::vector<Pair> pairs(const Policy& policy, detail::gemm::strided<A> a, std::size_t m, detail::gemm::strided<B> b, std::size_t n,
+		std::size_t k, bool symmetric, Select select, Make make)
+	{
+		std::vector<Pair> result;
+		std::mutex result_mutex;
+		stream_tiles<R>(policy, a, m, b, n, k, symmetric, [&](const MathLbr::Similarity::tile<R>& tile)
+			{
+				std::vector<Pair> found;
+				for (std::size_t row = 0; row < tile.rows(); ++row)
+				{
+					// symmetric: columns up to the diagonal are skipped
+					const std::size_t diagonal = tile.first_row() + row + 1;
+					const std::size_t first_col = symmetric and diagonal > tile.first_col() ? diagonal - tile.first_col() : 0;
+					for (std::size_t col = first_col; col < tile.cols(); ++col)
+					{
+						if (select(tile, row, col))
+						{
+							found.push_back(make(tile.first_row() + row, tile.first_col() + col, tile, row, col));
+						}
+					}
+				}
+				if (not found.empty())
+				{
+					const std::lock_guard lock{ result_mutex };
+					result.insert(result.end(), found.begin(), found.end());
+				}
+			});
+		// Tiles may finish in any order
+		std::sort(result.begin(), result.end(), [](const Pair& lhs, const Pair& rhs)
+			{
+				return std::pair{ lhs.first, lhs.second } < std::pair{ rhs.first, rhs.second };
+			});
+		return result;
+	}
+
+	// Element type of the similarities between the rows of matrices of T and T2
+	template<typename T, typename T2>
+	using result_type = decltype(std::declval<T>() * std::declval<T2>());
+}
+
+
+namespace MathLbr::Similarity
+{
+	/*
+		Calls function(const tile<R>&) for every tile of pairs (row of a, row of b). a and b must have the same number of
+		columns. With MathLbr::execution::par, function is called concurrently from several threads.
+	*/
+	template<concepts::execution_policy Policy,
+		concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2, typename Function>
+	void for_each_tile(Policy&& policy, const matrix<T, Rows, Cols, Order, Storage>& a, const matrix<T2, Rows2, Cols2, Order2, Storage2>& b,
+		Function function)
+	requires (std::floating_point<detail::similarity::result_type<T, T2>>)
+	{
+		detail::assert_same_extent<Cols, Cols2>(a.cols(), b.cols());
+		detail::similarity::stream_tiles<detail::similarity::result_type<T, T2>>(policy, detail::gemm::make_strided(a), a.rows(),
+			detail::gemm::make_strided(b), b.rows(), a.cols(), false, function);
+	}
+
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2, typename Function>
+	void for_each_tile(const matrix<T, Rows, Cols, Order, Storage>& a, const matrix<T2, Rows2, Cols2, Order2, Storage2>& b, Function function)
+	requires (std::floating_point<detail::similarity::result_type<T, T2>>)
+	{
+		for_each_tile(MathLbr::execution::seq, a, b, function);
+	}
+
+	// Rows of a with each other: only the tiles containing pairs (i, j) with j > i are computed, other pairs must be ignored
+	template<concepts::execution_policy Policy,
+		concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage, typename Function>
+	void for_each_tile(Policy&& policy, const matrix<T, Rows, Cols, Order, Storage>& a, Function function)
+	requires (std::floating_point<T>)
+	{
+		detail::similarity::stream_tiles<T>(policy, detail::gemm::make_strided(a), a.rows(),
+			detail::gemm::make_strided(a), a.rows(), a.cols(), true, function);
+	}
+
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage, typename Function>
+	void for_each_tile(const matrix<T, Rows, Cols, Order, Storage>& a, Function function)
+	requires (std::floating_point<T>)
+	{
+		for_each_tile(MathLbr::execution::seq, a, function);
+	}
+
+	// a.rows() x b.rows() matrix of the cosines between the rows of a and the rows of b
+	template<concepts::execution_policy Policy,
+		concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2>
+	auto cosine_matrix(Policy&& policy, const matrix<T, Rows, Cols, Order, Storage>& a, const matrix<T2, Rows2, Cols2, Order2, Storage2>& b)
+	requires (std::floating_point<detail::similarity::result_type<T, T2>>)
+	{
+		using R = detail::similarity::result_type<T, T2>;
+		detail::assert_same_extent<Cols, Cols2>(a.cols(), b.cols());
+
+		const auto a_rows = detail::gemm::make_strided(a);
+		const auto b_rows = detail::gemm::make_strided(b);
+		const auto norms_a = detail::similarity::norms<R>(a_rows, a.rows(), a.cols());
+		const auto norms_b = detail::similarity::norms<R>(b_rows, b.rows(), b.cols());
+
+		// Tiles are computed in place, then scaled while they are in cache
+		matrix<R> result(a.rows(), b.rows(), R{});
+		detail::similarity::dispatch<R>(policy, a.rows(), b.rows(), false, [&](std::size_t row, std::size_t rows, std::size_t col, std::size_t cols)
+			{
+				R* first = result.data() + row * b.rows() + col;
+				detail::similarity::inner_products(a.cols(), a_rows, b_rows, detail::gemm::strided<R>{ first, b.rows(), 1 }, row, rows, col, cols);
+				for (std::size_t i = 0; i < rows; ++i)
+				{
+					R* line = first + i * b.rows();
+					const R inverse_norm = norms_a.inverse[row + i];
+					const R* inverse_norms = norms_b.inverse.data() + col;
+					for (std::size_t j = 0; j < cols; ++j)
+					{
+						line[j] = std::clamp(line[j] * inverse_norm * inverse_norms[j], R{ -1 }, R{ 1 });
+					}
+				}
+			});
+		return result;
+	}
+
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2>
+	auto cosine_matrix(const matrix<T, Rows, Cols, Order, Storage>& a, const matrix<T2, Rows2, Cols2, Order2, Storage2>& b)
+	requires (std::floating_point<detail::similarity::result_type<T, T2>>)
+	{
+		return cosine_matrix(MathLbr::execution::seq, a, b);
+	}
+
+	// a.rows() x b.rows() matrix of the angles (radians) between the rows of a and the rows of b, acos vectorized over each row
+	template<concepts::execution_policy Policy, concepts::precision_policy Precision,
+		concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2>
+	auto angle_matrix(Policy&& policy, Precision, const matrix<T, Rows, Cols, Order, Storage>& a, const matrix<T2, Rows2, Cols2, Order2, Storage2>& b)
+	requires (std::floating_point<detail::similarity::result_type<T, T2>>)
+	{
+		using R = detail::similarity::result_type<T, T2>;
+		matrix<R> result = cosine_matrix(policy, a, b);
+		for (std::size_t first = 0; first < result.size(); first += detail::vectorized::block_size)
+		{
+			R* block = result.data() + first;
+			detail::vectorized::acos<Precision>(block, block, std::min(detail::vectorized::block_size, result.size() - first));
+		}
+		return result;
+	}
+
+	template<concepts::precision_policy Precision,
+		concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2>
+	auto angle_matrix(Precision precision, const matrix<T, Rows, Cols, Order, Storage>& a, const matrix<T2, Rows2, Cols2, Order2, Storage2>& b)
+	requires (std::floating_point<detail::similarity::result_type<T, T2>>)
+	{
+		return angle_matrix(MathLbr::execution::seq, precision, a, b);
+	}
+
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2>
+	auto angle_matrix(const matrix<T, Rows, Cols, Order, Storage>& a, const matrix<T2, Rows2, Cols2, Order2, Storage2>& b)
+	requires (std::floating_point<detail::similarity::result_type<T, T2>>)
+	{
+		return angle_matrix(MathLbr::execution::seq, MathLbr::precision::default_policy{}, a, b);
+	}
+
+	// Pairs (row of a, row of b) whose cosine is at least min_cosine, sorted
+	template<concepts::execution_policy Policy,
+		concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2>
+	auto similar_pairs(Policy&& policy, const matrix<T, Rows, Cols, Order, Storage>& a, const matrix<T2, Rows2, Cols2, Order2, Storage2>& b,
+		detail::similarity::result_type<T, T2> min_cosine)
+	requires (std::floating_point<detail::similarity::result_type<T, T2>>)
+	{
+		using R = detail::similarity::result_type<T, T2>;
+		detail::assert_same_extent<Cols, Cols2>(a.cols(), b.cols());
+		return detail::similarity::pairs<similar_pair<R>, R>(policy, detail::gemm::make_strided(a), a.rows(), detail::gemm::make_strided(b), b.rows(), a.cols(), false,
+			[=](const tile<R>& tile, std::size_t row, std::size_t col) { return tile.cosine(row, col) >= min_cosine; },
+			[](std::size_t i, std::size_t j, const tile<R>& tile, std::size_t row, std::size_t col) { return similar_pair<R>{ i, j, tile.cosine(row, col) }; });
+	}
+
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2>
+	auto similar_pairs(const matrix<T, Rows, Cols, Order, Storage>& a, const matrix<T2, Rows2, Cols2, Order2, Storage2>& b,
+		detail::similarity::result_type<T, T2> min_cosine)
+	requires (std::floating_point<detail::similarity::result_type<T, T2>>)
+	{
+		return similar_pairs(MathLbr::execution::seq, a, b, min_cosine);
+	}
+
+	// Pairs of rows (i, j) of a, with i < j, whose cosine is at least min_cosine (near duplicates), sorted
+	template<concepts::execution_policy Policy,
+		concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage>
+	auto similar_pairs(Policy&& policy, const matrix<T, Rows, Cols, Order, Storage>& a, T min_cosine)
+	requires (std::floating_point<T>)
+	{
+		return detail::similarity::pairs<similar_pair<T>, T>(policy, detail::gemm::make_strided(a), a.rows(), detail::gemm::make_strided(a), a.rows(), a.cols(), true,
+			[=](const tile<T>& tile, std::size_t row, std::size_t col) { return tile.cosine(row, col) >= min_cosine; },
+			[](std::size_t i, std::size_t j, const tile<T>& tile, std::size_t row, std::size_t col) { return similar_pair<T>{ i, j, tile.cosine(row, col) }; });
+	}
+
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage>
+	auto similar_pairs(const matrix<T, Rows, Cols, Order, Storage>& a, T min_cosine)
+	requires (std::floating_point<T>)
+	{
+		return similar_pairs(MathLbr::execution::seq, a, min_cosine);
+	}
+
+	// Pairs (row of a, row of b) that are parallel according to tile::are_parallel, sorted
+	template<concepts::execution_policy Policy,
+		concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2>
+	auto parallel_pairs(Policy&& policy, const matrix<T, Rows, Cols, Order, Storage>& a, const matrix<T2, Rows2, Cols2, Order2, Storage2>& b,
+		double epsilon = 1E-6)
+	requires (std::floating_point<detail::similarity::result_type<T, T2>>)
+	{
+		using R = detail::similarity::result_type<T, T2>;
+		detail::assert_same_extent<Cols, Cols2>(a.cols(), b.cols());
+		return detail::similarity::pairs<std::pair<std::size_t, std::size_t>, R>(policy, detail::gemm::make_strided(a), a.rows(),
+			detail::gemm::make_strided(b), b.rows(), a.cols(), false,
+			[=](const tile<R>& tile, std::size_t row, std::size_t col) { return tile.are_parallel(row, col, epsilon); },
+			[](std::size_t i, std::size_t j, const tile<R>&, std::size_t, std::size_t) { return std::pair{ i, j }; });
+	}
+
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2>
+	auto parallel_pairs(const matrix<T, Rows, Cols, Order, Storage>& a, const matrix<T2, Rows2, Cols2, Order2, Storage2>& b, double epsilon = 1E-6)
+	requires (std::floating_point<detail::similarity::result_type<T, T2>>)
+	{
+		return parallel_pairs(MathLbr::execution::seq, a, b, epsilon);
+	}
+
+	// Pairs (row of a, row of b) that are perpendicular according to tile::are_perpendicular, sorted
+	template<concepts::execution_policy Policy,
+		concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2>
+	auto perpendicular_pairs(Policy&& policy, const matrix<T, Rows, Cols, Order, Storage>& a, const matrix<T2, Rows2, Cols2, Order2, Storage2>& b,
+		double epsilon = 1E-6)
+	requires (std::floating_point<detail::similarity::result_type<T, T2>>)
+	{
+		using R = detail::similarity::result_type<T, T2>;
+		detail::assert_same_extent<Cols, Cols2>(a.cols(), b.cols());
+		return detail::similarity::pairs<std::pair<std::size_t, std::size_t>, R>(policy, detail::gemm::make_strided(a), a.rows(),
+			detail::gemm::make_strided(b), b.rows(), a.cols(), false,
+			[=](const tile<R>& tile, std::size_t row, std::size_t col) { return tile.are_perpendicular(row, col, epsilon); },
+			[](std::size_t i, std::size_t j, const tile<R>&, std::size_t, std::size_t) { return std::pair{ i, j }; });
+	}
+
+	template<concepts::underlying_vector_type T, std::size_t Rows, std::size_t Cols, Layout Order, typename Storage,
+		concepts::underlying_vector_type T2, std::size_t Rows2, std::size_t Cols2, Layout Order2, typename Storage2>
+	auto perpendicular_pairs(const matrix<T, Rows, Cols, Order, Storage>& a, const matrix<T2, Rows2, Cols2, Order2, Storage2>& b, double epsilon = 1E-6)
+	requires (std::floating_point<detail::similarity::result_type<T, T2>>)
+	{
+		return perpendicular_pairs(MathLbr::execution::seq, a, b, epsilon);
+	}
+}
+
+#endif
@@ -0,0 +1,300 @@
+#ifndef SMALL_VECTOR_HEADER
+#define SMALL_VECTOR_HEADER
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+
+namespace MathLbr
+{
+	/*
+		Contiguous container storing up to N elements inline, without any heap allocation; larger sizes spill to the heap.
+		Offers the subset of the std::vector interface used by MathLbr::vector (see small_storage).
+		Only meant for the element types of MathLbr::vector (arithmetic types and std::complex), which are trivially copyable.
+	*/
+	template<typename T, std::size_t N>
+	class small_vector_container
+	{
+		static_assert(N > 0, "The inline capacity must be greater than 0!");
+		static_assert(std::is_trivially_copyable_v<T>, "small_vector_container only supports trivially copyable types!");
+
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = T&;
+		using const_reference = const T&;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using iterator = T*;
+		using const_iterator = const T*;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		static constexpr size_type inline_capacity = N;
+
+	private:
+		std::array<T, N> _inline{};
+		T* _data = _inline.data(); // _inline.data() or heap memory
+		size_type _size = 0;
+		size_type _capacity = N;
+
+		// std::uninitialized_copy_n is not constexpr before C++23
+		static constexpr void construct_copies(const T* from, size_type count, T* to) noexcept
+		{
+			for (size_type i = 0; i < count; ++i)
+			{
+				std::construct_at(to + i, from[i]);
+			}
+		}
+
+		constexpr bool is_inline() const noexcept
+		{
+			return _capacity == N;
+		}
+
+		constexpr void release() noexcept
+		{
+			if (not is_inline())
+			{
+				std::allocator<T>{}.deallocate(_data, _capacity);
+				_data = _inline.data();
+				_capacity = N;
+			}
+		}
+
+		// Capacity grows geometrically, elements are kept
+		constexpr void grow_to(size_type count)
+		{
+			if (count <= _capacity) return;
+			const size_type new_capacity = std::max(count, 2 * _capacity);
+			T* new_data = std::allocator<T>{}.allocate(new_capacity);
+			construct_copies(_data, _size, new_data);
+			release();
+			_data = new_data;
+			_capacity = new_capacity;
+		}
+
+	public:
+		constexpr small_vector_container() noexcept = default;
+
+		constexpr explicit small_vector_container(size_type count)
+		{
+			resize(count);
+		}
+
+		template<std::input_iterator InputIter>
+		constexpr small_vector_container(InputIter first, InputIter last)
+		{
+			if constexpr (std::forward_iterator<InputIter>)
+			{
+				reserve(static_cast<size_type>(std::distance(first, last)));
+			}
+			for (; first != last; ++first)
+			{
+				push_back(static_cast<value_type>(*first));
+			}
+		}
+
+		constexpr small_vector_container(std::initializer_list<value_type> list)
+			: small_vector_container(list.begin(), list.end())
+		{
+		}
+
+		constexpr small_vector_container(const small_vector_container& other)
+			: small_vector_container(other.begin(), other.end())
+		{
+		}
+
+		// Heap memory is stolen, inline elements are copied
+		constexpr small_vector_container(small_vector_container&& other) noexcept
+		{
+			*this = std::move(other);
+		}
+
+		constexpr small_vector_container& operator=(const small_vector_container& other)
+		{
+			if (this != &other)
+			{
+				_size = 0;
+				grow_to(other._size);
+				construct_copies(other._data, other._size, _data);
+				_size = other._size;
+			}
+			return *this;
+		}
+
+		constexpr small_vector_container& operator=(small_vector_container&& other) noexcept
+		{
+			if (this == &other) return *this;
+			release();
+			if (other.is_inline())
+			{
+				construct_copies(other._data, other._size, _data);
+			}
+			else
+			{
+				_data = std::exchange(other._data, other._inline.data());
+				_capacity = std::exchange(other._capacity, N);
+			}
+			_size = std::exchange(other._size, 0);
+			return *this;
+		}
+
+		constexpr ~small_vector_container()
+		{
+			release();
+		}
+
+		constexpr size_type size() const noexcept
+		{
+			return _size;
+		}
+
+		constexpr size_type capacity() const noexcept
+		{
+			return _capacity;
+		}
+
+		constexpr bool empty() const noexcept
+		{
+			return _size == 0;
+		}
+
+		constexpr void reserve(size_type count)
+		{
+			grow_to(count);
+		}
+
+		// New elements are value-initialized
+		constexpr void resize(size_type count)
+		{
+			grow_to(count);
+			if (count > _size)
+			{
+				for (size_type i = _size; i < count; ++i)
+				{
+					std::construct_at(_data + i);
+				}
+			}
+			_size = count;
+		}
+
+		constexpr void push_back(const value_type& value)
+		{
+			if (_size == _capacity)
+			{
+				// value might refer to an element of the container itself
+				const value_type copy = value;
+				grow_to(_size + 1);
+				std::construct_at(_data + _size, copy);
+			}
+			else std::construct_at(_data + _size, value);
+			++_size;
+		}
+
+		constexpr void clear() noexcept
+		{
+			_size = 0;
+		}
+
+		constexpr reference operator[](size_type index) noexcept
+		{
+			return _data[index];
+		}
+
+		constexpr const_reference operator[](size_type index) const noexcept
+		{
+			return _data[index];
+		}
+
+		constexpr pointer data() noexcept
+		{
+			return _data;
+		}
+
+		constexpr const_pointer data() const noexcept
+		{
+			return _data;
+		}
+
+		constexpr iterator begin() noexcept
+		{
+			return _data;
+		}
+
+		constexpr const_iterator begin() const noexcept
+		{
+			return _data;
+		}
+
+		constexpr const_iterator cbegin() const noexcept
+		{
+			return _data;
+		}
+
+		constexpr iterator end() noexcept
+		{
+			return _data + _size;
+		}
+
+		constexpr const_iterator end() const noexcept
+		{
+			return _data + _size;
+		}
+
+		constexpr const_iterator cend() const noexcept
+		{
+			return _data + _size;
+		}
+
+		constexpr reverse_iterator rbegin() noexcept
+		{
+			return reverse_iterator(end());
+		}
+
+		constexpr const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		constexpr const_reverse_iterator crbegin() const noexcept
+		{
+			return rbegin();
+		}
+
+		constexpr reverse_iterator rend() noexcept
+		{
+			return reverse_iterator(begin());
+		}
+
+		constexpr const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		constexpr const_reverse_iterator crend() const noexcept
+		{
+			return rend();
+		}
+
+		friend constexpr bool operator==(const small_vector_container& lhs, const small_vector_container& rhs)
+		{
+			return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+		}
+
+		friend constexpr auto operator<=>(const small_vector_container& lhs, const small_vector_container& rhs)
+		requires (std::three_way_comparable<T>)
+		{
+			return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+		}
+	};
+}
+
+#endif
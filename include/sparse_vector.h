@@ -0,0 +1,659 @@
+#ifndef SPARSE_VECTOR_HEADER
+#define SPARSE_VECTOR_HEADER
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <numeric>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/*
+	sparse_vector<T> stores the non-zero elements of a real vector of dimension size(): their indices, sorted in increasing
+	order, and their values, in two arrays of the same length. Stored values are never zero.
+	Operations only visit the non-zero elements: an inner product between a vector with k non-zeros and a dense vector
+	costs k multiplications, whatever the dimension.
+*/
+
+namespace MathLbr
+{
+	template<concepts::arithmetic_char_const_excluded T>
+	class sparse_vector;
+}
+
+
+namespace concepts
+{
+	template<typename T>
+	struct is_sparse_vector : std::false_type {};
+
+	template<typename T>
+	struct is_sparse_vector<MathLbr::sparse_vector<T>> : std::true_type {};
+}
+
+
+namespace MathLbr
+{
+	template<concepts::arithmetic_char_const_excluded T>
+	class sparse_vector
+	{
+	public:
+		using size_type = std::size_t;
+		using value_type = T;
+		using index_container = std::vector<size_type>;
+		using value_container = std::vector<T>;
+
+		// Above this fraction of non-zero elements, a dense vector uses less memory and is faster (see Vector::to_sparse)
+		static constexpr double default_max_density = 0.1;
+
+	private:
+		size_type _size = 0;
+		index_container _indices;
+		value_container _values;
+
+		// Removes the stored zeros (results of cancellations, multiplications by zero, underflows)
+		constexpr void remove_zeros()
+		{
+			size_type kept = 0;
+			for (size_type k = 0; k < _values.size(); ++k)
+			{
+				if (_values[k] != value_type{})
+				{
+					_indices[kept] = _indices[k];
+					_values[kept] = _values[k];
+					++kept;
+				}
+			}
+			_indices.resize(kept);
+			_values.resize(kept);
+		}
+
+		// Merge of the non-zeros of both vectors: result = *this `op` other
+		template<typename Operation>
+		constexpr sparse_vector merge(const sparse_vector& other, Operation op) const
+		{
+			detail::assert_same_value<dynamic_extent>(size(), other.size());
+			sparse_vector result(size());
+			result.reserve(non_zeros() + other.non_zeros());
+
+			size_type i = 0, j = 0;
+			while (i < non_zeros() and j < other.non_zeros())
+			{
+				if (_indices[i] < other._indices[j])
+				{
+					result.push_back_unchecked(_indices[i], op(_values[i], value_type{}));
+					++i;
+				}
+				else if (other._indices[j] < _indices[i])
+				{
+					result.push_back_unchecked(other._indices[j], op(value_type{}, other._values[j]));
+					++j;
+				}
+				else
+				{
+					result.push_back_unchecked(_indices[i], op(_values[i], other._values[j]));
+					++i;
+					++j;
+				}
+			}
+			for (; i < non_zeros(); ++i)
+			{
+				result.push_back_unchecked(_indices[i], op(_values[i], value_type{}));
+			}
+			for (; j < other.non_zeros(); ++j)
+			{
+				result.push_back_unchecked(other._indices[j], op(value_type{}, other._values[j]));
+			}
+			return result;
+		}
+
+		static constexpr value_type magnitude(value_type value) noexcept
+		{
+			if constexpr (std::is_unsigned_v<value_type>) return value;
+			else return static_cast<value_type>(std::abs(value));
+		}
+
+		constexpr void push_back_unchecked(size_type index, value_type value)
+		{
+			if (value != value_type{})
+			{
+				_indices.push_back(index);
+				_values.push_back(value);
+			}
+		}
+
+	public:
+		constexpr sparse_vector() = default;
+
+		// Zero vector of dimension size
+		constexpr explicit sparse_vector(size_type size)
+			: _size{ size }
+		{
+		}
+
+		// Elements values[k] at indices[k], in any order. Values at the same index are summed, zeros are dropped
+		constexpr sparse_vector(size_type size, index_container indices, value_container values)
+			: _size{ size }
+		{
+			assert(indices.size() == values.size() && "There must be one value per index!");
+			assert(std::all_of(indices.begin(), indices.end(), [size](size_type index) { return index < size; })
+				&& "Indices must be smaller than the size of the vector!");
+
+			if (std::is_sorted(indices.begin(), indices.end()))
+			{
+				_indices = std::move(indices);
+				_values = std::move(values);
+			}
+			else
+			{
+				std::vector<size_type> order(indices.size());
+				std::iota(order.begin(), order.end(), size_type{ 0 });
+				std::stable_sort(order.begin(), order.end(), [&indices](size_type a, size_type b) { return indices[a] < indices[b]; });
+				_indices.reserve(order.size());
+				_values.reserve(order.size());
+				for (const size_type k : order)
+				{
+					_indices.push_back(indices[k]);
+					_values.push_back(values[k]);
+				}
+			}
+
+			// Sums duplicates in order of appearance
+			size_type last = 0;
+			for (size_type k = 1; k < _indices.size(); ++k)
+			{
+				if (_indices[k] == _indices[last])
+				{
+					_values[last] += _values[k];
+				}
+				else
+				{
+					++last;
+					_indices[last] = _indices[k];
+					_values[last] = _values[k];
+				}
+			}
+			if (not _indices.empty())
+			{
+				_indices.resize(last + 1);
+				_values.resize(last + 1);
+			}
+			remove_zeros();
+		}
+
+		constexpr sparse_vector(size_type size, std::initializer_list<std::pair<size_type, value_type>> elements)
+			: sparse_vector(size, [&elements]()
+				{
+					index_container indices;
+					indices.reserve(elements.size());
+					for (const auto& element : elements) indices.push_back(element.first);
+					return indices;
+				}(), [&elements]()
+				{
+					value_container values;
+					values.reserve(elements.size());
+					for (const auto& element : elements) values.push_back(element.second);
+					return values;
+				}())
+		{
+		}
+
+		// Non-zero elements of a dense vector
+		template<concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		constexpr explicit sparse_vector(const vector<T2, Size, Storage>& dense)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
+			: _size{ dense.size() }
+		{
+			for (size_type i = 0; i < dense.size(); ++i)
+			{
+				const value_type value = static_cast<value_type>(dense[i]);
+				if (value != value_type{})
+				{
+					_indices.push_back(i);
+					_values.push_back(value);
+				}
+			}
+		}
+
+		// Dimension of the vector
+		constexpr size_type size() const noexcept
+		{
+			return _size;
+		}
+
+		constexpr size_type non_zeros() const noexcept
+		{
+			return _indices.size();
+		}
+
+		// Fraction of non-zero elements, in [0, 1]
+		constexpr double density() const noexcept
+		{
+			return _size == 0 ? 0.0 : static_cast<double>(non_zeros()) / static_cast<double>(_size);
+		}
+
+		constexpr bool is_empty() const noexcept
+		{
+			return _indices.empty();
+		}
+
+		constexpr const index_container& indices() const noexcept
+		{
+			return _indices;
+		}
+
+		constexpr const value_container& values() const noexcept
+		{
+			return _values;
+		}
+
+		constexpr void reserve(size_type non_zeros)
+		{
+			_indices.reserve(non_zeros);
+			_values.reserve(non_zeros);
+		}
+
+		// All elements become zero, the dimension doesn't change
+		constexpr void clear() noexcept
+		{
+			_indices.clear();
+			_values.clear();
+		}
+
+		// Element at index (binary search)
+		constexpr value_type operator[](size_type index) const
+		{
+			assert(index < _size && "Index out of range!");
+			const auto found = std::lower_bound(_indices.begin(), _indices.end(), index);
+			if (found == _indices.end() or *found != index) return value_type{};
+			return _values[static_cast<size_type>(found - _indices.begin())];
+		}
+
+		// Sets the element at index: O(1) at the end of the vector, O(non_zeros()) elsewhere
+		constexpr void set(size_type index, value_type value)
+		{
+			assert(index < _size && "Index out of range!");
+			const auto found = std::lower_bound(_indices.begin(), _indices.end(), index);
+			const auto position = found - _indices.begin();
+			if (found != _indices.end() and *found == index)
+			{
+				if (value != value_type{}) _values[static_cast<size_type>(position)] = value;
+				else
+				{
+					_indices.erase(found);
+					_values.erase(_values.begin() + position);
+				}
+			}
+			else if (value != value_type{})
+			{
+				_indices.insert(found, index);
+				_values.insert(_values.begin() + position, value);
+			}
+		}
+
+		constexpr vector<value_type> to_dense() const
+		{
+			vector<value_type> result(_size);
+			for (size_type k = 0; k < non_zeros(); ++k)
+			{
+				result[_indices[k]] = _values[k];
+			}
+			return result;
+		}
+
+		// Same semantics as vector::norm<Norm>(), computed over the non-zero elements only
+		template<MathLbr::Norm Norm = MathLbr::Norm::L2>
+		auto norm() const
+		{
+			if constexpr (Norm == MathLbr::Norm::L0)
+			{
+				return static_cast<std::ptrdiff_t>(non_zeros());
+			}
+			else if constexpr (Norm == MathLbr::Norm::L1)
+			{
+				return std::accumulate(_values.begin(), _values.end(), value_type{},
+					[](value_type sum, value_type value) { return sum + magnitude(value); });
+			}
+			else if constexpr (Norm == MathLbr::Norm::L2)
+			{
+				using result_type = decltype(std::sqrt(std::declval<value_type>()));
+				const result_type sum = std::accumulate(_values.begin(), _values.end(), result_type{},
+					[](result_type sum, value_type value) { return sum + static_cast<result_type>(value) * static_cast<result_type>(value); });
+				if (detail::is_safe_sum_of_squares(sum) or std::isnan(sum) or is_empty()) return std::sqrt(sum);
+
+				// Overflow or underflow: the elements are scaled by the largest magnitude first
+				const result_type scale = std::accumulate(_values.begin(), _values.end(), result_type{},
+					[](result_type largest, value_type value) { return std::max(largest, static_cast<result_type>(magnitude(value))); });
+				const result_type scaled = std::accumulate(_values.begin(), _values.end(), result_type{},
+					[scale](result_type sum, value_type value)
+					{
+						const result_type ratio = static_cast<result_type>(value) / scale;
+						return sum + ratio * ratio;
+					});
+				return scale * std::sqrt(scaled);
+			}
+			else
+			{
+				// The element itself, with its sign, like vector::norm<Norm::LINF>()
+				value_type largest{};
+				for (const value_type value : _values)
+				{
+					largest = magnitude(largest) < magnitude(value) ? value : largest;
+				}
+				return largest;
+			}
+		}
+
+		template<std::size_t P>
+		auto p_norm() const requires (P >= 1)
+		{
+			const auto sum = std::accumulate(_values.begin(), _values.end(), decltype(std::pow(std::declval<value_type>(), P)){},
+				[](auto sum, value_type value) { return sum + std::pow(magnitude(value), P); });
+			return std::pow(sum, 1. / P);
+		}
+
+		constexpr sparse_vector& normalize()
+		{
+			const auto magnitude = norm();
+			detail::assert_div_byzero<decltype(magnitude)>(magnitude);
+			for (auto& value : _values)
+			{
+				value = static_cast<value_type>(value / magnitude);
+			}
+			remove_zeros();
+			return *this;
+		}
+
+		template<concepts::underlying_vector_type T2>
+		constexpr sparse_vector& operator*=(T2 lambda)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() * std::declval<T2>()), value_type>)
+		{
+			for (auto& value : _values)
+			{
+				value *= lambda;
+			}
+			remove_zeros();
+			return *this;
+		}
+
+		template<concepts::underlying_vector_type T2>
+		constexpr sparse_vector& operator/=(T2 lambda)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() / std::declval<T2>()), value_type>)
+		{
+			detail::assert_div_byzero<T2>(lambda);
+			for (auto& value : _values)
+			{
+				value /= lambda;
+			}
+			remove_zeros();
+			return *this;
+		}
+
+		constexpr sparse_vector& operator+=(const sparse_vector& other)
+		{
+			return *this = merge(other, [](value_type a, value_type b) { return static_cast<value_type>(a + b); });
+		}
+
+		constexpr sparse_vector& operator-=(const sparse_vector& other)
+		{
+			return *this = merge(other, [](value_type a, value_type b) { return static_cast<value_type>(a - b); });
+		}
+
+		constexpr sparse_vector operator-() const
+		requires (not std::is_unsigned_v<value_type>)
+		{
+			sparse_vector result = *this;
+			for (auto& value : result._values)
+			{
+				value = -value;
+			}
+			return result;
+		}
+
+		friend constexpr sparse_vector operator+(sparse_vector lhs, const sparse_vector& rhs)
+		{
+			return lhs += rhs;
+		}
+
+		friend constexpr sparse_vector operator-(sparse_vector lhs, const sparse_vector& rhs)
+		{
+			return lhs -= rhs;
+		}
+
+		template<concepts::underlying_vector_type T2>
+		friend constexpr sparse_vector operator*(sparse_vector lhs, T2 lambda)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() * std::declval<T2>()), value_type>)
+		{
+			return lhs *= lambda;
+		}
+
+		template<concepts::underlying_vector_type T2>
+		friend constexpr sparse_vector operator*(T2 lambda, sparse_vector rhs)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() * std::declval<T2>()), value_type>)
+		{
+			return rhs *= lambda;
+		}
+
+		template<concepts::underlying_vector_type T2>
+		friend constexpr sparse_vector operator/(sparse_vector lhs, T2 lambda)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() / std::declval<T2>()), value_type>)
+		{
+			return lhs /= lambda;
+		}
+
+		friend constexpr bool operator==(const sparse_vector& lhs, const sparse_vector& rhs) = default;
+	};
+
+
+	// Dense (op) sparse: only the elements at the non-zero indices of the sparse vector change
+	template<concepts::underlying_vector_type T, std::size_t Size, typename Storage, typename T2>
+	constexpr vector<T, Size, Storage>& operator+=(vector<T, Size, Storage>& dense, const sparse_vector<T2>& sparse)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<T>() + std::declval<T2>()), T>)
+	{
+		detail::assert_same_value<dynamic_extent>(dense.size(), sparse.size());
+		for (std::size_t k = 0; k < sparse.non_zeros(); ++k)
+		{
+			dense[sparse.indices()[k]] += sparse.values()[k];
+		}
+		return dense;
+	}
+
+	template<concepts::underlying_vector_type T, std::size_t Size, typename Storage, typename T2>
+	constexpr vector<T, Size, Storage>& operator-=(vector<T, Size, Storage>& dense, const sparse_vector<T2>& sparse)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<T>() - std::declval<T2>()), T>)
+	{
+		detail::assert_same_value<dynamic_extent>(dense.size(), sparse.size());
+		for (std::size_t k = 0; k < sparse.non_zeros(); ++k)
+		{
+			dense[sparse.indices()[k]] -= sparse.values()[k];
+		}
+		return dense;
+	}
+
+	template<concepts::underlying_vector_type T, std::size_t Size, typename Storage, typename T2>
+	constexpr auto operator+(const vector<T, Size, Storage>& dense, const sparse_vector<T2>& sparse)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<T>() + std::declval<T2>()), T>)
+	{
+		typename vector<T, Size, Storage>::result_type result(dense);
+		return result += sparse;
+	}
+
+	template<typename T, concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+	constexpr auto operator+(const sparse_vector<T>& sparse, const vector<T2, Size, Storage>& dense)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<T2>() + std::declval<T>()), T2>)
+	{
+		return dense + sparse;
+	}
+
+	template<concepts::underlying_vector_type T, std::size_t Size, typename Storage, typename T2>
+	constexpr auto operator-(const vector<T, Size, Storage>& dense, const sparse_vector<T2>& sparse)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<T>() - std::declval<T2>()), T>)
+	{
+		typename vector<T, Size, Storage>::result_type result(dense);
+		return result -= sparse;
+	}
+
+	template<typename T, concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+	constexpr auto operator-(const sparse_vector<T>& sparse, const vector<T2, Size, Storage>& dense)
+	requires (not std::is_unsigned_v<T2>
+	and concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<T2>() + std::declval<T>()), T2>)
+	{
+		typename vector<T2, Size, Storage>::result_type result(dense);
+		for (auto& element : result)
+		{
+			element = T2{} - element;
+		}
+		return result += sparse;
+	}
+
+
+	/*
+		Overloads of the MathLbr::Vector free functions for sparse vectors, with the same semantics as the dense versions.
+		Operands must have the same dimension.
+	*/
+	namespace Vector
+	{
+		// Merge of the sorted indices. When one vector has far fewer non-zeros, its indices are searched in the other one
+		template<typename T, typename T2>
+		constexpr auto inner_product(const sparse_vector<T>& lhs, const sparse_vector<T2>& other)
+		{
+			detail::assert_same_value<dynamic_extent>(lhs.size(), other.size());
+			using resulting_type = decltype(std::declval<T>() * std::declval<T2>());
+			const auto& lhs_indices = lhs.indices();
+			const auto& other_indices = other.indices();
+			resulting_type result{};
+
+			constexpr std::size_t search_ratio = 16;
+			if (lhs.non_zeros() * search_ratio < other.non_zeros() or other.non_zeros() * search_ratio < lhs.non_zeros())
+			{
+				const bool lhs_is_smaller = lhs.non_zeros() < other.non_zeros();
+				const auto& small = lhs_is_smaller ? lhs_indices : other_indices;
+				const auto& large = lhs_is_smaller ? other_indices : lhs_indices;
+				auto position = large.begin();
+				for (std::size_t k = 0; k < small.size(); ++k)
+				{
+					position = std::lower_bound(position, large.end(), small[k]);
+					if (position == large.end()) break;
+					if (*position == small[k])
+					{
+						const auto found = static_cast<std::size_t>(position - large.begin());
+						result += lhs_is_smaller ? lhs.values()[k] * other.values()[found] : lhs.values()[found] * other.values()[k];
+					}
+				}
+				return result;
+			}
+
+			// Branchless advance: which index moves is unpredictable, matches are rare
+			std::size_t i = 0, j = 0;
+			while (i < lhs_indices.size() and j < other_indices.size())
+			{
+				const std::size_t lhs_index = lhs_indices[i];
+				const std::size_t other_index = other_indices[j];
+				if (lhs_index == other_index)
+				{
+					result += lhs.values()[i] * other.values()[j];
+				}
+				i += static_cast<std::size_t>(lhs_index <= other_index);
+				j += static_cast<std::size_t>(other_index <= lhs_index);
+			}
+			return result;
+		}
+
+		// Gathers the dense elements at the non-zero indices
+		template<typename T, concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		constexpr auto inner_product(const sparse_vector<T>& lhs, const vector<T2, Size, Storage>& other)
+		requires (concepts::is_not_complex<T2>::value)
+		{
+			detail::assert_same_value<dynamic_extent>(lhs.size(), other.size());
+			using resulting_type = decltype(std::declval<T>() * std::declval<T2>());
+			const auto& indices = lhs.indices();
+			const auto& values = lhs.values();
+			resulting_type result{};
+			if constexpr (requires { other.data(); })
+			{
+				const T2* dense = other.data();
+				for (std::size_t k = 0; k < indices.size(); ++k)
+				{
+					result += values[k] * dense[indices[k]];
+				}
+			}
+			else
+			{
+				for (std::size_t k = 0; k < indices.size(); ++k)
+				{
+					result += values[k] * static_cast<T2>(other[indices[k]]);
+				}
+			}
+			return result;
+		}
+
+		template<concepts::underlying_vector_type T, std::size_t Size, typename Storage, typename T2>
+		constexpr auto inner_product(const vector<T, Size, Storage>& lhs, const sparse_vector<T2>& other)
+		requires (concepts::is_not_complex<T>::value)
+		{
+			return inner_product(other, lhs);
+		}
+
+		// Projection of `from` onto `to`: to * <from, to> / <to, to>
+		template<typename T, typename T2>
+		constexpr sparse_vector<T> projection(sparse_vector<T> to, const sparse_vector<T2>& from)
+		{
+			const auto denominator = inner_product(to, to);
+			detail::assert_div_byzero<decltype(denominator)>(denominator);
+			return to *= inner_product(from, to) / denominator;
+		}
+
+		template<typename T, concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		constexpr sparse_vector<T> projection(sparse_vector<T> to, const vector<T2, Size, Storage>& from)
+		requires (concepts::is_not_complex<T2>::value)
+		{
+			const auto denominator = inner_product(to, to);
+			detail::assert_div_byzero<decltype(denominator)>(denominator);
+			return to *= inner_product(to, from) / denominator;
+		}
+
+		template<concepts::underlying_vector_type T, std::size_t Size, typename Storage, typename T2>
+		constexpr auto projection(const vector<T, Size, Storage>& to, const sparse_vector<T2>& from)
+		requires (concepts::is_not_complex<T>::value)
+		{
+			typename vector<T, Size, Storage>::result_type result(to);
+			const auto denominator = inner_product(result, result);
+			detail::assert_div_byzero<decltype(denominator)>(denominator);
+			return result *= inner_product(from, result) / denominator;
+		}
+
+		template<typename T>
+		constexpr sparse_vector<T> normalize(sparse_vector<T> other)
+		{
+			return other.normalize();
+		}
+
+		// Sparse copy of dense, unless more than max_density of its elements are non-zero: then the dense vector should be kept
+		template<concepts::underlying_vector_type T, std::size_t Size, typename Storage>
+		constexpr std::optional<sparse_vector<T>> to_sparse(const vector<T, Size, Storage>& dense,
+			double max_density = sparse_vector<T>::default_max_density)
+		requires (concepts::is_not_complex<T>::value)
+		{
+			const auto non_zeros = static_cast<double>(dense.template norm<Norm::L0>());
+			if (dense.size() != 0 and non_zeros > max_density * static_cast<double>(dense.size())) return std::nullopt;
+			return sparse_vector<T>(dense);
+		}
+
+		// Dense copy of sparse, unless at most max_density of its elements are non-zero: then the sparse vector should be kept
+		template<typename T>
+		constexpr std::optional<vector<T>> to_dense(const sparse_vector<T>& sparse, double max_density = sparse_vector<T>::default_max_density)
+		{
+			if (sparse.density() <= max_density) return std::nullopt;
+			return sparse.to_dense();
+		}
+	}
+}
+
+#endif
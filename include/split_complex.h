@@ -0,0 +1,441 @@
+#ifndef SPLIT_COMPLEX_HEADER
+#define SPLIT_COMPLEX_HEADER
+
+#include "utility.h"
+
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+
+namespace MathLbr
+{
+	/*
+		Reference to a complex number whose real and imaginary parts are stored in two different arrays.
+		Behaves like std::complex<R>&: assigning to it writes through, reading it converts to std::complex<R>.
+	*/
+	template<typename R>
+	class complex_reference
+	{
+	private:
+		R* _real;
+		R* _imag;
+
+	public:
+		using value_type = std::complex<R>;
+
+		constexpr complex_reference(R& real, R& imag) noexcept
+			: _real(&real), _imag(&imag)
+		{
+		}
+
+		constexpr complex_reference(const complex_reference& other) noexcept = default;
+
+		// Assignments write to the referenced element, they never rebind the reference
+		constexpr const complex_reference& operator=(const complex_reference& other) const noexcept
+		{
+			return *this = other.get();
+		}
+
+		constexpr complex_reference& operator=(const complex_reference& other) noexcept
+		{
+			*_real = *other._real;
+			*_imag = *other._imag;
+			return *this;
+		}
+
+		constexpr const complex_reference& operator=(const value_type& value) const noexcept
+		{
+			*_real = value.real();
+			*_imag = value.imag();
+			return *this;
+		}
+
+		template<typename T2>
+		constexpr const complex_reference& operator=(const T2& value) const
+		requires (std::is_constructible_v<value_type, const T2&>)
+		{
+			return *this = value_type(value);
+		}
+
+		constexpr operator value_type() const noexcept
+		{
+			return { *_real, *_imag };
+		}
+
+		constexpr value_type get() const noexcept
+		{
+			return { *_real, *_imag };
+		}
+
+		constexpr R real() const noexcept
+		{
+			return *_real;
+		}
+
+		constexpr R imag() const noexcept
+		{
+			return *_imag;
+		}
+
+		template<typename T2>
+		constexpr const complex_reference& operator+=(const T2& val) const
+		{
+			value_type current = get();
+			current += val;
+			return *this = current;
+		}
+
+		template<typename T2>
+		constexpr const complex_reference& operator-=(const T2& val) const
+		{
+			value_type current = get();
+			current -= val;
+			return *this = current;
+		}
+
+		template<typename T2>
+		constexpr const complex_reference& operator*=(const T2& val) const
+		{
+			value_type current = get();
+			current *= val;
+			return *this = current;
+		}
+
+		template<typename T2>
+		constexpr const complex_reference& operator/=(const T2& val) const
+		{
+			value_type current = get();
+			current /= val;
+			return *this = current;
+		}
+
+		friend constexpr bool operator==(const complex_reference& lhs, const value_type& rhs) noexcept
+		{
+			return lhs.get() == rhs;
+		}
+
+		friend constexpr void swap(complex_reference lhs, complex_reference rhs) noexcept
+		{
+			std::swap(*lhs._real, *rhs._real);
+			std::swap(*lhs._imag, *rhs._imag);
+		}
+	};
+
+
+	template<typename R, bool Const>
+	class split_complex_iterator
+	{
+	private:
+		template<typename R2, bool Const2>
+		friend class split_complex_iterator;
+
+		using pointer_t = std::conditional_t<Const, const R*, R*>;
+		pointer_t _real = nullptr;
+		pointer_t _imag = nullptr;
+
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using iterator_concept = std::random_access_iterator_tag;
+		using value_type = std::complex<R>;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::conditional_t<Const, std::complex<R>, complex_reference<R>>;
+		using pointer = void;
+
+		constexpr split_complex_iterator() noexcept = default;
+
+		constexpr split_complex_iterator(pointer_t real, pointer_t imag) noexcept
+			: _real(real), _imag(imag)
+		{
+		}
+
+		// iterator -> const_iterator
+		template<bool OtherConst>
+		constexpr split_complex_iterator(const split_complex_iterator<R, OtherConst>& other) noexcept
+		requires (Const and not OtherConst)
+			: _real(other._real), _imag(other._imag)
+		{
+		}
+
+		constexpr reference operator*() const noexcept
+		{
+			return { *_real, *_imag };
+		}
+
+		constexpr reference operator[](difference_type offset) const noexcept
+		{
+			return *(*this + offset);
+		}
+
+		constexpr split_complex_iterator& operator++() noexcept
+		{
+			++_real;
+			++_imag;
+			return *this;
+		}
+
+		constexpr split_complex_iterator operator++(int) noexcept
+		{
+			auto temp = *this;
+			++*this;
+			return temp;
+		}
+
+		constexpr split_complex_iterator& operator--() noexcept
+		{
+			--_real;
+			--_imag;
+			return *this;
+		}
+
+		constexpr split_complex_iterator operator--(int) noexcept
+		{
+			auto temp = *this;
+			--*this;
+			return temp;
+		}
+
+		constexpr split_complex_iterator& operator+=(difference_type offset) noexcept
+		{
+			_real += offset;
+			_imag += offset;
+			return *this;
+		}
+
+		constexpr split_complex_iterator& operator-=(difference_type offset) noexcept
+		{
+			_real -= offset;
+			_imag -= offset;
+			return *this;
+		}
+
+		friend constexpr split_complex_iterator operator+(split_complex_iterator it, difference_type offset) noexcept
+		{
+			return it += offset;
+		}
+
+		friend constexpr split_complex_iterator operator+(difference_type offset, split_complex_iterator it) noexcept
+		{
+			return it += offset;
+		}
+
+		friend constexpr split_complex_iterator operator-(split_complex_iterator it, difference_type offset) noexcept
+		{
+			return it -= offset;
+		}
+
+		friend constexpr difference_type operator-(const split_complex_iterator& lhs, const split_complex_iterator& rhs) noexcept
+		{
+			return lhs._real - rhs._real;
+		}
+
+		friend constexpr bool operator==(const split_complex_iterator& lhs, const split_complex_iterator& rhs) noexcept
+		{
+			return lhs._real == rhs._real;
+		}
+
+		friend constexpr auto operator<=>(const split_complex_iterator& lhs, const split_complex_iterator& rhs) noexcept
+		{
+			return lhs._real <=> rhs._real;
+		}
+	};
+
+
+	/*
+		Container used by vectors with the split_complex_storage policy: real and imaginary parts are held in
+		two separate contiguous arrays (std::array if Size is given, std::vector otherwise).
+		Offers the subset of the std::vector/std::array interface used by MathLbr::vector.
+	*/
+	template<typename T, std::size_t Size>
+	requires (concepts::is_complex<T>::value)
+	class split_complex_container
+	{
+	public:
+		using value_type = T;
+		using real_type = typename T::value_type;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = complex_reference<real_type>;
+		using const_reference = T;
+		using iterator = split_complex_iterator<real_type, false>;
+		using const_iterator = split_complex_iterator<real_type, true>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	private:
+		using parts_container = std::conditional_t<concepts::dynamic_extent_enabled<Size>,
+			std::vector<real_type>, std::array<real_type, Size>>;
+
+		parts_container _real;
+		parts_container _imag;
+
+	public:
+		constexpr split_complex_container() = default;
+
+		constexpr explicit split_complex_container(size_type count)
+		requires (concepts::dynamic_extent_enabled<Size>)
+			: _real(count), _imag(count)
+		{
+		}
+
+		template<std::input_iterator InputIter>
+		constexpr split_complex_container(InputIter first, InputIter last)
+		{
+			if constexpr (concepts::dynamic_extent_enabled<Size>)
+			{
+				if constexpr (std::forward_iterator<InputIter>)
+				{
+					const auto count = static_cast<size_type>(std::distance(first, last));
+					_real.reserve(count);
+					_imag.reserve(count);
+				}
+				for (; first != last; ++first)
+				{
+					push_back(static_cast<value_type>(*first));
+				}
+			}
+			else
+			{
+				std::copy(first, last, begin());
+			}
+		}
+
+		// Mimics aggregate initialization for fixed sizes: remaining elements are zero initialized
+		constexpr split_complex_container(std::initializer_list<value_type> list)
+		{
+			if constexpr (concepts::dynamic_extent_enabled<Size>)
+			{
+				_real.reserve(list.size());
+				_imag.reserve(list.size());
+				for (const auto& element : list)
+				{
+					push_back(element);
+				}
+			}
+			else
+			{
+				_real = {};
+				_imag = {};
+				std::copy(list.begin(), list.end(), begin());
+			}
+		}
+
+		constexpr size_type size() const noexcept
+		{
+			return _real.size();
+		}
+
+		constexpr void resize(size_type count)
+		requires (concepts::dynamic_extent_enabled<Size>)
+		{
+			_real.resize(count);
+			_imag.resize(count);
+		}
+
+		constexpr void push_back(const value_type& value)
+		requires (concepts::dynamic_extent_enabled<Size>)
+		{
+			_real.push_back(value.real());
+			_imag.push_back(value.imag());
+		}
+
+		constexpr reference operator[](size_type index) noexcept
+		{
+			return { _real[index], _imag[index] };
+		}
+
+		constexpr const_reference operator[](size_type index) const noexcept
+		{
+			return { _real[index], _imag[index] };
+		}
+
+		constexpr real_type* real_data() noexcept
+		{
+			return _real.data();
+		}
+
+		constexpr const real_type* real_data() const noexcept
+		{
+			return _real.data();
+		}
+
+		constexpr real_type* imag_data() noexcept
+		{
+			return _imag.data();
+		}
+
+		constexpr const real_type* imag_data() const noexcept
+		{
+			return _imag.data();
+		}
+
+		constexpr iterator begin() noexcept
+		{
+			return { _real.data(), _imag.data() };
+		}
+
+		constexpr const_iterator begin() const noexcept
+		{
+			return { _real.data(), _imag.data() };
+		}
+
+		constexpr const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		constexpr iterator end() noexcept
+		{
+			return begin() + static_cast<difference_type>(size());
+		}
+
+		constexpr const_iterator end() const noexcept
+		{
+			return begin() + static_cast<difference_type>(size());
+		}
+
+		constexpr const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		constexpr reverse_iterator rbegin() noexcept
+		{
+			return reverse_iterator(end());
+		}
+
+		constexpr const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		constexpr const_reverse_iterator crbegin() const noexcept
+		{
+			return rbegin();
+		}
+
+		constexpr reverse_iterator rend() noexcept
+		{
+			return reverse_iterator(begin());
+		}
+
+		constexpr const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		constexpr const_reverse_iterator crend() const noexcept
+		{
+			return rend();
+		}
+
+		friend constexpr bool operator==(const split_complex_container& lhs, const split_complex_container& rhs) = default;
+	};
+}
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef STORAGE_HEADER
+#define STORAGE_HEADER
+
+#include "utility.h"
+#include "split_complex.h"
+#include "small_vector.h"
+#include "aligned.h"
+#include "view.h"
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+
+namespace MathLbr
+{
+	/*
+		Storage policies: the third template argument of MathLbr::vector decides which container holds the elements.
+		A policy only needs a member alias template container<T, Size>.
+	*/
+
+	// std::vector<T, Allocator> if Size == dynamic_extent, std::array<T, Size> otherwise.
+	// Allocator is rebound to the element type, so allocator_storage<std::allocator<void>> works for every T.
+	template<typename Allocator>
+	struct allocator_storage
+	{
+		template<typename T, std::size_t Size>
+		using container = std::conditional_t<concepts::dynamic_extent_enabled<Size>,
+			std::vector<T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>, std::array<T, Size>>;
+	};
+
+	// std::vector<T> if Size == dynamic_extent, std::array<T, Size> otherwise
+	using default_storage = allocator_storage<std::allocator<void>>;
+
+	// Dynamic vectors keep up to N elements inline and only allocate beyond that, std::array<T, Size> for fixed sizes
+	template<std::size_t N = 16>
+	struct small_storage
+	{
+		template<typename T, std::size_t Size>
+		using container = std::conditional_t<concepts::dynamic_extent_enabled<Size>,
+			small_vector_container<T, N>, std::array<T, Size>>;
+	};
+
+	/*
+		Elements start at an address multiple of Alignment (e.g. a cache line, or the width of an AVX-512 register),
+		for fixed sizes (aligned_array) as well as dynamic ones (std::vector with aligned_allocator).
+		HugePages: dynamic vectors of at least 2 MiB ask for transparent huge pages (Linux only).
+	*/
+	template<std::size_t Alignment = 64, bool HugePages = false>
+	struct aligned
+	{
+		static_assert(Alignment > 0 and (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two!");
+
+		static constexpr std::size_t alignment = Alignment;
+
+		template<typename T, std::size_t Size>
+		using container = std::conditional_t<concepts::dynamic_extent_enabled<Size>,
+			std::vector<T, aligned_allocator<T, Alignment, HugePages>>, aligned_array<T, Size, Alignment>>;
+	};
+
+	/*
+		Non-owning: the vector refers to elements stored elsewhere (see vector_view), read-only if Const is true.
+		Operations returning a new vector (expressions, Vector::normalize, Vector::cross_product ...) return a vector
+		using result_storage instead.
+	*/
+	template<bool Const = false>
+	struct view_storage
+	{
+		using result_storage = default_storage;
+
+		template<typename T, std::size_t Size>
+		using container = view_container<T, Size, Const>;
+	};
+
+	// Complex vectors only: real and imaginary parts are stored in two separate arrays.
+	// Element access returns a proxy (complex_reference) instead of std::complex<T>&.
+	struct split_complex_storage
+	{
+		template<typename T, std::size_t Size>
+		using container = split_complex_container<T, Size>;
+	};
+}
+
+
+namespace concepts
+{
+	template<typename Storage, typename T, std::size_t Size>
+	concept vector_storage = requires { typename Storage::template container<T, Size>; };
+
+	template<typename Container>
+	concept contiguous_container = requires(Container& container) { { container.data() } -> std::convertible_to<const typename Container::value_type*>; };
+
+	template<typename Container>
+	concept split_container = requires(Container& container) { container.real_data(); container.imag_data(); };
+
+	template<typename Container>
+	struct is_non_owning_container : std::false_type {};
+
+	template<typename T, std::size_t Size, bool Const>
+	struct is_non_owning_container<MathLbr::view_container<T, Size, Const>> : std::true_type {};
+
+	template<typename Container>
+	concept non_owning_container = is_non_owning_container<Container>::value;
+
+	template<typename Container>
+	concept owning_container = not non_owning_container<Container>;
+
+	template<typename Container>
+	concept allocator_aware_container = requires(const Container& container)
+	{
+		typename Container::allocator_type;
+		{ container.get_allocator() } -> std::same_as<typename Container::allocator_type>;
+	};
+}
+
+
+namespace detail
+{
+	// Placeholder allocator_type of vectors whose container doesn't use an allocator (e.g. std::array)
+	struct no_allocator {};
+
+	template<typename Container>
+	struct container_allocator
+	{
+		using type = no_allocator;
+	};
+
+	template<concepts::allocator_aware_container Container>
+	struct container_allocator<Container>
+	{
+		using type = typename Container::allocator_type;
+	};
+
+	template<typename Container>
+	using container_allocator_t = typename container_allocator<Container>::type;
+
+	// Storage of the vectors returned by value: Storage::result_storage if provided (e.g. views), Storage otherwise
+	template<typename Storage>
+	struct result_storage
+	{
+		using type = Storage;
+	};
+
+	template<typename Storage>
+	requires requires { typename Storage::result_storage; }
+	struct result_storage<Storage>
+	{
+		using type = typename Storage::result_storage;
+	};
+
+	template<typename Storage>
+	using result_storage_t = typename result_storage<Storage>::type;
+
+	// Pointer to the elements: T* (const T* for read-only views)
+	template<typename Container, typename T>
+	struct container_pointer
+	{
+		using type = T*;
+	};
+
+	template<concepts::non_owning_container Container, typename T>
+	struct container_pointer<Container, T>
+	{
+		using type = typename Container::pointer;
+	};
+
+	template<typename Container, typename T>
+	using container_pointer_t = typename container_pointer<Container, T>::type;
+
+	// Alignment guaranteed for the first element by a storage policy: Storage::alignment if provided, alignof(T) otherwise
+	template<typename Storage, typename T>
+	constexpr std::size_t storage_alignment() noexcept
+	{
+		if constexpr (requires { { Storage::alignment } -> std::convertible_to<std::size_t>; })
+		{
+			return Storage::alignment < alignof(T) ? alignof(T) : Storage::alignment;
+		}
+		else return alignof(T);
+	}
+}
+
+#endif
@@ -0,0 +1,255 @@
+#ifndef SUMMATION_HEADER
+#define SUMMATION_HEADER
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+namespace MathLbr::summation
+{
+	// Same behaviour as the overloads without a summation policy
+	struct sequential_policy {};
+
+	/*
+		Blocks of terms are summed with independent accumulators (vectorized), and the block sums are added pairwise:
+		the rounding error grows with log(n) instead of n, at the speed of a vectorized sum.
+	*/
+	struct pairwise_policy {};
+
+	// Compensated (Kahan) summation in independent lanes: the error bound doesn't depend on n. Best for terms of the same sign
+	struct kahan_policy {};
+
+	// Kahan-Babuska-Neumaier summation in independent lanes: also accurate when large terms cancel (e.g. inner products)
+	struct neumaier_policy {};
+
+	inline constexpr sequential_policy sequential{};
+	inline constexpr pairwise_policy pairwise{};
+	inline constexpr kahan_policy kahan{};
+	inline constexpr neumaier_policy neumaier{};
+}
+
+
+namespace concepts
+{
+	template<typename T>
+	concept summation_policy = std::is_same_v<std::remove_cvref_t<T>, MathLbr::summation::sequential_policy>
+		or std::is_same_v<std::remove_cvref_t<T>, MathLbr::summation::pairwise_policy>
+		or std::is_same_v<std::remove_cvref_t<T>, MathLbr::summation::kahan_policy>
+		or std::is_same_v<std::remove_cvref_t<T>, MathLbr::summation::neumaier_policy>;
+}
+
+
+/*
+	Summation kernels: sum(term(i)) for i in [0, count).
+	Terms are evaluated in blocks, stored in a small array, and accumulated by `lanes` independent accumulators: full
+	blocks are loops with constant trip counts, which the compiler vectorizes without reassociating, i.e. without
+	-ffast-math (which must not be used with the compensated policies: it may optimize the compensation away).
+*/
+namespace detail::summation
+{
+	inline constexpr std::size_t lanes = 8;
+	inline constexpr std::size_t block_size = 256;
+	static_assert(block_size % lanes == 0);
+
+	// Pairwise sum of the lanes
+	template<typename R>
+	constexpr R combine_lanes(const R (&values)[lanes]) noexcept
+	{
+		return ((values[0] + values[1]) + (values[2] + values[3])) + ((values[4] + values[5]) + (values[6] + values[7]));
+	}
+
+	// Calls accumulate(terms, length) for every block of terms. Length is std::integral_constant for full blocks
+	template<typename R, typename Term, typename Accumulate>
+	void for_each_block(std::size_t count, Term& term, Accumulate accumulate)
+	{
+		R terms[block_size];
+		std::size_t first = 0;
+		for (; first + block_size <= count; first += block_size)
+		{
+			for (std::size_t i = 0; i < block_size; ++i)
+			{
+				terms[i] = static_cast<R>(term(first + i));
+			}
+			accumulate(terms, std::integral_constant<std::size_t, block_size>{});
+		}
+		if (first < count)
+		{
+			const std::size_t length = count - first;
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				terms[i] = static_cast<R>(term(first + i));
+			}
+			// Zero padding up to a multiple of lanes doesn't change any sum
+			const std::size_t padded = (length + lanes - 1) / lanes * lanes;
+			for (std::size_t i = length; i < padded; ++i)
+			{
+				terms[i] = R{};
+			}
+			accumulate(terms, padded);
+		}
+	}
+
+	template<typename R, typename Term>
+	R sequential_sum(std::size_t count, Term& term)
+	{
+		R result{};
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			result += static_cast<R>(term(i));
+		}
+		return result;
+	}
+
+	// Blocks are summed with `lanes` accumulators, and block sums are combined like the leaves of a binary tree
+	// (partial[level] holds the sum of 2^level blocks, merged like the carries of a binary counter)
+	template<typename R, typename Term>
+	R pairwise_sum(std::size_t count, Term& term)
+	{
+		R partial[64];
+		std::uint64_t occupied = 0;
+		for_each_block<R>(count, term, [&](const R* terms, auto length)
+			{
+				R accumulators[lanes]{};
+				for (std::size_t i = 0; i < length; i += lanes)
+				{
+					for (std::size_t lane = 0; lane < lanes; ++lane)
+					{
+						accumulators[lane] += terms[i + lane];
+					}
+				}
+				R sum = combine_lanes(accumulators);
+				std::size_t level = 0;
+				for (; occupied & (std::uint64_t{ 1 } << level); ++level)
+				{
+					sum = partial[level] + sum;
+					occupied &= ~(std::uint64_t{ 1 } << level);
+				}
+				partial[level] = sum;
+				occupied |= std::uint64_t{ 1 } << level;
+			});
+
+		R result{};
+		for (std::size_t level = 0; level < 64; ++level)
+		{
+			if (occupied & (std::uint64_t{ 1 } << level)) result = partial[level] + result;
+		}
+		return result;
+	}
+
+	template<typename R>
+	constexpr void kahan_add(R& sum, R& compensation, R value) noexcept
+	{
+		const R corrected = value - compensation;
+		const R total = sum + corrected;
+		compensation = (total - sum) - corrected;
+		sum = total;
+	}
+
+	template<typename R>
+	constexpr void neumaier_add(R& sum, R& compensation, R value) noexcept
+	{
+		// The exact rounding error of sum + value, whichever operand is larger (TwoSum: branch-free, so it vectorizes)
+		const R total = sum + value;
+		const R rounded = total - sum;
+		compensation += (sum - (total - rounded)) + (value - rounded);
+		sum = total;
+	}
+
+	// sum + compensation == new sum + new compensation exactly, with |new compensation| <= ulp(new sum) / 2 (TwoSum)
+	template<typename R>
+	constexpr void renormalize(R& sum, R& compensation) noexcept
+	{
+		const R total = sum + compensation;
+		const R rounded = total - sum;
+		compensation = (sum - (total - rounded)) + (compensation - rounded);
+		sum = total;
+	}
+
+	template<typename R, typename Term>
+	R kahan_sum(std::size_t count, Term& term)
+	{
+		R sums[lanes]{}, compensations[lanes]{};
+		for_each_block<R>(count, term, [&](const R* terms, auto length)
+			{
+				// Local copies: the lanes stay in registers
+				R block_sums[lanes], block_compensations[lanes];
+				std::copy_n(sums, lanes, block_sums);
+				std::copy_n(compensations, lanes, block_compensations);
+				for (std::size_t i = 0; i < length; i += lanes)
+				{
+					for (std::size_t lane = 0; lane < lanes; ++lane)
+					{
+						kahan_add(block_sums[lane], block_compensations[lane], terms[i + lane]);
+					}
+				}
+				std::copy_n(block_sums, lanes, sums);
+				std::copy_n(block_compensations, lanes, compensations);
+			});
+
+		R result{}, compensation{};
+		for (std::size_t lane = 0; lane < lanes; ++lane)
+		{
+			kahan_add(result, compensation, sums[lane]);
+			kahan_add(result, compensation, -compensations[lane]);
+		}
+		return result;
+	}
+
+	template<typename R, typename Term>
+	R neumaier_sum(std::size_t count, Term& term)
+	{
+		R sums[lanes]{}, compensations[lanes]{};
+		for_each_block<R>(count, term, [&](const R* terms, auto length)
+			{
+				R block_sums[lanes], block_compensations[lanes];
+				std::copy_n(sums, lanes, block_sums);
+				std::copy_n(compensations, lanes, block_compensations);
+				for (std::size_t i = 0; i < length; i += lanes)
+				{
+					for (std::size_t lane = 0; lane < lanes; ++lane)
+					{
+						neumaier_add(block_sums[lane], block_compensations[lane], terms[i + lane]);
+					}
+				}
+				// Compensations accumulate rounding errors themselves: fold them back before they grow
+				for (std::size_t lane = 0; lane < lanes; ++lane)
+				{
+					renormalize(block_sums[lane], block_compensations[lane]);
+				}
+				std::copy_n(block_sums, lanes, sums);
+				std::copy_n(block_compensations, lanes, compensations);
+			});
+
+		R result{}, compensation{};
+		for (std::size_t lane = 0; lane < lanes; ++lane)
+		{
+			neumaier_add(result, compensation, sums[lane]);
+			neumaier_add(result, compensation, compensations[lane]);
+		}
+		return result + compensation;
+	}
+
+	// Integral sums are exact (until they overflow): every policy sums them sequentially
+	template<typename R, typename Policy, typename Term>
+	R sum(const Policy&, std::size_t count, Term term)
+	{
+		if constexpr (not std::is_floating_point_v<R> or std::is_same_v<Policy, MathLbr::summation::sequential_policy>)
+		{
+			return sequential_sum<R>(count, term);
+		}
+		else if constexpr (std::is_same_v<Policy, MathLbr::summation::pairwise_policy>)
+		{
+			return pairwise_sum<R>(count, term);
+		}
+		else if constexpr (std::is_same_v<Policy, MathLbr::summation::kahan_policy>)
+		{
+			return kahan_sum<R>(count, term);
+		}
+		else return neumaier_sum<R>(count, term);
+	}
+}
+
+#endif
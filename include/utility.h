@@ -1,11 +1,14 @@
 #ifndef UTILITY_HEADER
 #define UTILITY_HEADER
 
+#include "half.h"
+
 #include <complex>
 #include <type_traits>
 #include <cassert>
 #include <random>
 #include <concepts>
+#include <limits>
 
 
 namespace MathLbr
@@ -60,7 +63,7 @@ namespace concepts
 
 	template<typename T>
 	concept underlying_vector_type =
-		(is_complex<T>::value or std::is_arithmetic_v<T>)
+		(is_complex<T>::value or std::is_arithmetic_v<T> or half_precision_type<T>)
 		and not std::is_same_v<T, char>
 		and not std::is_const_v<T>;
 
@@ -93,9 +96,12 @@ namespace concepts
 	concept convertible_to_or_not_narrowing_inner_product = concepts::convertible_to_or_not_narrowing_conversion<decltype(
 		std::declval<T>()* std::declval<T2>() + std::declval<T>() * std::declval<T2>()), T>;
 
+	// Real type of the elements (of their parts for complex numbers). 16 bits floating point numbers (see half.h) are
+	// only a storage format: their sums and norms are computed in float
 	template<typename T>
 	using dispatched_underlying_type = typename std::conditional<concepts::is_complex<T>::value,
-		typename concepts::is_complex<T>::value_type, T>::type;
+		typename concepts::is_complex<T>::value_type,
+		typename std::conditional<half_precision_type<T>, float, T>::type>::type;
 }
 
 
@@ -117,7 +123,7 @@ namespace detail
 			&& abs_val_imag >= 0 && abs_val_imag <= abs_epsilon;
 	}
 
-	template<std::size_t Size = -1, std::size_t OtherSize = -1>
+	template<std::size_t Size = MathLbr::dynamic_extent, std::size_t OtherSize = MathLbr::dynamic_extent>
 	constexpr void dispatch_assert_size_mismatch(std::size_t NonTemplateSize, std::size_t NonTemplateOtherSize)
 	{
 		if constexpr (concepts::are_sizes_compiletime<Size, OtherSize>)
@@ -172,6 +178,15 @@ namespace detail
 		assert((given_value != Value{} and "Cannot perform division by zero!"));
 	}
 
+	// True if a floating point sum of squares can be used as is to compute a Euclidean norm: it neither overflowed nor
+	// lost precision to underflow. Otherwise the elements must be scaled first, like BLAS nrm2 does
+	template<std::floating_point R>
+	constexpr bool is_safe_sum_of_squares(R sum) noexcept
+	{
+		return sum >= std::numeric_limits<R>::min() / std::numeric_limits<R>::epsilon()
+			and sum <= std::numeric_limits<R>::max();
+	}
+
 	template<std::size_t Size, typename T, typename T2>
 	constexpr void assert_same_value(T lhs, T2 rhs)
 	{
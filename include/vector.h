@@ -2,6 +2,14 @@
 #define VECTOR_MATH_MINILIBRARY
 
 #include "utility.h"
+#include "vector_expression.h"
+#include "simd.h"
+#include "storage.h"
+#include "execution.h"
+#include "summation.h"
+#include "precision.h"
+#include "constexpr_math.h"
+#include "vectorized_math.h"
 
 #include <array>
 #include <vector>
@@ -11,10 +19,13 @@
 #include <concepts>
 #include <initializer_list> 
 #include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <numeric>
 #include <numbers>
 #include <optional>
 #include <random>
+#include <ranges>
 #include <type_traits>
 #include <utility>
 
@@ -28,14 +39,21 @@
 
 namespace MathLbr 
 {
-	template<concepts::underlying_vector_type T, std::size_t Size = dynamic_extent>
+	template<concepts::underlying_vector_type T, std::size_t Size = dynamic_extent, typename Storage = default_storage>
 	class vector;
 
 	namespace Vector 
 	{
+		// Used by the triple products and similarity checks below
+		template<typename T, std::size_t Size, typename Storage>
+		constexpr auto normalize(vector<T, Size, Storage> other);
+
+		template<concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size1, typename Storage, typename Storage2>
+		constexpr auto cross_product(vector<T, Size1, Storage> lhs, const vector<T2, Size1, Storage2>& rhs);
+
 		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
-			concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size>
-		constexpr auto inner_product(const vector<T, Size>& lhs, const vector<T2, Size>& other)
+			concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size, typename Storage, typename Storage2>
+		constexpr auto inner_product(const vector<T, Size, Storage>& lhs, const vector<T2, Size, Storage2>& other)
 		requires (concepts::is_all_complex<T, T2>)
 		{
 			// std::complex does not support std::complex<T> OP std::complex<T2>, so static_cast is needed
@@ -44,6 +62,28 @@ namespace MathLbr
 				std::declval<concepts::dispatched_underlying_type<T2>>());
 			using resulting_type = std::complex<resulting_type_mult>;
 
+			// Contiguous (interleaved or split) complex<float>/complex<double> vectors use the explicitly vectorized kernels
+			if constexpr (std::is_same_v<T, T2> and concepts::simd_complex_type<T>
+				and (requires { lhs.data(); other.data(); } or requires { lhs.real_data(); other.real_data(); }))
+			{
+				if (not std::is_constant_evaluated())
+				{
+					T result;
+					if constexpr (requires { lhs.real_data(); other.real_data(); })
+					{
+						result = detail::simd::split_conj_dot(lhs.real_data(), lhs.imag_data(),
+							other.real_data(), other.imag_data(), lhs.size());
+					}
+					else result = detail::simd::conj_dot(lhs.data(), other.data(), lhs.size());
+					if constexpr (definition_type == ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT)
+					{
+						return result;
+					}
+					// sum(a * conj(b)) == conj(sum(conj(a) * b))
+					else return std::conj(result);
+				}
+			}
+
 			return std::transform_reduce(lhs.begin(), lhs.end(), other.begin(), resulting_type{},
 				std::plus<resulting_type>{}, [](const auto& lhs_elem, const auto& other_elem)
 				{
@@ -59,15 +99,126 @@ namespace MathLbr
 				});
 		}
 
-		template<concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size>
-		constexpr auto inner_product(const vector<T, Size>& lhs, const vector<T2, Size>& other)
+		template<concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size, typename Storage, typename Storage2>
+		constexpr auto inner_product(const vector<T, Size, Storage>& lhs, const vector<T2, Size, Storage2>& other)
 		requires (concepts::is_not_all_complex<T, T2>)
 		{
 			detail::assert_same_value<Size>(lhs.size(), other.size());
+			if constexpr (std::is_same_v<T, T2> and concepts::simd_small_vector<T, Size> and requires { lhs.data(); other.data(); })
+			{
+				return detail::simd::fixed::dot<Size>(lhs.data(), other.data());
+			}
+			else if constexpr (std::is_same_v<T, T2> and (concepts::simd_real_type<T> or concepts::half_precision_type<T>)
+				and requires { lhs.data(); other.data(); })
+			{
+				// 16 bits floating point numbers are accumulated in float
+				if (not std::is_constant_evaluated())
+				{
+					return detail::simd::dot(lhs.data(), other.data(), lhs.size());
+				}
+			}
 			return std::inner_product(lhs.begin(), lhs.end(),
 				other.begin(), decltype(std::declval<T>() * std::declval<T2>()){});
 		}
 
+		// Inner product with an execution policy (see execution.h), for real and complex vectors
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+			concepts::execution_policy Policy, concepts::underlying_vector_type T, concepts::underlying_vector_type T2,
+			std::size_t Size, typename Storage, typename Storage2>
+		auto inner_product(const Policy& policy, const vector<T, Size, Storage>& lhs, const vector<T2, Size, Storage2>& other)
+		{
+			const auto serial = [&]()
+			{
+				if constexpr (concepts::is_all_complex<T, T2>) return inner_product<definition_type>(lhs, other);
+				else return inner_product(lhs, other);
+			};
+			if constexpr (not concepts::parallel_execution_policy<Policy>)
+			{
+				return serial();
+			}
+			else
+			{
+				detail::assert_same_value<Size>(lhs.size(), other.size());
+				if (detail::execution::use_serial_path(policy, lhs.size())) return serial();
+
+				if constexpr (concepts::is_all_complex<T, T2>)
+				{
+					using resulting_type = std::complex<decltype(std::declval<concepts::dispatched_underlying_type<T>>() *
+						std::declval<concepts::dispatched_underlying_type<T2>>())>;
+					// Every chunk computes sum(conj(lhs) * other), conjugated at the end for ANTILINEAR_SECOND_ARGUMENT
+					const auto result = detail::execution::reduce_chunks(policy, lhs.size(), resulting_type{},
+						[&](std::size_t first, std::size_t last) -> resulting_type
+						{
+							if constexpr (std::is_same_v<T, T2> and concepts::simd_complex_type<T>
+								and requires { lhs.real_data(); other.real_data(); })
+							{
+								return detail::simd::split_conj_dot(lhs.real_data() + first, lhs.imag_data() + first,
+									other.real_data() + first, other.imag_data() + first, last - first);
+							}
+							else if constexpr (std::is_same_v<T, T2> and concepts::simd_complex_type<T>
+								and requires { lhs.data(); other.data(); })
+							{
+								return detail::simd::conj_dot(lhs.data() + first, other.data() + first, last - first);
+							}
+							else
+							{
+								return std::transform_reduce(lhs.begin() + first, lhs.begin() + last, other.begin() + first,
+									resulting_type{}, std::plus<resulting_type>{}, [](const auto& lhs_elem, const auto& other_elem)
+									{
+										return std::conj(static_cast<resulting_type>(lhs_elem)) * static_cast<resulting_type>(other_elem);
+									});
+							}
+						}, std::plus<resulting_type>{});
+					if constexpr (definition_type == ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT) return result;
+					else return std::conj(result);
+				}
+				else
+				{
+					using resulting_type = decltype(std::declval<T>() * std::declval<T2>());
+					return detail::execution::reduce_chunks(policy, lhs.size(), resulting_type{},
+						[&](std::size_t first, std::size_t last) -> resulting_type
+						{
+							if constexpr (std::is_same_v<T, T2> and (concepts::simd_real_type<T> or concepts::half_precision_type<T>)
+								and requires { lhs.data(); other.data(); })
+							{
+								return detail::simd::dot(lhs.data() + first, other.data() + first, last - first);
+							}
+							else return std::inner_product(lhs.begin() + first, lhs.begin() + last, other.begin() + first, resulting_type{});
+						}, std::plus<resulting_type>{});
+				}
+			}
+		}
+
+		// Inner product of real vectors with a summation policy (see summation.h)
+		template<concepts::summation_policy Summation, concepts::underlying_vector_type T, concepts::underlying_vector_type T2,
+			std::size_t Size, typename Storage, typename Storage2>
+		auto inner_product(const Summation& summation, const vector<T, Size, Storage>& lhs, const vector<T2, Size, Storage2>& other)
+		requires (concepts::is_not_all_complex<T, T2>)
+		{
+			if constexpr (std::is_same_v<Summation, summation::sequential_policy>)
+			{
+				return inner_product(lhs, other);
+			}
+			else
+			{
+				detail::assert_same_value<Size>(lhs.size(), other.size());
+				using resulting_type = decltype(std::declval<T>() * std::declval<T2>());
+				if constexpr (requires { lhs.data(); other.data(); })
+				{
+					const T* a = lhs.data();
+					const T2* b = other.data();
+					return detail::summation::sum<resulting_type>(summation, lhs.size(), [a, b](std::size_t i) { return a[i] * b[i]; });
+				}
+				else
+				{
+					const auto a = lhs.begin();
+					const auto b = other.begin();
+					return detail::summation::sum<resulting_type>(summation, lhs.size(),
+						[a, b](std::size_t i) { return static_cast<T>(a[i]) * static_cast<T2>(b[i]); });
+				}
+			}
+		}
+
 		template<concepts::underlying_vector_type T, concepts::underlying_vector_type T2>
 		constexpr auto complex_inner_product(const std::complex<T>& lhs, const std::complex<T2>& rhs)
 		-> decltype(std::declval<T>() * std::declval<T2>() + std::declval<T>() * std::declval<T2>()) 
@@ -83,8 +234,8 @@ namespace MathLbr
 		}
 
 		template <concepts::underlying_vector_type T, concepts::underlying_vector_type T2, 
-			concepts::underlying_vector_type T3, std::size_t Size>
-		constexpr auto scalar_triple_product(const vector<T, Size>& first, const vector<T2, Size>& other2, const vector<T3, Size>& other3)
+			concepts::underlying_vector_type T3, std::size_t Size, typename Storage, typename Storage2, typename Storage3>
+		constexpr auto scalar_triple_product(const vector<T, Size, Storage>& first, const vector<T2, Size, Storage2>& other2, const vector<T3, Size, Storage3>& other3)
 		requires (concepts::is_not_all_complex<T, T2, T3> 
 		and concepts::convertible_to_or_not_narrowing_complex_product<T, T2>)
 		{
@@ -94,8 +245,8 @@ namespace MathLbr
 
 		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT, 
 			concepts::underlying_vector_type T, concepts::underlying_vector_type T2, 
-			concepts::underlying_vector_type T3, std::size_t Size>
-		constexpr auto scalar_triple_product(const vector<T, Size>& first, const vector<T2, Size>& other2, const vector<T3, Size>& other3)
+			concepts::underlying_vector_type T3, std::size_t Size, typename Storage, typename Storage2, typename Storage3>
+		constexpr auto scalar_triple_product(const vector<T, Size, Storage>& first, const vector<T2, Size, Storage2>& other2, const vector<T3, Size, Storage3>& other3)
 		requires (concepts::is_all_complex<T, T2, T3> and concepts::convertible_to_or_not_narrowing_complex_product<T, T2>)
 		{
 			// necessary assert (dispatch) performed by inner_product and cross_product internally
@@ -103,8 +254,8 @@ namespace MathLbr
 		}
 
 		template<concepts::underlying_vector_type T, concepts::underlying_vector_type T2,
-			concepts::underlying_vector_type T3, std::size_t Size>
-		constexpr auto vector_triple_product(const vector<T, Size>& first, const vector<T2, Size>& other2, const vector<T3, Size>& other3) 
+			concepts::underlying_vector_type T3, std::size_t Size, typename Storage, typename Storage2, typename Storage3>
+		constexpr auto vector_triple_product(const vector<T, Size, Storage>& first, const vector<T2, Size, Storage2>& other2, const vector<T3, Size, Storage3>& other3) 
 		requires (concepts::is_not_all_complex<T, T2, T3>
 		and concepts::convertible_to_or_not_narrowing_complex_product<T, T2>
 		and concepts::convertible_to_or_not_narrowing_complex_product<T3, T>)
@@ -113,8 +264,8 @@ namespace MathLbr
 			return cross_product(other3, cross_product(first, other2));
 		}
 
-		template<concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size>
-		constexpr bool are_parallel(const vector<T, Size>& first, const vector<T2, Size>& other, double epsilon = 1E-6)
+		template<concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size, typename Storage, typename Storage2>
+		constexpr bool are_parallel(const vector<T, Size, Storage>& first, const vector<T2, Size, Storage2>& other, double epsilon = 1E-6)
 		requires (concepts::is_not_all_complex<T, T2>)
 		{
 			detail::assert_same_value<Size>(other.size(), first.size());
@@ -144,8 +295,8 @@ namespace MathLbr
 		}
 
 		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
-			concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size>
-		constexpr bool are_parallel(const vector<T, Size>& first, const vector<T2, Size>& other, double epsilon = 1E-6)
+			concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size, typename Storage, typename Storage2>
+		constexpr bool are_parallel(const vector<T, Size, Storage>& first, const vector<T2, Size, Storage2>& other, double epsilon = 1E-6)
 		requires (concepts::is_all_complex<T, T2>)
 		{
 			// Beware: this calculation won't work correctly with integral types, because truncation happens inside normalize()
@@ -159,8 +310,8 @@ namespace MathLbr
 		}
 
 		template<concepts::underlying_vector_type T, concepts::underlying_vector_type T2,
-			std::size_t Size>
-		constexpr bool are_perpendicular(const vector<T, Size>& first, const vector<T2, Size>& other, double epsilon = 1E-6)
+			std::size_t Size, typename Storage, typename Storage2>
+		constexpr bool are_perpendicular(const vector<T, Size, Storage>& first, const vector<T2, Size, Storage2>& other, double epsilon = 1E-6)
 		requires (concepts::is_not_all_complex<T, T2>)
 		{
 			detail::assert_same_value<Size>(other.size(), first.size());
@@ -169,8 +320,8 @@ namespace MathLbr
 
 		// Should be OK, see https://www.sciencedirect.com/topics/mathematics/orthogonal-set-of-vector
 		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
-			concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size>
-		constexpr bool are_perpendicular(const vector<T, Size>& first, const vector<T2, Size>& other, double epsilon = 1E-6)
+			concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size, typename Storage, typename Storage2>
+		constexpr bool are_perpendicular(const vector<T, Size, Storage>& first, const vector<T2, Size, Storage2>& other, double epsilon = 1E-6)
 		requires (concepts::is_all_complex<T, T2>)
 		{
 			detail::assert_same_value<Size>(other.size(), first.size());
@@ -178,9 +329,9 @@ namespace MathLbr
 		}
 
 		template<concepts::underlying_vector_type T, concepts::underlying_vector_type T2,
-			concepts::underlying_vector_type T3, std::size_t Size>
-		constexpr bool are_coplanar(const vector<T, Size>& first, const vector<T2, Size>& other2,
-			const vector<T3, Size>& other3, double epsilon = 1E-6)
+			concepts::underlying_vector_type T3, std::size_t Size, typename Storage, typename Storage2, typename Storage3>
+		constexpr bool are_coplanar(const vector<T, Size, Storage>& first, const vector<T2, Size, Storage2>& other2,
+			const vector<T3, Size, Storage3>& other3, double epsilon = 1E-6)
 		requires (concepts::is_not_all_complex<T, T2, T3> and concepts::convertible_to_or_not_narrowing_complex_product<T, T2>)
 		{
 			// necessary assert (dispatch) performed by inner_product and cross_product internally
@@ -189,9 +340,9 @@ namespace MathLbr
 
 		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
 			concepts::underlying_vector_type T, concepts::underlying_vector_type T2,
-			concepts::underlying_vector_type T3, std::size_t Size>
-		constexpr bool are_coplanar(const vector<T, Size>& first, const vector <T2, Size>& other2,
-			const vector<T3, Size> other3, double epsilon = 1E-6)
+			concepts::underlying_vector_type T3, std::size_t Size, typename Storage, typename Storage2, typename Storage3>
+		constexpr bool are_coplanar(const vector<T, Size, Storage>& first, const vector<T2, Size, Storage2>& other2,
+			const vector<T3, Size, Storage3> other3, double epsilon = 1E-6)
 		requires (concepts::is_all_complex<T, T2, T3> and concepts::convertible_to_or_not_narrowing_complex_product<T, T2>)
 		{
 			// necessary assert (dispatch) performed by inner_product and cross_product internally
@@ -199,31 +350,162 @@ namespace MathLbr
 		}
 
 
-		template<concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size>
-		constexpr auto projection(vector<T, Size> to, const vector<T2, Size>& from)
+		template<concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size, typename Storage, typename Storage2>
+		constexpr auto projection(vector<T, Size, Storage> to, const vector<T2, Size, Storage2>& from)
 		requires (concepts::is_not_all_complex<T, T2>) 
 		{
-			return to.vector_projection_from(from);
+			if constexpr (concepts::non_owning_container<typename vector<T, Size, Storage>::underlying_container>)
+			{
+				// Copying a view doesn't copy its elements
+				return projection(typename vector<T, Size, Storage>::result_type(to), from);
+			}
+			else return to.vector_projection_from(from);
 		}
 
 		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
-			concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size>
-		constexpr auto projection(vector<T, Size> to, const vector<T2, Size>& from)
+			concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size, typename Storage, typename Storage2>
+		constexpr auto projection(vector<T, Size, Storage> to, const vector<T2, Size, Storage2>& from)
 		requires (concepts::is_all_complex<T, T2>)
 		{
-			return to.vector_projection_from<definition_type>(from);
+			if constexpr (concepts::non_owning_container<typename vector<T, Size, Storage>::underlying_container>)
+			{
+				return projection<definition_type>(typename vector<T, Size, Storage>::result_type(to), from);
+			}
+			else return to.template vector_projection_from<definition_type>(from);
+		}
+
+		template<typename T, std::size_t Size, typename Storage>
+		constexpr auto normalize(vector<T, Size, Storage> other)
+		{
+			if constexpr (concepts::non_owning_container<typename vector<T, Size, Storage>::underlying_container>)
+			{
+				return normalize(typename vector<T, Size, Storage>::result_type(other));
+			}
+			else return other.normalize();
+		}
+
+		template<concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size1, typename Storage, typename Storage2>
+		constexpr auto cross_product(vector<T, Size1, Storage> lhs, const vector<T2, Size1, Storage2>& rhs)
+		{
+			if constexpr (concepts::non_owning_container<typename vector<T, Size1, Storage>::underlying_container>)
+			{
+				return cross_product(typename vector<T, Size1, Storage>::result_type(lhs), rhs);
+			}
+			else return lhs.cross_product(rhs);
+		}
+
+		/*
+			Overloads taking lazy expressions (see vector_expression.h), like inner_product(a + b, c):
+			the expressions are evaluated first, then the functions above are called.
+		*/
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+			typename Lhs, typename Rhs>
+		constexpr auto inner_product(const Lhs& lhs, const Rhs& other)
+		requires (concepts::vector_operands_with_expression<Lhs, Rhs>)
+		{
+			if constexpr (concepts::is_all_complex<concepts::operand_value_type<Lhs>, concepts::operand_value_type<Rhs>>)
+			{
+				return inner_product<definition_type>(detail::evaluate_operand(lhs), detail::evaluate_operand(other));
+			}
+			else return inner_product(detail::evaluate_operand(lhs), detail::evaluate_operand(other));
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+			typename PolicyOrSummation, typename Lhs, typename Rhs>
+		auto inner_product(const PolicyOrSummation& policy, const Lhs& lhs, const Rhs& other)
+		requires ((concepts::execution_policy<PolicyOrSummation> or concepts::summation_policy<PolicyOrSummation>)
+		and concepts::vector_operands_with_expression<Lhs, Rhs>)
+		{
+			if constexpr (concepts::execution_policy<PolicyOrSummation>)
+			{
+				return inner_product<definition_type>(policy, detail::evaluate_operand(lhs), detail::evaluate_operand(other));
+			}
+			else return inner_product(policy, detail::evaluate_operand(lhs), detail::evaluate_operand(other));
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+			typename First, typename Second, typename Third>
+		constexpr auto scalar_triple_product(const First& first, const Second& other2, const Third& other3)
+		requires (concepts::vector_operands_with_expression<First, Second, Third>)
+		{
+			if constexpr (concepts::is_complex<concepts::operand_value_type<First>>::value)
+			{
+				return scalar_triple_product<definition_type>(detail::evaluate_operand(first),
+					detail::evaluate_operand(other2), detail::evaluate_operand(other3));
+			}
+			else return scalar_triple_product(detail::evaluate_operand(first),
+				detail::evaluate_operand(other2), detail::evaluate_operand(other3));
+		}
+
+		template<typename First, typename Second, typename Third>
+		constexpr auto vector_triple_product(const First& first, const Second& other2, const Third& other3)
+		requires (concepts::vector_operands_with_expression<First, Second, Third>)
+		{
+			return vector_triple_product(detail::evaluate_operand(first),
+				detail::evaluate_operand(other2), detail::evaluate_operand(other3));
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+			typename First, typename Second>
+		constexpr bool are_parallel(const First& first, const Second& other, double epsilon = 1E-6)
+		requires (concepts::vector_operands_with_expression<First, Second>)
+		{
+			if constexpr (concepts::is_complex<concepts::operand_value_type<First>>::value)
+			{
+				return are_parallel<definition_type>(detail::evaluate_operand(first), detail::evaluate_operand(other), epsilon);
+			}
+			else return are_parallel(detail::evaluate_operand(first), detail::evaluate_operand(other), epsilon);
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+			typename First, typename Second>
+		constexpr bool are_perpendicular(const First& first, const Second& other, double epsilon = 1E-6)
+		requires (concepts::vector_operands_with_expression<First, Second>)
+		{
+			if constexpr (concepts::is_complex<concepts::operand_value_type<First>>::value)
+			{
+				return are_perpendicular<definition_type>(detail::evaluate_operand(first), detail::evaluate_operand(other), epsilon);
+			}
+			else return are_perpendicular(detail::evaluate_operand(first), detail::evaluate_operand(other), epsilon);
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+			typename First, typename Second, typename Third>
+		constexpr bool are_coplanar(const First& first, const Second& other2, const Third& other3, double epsilon = 1E-6)
+		requires (concepts::vector_operands_with_expression<First, Second, Third>)
+		{
+			if constexpr (concepts::is_complex<concepts::operand_value_type<First>>::value)
+			{
+				return are_coplanar<definition_type>(detail::evaluate_operand(first),
+					detail::evaluate_operand(other2), detail::evaluate_operand(other3), epsilon);
+			}
+			else return are_coplanar(detail::evaluate_operand(first),
+				detail::evaluate_operand(other2), detail::evaluate_operand(other3), epsilon);
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+			typename To, typename From>
+		constexpr auto projection(const To& to, const From& from)
+		requires (concepts::vector_operands_with_expression<To, From>)
+		{
+			if constexpr (concepts::is_complex<concepts::operand_value_type<To>>::value)
+			{
+				return projection<definition_type>(detail::evaluate_operand(to), detail::evaluate_operand(from));
+			}
+			else return projection(detail::evaluate_operand(to), detail::evaluate_operand(from));
 		}
 
-		template<typename T, std::size_t Size>
-		constexpr auto normalize(vector<T, Size> other)
+		template<concepts::vector_expression Expression>
+		constexpr auto normalize(const Expression& other)
 		{
-			return other.normalize();
+			return normalize(other.eval());
 		}
 
-		template<concepts::underlying_vector_type T, concepts::underlying_vector_type T2, std::size_t Size1>
-		constexpr auto cross_product(vector<T, Size1> lhs, const vector<T2, Size1>& rhs)
+		template<typename Lhs, typename Rhs>
+		constexpr auto cross_product(const Lhs& lhs, const Rhs& rhs)
+		requires (concepts::vector_operands_with_expression<Lhs, Rhs>)
 		{
-			return lhs.cross_product(rhs);
+			return cross_product(detail::evaluate_operand(lhs), detail::evaluate_operand(rhs));
 		}
 	}
 
@@ -231,33 +513,42 @@ namespace MathLbr
 	/*
 		General vector expressed in cartesian coordinates - accepts the specified type and any size.
 		Internally, std::vector is used if Size == -1. Otherwise, std::array is used.
+		A different container can be chosen through the Storage policy (see storage.h).
 		Most operations are defined for complex vectors (vectors with complex entries) as well,
 		but some are explicitly disabled because they make little sense with complex entries.
 	*/
 
-	template<concepts::underlying_vector_type T, std::size_t Size>
+	template<concepts::underlying_vector_type T, std::size_t Size, typename Storage>
 	class vector
 	{
+		static_assert(concepts::vector_storage<Storage, T, Size>, "Storage must be a valid storage policy!");
 
 	private:
-		template<concepts::underlying_vector_type T2, std::size_t Size2>
+		template<concepts::underlying_vector_type T2, std::size_t Size2, typename Storage2>
 		friend class vector;
 
-		std::conditional_t<concepts::dynamic_extent_enabled<Size, dynamic_extent>,
-			std::vector<T>, std::array<T, Size>> _vector;
+		typename Storage::template container<T, Size> _vector;
 
 	public:
 		using size_type = std::size_t;
 		using value_type = T;
-		using pointer_type = T*;
-		using reference_type = T&;
+		using underlying_container = typename Storage::template container<T, Size>;
+		using pointer_type = detail::container_pointer_t<underlying_container, T>;
+		// Plain references for std::vector/std::array, proxies for split storages
+		using reference_type = typename underlying_container::reference;
 		using const_pointer_type = const T*;
-		using const_reference_type = const T&;
-		using underlying_container = std::conditional_t<concepts::dynamic_extent_enabled<Size>,
-			std::vector<T>, std::array<T, Size>>;
+		using const_reference_type = typename underlying_container::const_reference;
+		using storage_type = Storage;
+		// Allocator of the underlying std::vector, detail::no_allocator if the storage doesn't use one
+		using allocator_type = detail::container_allocator_t<underlying_container>;
+		// Type of the vectors returned by value (e.g. by expressions): vector itself, an owning vector for views
+		using result_type = vector<T, Size, detail::result_storage_t<Storage>>;
 		template<typename _T>
 		using complex_internal_value_type = typename concepts::is_complex<_T>::value_type;
 
+		// Alignment (in bytes) of data(), guaranteed by the storage policy (see MathLbr::aligned)
+		static constexpr size_type alignment = detail::storage_alignment<Storage, T>();
+
 
 		constexpr vector() = default;
 
@@ -280,7 +571,7 @@ namespace MathLbr
 		// constructors [3]
 		template<std::input_iterator InputIter>
 		constexpr vector(InputIter first, InputIter last)
-		requires (concepts::dynamic_extent_enabled<Size>
+		requires (concepts::dynamic_extent_enabled<Size> and concepts::owning_container<underlying_container>
 		and concepts::convertible_to_or_not_narrowing_conversion<typename std::iterator_traits<InputIter>::value_type, value_type>)
 			: _vector(first, last)
 		{
@@ -288,7 +579,7 @@ namespace MathLbr
 
 		template<std::input_iterator InputIter>
 		constexpr vector(InputIter first, InputIter last)
-		requires (concepts::dynamic_extent_disabled<Size>
+		requires (concepts::dynamic_extent_disabled<Size> and concepts::owning_container<underlying_container>
 		and concepts::convertible_to_or_not_narrowing_conversion<typename std::iterator_traits<InputIter>::value_type, value_type>)
 		{
 			const auto distance = std::distance(first, last);
@@ -335,17 +626,17 @@ namespace MathLbr
 		*/
 
 		// Constructors [5]
-		template<concepts::underlying_vector_type T2, size_type Size2>
-		constexpr explicit(not concepts::allow_implicit_conversions::value) vector(const vector<T2, Size2>& other)
-		requires (concepts::dynamic_extent_enabled<Size>
+		template<concepts::underlying_vector_type T2, size_type Size2, typename Storage2>
+		constexpr explicit(not concepts::allow_implicit_conversions::value) vector(const vector<T2, Size2, Storage2>& other)
+		requires (concepts::dynamic_extent_enabled<Size> and concepts::owning_container<underlying_container>
 		and concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
-			: _vector{ other.begin(), other.end() }
+			: _vector(make_container(other.begin(), other.end(), other))
 		{
 		}
 
-		template<concepts::underlying_vector_type T2, size_type Size2>
-		constexpr explicit(not concepts::allow_implicit_conversions::value) vector(const vector<T2, Size2>& other)
-		requires (concepts::dynamic_extent_disabled<Size>
+		template<concepts::underlying_vector_type T2, size_type Size2, typename Storage2>
+		constexpr explicit(not concepts::allow_implicit_conversions::value) vector(const vector<T2, Size2, Storage2>& other)
+		requires (concepts::dynamic_extent_disabled<Size> and concepts::owning_container<underlying_container>
 		and concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
 			// We could've dispatched to the constructor taking InputIterators, but that way we can not dispatch the assert/static_assert
 		{
@@ -360,21 +651,20 @@ namespace MathLbr
 		// Mimics move constructor, but accepts different sizes
 		// Only the elements themselves are moved, not the underlying vector or array.
 		// Constructors [6]
-		template<concepts::underlying_vector_type T2, size_type Size2>
+		template<concepts::underlying_vector_type T2, size_type Size2, typename Storage2>
 		constexpr explicit(not concepts::allow_implicit_conversions::value)
-		vector(vector<T2, Size2>&& other) noexcept (std::is_nothrow_move_constructible_v<T2>)
+		vector(vector<T2, Size2, Storage2>&& other) noexcept (std::is_nothrow_move_constructible_v<T2>)
 		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>
-		and concepts::dynamic_extent_enabled<Size>)
-			: _vector{ std::make_move_iterator(other.begin())
-			, std::make_move_iterator(other.end()) }
+		and concepts::dynamic_extent_enabled<Size> and concepts::owning_container<underlying_container>)
+			: _vector(make_container(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()), other))
 		{
 		}
 
-		template<concepts::underlying_vector_type T2, size_type Size2>
+		template<concepts::underlying_vector_type T2, size_type Size2, typename Storage2>
 		constexpr explicit(not concepts::allow_implicit_conversions::value)
-		vector(vector<T2, Size2>&& other) noexcept (std::is_nothrow_move_constructible_v<T2>)
+		vector(vector<T2, Size2, Storage2>&& other) noexcept (std::is_nothrow_move_constructible_v<T2>)
 		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>
-		and concepts::dynamic_extent_disabled<Size>)
+		and concepts::dynamic_extent_disabled<Size> and concepts::owning_container<underlying_container>)
 		{
 			detail::dispatch_assert_size_mismatch<Size, Size2>(Size, other.size());
 
@@ -384,16 +674,22 @@ namespace MathLbr
 		}
 
 	private:
+		// Returns a generator of uniform values in [lower, higher], the distribution is built once per vector.
+		// Each thread has its own engine: constructing random vectors concurrently is safe.
+		// For reproducible (seeded) or parallel generation see MathLbr::random::fill (random.h)
 		template<concepts::underlying_vector_type Type>
-		Type get_random(Type lower, Type higher)
+		static auto random_generator(Type lower, Type higher)
 		{
-			static std::mt19937 mt(std::random_device{}());
+			thread_local std::mt19937 mt(std::random_device{}());
 
 			// Choose the appropriate distribution
 			std::conditional_t<std::is_floating_point_v<Type>,
 				std::uniform_real_distribution<Type>,
 				std::uniform_int_distribution<Type>> un{ lower, higher };
-			return un(mt);
+			return [un]() mutable
+				{
+				return un(mt);
+				};
 		}
 
 
@@ -405,10 +701,7 @@ namespace MathLbr
 		and concepts::dynamic_extent_disabled<Size>
 		and concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
 		{
-			std::generate(_vector.begin(), _vector.end(), [=]() 
-				{
-				return get_random<T2>(lower, higher);
-				});
+			std::generate(_vector.begin(), _vector.end(), random_generator<T2>(lower, higher));
 		}
 
 		template<concepts::underlying_vector_type T2>
@@ -418,10 +711,7 @@ namespace MathLbr
 		and concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
 			: _vector(count)
 		{
-			std::generate_n(_vector.begin(), count, [=]() 
-				{
-				return get_random<T2>(lower, higher);
-				});
+			std::generate_n(_vector.begin(), count, random_generator<T2>(lower, higher));
 		}
 
 		template<concepts::underlying_vector_type T2>
@@ -431,10 +721,11 @@ namespace MathLbr
 		and concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
 		{
 			using Tp = typename T::value_type;
-			std::generate(_vector.begin(), _vector.end(), [=]() 
+			auto random = random_generator<T2>(lower, higher);
+			std::generate(_vector.begin(), _vector.end(), [&]() 
 				{
-				return std::complex<Tp>(get_random<T2>(lower, higher),
-					get_random<T2>(lower, higher));
+				const auto real = random();
+				return std::complex<Tp>(real, random());
 				});
 		}
 
@@ -446,53 +737,335 @@ namespace MathLbr
 			: _vector(count)
 		{
 			using Tp = typename T::value_type;
-			std::generate_n(_vector.begin(), count, [=]() 
+			auto random = random_generator<T2>(lower, higher);
+			std::generate_n(_vector.begin(), count, [&]() 
+				{
+				const auto real = random();
+				return std::complex<Tp>(real, random());
+				});
+		}
+
+
+		template<concepts::underlying_vector_type T2>
+		explicit(not concepts::allow_implicit_conversions::value) vector(T2 lower, T2 higher, size_type count, const allocator_type& allocator)
+		requires (concepts::allocator_aware_container<underlying_container>
+		and concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
+			: _vector(count, allocator)
+		{
+			auto random = random_generator<T2>(lower, higher);
+			std::generate_n(_vector.begin(), count, [&]()
 				{
-				return std::complex<Tp>(get_random<T2>(lower, higher), get_random<T2>(lower, higher));
+					if constexpr (concepts::is_complex<value_type>::value)
+					{
+						const auto real = random();
+						return value_type(real, random());
+					}
+					else return static_cast<value_type>(random());
 				});
 		}
 
 
+		// Allocator-extended constructors, only for allocator-aware storages (e.g. MathLbr::pmr::vector)
+		// Same as the constructors above, but the memory is obtained from allocator
+		constexpr explicit vector(const allocator_type& allocator) noexcept
+		requires (concepts::allocator_aware_container<underlying_container>)
+			: _vector(allocator)
+		{
+		}
+
+		constexpr vector(size_type count, const allocator_type& allocator)
+		requires (concepts::allocator_aware_container<underlying_container>)
+			: _vector(count, allocator)
+		{
+		}
+
+		template<std::input_iterator InputIter>
+		constexpr vector(InputIter first, InputIter last, const allocator_type& allocator)
+		requires (concepts::allocator_aware_container<underlying_container>
+		and concepts::convertible_to_or_not_narrowing_conversion<typename std::iterator_traits<InputIter>::value_type, value_type>)
+			: _vector(first, last, allocator)
+		{
+		}
+
+		template<size_type Sz, concepts::underlying_vector_type T2>
+		constexpr explicit(not concepts::allow_implicit_conversions::value) vector(const T2(&arr)[Sz], const allocator_type& allocator)
+		requires (concepts::allocator_aware_container<underlying_container>
+		and concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
+			: _vector(allocator)
+		{
+			_vector.reserve(Sz);
+			for (const auto& element : arr)
+			{
+				_vector.push_back(static_cast<value_type>(element));
+			}
+		}
+
+		template<size_type Sz>
+		constexpr explicit(not concepts::allow_implicit_conversions::value) vector(const value_type(&arr)[Sz], const allocator_type& allocator)
+		requires (concepts::allocator_aware_container<underlying_container>)
+			: _vector(std::begin(arr), std::end(arr), allocator)
+		{
+		}
+
+		constexpr vector(const vector& other, const allocator_type& allocator)
+		requires (concepts::allocator_aware_container<underlying_container>)
+			: _vector(other._vector, allocator)
+		{
+		}
+
+		constexpr vector(vector&& other, const allocator_type& allocator)
+		requires (concepts::allocator_aware_container<underlying_container>)
+			: _vector(std::move(other._vector), allocator)
+		{
+		}
+
+		template<concepts::underlying_vector_type T2, size_type Size2, typename Storage2>
+		constexpr explicit(not concepts::allow_implicit_conversions::value) vector(const vector<T2, Size2, Storage2>& other, const allocator_type& allocator)
+		requires (concepts::allocator_aware_container<underlying_container>
+		and concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
+			: _vector(other.begin(), other.end(), allocator)
+		{
+		}
+
+		template<concepts::underlying_vector_type T2, size_type Size2, typename Storage2>
+		constexpr explicit(not concepts::allow_implicit_conversions::value) vector(vector<T2, Size2, Storage2>&& other, const allocator_type& allocator)
+		requires (concepts::allocator_aware_container<underlying_container>
+		and concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
+			: _vector(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()), allocator)
+		{
+		}
+
+		// View constructors: only exist for non-owning storages (see vector_view). The elements are referenced, not copied
+		template<std::contiguous_iterator Iter>
+		constexpr explicit(concepts::dynamic_extent_disabled<Size>) vector(Iter first, size_type count) noexcept
+		requires (concepts::non_owning_container<underlying_container>
+		and std::is_convertible_v<std::remove_reference_t<std::iter_reference_t<Iter>>(*)[], std::remove_pointer_t<pointer_type>(*)[]>)
+			: _vector(std::to_address(first), count)
+		{
+		}
+
+		template<std::contiguous_iterator Iter, std::sized_sentinel_for<Iter> End>
+		constexpr explicit(concepts::dynamic_extent_disabled<Size>) vector(Iter first, End last) noexcept
+		requires (concepts::non_owning_container<underlying_container> and not std::is_convertible_v<End, size_type>
+		and std::is_convertible_v<std::remove_reference_t<std::iter_reference_t<Iter>>(*)[], std::remove_pointer_t<pointer_type>(*)[]>)
+			: _vector(std::to_address(first), static_cast<size_type>(last - first))
+		{
+		}
+
+		// Rvalue ranges are only accepted if the elements outlive them (e.g. std::span), never for owning containers
+		template<std::ranges::contiguous_range Range>
+		constexpr explicit(concepts::dynamic_extent_disabled<Size>) vector(Range&& range) noexcept
+		requires (concepts::non_owning_container<underlying_container>
+		and not std::is_same_v<std::remove_cvref_t<Range>, vector>
+		and std::ranges::sized_range<Range>
+		and (std::is_lvalue_reference_v<Range> or std::ranges::borrowed_range<Range>)
+		and std::is_convertible_v<std::remove_reference_t<std::ranges::range_reference_t<Range>>(*)[], std::remove_pointer_t<pointer_type>(*)[]>)
+			: _vector(std::ranges::data(range), static_cast<size_type>(std::ranges::size(range)))
+		{
+		}
+
+		constexpr allocator_type get_allocator() const noexcept
+		requires (concepts::allocator_aware_container<underlying_container>)
+		{
+			return _vector.get_allocator();
+		}
+
+	private:
+		// Allocator of a new vector built from source: the allocator of source if it can be converted
+		// (e.g. std::pmr::polymorphic_allocator<U> -> std::pmr::polymorphic_allocator<T>), a default one otherwise
+		template<typename Source>
+		static constexpr allocator_type propagated_allocator(const Source& source)
+		{
+			if constexpr (requires { allocator_type(source.get_allocator()); })
+			{
+				return allocator_type(source.get_allocator());
+			}
+			else return allocator_type{};
+		}
+
+		template<typename InputIter, typename Source>
+		static constexpr underlying_container make_container(InputIter first, InputIter last, const Source& source)
+		{
+			if constexpr (concepts::allocator_aware_container<underlying_container>)
+			{
+				return underlying_container(first, last, propagated_allocator(source));
+			}
+			else return underlying_container(first, last);
+		}
+
+		template<typename Source>
+		static constexpr underlying_container make_empty_container(const Source& source)
+		{
+			if constexpr (concepts::allocator_aware_container<underlying_container>)
+			{
+				return underlying_container(propagated_allocator(source));
+			}
+			else return underlying_container{};
+		}
+
+	public:
+		// Constructors [8]
+		// Evaluates a lazy expression (e.g. a + b * 2.0 - c) in a single pass.
+		// The result uses the allocator of the leftmost vector of the expression.
+		template<concepts::vector_expression Expression>
+		constexpr vector(const Expression& expr)
+		requires (std::is_same_v<typename Expression::result_type, vector>)
+			: _vector(make_empty_container(expr.leftmost()))
+		{
+			if constexpr (concepts::dynamic_extent_enabled<Size>)
+			{
+				_vector.resize(expr.size());
+			}
+			assign_expression(expr);
+		}
+
+		template<concepts::vector_expression Expression>
+		constexpr explicit(not concepts::allow_implicit_conversions::value) vector(const Expression& expr)
+		requires (not std::is_same_v<typename Expression::result_type, vector> and concepts::owning_container<underlying_container>
+		and concepts::convertible_to_or_not_narrowing_conversion<typename Expression::value_type, value_type>)
+			: vector(expr.eval())
+		{
+		}
+
 		constexpr vector(const vector& other) = default;
+
+		// Unlike std::vector, copies keep the allocator of other (std::pmr::polymorphic_allocator would otherwise
+		// fall back to the default memory resource), so that copies made by value-returning functions stay in the same arena
+		constexpr vector(const vector& other)
+		requires (concepts::allocator_aware_container<underlying_container>)
+			: _vector(other._vector, other._vector.get_allocator())
+		{
+		}
+
 		constexpr vector(vector&& other) noexcept = default;
 		constexpr vector& operator=(vector&& other) noexcept = default;
 		constexpr vector& operator=(const vector& other) = default;
 
+		// Views: the result is written to the referenced elements, whose number can't change
+		template<concepts::vector_expression Expression>
+		constexpr vector& operator=(const Expression& expr)
+		requires (std::is_same_v<typename Expression::result_type, result_type>)
+		{
+			// Element-wise expressions can safely be evaluated in place, even when they refer to *this (e.g. v = 2 * v).
+			// A resize could invalidate that, so a new vector is built in such case.
+			if constexpr (concepts::non_owning_container<underlying_container>)
+			{
+				detail::assert_same_value<Size>(size(), expr.size());
+			}
+			else if constexpr (concepts::dynamic_extent_enabled<Size>)
+			{
+				if (size() != expr.size())
+				{
+					return *this = vector(expr);
+				}
+			}
+			assign_expression(expr);
+			return *this;
+		}
+
+	private:
+		template<concepts::vector_expression Expression>
+		constexpr void assign_expression(const Expression& expr)
+		{
+			// Fused loop: no bound checks are needed in the range where every operation of the expression applies
+			const size_type common_size = expr.common_size();
+			for (size_type i = 0; i < common_size; ++i)
+			{
+				_vector[i] = expr.fused_at(i);
+			}
+			for (size_type i = common_size; i < size(); ++i)
+			{
+				_vector[i] = expr[i];
+			}
+		}
+
+	public:
 
-		constexpr const value_type& operator[] (size_type index) const noexcept
+		constexpr const_reference_type operator[] (size_type index) const noexcept
 		{
 			return _vector[index];
 		}
 
-		constexpr value_type& operator[] (size_type index) noexcept
+		constexpr reference_type operator[] (size_type index) noexcept
 		{
 			return _vector[index];
 		}
 
-		constexpr const value_type& x() const noexcept
+		// For read-only views, pointer_type is const T*
+		constexpr pointer_type data() noexcept
+		requires (concepts::contiguous_container<underlying_container>)
+		{
+			return _vector.data();
+		}
+
+		constexpr const_pointer_type data() const noexcept
+		requires (concepts::contiguous_container<underlying_container>)
+		{
+			return _vector.data();
+		}
+
+		// Same as data(), but tells the compiler that the pointer is aligned to `alignment` bytes
+		constexpr pointer_type aligned_data() noexcept
+		requires (concepts::contiguous_container<underlying_container>)
+		{
+			return std::assume_aligned<alignment>(_vector.data());
+		}
+
+		constexpr const_pointer_type aligned_data() const noexcept
+		requires (concepts::contiguous_container<underlying_container>)
+		{
+			return std::assume_aligned<alignment>(_vector.data());
+		}
+
+		// Split storages only: contiguous arrays of the real and imaginary parts
+		constexpr auto real_data() noexcept
+		requires (concepts::split_container<underlying_container>)
+		{
+			return _vector.real_data();
+		}
+
+		constexpr auto real_data() const noexcept
+		requires (concepts::split_container<underlying_container>)
+		{
+			return _vector.real_data();
+		}
+
+		constexpr auto imag_data() noexcept
+		requires (concepts::split_container<underlying_container>)
+		{
+			return _vector.imag_data();
+		}
+
+		constexpr auto imag_data() const noexcept
+		requires (concepts::split_container<underlying_container>)
+		{
+			return _vector.imag_data();
+		}
+
+		constexpr const_reference_type x() const noexcept
 		{
 			return _vector[0];
 		}
 
-		constexpr const value_type& y() const noexcept
+		constexpr const_reference_type y() const noexcept
 		{
 			return _vector[1];
 		}
 
-		constexpr const value_type& z() const noexcept
+		constexpr const_reference_type z() const noexcept
 		{
 			return _vector[2];
 		}
 
-		constexpr const value_type& w() const noexcept
+		constexpr const_reference_type w() const noexcept
 		{
 			return _vector[3];
 		}
 
 
 		// Addition operations
-		template<concepts::underlying_vector_type T2, size_type OtherSize>
-		constexpr vector& operator+=(const vector<T2, OtherSize>& rhs)
+		template<concepts::underlying_vector_type T2, size_type OtherSize, typename Storage2>
+		constexpr vector& operator+=(const vector<T2, OtherSize, Storage2>& rhs)
 		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() + std::declval<T2>()), value_type>)
 		{
 			// The first elements [0, min_size] of both containers must be correctly initialized
@@ -512,7 +1085,7 @@ namespace MathLbr
 		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() + std::declval<T2>()), value_type>)
 		{
 			std::for_each(begin(), end(),
-				[val](value_type& current)
+				[val](auto&& current)
 				{
 					current += val;
 				});
@@ -520,41 +1093,18 @@ namespace MathLbr
 			return *this;
 		}
 
-		template<concepts::underlying_vector_type T2>
-		friend constexpr vector operator+(vector lhs, T2 val)
-		{
-			return lhs += val;
-		}
-
-		template<concepts::underlying_vector_type T2>
-		friend constexpr vector operator+(T2 val, vector lhs)
-		{
-			return lhs += val;
-		}
-
-		template<concepts::underlying_vector_type T2, size_type OtherSize>
-		friend constexpr vector operator+(vector lhs, const vector<T2, OtherSize>& rhs)
-		{
-			return lhs += rhs;
-		}
-
-		// Negation
-		constexpr vector operator-() const
-		requires (not std::is_unsigned<value_type>::value)
+		template<concepts::vector_expression Expression>
+		constexpr vector& operator+=(const Expression& expr)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>()
+			+ std::declval<typename Expression::value_type>()), value_type>)
 		{
-			vector temp = *this;
-			std::for_each(temp.begin(), temp.end(),
-				[](value_type& current)
-				{
-					current = -current;
-				});
-			return temp;
+			return *this = *this + expr;
 		}
 
 		// Substraction operations
 	private:
-		template<concepts::underlying_vector_type T2, size_type OtherSize>
-		constexpr vector& substract(const vector<T2, OtherSize>& rhs)
+		template<concepts::underlying_vector_type T2, size_type OtherSize, typename Storage2>
+		constexpr vector& substract(const vector<T2, OtherSize, Storage2>& rhs)
 		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() - std::declval<T2>()), value_type>)
 		{
 			const size_type min_size = std::min(size(), rhs.size());
@@ -573,7 +1123,7 @@ namespace MathLbr
 			requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() - val), value_type>)
 		{
 			std::for_each(begin(), end(),
-				[val](auto& current) {
+				[val](auto&& current) {
 					current -= val;
 				});
 
@@ -581,24 +1131,26 @@ namespace MathLbr
 		}
 
 	public:
-		template<concepts::underlying_vector_type T2, size_type Size2>
-		constexpr vector& operator-=(const vector<T2, Size2>& rhs)
+		template<concepts::underlying_vector_type T2, size_type Size2, typename Storage2>
+		constexpr vector& operator-=(const vector<T2, Size2, Storage2>& rhs)
 		{
 			return substract(rhs);
 		}
 
-		template<concepts::underlying_vector_type T2, size_type Size2>
+		template<concepts::underlying_vector_type T2, size_type Size2, typename Storage2>
 		[[deprecated("substracting vector of type unsigned might cause issues!")]]
-		constexpr vector& operator-=(const vector<T2, Size2>& rhs)
+		constexpr vector& operator-=(const vector<T2, Size2, Storage2>& rhs)
 			requires (std::is_unsigned<T>::value)
 		{
 			return substract(rhs);
 		}
 
-		template<concepts::underlying_vector_type T2, size_type Size2>
-		friend constexpr vector operator-(vector lhs, const vector<T2, Size2>& rhs)
+		template<concepts::vector_expression Expression>
+		constexpr vector& operator-=(const Expression& expr)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>()
+			- std::declval<typename Expression::value_type>()), value_type>)
 		{
-			return lhs -= rhs;
+			return *this = *this - expr;
 		}
 
 		template<concepts::underlying_vector_type T2>
@@ -615,18 +1167,12 @@ namespace MathLbr
 			return substract(val);
 		}
 
-		template<concepts::underlying_vector_type T2>
-		friend constexpr vector operator-(vector lhs, T2 val)
-		{
-			return lhs -= val;
-		}
-
-	private:
+	private:
 		template<concepts::underlying_vector_type T2>
 		constexpr vector& lambda_multiplicator(T2 lambda)
 		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() * lambda), value_type>)
 		{
-			std::for_each(begin(), end(), [lambda](auto& current)
+			std::for_each(begin(), end(), [lambda](auto&& current)
 				{
 					current *= lambda;
 				});
@@ -649,62 +1195,59 @@ namespace MathLbr
 			return lambda_multiplicator(lambda);
 		}
 
-		template<concepts::underlying_vector_type T2>
-		friend constexpr vector operator*(vector lhs, T2 lambda)
-		{
-			return lhs *= lambda;
-		}
-
-		template<concepts::underlying_vector_type T2>
-		friend constexpr vector operator*(T2 lambda, vector lhs)
-		{
-			return lhs *= lambda;
-		}
-
 
 	private:
 		// If std::array, Size == 3 for both lhs and rhs
 		// If std::vector, check rhs.size()
-		template<concepts::underlying_vector_type T2>
-		constexpr vector& cross_product_impl(const vector<T2, Size>& rhs)
+		template<concepts::underlying_vector_type T2, typename Storage2>
+		constexpr vector& cross_product_impl(const vector<T2, Size, Storage2>& rhs)
 		requires (concepts::convertible_to_or_not_narrowing_complex_product<value_type, T2>)
 		{
 			detail::dispatch_assert_equals<Size, 3>(size(), rhs.size());
 
-			vector temp = *this;
+			// Only the three components are needed, no need to copy the whole vector
+			const value_type x0 = _vector[0], x1 = _vector[1], x2 = _vector[2];
+			const T2 y0 = rhs[0], y1 = rhs[1], y2 = rhs[2];
 			if constexpr (concepts::is_complex<value_type>::value)
 			{
 				// The cross product for complex vectors has the same formulaes as a cross product in R3, with the only
 				// difference being that the final step is taking the complex conjugates of the results.
-				_vector[0] = std::conj((temp[1] * rhs[2] - temp[2] * rhs[1]));
-				_vector[1] = std::conj((temp[2] * rhs[0] - temp[0] * rhs[2]));
-				_vector[2] = std::conj((temp[0] * rhs[1] - temp[1] * rhs[0]));
+				_vector[0] = std::conj((x1 * y2 - x2 * y1));
+				_vector[1] = std::conj((x2 * y0 - x0 * y2));
+				_vector[2] = std::conj((x0 * y1 - x1 * y0));
 				return *this;
 			}
-			_vector[0] = temp[1] * rhs[2] - temp[2] * rhs[1];
-			_vector[1] = temp[2] * rhs[0] - temp[0] * rhs[2];
-			_vector[2] = temp[0] * rhs[1] - temp[1] * rhs[0];
+			_vector[0] = x1 * y2 - x2 * y1;
+			_vector[1] = x2 * y0 - x0 * y2;
+			_vector[2] = x0 * y1 - x1 * y0;
 			return *this;
 		}
 
 
 	public:
-		template<concepts::underlying_vector_type T2>
-		constexpr vector& cross_product(const vector<T2, Size>& rhs)
+		template<concepts::underlying_vector_type T2, typename Storage2>
+		constexpr vector& cross_product(const vector<T2, Size, Storage2>& rhs)
 		{
 			return cross_product_impl(rhs);
 		}
 
 
-		template<concepts::underlying_vector_type T2>
+		template<concepts::underlying_vector_type T2, typename Storage2>
 		[[deprecated("Multiplication on two vectors of type unsigned might cause issues!")]]
-		constexpr vector& cross_product(const vector<T2, Size>& rhs)
+		constexpr vector& cross_product(const vector<T2, Size, Storage2>& rhs)
 		requires (std::is_unsigned<value_type>::value
 		or std::is_unsigned<T2>::value)
 		{
 			return cross_product_impl(rhs);
 		}
 
+		// Lazy expressions (see vector_expression.h) are evaluated first
+		template<concepts::vector_expression Expression>
+		constexpr vector& cross_product(const Expression& rhs)
+		{
+			return cross_product(rhs.eval());
+		}
+
 		// Division with a constant/lambda - for precision and correctness, use multiplication instead
 		template<concepts::underlying_vector_type T2>
 		constexpr vector& operator/=(T2 lambda)
@@ -715,7 +1258,7 @@ namespace MathLbr
 			detail::assert_div_byzero<value_type>(static_cast<value_type>(lambda));
 
 			std::for_each(std::begin(_vector), std::end(_vector),
-				[lambda](auto& current)
+				[lambda](auto&& current)
 				{
 					current /= lambda;
 				});
@@ -723,12 +1266,6 @@ namespace MathLbr
 			return *this;
 		}
 
-		template<concepts::underlying_vector_type T2>
-		friend constexpr vector operator/(vector lhs, T2 lambda)
-		{
-			return lhs /= lambda;
-		}
-
 		template<concepts::underlying_vector_type T2>
 		constexpr vector& operator%=(T2 lambda)
 		requires (std::is_integral_v<value_type> and std::is_integral_v<T2>
@@ -738,7 +1275,7 @@ namespace MathLbr
 			detail::assert_div_byzero<value_type>(lambda);
 
 			std::for_each(std::begin(_vector), std::end(_vector),
-				[lambda](auto& current)
+				[lambda](auto&& current)
 				{
 					current %= lambda;
 				});
@@ -746,10 +1283,92 @@ namespace MathLbr
 			return *this;
 		}
 
-		template<concepts::underlying_vector_type T2>
-		friend constexpr vector operator%(vector lhs, T2 lambda) 
+
+		// Element-wise operations with an execution policy (see execution.h): same results as the compound operators
+	private:
+		template<concepts::execution_policy Policy, typename Serial, typename Chunk>
+		vector& dispatch_elementwise(const Policy& policy, size_type count, Serial serial, Chunk chunk)
 		{
-			return lhs %= lambda;
+			if constexpr (not concepts::parallel_execution_policy<Policy>)
+			{
+				serial();
+			}
+			else if (detail::execution::use_serial_path(policy, count))
+			{
+				serial();
+			}
+			else detail::execution::for_each_chunk(policy, count, chunk);
+			return *this;
+		}
+
+	public:
+		template<concepts::execution_policy Policy, concepts::underlying_vector_type T2, size_type OtherSize, typename Storage2>
+		vector& plus_assign(const Policy& policy, const vector<T2, OtherSize, Storage2>& rhs)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() + std::declval<T2>()), value_type>)
+		{
+			return dispatch_elementwise(policy, std::min(size(), rhs.size()), [&]() { *this += rhs; },
+				[&](size_type first, size_type last)
+				{
+					std::transform(begin() + first, begin() + last, rhs.begin() + first, begin() + first,
+						[](const T& lhs, const T2& rhs) { return lhs + rhs; });
+				});
+		}
+
+		template<concepts::execution_policy Policy, concepts::underlying_vector_type T2>
+		vector& plus_assign(const Policy& policy, T2 val)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() + std::declval<T2>()), value_type>)
+		{
+			return dispatch_elementwise(policy, size(), [&]() { *this += val; },
+				[&](size_type first, size_type last)
+				{
+					std::for_each(begin() + first, begin() + last, [val](auto&& current) { current += val; });
+				});
+		}
+
+		template<concepts::execution_policy Policy, concepts::underlying_vector_type T2, size_type OtherSize, typename Storage2>
+		vector& minus_assign(const Policy& policy, const vector<T2, OtherSize, Storage2>& rhs)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() - std::declval<T2>()), value_type>)
+		{
+			return dispatch_elementwise(policy, std::min(size(), rhs.size()), [&]() { substract(rhs); },
+				[&](size_type first, size_type last)
+				{
+					std::transform(begin() + first, begin() + last, rhs.begin() + first, begin() + first,
+						[](const T& lhs, const T2& rhs) { return lhs - rhs; });
+				});
+		}
+
+		template<concepts::execution_policy Policy, concepts::underlying_vector_type T2>
+		vector& minus_assign(const Policy& policy, T2 val)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() - val), value_type>)
+		{
+			return dispatch_elementwise(policy, size(), [&]() { substract(val); },
+				[&](size_type first, size_type last)
+				{
+					std::for_each(begin() + first, begin() + last, [val](auto&& current) { current -= val; });
+				});
+		}
+
+		template<concepts::execution_policy Policy, concepts::underlying_vector_type T2>
+		vector& multiplies_assign(const Policy& policy, T2 lambda)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<value_type>() * lambda), value_type>)
+		{
+			return dispatch_elementwise(policy, size(), [&]() { lambda_multiplicator(lambda); },
+				[&](size_type first, size_type last)
+				{
+					std::for_each(begin() + first, begin() + last, [lambda](auto&& current) { current *= lambda; });
+				});
+		}
+
+		template<concepts::execution_policy Policy, concepts::underlying_vector_type T2>
+		vector& divides_assign(const Policy& policy, T2 lambda)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<T>() / lambda), value_type>)
+		{
+			detail::assert_div_byzero<value_type>(static_cast<value_type>(lambda));
+			return dispatch_elementwise(policy, size(), [&]() { *this /= lambda; },
+				[&](size_type first, size_type last)
+				{
+					std::for_each(begin() + first, begin() + last, [lambda](auto&& current) { current /= lambda; });
+				});
 		}
 
 		constexpr void reset() noexcept
@@ -761,8 +1380,8 @@ namespace MathLbr
 		// OK + TESTED
 	public:
 		// Calculates projection of other to this, then stores the result in this 
-		template<concepts::underlying_vector_type T2>
-		constexpr vector& vector_projection_from(const vector<T2, Size>& from)
+		template<concepts::underlying_vector_type T2, typename Storage2>
+		constexpr vector& vector_projection_from(const vector<T2, Size, Storage2>& from)
 		requires (concepts::is_not_all_complex<value_type, T2>)
 		{
 			detail::assert_same_value<Size>(size(), from.size());
@@ -779,8 +1398,8 @@ namespace MathLbr
 		}
 
 		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
-			concepts::underlying_vector_type T2>
-		constexpr vector& vector_projection_from(const vector<T2, Size>& from)
+			concepts::underlying_vector_type T2, typename Storage2>
+		constexpr vector& vector_projection_from(const vector<T2, Size, Storage2>& from)
 		requires (concepts::is_all_complex<value_type, T2>) 
 		{
 			detail::assert_same_value<Size>(size(), from.size());
@@ -792,20 +1411,63 @@ namespace MathLbr
 			return *this;
 		}
 
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+			concepts::vector_expression Expression>
+		constexpr vector& vector_projection_from(const Expression& from)
+		{
+			if constexpr (concepts::is_complex<value_type>::value)
+			{
+				return vector_projection_from<definition_type>(from.eval());
+			}
+			else return vector_projection_from(from.eval());
+		}
+
+		/*
+			Angle and coordinate functions use the precision policy MathLbr::precision::default_policy (exact, unless
+			MATHLBR_FAST_MATH is defined), or the one given as first argument: precision::exact (<cmath>) or precision::fast
+			(polynomial approximations, see documentation/vector/fast_math.md for their errors).
+		*/
+
 		// Return direction of a 2D vector. The vector components must be cartesian coordinates. x will return the angle in respect
 		// to the x axis, y returns the angle in respect to the y axis 
-		constexpr double direction_radians_y() const
+		template<concepts::precision_policy Precision>
+		constexpr double direction_radians_y(Precision precision) const
 		requires (not concepts::is_complex<value_type>::value)
 		{
 			detail::dispatch_assert_equals<Size, 2>(size());
-			return std::atan2(_vector[0], _vector[1]); // (x / y)
+			return detail::math::atan2(precision, _vector[0], _vector[1]); // (x / y)
 		}
 
-		constexpr double direction_radians_x() const
+		template<concepts::precision_policy Precision>
+		constexpr double direction_radians_x(Precision precision) const
 		requires (not concepts::is_complex<value_type>::value)
 		{
 			detail::dispatch_assert_equals<Size, 2>(size());
-			return std::atan2(_vector[1], _vector[0]); // (y / x)
+			return detail::math::atan2(precision, _vector[1], _vector[0]); // (y / x)
+		}
+
+		constexpr double direction_radians_y() const
+		requires (not concepts::is_complex<value_type>::value)
+		{
+			return direction_radians_y(MathLbr::precision::default_policy{});
+		}
+
+		constexpr double direction_radians_x() const
+		requires (not concepts::is_complex<value_type>::value)
+		{
+			return direction_radians_x(MathLbr::precision::default_policy{});
+		}
+
+		template<concepts::precision_policy Precision>
+		constexpr double direction_degrees_y(Precision precision) const
+		{
+			return direction_radians_y(precision) * 180.0 / std::numbers::pi;
+		}
+
+		template<concepts::precision_policy Precision>
+		constexpr double direction_degrees_x(Precision precision) const
+		{
+			return direction_radians_x(precision) * 180.0 / std::numbers::pi;
 		}
 
 		constexpr double direction_degrees_y() const
@@ -827,14 +1489,39 @@ namespace MathLbr
 			return static_cast<double>(_vector[static_cast<std::size_t>(type)] / denominator);
 		}
 
+		template<concepts::precision_policy Precision>
+		constexpr double direction_angle(Precision precision, Cos type) const
+		requires (not concepts::is_complex<value_type>::value) 
+		{
+			return detail::math::acos(precision, direction_cosine(type));
+		}
+
 		constexpr double direction_angle(Cos type) const
 		requires (not concepts::is_complex<value_type>::value) 
 		{
-			return std::acos(direction_cosine(type));
+			return direction_angle(MathLbr::precision::default_policy{}, type);
 		}
 
 		constexpr vector& normalize() 
 		{
+			if constexpr (concepts::simd_small_vector<value_type, Size> and concepts::contiguous_container<underlying_container>)
+			{
+				const auto denominator = norm();
+				detail::assert_div_byzero<decltype(denominator)>(denominator);
+				detail::simd::fixed::divide<Size>(data(), denominator);
+				return *this;
+			}
+			else if constexpr (concepts::simd_type<value_type> or concepts::half_precision_type<value_type>)
+			{
+				if (not std::is_constant_evaluated())
+				{
+					// One vectorized pass for the norm (see scaled_l2_norm), one for the scaling
+					const auto denominator = scaled_l2_norm();
+					detail::assert_div_byzero<decltype(denominator)>(denominator);
+					divide_parts(denominator);
+					return *this;
+				}
+			}
 			const auto denominator = norm();
 			detail::assert_div_byzero<decltype(denominator)>(denominator);
 			*this *= (1 / denominator);
@@ -850,7 +1537,7 @@ namespace MathLbr
 		constexpr auto norm_impl() const
 		requires (Norm == MathLbr::Norm::L0)
 		{
-			return std::count_if(begin(), end(), [](const auto& elem)
+			return std::count_if(begin(), end(), [](const value_type& elem)
 				{
 					return elem != value_type{};
 				});
@@ -863,17 +1550,17 @@ namespace MathLbr
 		requires (Norm == MathLbr::Norm::L1)
 		{
 			return std::accumulate(begin(), end(), concepts::dispatched_underlying_type<value_type>{},
-				[](auto internal_sum, const auto& element)
+				[](auto internal_sum, const value_type& element)
 				{
-					return internal_sum + std::abs(element);
+					return internal_sum + detail::math::abs(element);
 				});
 		}
 
 		template<typename Function>
 		constexpr auto sqrt_sum_of_powers(Function fct) const
 		{
-			return std::sqrt(std::accumulate(begin(), end(), concepts::dispatched_underlying_type<value_type>{},
-				[fct](auto internal_sum, const auto& element) 
+			return detail::math::sqrt(std::accumulate(begin(), end(), concepts::dispatched_underlying_type<value_type>{},
+				[fct](auto internal_sum, const value_type& element) 
 				{
 					return internal_sum + fct(element);
 				}));
@@ -884,6 +1571,16 @@ namespace MathLbr
 		constexpr auto norm_impl() const
 		requires (MathLbr::Norm::L2 == Norm and concepts::is_not_complex<value_type>::value)
 		{
+			if constexpr (concepts::simd_small_vector<value_type, Size> and concepts::contiguous_container<underlying_container>)
+			{
+				const value_type sum = detail::simd::fixed::dot<Size>(data(), data());
+				if (std::is_constant_evaluated() or detail::is_safe_sum_of_squares(sum) or sum != sum) return detail::math::sqrt(sum);
+				return scaled_l2_norm_fallback();
+			}
+			else if constexpr (concepts::simd_real_type<value_type> or concepts::half_precision_type<value_type>)
+			{
+				if (not std::is_constant_evaluated()) return scaled_l2_norm();
+			}
 			return sqrt_sum_of_powers([](const auto& e1) { return e1 * e1; });
 		}
 
@@ -892,9 +1589,13 @@ namespace MathLbr
 		constexpr auto norm_impl() const
 		requires (MathLbr::Norm::L2 == Norm and concepts::is_complex<value_type>::value)
 		{
+			if constexpr (concepts::simd_complex_type<value_type>)
+			{
+				if (not std::is_constant_evaluated()) return scaled_l2_norm();
+			}
 			return sqrt_sum_of_powers([](const auto& e1)
 				{
-					const auto res = std::abs(e1);
+					const auto res = detail::math::abs(e1);
 					return res * res;
 				});
 		}
@@ -904,9 +1605,9 @@ namespace MathLbr
 		constexpr auto norm_impl() const -> concepts::dispatched_underlying_type<value_type>
 		requires (Norm == MathLbr::Norm::LINF)
 		{
-			return *std::max_element(begin(), end(), [](const auto& a, const auto& b)
+			return *std::max_element(begin(), end(), [](const value_type& a, const value_type& b)
 				{
-					return std::abs(a) < std::abs(b);
+					return detail::math::abs(a) < detail::math::abs(b);
 				});
 		}
 
@@ -917,11 +1618,11 @@ namespace MathLbr
 		constexpr auto p_norm() const requires (P >= 1)
 		{
 			auto result = std::accumulate(begin(), end(), concepts::dispatched_underlying_type<value_type>{},
-				[=](auto internal_sum, const auto& element)
+				[=](auto internal_sum, const value_type& element)
 				{
-					return internal_sum + (std::pow(std::abs(element), P));
+					return internal_sum + (detail::math::pow(detail::math::abs(element), P));
 				});
-			return std::pow(result, 1. / P);
+			return detail::math::pow(result, 1. / P);
 		}
 
 		template<MathLbr::Norm Norm = MathLbr::Norm::L2>
@@ -930,21 +1631,295 @@ namespace MathLbr
 			return norm_impl<Norm>();
 		}
 
+		// Norms with an execution policy (see execution.h)
+		template<MathLbr::Norm Norm = MathLbr::Norm::L2, concepts::execution_policy Policy>
+		auto norm(const Policy& policy) const
+		{
+			if constexpr (not concepts::parallel_execution_policy<Policy>)
+			{
+				return norm<Norm>();
+			}
+			else
+			{
+				using result_type = decltype(norm<Norm>());
+				if (detail::execution::use_serial_path(policy, size())) return norm<Norm>();
+				return static_cast<result_type>(parallel_norm_impl<Norm>(policy));
+			}
+		}
+
+		template<std::size_t P, concepts::execution_policy Policy>
+		auto p_norm(const Policy& policy) const requires (P >= 1)
+		{
+			if constexpr (not concepts::parallel_execution_policy<Policy>)
+			{
+				return p_norm<P>();
+			}
+			else
+			{
+				if (detail::execution::use_serial_path(policy, size())) return p_norm<P>();
+				using sum_type = concepts::dispatched_underlying_type<value_type>;
+				const auto result = detail::execution::reduce_chunks(policy, size(), sum_type{},
+					[this](size_type first, size_type last)
+					{
+						return std::accumulate(begin() + first, begin() + last, sum_type{},
+							[](auto internal_sum, const value_type& element)
+							{
+								return internal_sum + (std::pow(std::abs(element), P));
+							});
+					}, std::plus<sum_type>{});
+				return std::pow(result, 1. / P);
+			}
+		}
+
+		// L1 and L2 norms, and p-norms, with a summation policy (see summation.h)
+		template<MathLbr::Norm Norm = MathLbr::Norm::L2, concepts::summation_policy Summation>
+		auto norm(const Summation& summation) const
+		requires (Norm == MathLbr::Norm::L1 or Norm == MathLbr::Norm::L2)
+		{
+			using sum_type = concepts::dispatched_underlying_type<value_type>;
+			if constexpr (std::is_same_v<Summation, summation::sequential_policy>)
+			{
+				return norm<Norm>();
+			}
+			else if constexpr (Norm == MathLbr::Norm::L1)
+			{
+				return summed<sum_type>(summation, [](const value_type& element) { return std::abs(element); });
+			}
+			else
+			{
+				const auto sum = summed<sum_type>(summation, [](const value_type& element)
+					{
+						if constexpr (concepts::is_complex<value_type>::value) return std::norm(element);
+						else return element * element;
+					});
+				if constexpr (std::is_floating_point_v<sum_type>)
+				{
+					// Overflowing compensated sums are NaN (inf - inf), not inf: NaN elements are told apart by a second pass
+					const bool nan_element = std::isnan(sum)
+						and std::any_of(begin(), end(), [](const value_type& element) { return element != element; });
+					if (not (detail::is_safe_sum_of_squares(sum) or nan_element)) return scaled_l2_norm_fallback();
+				}
+				return std::sqrt(sum);
+			}
+		}
+
+		template<std::size_t P, concepts::summation_policy Summation>
+		auto p_norm(const Summation& summation) const requires (P >= 1)
+		{
+			if constexpr (std::is_same_v<Summation, summation::sequential_policy>)
+			{
+				return p_norm<P>();
+			}
+			else
+			{
+				using sum_type = concepts::dispatched_underlying_type<value_type>;
+				const auto result = summed<sum_type>(summation,
+					[](const value_type& element) { return std::pow(std::abs(element), P); });
+				return std::pow(result, 1. / P);
+			}
+		}
+
+	private:
+		// sum(function(element)) with a summation policy
+		template<typename R, typename Summation, typename Function>
+		R summed(const Summation& summation, Function function) const
+		{
+			if constexpr (concepts::contiguous_container<underlying_container>)
+			{
+				const value_type* elements = data();
+				return detail::summation::sum<R>(summation, size(), [elements, function](size_type i) { return function(elements[i]); });
+			}
+			else
+			{
+				const auto elements = begin();
+				return detail::summation::sum<R>(summation, size(),
+					[elements, function](size_type i) { return function(static_cast<value_type>(elements[i])); });
+			}
+		}
+
+	private:
+		// Sum of |x|^2 over [first, last), uses the vectorized kernels when possible
+		auto squared_sum(size_type first, size_type last) const
+		{
+			using sum_type = concepts::dispatched_underlying_type<value_type>;
+			const size_type count = last - first;
+			if constexpr (concepts::split_container<underlying_container> and concepts::simd_complex_type<value_type>)
+			{
+				return detail::simd::dot(real_data() + first, real_data() + first, count)
+					+ detail::simd::dot(imag_data() + first, imag_data() + first, count);
+			}
+			else if constexpr (concepts::contiguous_container<underlying_container>
+				and (concepts::simd_real_type<value_type> or concepts::half_precision_type<value_type>))
+			{
+				return detail::simd::dot(data() + first, data() + first, count);
+			}
+			else if constexpr (concepts::contiguous_container<underlying_container> and concepts::simd_complex_type<value_type>)
+			{
+				// The squared moduli are the squares of the 2 * count parts
+				const auto* parts = reinterpret_cast<const sum_type*>(data() + first);
+				return detail::simd::dot(parts, parts, 2 * count);
+			}
+			else
+			{
+				return std::accumulate(begin() + first, begin() + last, sum_type{},
+					[](auto internal_sum, const value_type& element)
+					{
+						if constexpr (concepts::is_complex<value_type>::value)
+						{
+							const auto res = std::abs(element);
+							return internal_sum + res * res;
+						}
+						else return internal_sum + element * element;
+					});
+			}
+		}
+
+		// Calls function with every real number stored in the vector (both parts of complex elements)
+		template<typename Function>
+		void for_each_part(Function function) const
+		{
+			for (const value_type& element : *this)
+			{
+				if constexpr (concepts::is_complex<value_type>::value)
+				{
+					function(element.real());
+					function(element.imag());
+				}
+				else function(element);
+			}
+		}
+
+		// Euclidean norm in the spirit of BLAS nrm2: the vectorized sum of squares is used when it neither overflowed
+		// nor underflowed, which is the common case. Otherwise the parts are scaled by the largest magnitude and summed again
+		auto scaled_l2_norm() const
+		requires (concepts::simd_type<value_type> or concepts::half_precision_type<value_type>)
+		{
+			using real_type = concepts::dispatched_underlying_type<value_type>;
+			const real_type sum = squared_sum(0, size());
+			if (detail::is_safe_sum_of_squares(sum) or std::isnan(sum)) return std::sqrt(sum);
+			return scaled_l2_norm_fallback();
+		}
+
+		auto scaled_l2_norm_fallback() const
+		{
+			using real_type = concepts::dispatched_underlying_type<value_type>;
+			real_type scale{};
+			for_each_part([&scale](real_type part) { scale = std::max(scale, std::abs(part)); });
+			if (scale == real_type{} or std::isinf(scale)) return scale;
+
+			real_type sum{};
+			for_each_part([&sum, scale](real_type part)
+				{
+					const real_type ratio = part / scale;
+					sum += ratio * ratio;
+				});
+			return scale * std::sqrt(sum);
+		}
+
+		// Divides every element by the real number denominator: vectorized multiplication of the parts by its inverse
+		void divide_parts(concepts::dispatched_underlying_type<value_type> denominator)
+		{
+			using real_type = concepts::dispatched_underlying_type<value_type>;
+			const real_type inverse = 1 / denominator;
+			if (std::isinf(inverse))
+			{
+				// Subnormal denominator
+				for (auto&& element : *this) element /= denominator;
+			}
+			else if constexpr (concepts::half_precision_type<value_type> and concepts::contiguous_container<underlying_container>)
+			{
+				detail::simd::scale(data(), size(), inverse);
+			}
+			else if constexpr (concepts::split_container<underlying_container>)
+			{
+				detail::simd::scale(real_data(), size(), inverse);
+				detail::simd::scale(imag_data(), size(), inverse);
+			}
+			else if constexpr (concepts::contiguous_container<underlying_container>)
+			{
+				// Complex elements: both parts are scaled
+				detail::simd::scale(reinterpret_cast<real_type*>(data()), size() * (concepts::is_complex<value_type>::value ? 2 : 1), inverse);
+			}
+			else
+			{
+				for (auto&& element : *this) element *= inverse;
+			}
+		}
+
+		template<MathLbr::Norm Norm>
+		auto parallel_norm_impl(const execution::parallel_policy& policy) const
+		{
+			using result_type = decltype(norm<Norm>());
+			if constexpr (Norm == MathLbr::Norm::L0)
+			{
+				return detail::execution::reduce_chunks(policy, size(), result_type{}, [this](size_type first, size_type last)
+					{
+						return static_cast<result_type>(std::count_if(begin() + first, begin() + last,
+							[](const value_type& elem) { return elem != value_type{}; }));
+					}, std::plus<result_type>{});
+			}
+			else if constexpr (Norm == MathLbr::Norm::L1)
+			{
+				return detail::execution::reduce_chunks(policy, size(), result_type{}, [this](size_type first, size_type last)
+					{
+						return std::accumulate(begin() + first, begin() + last, result_type{},
+							[](auto internal_sum, const value_type& element) { return internal_sum + std::abs(element); });
+					}, std::plus<result_type>{});
+			}
+			else if constexpr (Norm == MathLbr::Norm::L2)
+			{
+				using sum_type = concepts::dispatched_underlying_type<value_type>;
+				const sum_type sum = detail::execution::reduce_chunks(policy, size(), sum_type{},
+					[this](size_type first, size_type last) { return squared_sum(first, last); }, std::plus<sum_type>{});
+				if constexpr (std::is_floating_point_v<sum_type>)
+				{
+					// Sums of squares overflow to inf: a NaN sum comes from a NaN element, and stays the result
+					if (not (detail::is_safe_sum_of_squares(sum) or std::isnan(sum))) return scaled_l2_norm_fallback();
+				}
+				return std::sqrt(sum);
+			}
+			else
+			{
+				// Earlier chunks win ties, like std::max_element
+				return detail::execution::reduce_chunks(policy, size(), result_type{}, [this](size_type first, size_type last)
+					{
+						return static_cast<result_type>(*std::max_element(begin() + first, begin() + last,
+							[](const value_type& a, const value_type& b) { return std::abs(a) < std::abs(b); }));
+					}, [](const result_type& a, const result_type& b) { return std::abs(a) < std::abs(b) ? b : a; });
+			}
+		}
+
+	public:
+
 
 		// Angle between two vectors (in radians)
-		template<concepts::underlying_vector_type T2>
-		constexpr auto angle_between_radians(const vector<T2, Size>& other) const
+		template<concepts::precision_policy Precision, concepts::underlying_vector_type T2, typename Storage2>
+		constexpr auto angle_between_radians(Precision precision, const vector<T2, Size, Storage2>& other) const
 		requires (concepts::is_not_all_complex<T, T2>) 
 		{
 			detail::assert_same_value<Size>(size(), other.size());
 			const auto magnitude_mult = norm() * other.norm();
 			detail::assert_div_byzero<decltype(magnitude_mult)>(magnitude_mult);
 
-			return std::acos(Vector::inner_product(*this, other) / magnitude_mult);
+			return detail::math::acos(precision, Vector::inner_product(*this, other) / magnitude_mult);
 		}
 
-		template<concepts::underlying_vector_type T2>
-		constexpr auto angle_between_degrees(const vector<T2, Size>& other) const
+		template<concepts::precision_policy Precision, concepts::underlying_vector_type T2, typename Storage2>
+		constexpr auto angle_between_degrees(Precision precision, const vector<T2, Size, Storage2>& other) const
+		requires (concepts::is_not_all_complex<T, T2>) 
+		{
+			return angle_between_radians(precision, other) * 180 / std::numbers::pi;
+		}
+
+		template<concepts::underlying_vector_type T2, typename Storage2>
+		constexpr auto angle_between_radians(const vector<T2, Size, Storage2>& other) const
+		requires (concepts::is_not_all_complex<T, T2>) 
+		{
+			return angle_between_radians(MathLbr::precision::default_policy{}, other);
+		}
+
+		template<concepts::underlying_vector_type T2, typename Storage2>
+		constexpr auto angle_between_degrees(const vector<T2, Size, Storage2>& other) const
 		requires (concepts::is_not_all_complex<T, T2>) 
 		{
 			return angle_between_radians(other) * 180 / std::numbers::pi;
@@ -952,26 +1927,80 @@ namespace MathLbr
 
 		// Angle between complex vectors
 		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
-		concepts::underlying_vector_type T2>
-		constexpr auto angle_between_radians(const vector<T2, Size>& other) const
+		concepts::precision_policy Precision, concepts::underlying_vector_type T2, typename Storage2>
+		constexpr auto angle_between_radians(Precision precision, const vector<T2, Size, Storage2>& other) const
 		requires (concepts::is_all_complex<T, T2>) 
 		{
 			detail::assert_same_value<Size>(size(), other.size());
 
 			const auto magnitude_mult = norm() * other.norm();
 			detail::assert_div_byzero<decltype(magnitude_mult)>(magnitude_mult);
-			return std::acos(Vector::inner_product<definition_type>(*this, other).real() / magnitude_mult);
+			return detail::math::acos(precision, Vector::inner_product<definition_type>(*this, other).real() / magnitude_mult);
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+		concepts::precision_policy Precision, concepts::underlying_vector_type T2, typename Storage2>
+		constexpr auto angle_between_degrees(Precision precision, const vector<T2, Size, Storage2>& other) const
+		requires (concepts::is_all_complex<T, T2>)
+		{
+			return angle_between_radians<definition_type>(precision, other) *
+				static_cast<complex_internal_value_type<value_type>>(180) / std::numbers::pi;
 		}
 
 		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
-		concepts::underlying_vector_type T2>
-		constexpr auto angle_between_degrees(const vector<T2, Size>& other) const
+		concepts::underlying_vector_type T2, typename Storage2>
+		constexpr auto angle_between_radians(const vector<T2, Size, Storage2>& other) const
+		requires (concepts::is_all_complex<T, T2>) 
+		{
+			return angle_between_radians<definition_type>(MathLbr::precision::default_policy{}, other);
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+		concepts::underlying_vector_type T2, typename Storage2>
+		constexpr auto angle_between_degrees(const vector<T2, Size, Storage2>& other) const
 		requires (concepts::is_all_complex<T, T2>)
 		{
 			return angle_between_radians<definition_type>(other) *
 				static_cast<complex_internal_value_type<value_type>>(180) / std::numbers::pi;
 		}
 
+		// Angles with lazy expressions (see vector_expression.h), evaluated first
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+		concepts::precision_policy Precision, concepts::vector_expression Expression>
+		constexpr auto angle_between_radians(Precision precision, const Expression& other) const
+		{
+			if constexpr (concepts::is_complex<value_type>::value)
+			{
+				return angle_between_radians<definition_type>(precision, other.eval());
+			}
+			else return angle_between_radians(precision, other.eval());
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+		concepts::precision_policy Precision, concepts::vector_expression Expression>
+		constexpr auto angle_between_degrees(Precision precision, const Expression& other) const
+		{
+			if constexpr (concepts::is_complex<value_type>::value)
+			{
+				return angle_between_degrees<definition_type>(precision, other.eval());
+			}
+			else return angle_between_degrees(precision, other.eval());
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+		concepts::vector_expression Expression>
+		constexpr auto angle_between_radians(const Expression& other) const
+		{
+			return angle_between_radians<definition_type>(MathLbr::precision::default_policy{}, other);
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT,
+		concepts::vector_expression Expression>
+		constexpr auto angle_between_degrees(const Expression& other) const
+		{
+			return angle_between_degrees<definition_type>(MathLbr::precision::default_policy{}, other);
+		}
+
 		constexpr bool is_empty() const 
 		{
 			return (size() == 0 || std::all_of(begin(), end(),
@@ -981,7 +2010,8 @@ namespace MathLbr
 		constexpr auto operator<=>(const vector&) const = default;
 
 		// Conversions: cartesian --> other coordinate system
-		constexpr underlying_container to_polar_coords() const
+		template<concepts::precision_policy Precision>
+		constexpr underlying_container to_polar_coords(Precision precision) const
 		requires (concepts::is_not_complex<value_type>::value) 
 		{
 			detail::dispatch_assert_equals<Size, 2>(size());
@@ -990,27 +2020,28 @@ namespace MathLbr
 			{
 				return std::vector<value_type>
 				{
-					std::sqrt(std::pow(_vector[0], 2) + std::pow(_vector[1], 2)),
-					std::atan2(_vector[1], _vector[0])
+					detail::math::sqrt(_vector[0] * _vector[0] + _vector[1] * _vector[1]),
+					detail::math::atan2(precision, _vector[1], _vector[0])
 				};
 			}
 			else 
 			{
 				return std::array<value_type, 2>
 				{
-					std::sqrt(std::pow(_vector[0], 2) + std::pow(_vector[1], 2)),
-					std::atan2(_vector[1] / _vector[0])
+					detail::math::sqrt(_vector[0] * _vector[0] + _vector[1] * _vector[1]),
+					detail::math::atan2(precision, _vector[1], _vector[0])
 				};
 			}
 		}
 
-		constexpr underlying_container to_spherical_coords() const
+		template<concepts::precision_policy Precision>
+		constexpr underlying_container to_spherical_coords(Precision precision) const
 		requires (concepts::is_not_complex<value_type>::value) 
 		{
 			detail::dispatch_assert_equals<Size, 3>(size());
 			detail::assert_div_byzero<value_type>(_vector[0]);
 
-			const auto res = std::sqrt(std::pow(_vector[0], 2) + std::pow(_vector[1], 2) + std::pow(_vector[2], 2));
+			const auto res = detail::math::sqrt(_vector[0] * _vector[0] + _vector[1] * _vector[1] + _vector[2] * _vector[2]);
 			detail::assert_div_byzero<decltype(res)>(res);
 
 			// [0] = alpha, [1] = beta, [3] = theta
@@ -1019,8 +2050,8 @@ namespace MathLbr
 				return std::vector<value_type>
 				{
 					res,
-					std::atan2(_vector[1], _vector[0]),
-					std::acos(_vector[2] / res)
+					detail::math::atan2(precision, _vector[1], _vector[0]),
+					detail::math::acos(precision, _vector[2] / res)
 				};
 			}
 			else 
@@ -1028,13 +2059,14 @@ namespace MathLbr
 				return std::array<value_type, 3>
 				{
 					res,
-					std::atan2(_vector[1], _vector[0]),
-					std::acos(_vector[2] / res)
+					detail::math::atan2(precision, _vector[1], _vector[0]),
+					detail::math::acos(precision, _vector[2] / res)
 				};
 			}
 		}
 
-		constexpr underlying_container to_cylindrical_coords() const
+		template<concepts::precision_policy Precision>
+		constexpr underlying_container to_cylindrical_coords(Precision precision) const
 		requires (concepts::is_not_complex<value_type>::value) 
 		{
 			detail::dispatch_assert_equals<Size, 3>(size());
@@ -1044,57 +2076,96 @@ namespace MathLbr
 			{
 				return std::vector<value_type> 
 				{
-					std::sqrt(std::pow(_vector[0], 2) + std::pow(_vector[1], 2)),
-					std::atan2(_vector[1], _vector[0]),
+					detail::math::sqrt(_vector[0] * _vector[0] + _vector[1] * _vector[1]),
+					detail::math::atan2(precision, _vector[1], _vector[0]),
 					_vector[2]
 				};
 			}
 			else
 			{
 				return std::array<T, 3> {
-					std::sqrt(std::pow(_vector[0], 2) + std::pow(_vector[1], 2)),
-					std::atan2(_vector[1], _vector[0]),
+					detail::math::sqrt(_vector[0] * _vector[0] + _vector[1] * _vector[1]),
+					detail::math::atan2(precision, _vector[1], _vector[0]),
 					_vector[2]
 				};
 			}
 		}
 
+		constexpr underlying_container to_polar_coords() const
+		requires (concepts::is_not_complex<value_type>::value) 
+		{
+			return to_polar_coords(MathLbr::precision::default_policy{});
+		}
+
+		constexpr underlying_container to_spherical_coords() const
+		requires (concepts::is_not_complex<value_type>::value) 
+		{
+			return to_spherical_coords(MathLbr::precision::default_policy{});
+		}
+
+		constexpr underlying_container to_cylindrical_coords() const
+		requires (concepts::is_not_complex<value_type>::value) 
+		{
+			return to_cylindrical_coords(MathLbr::precision::default_policy{});
+		}
+
 		// Polar coordinates --> cartesian vector
 		// radius in radians
-		constexpr void from_polar(T r, T radius)
+		template<concepts::precision_policy Precision>
+		constexpr void from_polar(Precision precision, T r, T radius)
 		requires (concepts::is_not_complex<T>::value) 
 		{
 			detail::dispatch_assert_equals<Size, 2>(size());
 
-			_vector[0] = r * std::cos(radius);
-			_vector[1] = r * std::sin(radius);
+			_vector[0] = r * detail::math::cos(precision, radius);
+			_vector[1] = r * detail::math::sin(precision, radius);
 		}
 
 		// Cylindrical coordinates --> cartesian vector
-		constexpr void from_cylindrical(T magnitude, T radius, T z)
+		template<concepts::precision_policy Precision>
+		constexpr void from_cylindrical(Precision precision, T magnitude, T radius, T z)
 		requires (concepts::is_not_complex<T>::value) 
 		{
 			detail::dispatch_assert_equals<Size, 3>(size());
 
-			_vector[0] = magnitude * std::cos(radius);
-			_vector[1] = magnitude * std::sin(radius);
+			_vector[0] = magnitude * detail::math::cos(precision, radius);
+			_vector[1] = magnitude * detail::math::sin(precision, radius);
 			_vector[2] = z;
 		}
 
 		// Spherical coordinates --> cartesian vector
-		constexpr void from_spherical(T alpha, T beta, T theta)
+		template<concepts::precision_policy Precision>
+		constexpr void from_spherical(Precision precision, T alpha, T beta, T theta)
 		requires (concepts::is_not_complex<T>::value) 
 		{
 			detail::dispatch_assert_equals<Size, 3>(size());
 
-			_vector[0] = alpha * std::sin(theta) * std::cos(beta);
-			_vector[1] = alpha * std::sin(theta) * std::sin(beta);
-			_vector[2] = alpha * std::cos(theta);
+			_vector[0] = alpha * detail::math::sin(precision, theta) * detail::math::cos(precision, beta);
+			_vector[1] = alpha * detail::math::sin(precision, theta) * detail::math::sin(precision, beta);
+			_vector[2] = alpha * detail::math::cos(precision, theta);
+		}
+
+		constexpr void from_polar(T r, T radius)
+		requires (concepts::is_not_complex<T>::value) 
+		{
+			from_polar(MathLbr::precision::default_policy{}, r, radius);
+		}
+
+		constexpr void from_cylindrical(T magnitude, T radius, T z)
+		requires (concepts::is_not_complex<T>::value) 
+		{
+			from_cylindrical(MathLbr::precision::default_policy{}, magnitude, radius, z);
+		}
+
+		constexpr void from_spherical(T alpha, T beta, T theta)
+		requires (concepts::is_not_complex<T>::value) 
+		{
+			from_spherical(MathLbr::precision::default_policy{}, alpha, beta, theta);
 		}
 
 		friend std::ostream& operator<< (std::ostream& stream, const vector& rhs) 
 		{
-			for (auto x : rhs._vector) {
+			for (const value_type& x : rhs._vector) {
 				stream << x << ' ';
 			}
 			stream << '\n';
@@ -1102,46 +2173,67 @@ namespace MathLbr
 			return stream;
 		}
 
-		// Todo: Remove rotations and simplify calculus when Math::Matrix is available
-		constexpr void rotate_around_z(T rotation_angle)
+		// Single rotations around one axis: rotation.h has precomputed, composable rotations (matrices and quaternions)
+		template<concepts::precision_policy Precision>
+		constexpr void rotate_around_z(Precision precision, T rotation_angle)
 		requires (concepts::is_not_complex<T>::value) 
 		{
 			detail::dispatch_assert_equals<Size, 3>(size());
 
-			const auto cos = std::cos(rotation_angle);
-			const auto sin = std::sin(rotation_angle);
+			const auto cos = detail::math::cos(precision, rotation_angle);
+			const auto sin = detail::math::sin(precision, rotation_angle);
 			const T tempX = _vector[0] * cos - _vector[1] * sin;
 			const T tempY = _vector[0] * sin + _vector[1] * cos;
 			_vector[0] = tempX;
 			_vector[1] = tempY;
 		}
 
-		constexpr void rotate_around_y(T rotation_angle)
+		template<concepts::precision_policy Precision>
+		constexpr void rotate_around_y(Precision precision, T rotation_angle)
 		requires (concepts::is_not_complex<T>::value) 
 		{
 			detail::dispatch_assert_equals<Size, 3>(size());
 
-			const auto cos = std::cos(rotation_angle);
-			const auto sin = std::sin(rotation_angle);
+			const auto cos = detail::math::cos(precision, rotation_angle);
+			const auto sin = detail::math::sin(precision, rotation_angle);
 			const T tempX = _vector[0] * cos + _vector[2] * sin;
 			const T tempZ = -(_vector[0]) * sin + _vector[2] * cos;
 			_vector[0] = tempX;
 			_vector[2] = tempZ;
 		}
 
-		constexpr void rotate_around_x(T rotation_angle)
+		template<concepts::precision_policy Precision>
+		constexpr void rotate_around_x(Precision precision, T rotation_angle)
 		requires (concepts::is_not_complex<T>::value) 
 		{
 			detail::dispatch_assert_equals<Size, 3>(size());
 
-			const auto cos = std::cos(rotation_angle);
-			const auto sin = std::sin(rotation_angle);
+			const auto cos = detail::math::cos(precision, rotation_angle);
+			const auto sin = detail::math::sin(precision, rotation_angle);
 			const T tempY = _vector[1] * cos - _vector[2] * sin;
 			const T tempZ = _vector[1] * sin + _vector[2] * cos;
 			_vector[1] = tempY;
 			_vector[2] = tempZ;
 		}
 
+		constexpr void rotate_around_z(T rotation_angle)
+		requires (concepts::is_not_complex<T>::value) 
+		{
+			rotate_around_z(MathLbr::precision::default_policy{}, rotation_angle);
+		}
+
+		constexpr void rotate_around_y(T rotation_angle)
+		requires (concepts::is_not_complex<T>::value) 
+		{
+			rotate_around_y(MathLbr::precision::default_policy{}, rotation_angle);
+		}
+
+		constexpr void rotate_around_x(T rotation_angle)
+		requires (concepts::is_not_complex<T>::value) 
+		{
+			rotate_around_x(MathLbr::precision::default_policy{}, rotation_angle);
+		}
+
 		template<typename Function>
 		constexpr vector apply_foreach(Function function) noexcept(noexcept(function)) 
 		{
@@ -1152,6 +2244,20 @@ namespace MathLbr
 			return *this;
 		}
 
+		// function must be safe to call concurrently on different elements
+		template<concepts::execution_policy Policy, typename Function>
+		vector apply_foreach(const Policy& policy, Function function)
+		{
+			return dispatch_elementwise(policy, size(), [&]() { apply_foreach(function); },
+				[&](size_type first, size_type last)
+				{
+					for (size_type i = first; i < last; ++i)
+					{
+						function(_vector[i]);
+					}
+				});
+		}
+
 		constexpr size_type size() const noexcept 
 		{
 			if constexpr (concepts::dynamic_extent_enabled<Size>) 
@@ -1229,14 +2335,7 @@ namespace MathLbr
 			_vector.push_back(static_cast<value_type>(new_element));
 		}
 
-		constexpr std::vector<value_type>& underlying_data()
-		requires (concepts::dynamic_extent_enabled<Size>) 
-		{
-			return _vector;
-		}
-
-		constexpr std::array<T, Size>& underlying_data() 
-		requires (not concepts::dynamic_extent_disabled<Size>)
+		constexpr underlying_container& underlying_data()
 		{
 			return _vector;
 		}
@@ -1249,6 +2348,32 @@ namespace MathLbr
 
 	template<typename InputIt>
 	vector(InputIt, InputIt)->vector<typename std::iterator_traits<InputIt>::value_type>;
+
+	namespace pmr
+	{
+		// Dynamic vectors get their memory from a std::pmr::memory_resource (e.g. std::pmr::monotonic_buffer_resource)
+		template<concepts::underlying_vector_type T, std::size_t Size = dynamic_extent>
+		using vector = MathLbr::vector<T, Size, allocator_storage<std::pmr::polymorphic_allocator<T>>>;
+	}
+
+	// Dynamic vector storing up to N elements without heap allocations (see small_storage)
+	template<concepts::underlying_vector_type T, std::size_t N = 16>
+	using small_vector = vector<T, dynamic_extent, small_storage<N>>;
+
+	// Complex vector whose real and imaginary parts are stored separately (see split_complex_storage)
+	template<typename T, std::size_t Size = dynamic_extent>
+	using split_complex_vector = vector<std::complex<T>, Size, split_complex_storage>;
+
+	/*
+		Non-owning vector referring to Extent (or a runtime number of) contiguous elements owned by someone else, like std::span.
+		vector_view<const T> is read-only. Operations returning a new vector return a MathLbr::vector<T, Extent>.
+	*/
+	template<typename T, std::size_t Extent = dynamic_extent>
+	using vector_view = vector<std::remove_const_t<T>, Extent, view_storage<std::is_const_v<T>>>;
+
+	// Vector whose elements are aligned to Alignment bytes (see aligned)
+	template<concepts::underlying_vector_type T, std::size_t Size = dynamic_extent, std::size_t Alignment = 64>
+	using aligned_vector = vector<T, Size, aligned<Alignment>>;
 }
 
 #endif
@@ -0,0 +1,613 @@
+#ifndef VECTOR_BATCH_HEADER
+#define VECTOR_BATCH_HEADER
+
+#include "vector.h"
+#include "vectorized_math.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+
+/*
+	vector_batch<T, Dim> holds many vectors of the same (small, compile-time) dimension in structure-of-arrays layout:
+	component d of every vector is stored contiguously (x0 x1 x2 ..., y0 y1 y2 ..., ...).
+	Batched operations are simple loops over these arrays, which the compiler vectorizes.
+*/
+
+namespace MathLbr
+{
+	template<concepts::arithmetic_char_const_excluded T, std::size_t Dim>
+	requires (Dim > 0 and concepts::dynamic_extent_disabled<Dim>)
+	class vector_batch;
+}
+
+
+namespace concepts
+{
+	template<typename T>
+	struct is_vector_batch : std::false_type {};
+
+	template<typename T, std::size_t Dim>
+	struct is_vector_batch<MathLbr::vector_batch<T, Dim>> : std::true_type {};
+}
+
+
+namespace MathLbr
+{
+	template<concepts::arithmetic_char_const_excluded T, std::size_t Dim>
+	requires (Dim > 0 and concepts::dynamic_extent_disabled<Dim>)
+	class vector_batch
+	{
+	public:
+		using size_type = std::size_t;
+		using value_type = T;
+		using vector_type = vector<T, Dim>;
+		using component_container = std::vector<T>;
+
+		static constexpr size_type dimension = Dim;
+
+	private:
+		std::array<component_container, Dim> _components;
+
+	public:
+		constexpr vector_batch() = default;
+
+		constexpr explicit vector_batch(size_type count)
+		{
+			resize(count);
+		}
+
+		// AoS -> SoA: from a range of MathLbr::vector with the same dimension
+		template<std::input_iterator InputIter>
+		constexpr vector_batch(InputIter first, InputIter last)
+		requires (concepts::is_vector<typename std::iterator_traits<InputIter>::value_type>::value
+		and concepts::convertible_to_or_not_narrowing_conversion<typename std::iterator_traits<InputIter>::value_type::value_type, value_type>)
+		{
+			if constexpr (std::forward_iterator<InputIter>)
+			{
+				reserve(static_cast<size_type>(std::distance(first, last)));
+			}
+			for (; first != last; ++first)
+			{
+				push_back(*first);
+			}
+		}
+
+		template<concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		constexpr explicit(not concepts::allow_implicit_conversions::value) vector_batch(std::initializer_list<vector<T2, Size, Storage>> list)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
+			: vector_batch(list.begin(), list.end())
+		{
+		}
+
+		constexpr size_type size() const noexcept
+		{
+			return _components[0].size();
+		}
+
+		constexpr bool is_empty() const noexcept
+		{
+			return _components[0].empty();
+		}
+
+		constexpr void resize(size_type count)
+		{
+			for (auto& component : _components)
+			{
+				component.resize(count);
+			}
+		}
+
+		constexpr void reserve(size_type count)
+		{
+			for (auto& component : _components)
+			{
+				component.reserve(count);
+			}
+		}
+
+		constexpr void clear() noexcept
+		{
+			for (auto& component : _components)
+			{
+				component.clear();
+			}
+		}
+
+		template<concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		constexpr void push_back(const vector<T2, Size, Storage>& element)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
+		{
+			detail::dispatch_assert_equals<Size, Dim>(element.size());
+			for (size_type d = 0; d < Dim; ++d)
+			{
+				_components[d].push_back(static_cast<value_type>(element[d]));
+			}
+		}
+
+		// Gathers the index-th vector of the batch
+		constexpr vector_type operator[](size_type index) const
+		{
+			vector_type result{};
+			for (size_type d = 0; d < Dim; ++d)
+			{
+				result[d] = _components[d][index];
+			}
+			return result;
+		}
+
+		// Scatters element into the index-th vector of the batch
+		template<concepts::underlying_vector_type T2, std::size_t Size, typename Storage>
+		constexpr void set(size_type index, const vector<T2, Size, Storage>& element)
+		requires (concepts::convertible_to_or_not_narrowing_conversion<T2, value_type>)
+		{
+			detail::dispatch_assert_equals<Size, Dim>(element.size());
+			for (size_type d = 0; d < Dim; ++d)
+			{
+				_components[d][index] = static_cast<value_type>(element[d]);
+			}
+		}
+
+		// SoA -> AoS
+		std::vector<vector_type> to_vectors() const
+		{
+			std::vector<vector_type> result(size());
+			for (size_type d = 0; d < Dim; ++d)
+			{
+				for (size_type i = 0; i < size(); ++i)
+				{
+					result[i][d] = _components[d][i];
+				}
+			}
+			return result;
+		}
+
+		// Contiguous array holding the d-th component of every vector
+		constexpr value_type* component(size_type d) noexcept
+		{
+			return _components[d].data();
+		}
+
+		constexpr const value_type* component(size_type d) const noexcept
+		{
+			return _components[d].data();
+		}
+
+		constexpr value_type* x() noexcept { return component(0); }
+		constexpr const value_type* x() const noexcept { return component(0); }
+
+		constexpr value_type* y() noexcept requires (Dim >= 2) { return component(1); }
+		constexpr const value_type* y() const noexcept requires (Dim >= 2) { return component(1); }
+
+		constexpr value_type* z() noexcept requires (Dim >= 3) { return component(2); }
+		constexpr const value_type* z() const noexcept requires (Dim >= 3) { return component(2); }
+
+		constexpr value_type* w() noexcept requires (Dim >= 4) { return component(3); }
+		constexpr const value_type* w() const noexcept requires (Dim >= 4) { return component(3); }
+
+		// Same semantics as vector::norm<Norm>(), computed for every vector of the batch
+		// (L2 norms of integral batches are floating point, like for vector)
+		template<MathLbr::Norm Norm = MathLbr::Norm::L2>
+		auto norm() const
+		{
+			using result_type = std::conditional_t<Norm == MathLbr::Norm::L2, decltype(std::sqrt(std::declval<value_type>())), value_type>;
+			std::vector<result_type> result(size(), result_type{});
+			result_type* out = result.data();
+			const size_type count = size();
+
+			if constexpr (Norm == MathLbr::Norm::L2)
+			{
+				for (size_type d = 0; d < Dim; ++d)
+				{
+					const value_type* in = component(d);
+					for (size_type i = 0; i < count; ++i)
+					{
+						out[i] += in[i] * in[i];
+					}
+				}
+				for (size_type i = 0; i < count; ++i)
+				{
+					out[i] = std::sqrt(out[i]);
+				}
+				if constexpr (std::is_floating_point_v<value_type>)
+				{
+					// Sums of squares that overflowed or underflowed: scaled computation of vector::norm()
+					for (size_type i = 0; i < count; ++i)
+					{
+						const result_type squared = out[i] * out[i];
+						if (not detail::is_safe_sum_of_squares(squared) and not std::isnan(squared)) out[i] = (*this)[i].norm();
+					}
+				}
+			}
+			else if constexpr (Norm == MathLbr::Norm::L1)
+			{
+				for (size_type d = 0; d < Dim; ++d)
+				{
+					const value_type* in = component(d);
+					for (size_type i = 0; i < count; ++i)
+					{
+						out[i] += static_cast<value_type>(std::abs(in[i]));
+					}
+				}
+			}
+			else if constexpr (Norm == MathLbr::Norm::L0)
+			{
+				for (size_type d = 0; d < Dim; ++d)
+				{
+					const value_type* in = component(d);
+					for (size_type i = 0; i < count; ++i)
+					{
+						out[i] += (in[i] != value_type{}) ? 1 : 0;
+					}
+				}
+			}
+			else
+			{
+				// Element with the greatest magnitude (first one on ties), like vector::norm<Norm::LINF>()
+				std::copy_n(component(0), count, out);
+				for (size_type d = 1; d < Dim; ++d)
+				{
+					const value_type* in = component(d);
+					for (size_type i = 0; i < count; ++i)
+					{
+						out[i] = std::abs(out[i]) < std::abs(in[i]) ? in[i] : out[i];
+					}
+				}
+			}
+			return result;
+		}
+
+	private:
+		static constexpr size_type normalize_block_size = 256;
+
+		// Length is std::integral_constant for full blocks: loops with a constant trip count are always vectorized
+		template<typename Length>
+		void normalize_block(size_type first, Length length)
+		{
+			using real_type = decltype(std::sqrt(std::declval<value_type>()));
+			real_type sums[normalize_block_size]{};
+			real_type inverses[normalize_block_size];
+
+			for (size_type d = 0; d < Dim; ++d)
+			{
+				const value_type* in = component(d) + first;
+				for (size_type i = 0; i < length; ++i)
+				{
+					sums[i] += static_cast<real_type>(in[i]) * static_cast<real_type>(in[i]);
+				}
+			}
+			for (size_type i = 0; i < length; ++i)
+			{
+				inverses[i] = 1 / std::sqrt(sums[i]);
+				if constexpr (std::is_floating_point_v<value_type>)
+				{
+					if (not detail::is_safe_sum_of_squares(sums[i]) and not std::isnan(sums[i]))
+					{
+						set(first + i, (*this)[first + i].normalize());
+						inverses[i] = 1;
+					}
+				}
+				else detail::assert_div_byzero<real_type>(sums[i]);
+			}
+
+			for (size_type d = 0; d < Dim; ++d)
+			{
+				value_type* inout = component(d) + first;
+				for (size_type i = 0; i < length; ++i)
+				{
+					inout[i] = static_cast<value_type>(inout[i] * inverses[i]);
+				}
+			}
+		}
+
+	public:
+		// Normalizes every vector of the batch. Every vector must have a non-zero norm.
+		// Blocks of vectors are normalized while their components are still in cache: sums of squares, then scaling.
+		// The rare vectors whose sum of squares overflows or underflows are normalized by vector::normalize() instead
+		vector_batch& normalize()
+		{
+			const size_type count = size();
+			size_type first = 0;
+			for (; first + normalize_block_size <= count; first += normalize_block_size)
+			{
+				normalize_block(first, std::integral_constant<size_type, normalize_block_size>{});
+			}
+			if (first < count) normalize_block(first, count - first);
+			return *this;
+		}
+
+		/*
+			Coordinate conversions of every vector, with the same conventions as vector::to_*_coords and vector::from_*:
+			polar (radius, angle), cylindrical (radius, angle, z), spherical (radius, azimuth, polar angle).
+			Results are batches too: component d of the result is coordinate d of every vector.
+			float and double batches use the vectorized functions of vectorized_math.h (a few ulp away from <cmath>), or their
+			faster approximations with precision::fast (see documentation/vector/fast_math.md).
+			The overloads taking a result batch resize it and never allocate otherwise; result may be *this.
+		*/
+		template<concepts::precision_policy Precision>
+		void to_polar_coords(Precision, vector_batch& result) const
+		requires (Dim == 2 and std::floating_point<T>)
+		{
+			result.resize(size());
+			detail::vectorized::run(detail::vectorized::to_polar<T, Precision>{ { x(), y() }, { result.x(), result.y() } }, size());
+		}
+
+		template<concepts::precision_policy Precision>
+		vector_batch to_polar_coords(Precision precision) const
+		requires (Dim == 2 and std::floating_point<T>)
+		{
+			vector_batch result;
+			to_polar_coords(precision, result);
+			return result;
+		}
+
+		template<concepts::precision_policy Precision>
+		void to_cylindrical_coords(Precision, vector_batch& result) const
+		requires (Dim == 3 and std::floating_point<T>)
+		{
+			result.resize(size());
+			detail::vectorized::run(detail::vectorized::to_polar<T, Precision>{ { x(), y() }, { result.x(), result.y() } }, size());
+			if (&result != this) std::copy_n(z(), size(), result.z());
+		}
+
+		template<concepts::precision_policy Precision>
+		vector_batch to_cylindrical_coords(Precision precision) const
+		requires (Dim == 3 and std::floating_point<T>)
+		{
+			vector_batch result;
+			to_cylindrical_coords(precision, result);
+			return result;
+		}
+
+		template<concepts::precision_policy Precision>
+		void to_spherical_coords(Precision, vector_batch& result) const
+		requires (Dim == 3 and std::floating_point<T>)
+		{
+			result.resize(size());
+			detail::vectorized::run(detail::vectorized::to_spherical<T, Precision>{ { x(), y(), z() }, { result.x(), result.y(), result.z() } },
+				size());
+		}
+
+		template<concepts::precision_policy Precision>
+		vector_batch to_spherical_coords(Precision precision) const
+		requires (Dim == 3 and std::floating_point<T>)
+		{
+			vector_batch result;
+			to_spherical_coords(precision, result);
+			return result;
+		}
+
+		// Polar coordinates (radius, angle) --> cartesian vectors
+		template<concepts::precision_policy Precision>
+		vector_batch& from_polar(Precision, const vector_batch& polar)
+		requires (Dim == 2 and std::floating_point<T>)
+		{
+			resize(polar.size());
+			detail::vectorized::run(detail::vectorized::from_polar<T, Precision>{ { polar.x(), polar.y() }, { x(), y() } }, size());
+			return *this;
+		}
+
+		// Cylindrical coordinates (radius, angle, z) --> cartesian vectors
+		template<concepts::precision_policy Precision>
+		vector_batch& from_cylindrical(Precision, const vector_batch& cylindrical)
+		requires (Dim == 3 and std::floating_point<T>)
+		{
+			resize(cylindrical.size());
+			detail::vectorized::run(detail::vectorized::from_polar<T, Precision>{ { cylindrical.x(), cylindrical.y() }, { x(), y() } },
+				size());
+			if (&cylindrical != this) std::copy_n(cylindrical.z(), size(), z());
+			return *this;
+		}
+
+		// Spherical coordinates (radius, azimuth, polar angle) --> cartesian vectors
+		template<concepts::precision_policy Precision>
+		vector_batch& from_spherical(Precision, const vector_batch& spherical)
+		requires (Dim == 3 and std::floating_point<T>)
+		{
+			resize(spherical.size());
+			detail::vectorized::run(detail::vectorized::from_spherical<T, Precision>{ { spherical.x(), spherical.y(), spherical.z() },
+				{ x(), y(), z() } }, size());
+			return *this;
+		}
+
+		// Without a precision policy: MathLbr::precision::default_policy
+		void to_polar_coords(vector_batch& result) const
+		requires (Dim == 2 and std::floating_point<T>)
+		{
+			to_polar_coords(MathLbr::precision::default_policy{}, result);
+		}
+
+		vector_batch to_polar_coords() const
+		requires (Dim == 2 and std::floating_point<T>)
+		{
+			return to_polar_coords(MathLbr::precision::default_policy{});
+		}
+
+		void to_cylindrical_coords(vector_batch& result) const
+		requires (Dim == 3 and std::floating_point<T>)
+		{
+			to_cylindrical_coords(MathLbr::precision::default_policy{}, result);
+		}
+
+		vector_batch to_cylindrical_coords() const
+		requires (Dim == 3 and std::floating_point<T>)
+		{
+			return to_cylindrical_coords(MathLbr::precision::default_policy{});
+		}
+
+		void to_spherical_coords(vector_batch& result) const
+		requires (Dim == 3 and std::floating_point<T>)
+		{
+			to_spherical_coords(MathLbr::precision::default_policy{}, result);
+		}
+
+		vector_batch to_spherical_coords() const
+		requires (Dim == 3 and std::floating_point<T>)
+		{
+			return to_spherical_coords(MathLbr::precision::default_policy{});
+		}
+
+		vector_batch& from_polar(const vector_batch& polar)
+		requires (Dim == 2 and std::floating_point<T>)
+		{
+			return from_polar(MathLbr::precision::default_policy{}, polar);
+		}
+
+		vector_batch& from_cylindrical(const vector_batch& cylindrical)
+		requires (Dim == 3 and std::floating_point<T>)
+		{
+			return from_cylindrical(MathLbr::precision::default_policy{}, cylindrical);
+		}
+
+		vector_batch& from_spherical(const vector_batch& spherical)
+		requires (Dim == 3 and std::floating_point<T>)
+		{
+			return from_spherical(MathLbr::precision::default_policy{}, spherical);
+		}
+
+		friend bool operator==(const vector_batch& lhs, const vector_batch& rhs) = default;
+	};
+
+
+	/*
+		Batched versions of the free functions of MathLbr::Vector: operation i is performed between the i-th vectors
+		of every batch. All batches must have the same size.
+	*/
+	namespace Vector
+	{
+		template<typename T, std::size_t Dim>
+		std::vector<T> inner_product(const vector_batch<T, Dim>& lhs, const vector_batch<T, Dim>& rhs)
+		{
+			assert(lhs.size() == rhs.size() && "Batches must have the same size!");
+			std::vector<T> result(lhs.size(), T{});
+			T* out = result.data();
+			for (std::size_t d = 0; d < Dim; ++d)
+			{
+				const T* a = lhs.component(d);
+				const T* b = rhs.component(d);
+				for (std::size_t i = 0; i < lhs.size(); ++i)
+				{
+					out[i] += a[i] * b[i];
+				}
+			}
+			return result;
+		}
+
+		template<typename T>
+		vector_batch<T, 3> cross_product(const vector_batch<T, 3>& lhs, const vector_batch<T, 3>& rhs)
+		{
+			assert(lhs.size() == rhs.size() && "Batches must have the same size!");
+			const std::size_t count = lhs.size();
+			vector_batch<T, 3> result(count);
+			const T* ax = lhs.x(); const T* ay = lhs.y(); const T* az = lhs.z();
+			const T* bx = rhs.x(); const T* by = rhs.y(); const T* bz = rhs.z();
+			T* rx = result.x(); T* ry = result.y(); T* rz = result.z();
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				rx[i] = ay[i] * bz[i] - az[i] * by[i];
+				ry[i] = az[i] * bx[i] - ax[i] * bz[i];
+				rz[i] = ax[i] * by[i] - ay[i] * bx[i];
+			}
+			return result;
+		}
+
+		// Same order of operations as the non-batched version: third DOT (first CROSS second)
+		template<typename T>
+		std::vector<T> scalar_triple_product(const vector_batch<T, 3>& first, const vector_batch<T, 3>& other2,
+			const vector_batch<T, 3>& other3)
+		{
+			assert(first.size() == other2.size() && first.size() == other3.size() && "Batches must have the same size!");
+			const std::size_t count = first.size();
+			std::vector<T> result(count);
+			const T* ax = first.x(); const T* ay = first.y(); const T* az = first.z();
+			const T* bx = other2.x(); const T* by = other2.y(); const T* bz = other2.z();
+			const T* cx = other3.x(); const T* cy = other3.y(); const T* cz = other3.z();
+			T* out = result.data();
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				out[i] = cx[i] * (ay[i] * bz[i] - az[i] * by[i])
+					+ cy[i] * (az[i] * bx[i] - ax[i] * bz[i])
+					+ cz[i] * (ax[i] * by[i] - ay[i] * bx[i]);
+			}
+			return result;
+		}
+
+		template<typename T>
+		vector_batch<T, 3> vector_triple_product(const vector_batch<T, 3>& first, const vector_batch<T, 3>& other2,
+			const vector_batch<T, 3>& other3)
+		{
+			return cross_product(other3, cross_product(first, other2));
+		}
+
+		template<typename T, std::size_t Dim>
+		vector_batch<T, Dim> normalize(vector_batch<T, Dim> batch)
+		{
+			return batch.normalize();
+		}
+
+		// Same criteria as the non-batched are_parallel: cross product in 3D, Cauchy-Schwarz equality otherwise
+		template<typename T, std::size_t Dim>
+		std::vector<bool> are_parallel(const vector_batch<T, Dim>& first, const vector_batch<T, Dim>& other, double epsilon = 1E-6)
+		{
+			std::vector<bool> result(first.size());
+			if constexpr (Dim == 3)
+			{
+				const auto cross = cross_product(first, other);
+				const auto eps = std::abs(epsilon);
+				for (std::size_t i = 0; i < result.size(); ++i)
+				{
+					result[i] = cross.x()[i] >= 0 && cross.x()[i] <= eps
+						&& cross.y()[i] >= 0 && cross.y()[i] <= eps
+						&& cross.z()[i] >= 0 && cross.z()[i] <= eps;
+				}
+			}
+			else
+			{
+				const auto inner = inner_product(first, other);
+				const auto first_squared = inner_product(first, first);
+				const auto other_squared = inner_product(other, other);
+				for (std::size_t i = 0; i < result.size(); ++i)
+				{
+					const double rhs1 = first_squared[i];
+					const double rhs2 = other_squared[i];
+					result[i] = detail::is_near_zero(std::abs(rhs1 * rhs2 - std::pow(inner[i], 2)), epsilon);
+				}
+			}
+			return result;
+		}
+
+		template<typename T, std::size_t Dim>
+		std::vector<bool> are_perpendicular(const vector_batch<T, Dim>& first, const vector_batch<T, Dim>& other, double epsilon = 1E-6)
+		{
+			const auto inner = inner_product(first, other);
+			std::vector<bool> result(inner.size());
+			for (std::size_t i = 0; i < inner.size(); ++i)
+			{
+				result[i] = detail::is_near_zero(inner[i], epsilon);
+			}
+			return result;
+		}
+
+		template<typename T>
+		std::vector<bool> are_coplanar(const vector_batch<T, 3>& first, const vector_batch<T, 3>& other2,
+			const vector_batch<T, 3>& other3, double epsilon = 1E-6)
+		{
+			const auto triple = scalar_triple_product(first, other2, other3);
+			std::vector<bool> result(triple.size());
+			for (std::size_t i = 0; i < triple.size(); ++i)
+			{
+				result[i] = detail::is_near_zero(triple[i], epsilon);
+			}
+			return result;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,665 @@
+#ifndef VECTOR_EXPRESSION_HEADER
+#define VECTOR_EXPRESSION_HEADER
+
+#include "utility.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+
+namespace MathLbr
+{
+	template<concepts::underlying_vector_type T, std::size_t Size, typename Storage>
+	class vector;
+
+	template<typename Op, typename Lhs, typename Rhs>
+	class vector_binary_expression;
+
+	template<typename Op, typename Lhs, typename Scalar>
+	class vector_scalar_expression;
+
+	template<typename Op, typename Operand>
+	class vector_unary_expression;
+}
+
+
+namespace concepts
+{
+	template<typename T>
+	struct is_vector : std::false_type {};
+
+	template<typename T, std::size_t Size, typename Storage>
+	struct is_vector<MathLbr::vector<T, Size, Storage>> : std::true_type {};
+
+	template<typename T>
+	struct is_vector_expression : std::false_type {};
+
+	template<typename Op, typename Lhs, typename Rhs>
+	struct is_vector_expression<MathLbr::vector_binary_expression<Op, Lhs, Rhs>> : std::true_type {};
+
+	template<typename Op, typename Lhs, typename Scalar>
+	struct is_vector_expression<MathLbr::vector_scalar_expression<Op, Lhs, Scalar>> : std::true_type {};
+
+	template<typename Op, typename Operand>
+	struct is_vector_expression<MathLbr::vector_unary_expression<Op, Operand>> : std::true_type {};
+
+	template<typename T>
+	concept vector_expression = is_vector_expression<std::remove_cvref_t<T>>::value;
+
+	// Anything that can appear on either side of a (lazy) vector operator: a vector or an unevaluated expression
+	template<typename T>
+	concept vector_operand = is_vector<std::remove_cvref_t<T>>::value or vector_expression<T>;
+
+	template<vector_operand T>
+	using operand_value_type = typename std::remove_cvref_t<T>::value_type;
+
+	// Vector operands of which at least one is an unevaluated expression
+	template<typename... T>
+	concept vector_operands_with_expression = (vector_operand<T> and ...) and (vector_expression<T> or ...);
+}
+
+
+namespace detail
+{
+	// Lvalue operands are referenced, rvalue operands are moved inside the expression so that
+	// something like (a + b) * 2 or make_vector() + a never holds a dangling reference.
+	template<typename Operand>
+	using expression_operand_t = std::conditional_t<std::is_lvalue_reference_v<Operand>,
+		const std::remove_cvref_t<Operand>&, std::remove_cvref_t<Operand>>;
+
+	template<typename Operand>
+	constexpr std::size_t expression_common_size(const Operand& operand) noexcept
+	{
+		if constexpr (concepts::vector_expression<Operand>)
+		{
+			return operand.common_size();
+		}
+		else return operand.size();
+	}
+
+	// Leftmost vector of an expression, the one that decides the type (and allocator) of the result
+	template<typename Operand>
+	constexpr const auto& expression_leftmost(const Operand& operand) noexcept
+	{
+		if constexpr (concepts::vector_expression<Operand>)
+		{
+			return operand.leftmost();
+		}
+		else return operand;
+	}
+
+	// Vectors are used as they are, expressions are evaluated into their result_type
+	template<typename Operand>
+	constexpr decltype(auto) evaluate_operand(const Operand& operand)
+	{
+		if constexpr (concepts::vector_expression<Operand>)
+		{
+			return operand.eval();
+		}
+		else return (operand);
+	}
+
+	template<typename Operand>
+	constexpr decltype(auto) expression_fused_at(const Operand& operand, std::size_t index)
+	{
+		if constexpr (concepts::vector_expression<Operand>)
+		{
+			return operand.fused_at(index);
+		}
+		else return operand[index];
+	}
+
+	// Element-wise operations between two vectors. They mirror the lambdas used by operator+= and operator-=
+	struct expression_plus
+	{
+		template<typename T, typename T2>
+		constexpr auto operator()(const T& lhs, const T2& rhs) const
+		{
+			return lhs + rhs;
+		}
+	};
+
+	struct expression_minus
+	{
+		template<typename T, typename T2>
+		constexpr auto operator()(const T& lhs, const T2& rhs) const
+		{
+			return lhs - rhs;
+		}
+	};
+
+	// Operations between a vector and a scalar. They mirror the compound assignment operators, so that
+	// conversions happen exactly as they would with operator+=, operator*= and so on.
+	struct expression_plus_assign
+	{
+		template<typename T, typename T2>
+		constexpr void operator()(T& current, const T2& val) const
+		{
+			current += val;
+		}
+	};
+
+	struct expression_minus_assign
+	{
+		template<typename T, typename T2>
+		constexpr void operator()(T& current, const T2& val) const
+		{
+			current -= val;
+		}
+	};
+
+	struct expression_multiplies_assign
+	{
+		template<typename T, typename T2>
+		constexpr void operator()(T& current, const T2& lambda) const
+		{
+			current *= lambda;
+		}
+	};
+
+	struct expression_divides_assign
+	{
+		template<typename T, typename T2>
+		constexpr void operator()(T& current, const T2& lambda) const
+		{
+			current /= lambda;
+		}
+	};
+
+	struct expression_modulus_assign
+	{
+		template<typename T, typename T2>
+		constexpr void operator()(T& current, const T2& lambda) const
+		{
+			current %= lambda;
+		}
+	};
+
+	struct expression_negate
+	{
+		template<typename T>
+		constexpr auto operator()(const T& current) const
+		{
+			return -current;
+		}
+	};
+}
+
+
+namespace MathLbr
+{
+	/*
+		Member functions shared by the expressions below: the expression is evaluated, then the member function of
+		the resulting vector is called. The ones modifying a vector (normalize, cross_product, vector_projection_from)
+		return the modified result by value, so that (a + b).norm() or (a - b).normalize() keep working as with vectors.
+	*/
+	template<typename Expression>
+	class vector_expression_interface
+	{
+	private:
+		constexpr auto evaluated() const
+		{
+			return static_cast<const Expression&>(*this).eval();
+		}
+
+		static constexpr bool is_complex_expression()
+		{
+			return concepts::is_complex<typename Expression::value_type>::value;
+		}
+
+	public:
+		constexpr auto x() const
+		{
+			return static_cast<const Expression&>(*this)[0];
+		}
+
+		constexpr auto y() const
+		{
+			return static_cast<const Expression&>(*this)[1];
+		}
+
+		constexpr auto z() const
+		{
+			return static_cast<const Expression&>(*this)[2];
+		}
+
+		constexpr auto w() const
+		{
+			return static_cast<const Expression&>(*this)[3];
+		}
+
+		template<MathLbr::Norm Norm = MathLbr::Norm::L2, typename... Args>
+		constexpr auto norm(const Args&... args) const
+		{
+			return evaluated().template norm<Norm>(args...);
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT, typename... Args>
+		constexpr auto angle_between_radians(const Args&... args) const
+		{
+			if constexpr (is_complex_expression())
+			{
+				return evaluated().template angle_between_radians<definition_type>(args...);
+			}
+			else return evaluated().angle_between_radians(args...);
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT, typename... Args>
+		constexpr auto angle_between_degrees(const Args&... args) const
+		{
+			if constexpr (is_complex_expression())
+			{
+				return evaluated().template angle_between_degrees<definition_type>(args...);
+			}
+			else return evaluated().angle_between_degrees(args...);
+		}
+
+		template<typename... Args>
+		constexpr double direction_radians_x(const Args&... args) const
+		{
+			return evaluated().direction_radians_x(args...);
+		}
+
+		template<typename... Args>
+		constexpr double direction_radians_y(const Args&... args) const
+		{
+			return evaluated().direction_radians_y(args...);
+		}
+
+		template<typename... Args>
+		constexpr double direction_degrees_x(const Args&... args) const
+		{
+			return evaluated().direction_degrees_x(args...);
+		}
+
+		template<typename... Args>
+		constexpr double direction_degrees_y(const Args&... args) const
+		{
+			return evaluated().direction_degrees_y(args...);
+		}
+
+		constexpr double direction_cosine(Cos type) const
+		{
+			return evaluated().direction_cosine(type);
+		}
+
+		template<typename... Args>
+		constexpr double direction_angle(const Args&... args) const
+		{
+			return evaluated().direction_angle(args...);
+		}
+
+		template<typename... Args>
+		constexpr auto to_polar_coords(const Args&... args) const
+		{
+			return evaluated().to_polar_coords(args...);
+		}
+
+		template<typename... Args>
+		constexpr auto to_spherical_coords(const Args&... args) const
+		{
+			return evaluated().to_spherical_coords(args...);
+		}
+
+		template<typename... Args>
+		constexpr auto to_cylindrical_coords(const Args&... args) const
+		{
+			return evaluated().to_cylindrical_coords(args...);
+		}
+
+		constexpr bool is_empty() const
+		{
+			return evaluated().is_empty();
+		}
+
+		constexpr auto normalize() const
+		{
+			auto result = evaluated();
+			result.normalize();
+			return result;
+		}
+
+		template<typename Rhs>
+		constexpr auto cross_product(const Rhs& rhs) const
+		{
+			auto result = evaluated();
+			result.cross_product(rhs);
+			return result;
+		}
+
+		template<ComplexInnerProduct definition_type = ComplexInnerProduct::ANTILINEAR_FIRST_ARGUMENT, typename From>
+		constexpr auto vector_projection_from(const From& from) const
+		{
+			auto result = evaluated();
+			if constexpr (is_complex_expression())
+			{
+				result.template vector_projection_from<definition_type>(from);
+			}
+			else result.vector_projection_from(from);
+			return result;
+		}
+	};
+
+
+	/*
+		Lazy expressions returned by the arithmetic operators of MathLbr::vector.
+		No computation happens until the expression is assigned to (or used to construct) a vector, at which point
+		the whole expression tree is evaluated in a single loop, without any intermediate vector.
+		The semantics are the same as the eager operators: the result has the type and size of the leftmost vector,
+		and binary operations between vectors of different sizes only affect the first min(lhs.size(), rhs.size()) elements.
+		Expressions hold references to lvalue operands, so they must not outlive them: use eval() when in doubt.
+	*/
+
+	template<typename Op, typename Lhs, typename Rhs>
+	class vector_binary_expression : public vector_expression_interface<vector_binary_expression<Op, Lhs, Rhs>>
+	{
+	private:
+		detail::expression_operand_t<Lhs> _lhs;
+		detail::expression_operand_t<Rhs> _rhs;
+
+	public:
+		using result_type = typename std::remove_cvref_t<Lhs>::result_type;
+		using value_type = typename result_type::value_type;
+		using size_type = std::size_t;
+
+		constexpr vector_binary_expression(Lhs&& lhs, Rhs&& rhs)
+			: _lhs(std::forward<Lhs>(lhs)), _rhs(std::forward<Rhs>(rhs))
+		{
+		}
+
+		constexpr size_type size() const noexcept
+		{
+			return _lhs.size();
+		}
+
+		constexpr const auto& leftmost() const noexcept
+		{
+			return detail::expression_leftmost(_lhs);
+		}
+
+		// Number of leading elements where every node of the expression applies its operation
+		constexpr size_type common_size() const noexcept
+		{
+			return std::min(detail::expression_common_size(_lhs), detail::expression_common_size(_rhs));
+		}
+
+		constexpr value_type fused_at(size_type index) const
+		{
+			return Op{}(detail::expression_fused_at(_lhs, index), detail::expression_fused_at(_rhs, index));
+		}
+
+		constexpr value_type operator[](size_type index) const
+		{
+			if (index < _rhs.size())
+			{
+				return Op{}(_lhs[index], _rhs[index]);
+			}
+			return _lhs[index];
+		}
+
+		constexpr result_type eval() const
+		{
+			return result_type(*this);
+		}
+
+		friend constexpr bool operator==(const vector_binary_expression& lhs, const result_type& rhs)
+		{
+			return lhs.eval() == rhs;
+		}
+
+		friend std::ostream& operator<< (std::ostream& stream, const vector_binary_expression& rhs)
+		{
+			return stream << rhs.eval();
+		}
+	};
+
+	template<typename Op, typename Lhs, typename Scalar>
+	class vector_scalar_expression : public vector_expression_interface<vector_scalar_expression<Op, Lhs, Scalar>>
+	{
+	private:
+		detail::expression_operand_t<Lhs> _lhs;
+		Scalar _scalar;
+
+	public:
+		using result_type = typename std::remove_cvref_t<Lhs>::result_type;
+		using value_type = typename result_type::value_type;
+		using size_type = std::size_t;
+
+		constexpr vector_scalar_expression(Lhs&& lhs, Scalar scalar)
+			: _lhs(std::forward<Lhs>(lhs)), _scalar(scalar)
+		{
+		}
+
+		constexpr size_type size() const noexcept
+		{
+			return _lhs.size();
+		}
+
+		constexpr const auto& leftmost() const noexcept
+		{
+			return detail::expression_leftmost(_lhs);
+		}
+
+		constexpr size_type common_size() const noexcept
+		{
+			return detail::expression_common_size(_lhs);
+		}
+
+		constexpr value_type fused_at(size_type index) const
+		{
+			value_type current = detail::expression_fused_at(_lhs, index);
+			Op{}(current, _scalar);
+			return current;
+		}
+
+		constexpr value_type operator[](size_type index) const
+		{
+			value_type current = _lhs[index];
+			Op{}(current, _scalar);
+			return current;
+		}
+
+		constexpr result_type eval() const
+		{
+			return result_type(*this);
+		}
+
+		friend constexpr bool operator==(const vector_scalar_expression& lhs, const result_type& rhs)
+		{
+			return lhs.eval() == rhs;
+		}
+
+		friend std::ostream& operator<< (std::ostream& stream, const vector_scalar_expression& rhs)
+		{
+			return stream << rhs.eval();
+		}
+	};
+
+	template<typename Op, typename Operand>
+	class vector_unary_expression : public vector_expression_interface<vector_unary_expression<Op, Operand>>
+	{
+	private:
+		detail::expression_operand_t<Operand> _operand;
+
+	public:
+		using result_type = typename std::remove_cvref_t<Operand>::result_type;
+		using value_type = typename result_type::value_type;
+		using size_type = std::size_t;
+
+		constexpr explicit vector_unary_expression(Operand&& operand)
+			: _operand(std::forward<Operand>(operand))
+		{
+		}
+
+		constexpr size_type size() const noexcept
+		{
+			return _operand.size();
+		}
+
+		constexpr const auto& leftmost() const noexcept
+		{
+			return detail::expression_leftmost(_operand);
+		}
+
+		constexpr size_type common_size() const noexcept
+		{
+			return detail::expression_common_size(_operand);
+		}
+
+		constexpr value_type fused_at(size_type index) const
+		{
+			return Op{}(detail::expression_fused_at(_operand, index));
+		}
+
+		constexpr value_type operator[](size_type index) const
+		{
+			return Op{}(_operand[index]);
+		}
+
+		constexpr result_type eval() const
+		{
+			return result_type(*this);
+		}
+
+		friend constexpr bool operator==(const vector_unary_expression& lhs, const result_type& rhs)
+		{
+			return lhs.eval() == rhs;
+		}
+
+		friend std::ostream& operator<< (std::ostream& stream, const vector_unary_expression& rhs)
+		{
+			return stream << rhs.eval();
+		}
+	};
+
+
+	// Addition
+	template<concepts::vector_operand Lhs, concepts::vector_operand Rhs>
+	constexpr auto operator+(Lhs&& lhs, Rhs&& rhs)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<concepts::operand_value_type<Lhs>>()
+		+ std::declval<concepts::operand_value_type<Rhs>>()), concepts::operand_value_type<Lhs>>)
+	{
+		return vector_binary_expression<detail::expression_plus, Lhs, Rhs>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+	}
+
+	template<concepts::vector_operand Lhs, concepts::underlying_vector_type T2>
+	constexpr auto operator+(Lhs&& lhs, T2 val)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<concepts::operand_value_type<Lhs>>()
+		+ std::declval<T2>()), concepts::operand_value_type<Lhs>>)
+	{
+		return vector_scalar_expression<detail::expression_plus_assign, Lhs, T2>(std::forward<Lhs>(lhs), val);
+	}
+
+	template<concepts::underlying_vector_type T2, concepts::vector_operand Rhs>
+	constexpr auto operator+(T2 val, Rhs&& rhs)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<concepts::operand_value_type<Rhs>>()
+		+ std::declval<T2>()), concepts::operand_value_type<Rhs>>)
+	{
+		return vector_scalar_expression<detail::expression_plus_assign, Rhs, T2>(std::forward<Rhs>(rhs), val);
+	}
+
+	// Negation
+	template<concepts::vector_operand Operand>
+	constexpr auto operator-(Operand&& operand)
+	requires (not std::is_unsigned<concepts::operand_value_type<Operand>>::value)
+	{
+		return vector_unary_expression<detail::expression_negate, Operand>(std::forward<Operand>(operand));
+	}
+
+	// Substraction
+	template<concepts::vector_operand Lhs, concepts::vector_operand Rhs>
+	constexpr auto operator-(Lhs&& lhs, Rhs&& rhs)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<concepts::operand_value_type<Lhs>>()
+		- std::declval<concepts::operand_value_type<Rhs>>()), concepts::operand_value_type<Lhs>>)
+	{
+		return vector_binary_expression<detail::expression_minus, Lhs, Rhs>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+	}
+
+	template<concepts::vector_operand Lhs, concepts::vector_operand Rhs>
+	[[deprecated("substracting vector of type unsigned might cause issues!")]]
+	constexpr auto operator-(Lhs&& lhs, Rhs&& rhs)
+	requires (std::is_unsigned<concepts::operand_value_type<Lhs>>::value
+	and concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<concepts::operand_value_type<Lhs>>()
+		- std::declval<concepts::operand_value_type<Rhs>>()), concepts::operand_value_type<Lhs>>)
+	{
+		return vector_binary_expression<detail::expression_minus, Lhs, Rhs>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+	}
+
+	template<concepts::vector_operand Lhs, concepts::underlying_vector_type T2>
+	constexpr auto operator-(Lhs&& lhs, T2 val)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<concepts::operand_value_type<Lhs>>()
+		- std::declval<T2>()), concepts::operand_value_type<Lhs>>)
+	{
+		return vector_scalar_expression<detail::expression_minus_assign, Lhs, T2>(std::forward<Lhs>(lhs), val);
+	}
+
+	template<concepts::vector_operand Lhs, concepts::underlying_vector_type T2>
+	[[deprecated("substracting from an unsigned vector might cause issues!")]]
+	constexpr auto operator-(Lhs&& lhs, T2 val)
+	requires (std::is_unsigned<concepts::operand_value_type<Lhs>>::value
+	and concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<concepts::operand_value_type<Lhs>>()
+		- std::declval<T2>()), concepts::operand_value_type<Lhs>>)
+	{
+		return vector_scalar_expression<detail::expression_minus_assign, Lhs, T2>(std::forward<Lhs>(lhs), val);
+	}
+
+	// Multiplication with a Lambda - Scalar multiplication
+	template<concepts::vector_operand Lhs, concepts::underlying_vector_type T2>
+	constexpr auto operator*(Lhs&& lhs, T2 lambda)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<concepts::operand_value_type<Lhs>>()
+		* lambda), concepts::operand_value_type<Lhs>>)
+	{
+		return vector_scalar_expression<detail::expression_multiplies_assign, Lhs, T2>(std::forward<Lhs>(lhs), lambda);
+	}
+
+	template<concepts::vector_operand Lhs, concepts::underlying_vector_type T2>
+	[[deprecated("multiplying vector of type unsigned might cause issues!")]]
+	constexpr auto operator*(Lhs&& lhs, T2 lambda)
+	requires (std::is_unsigned<concepts::operand_value_type<Lhs>>::value
+	and concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<concepts::operand_value_type<Lhs>>()
+		* lambda), concepts::operand_value_type<Lhs>>)
+	{
+		return vector_scalar_expression<detail::expression_multiplies_assign, Lhs, T2>(std::forward<Lhs>(lhs), lambda);
+	}
+
+	template<concepts::underlying_vector_type T2, concepts::vector_operand Rhs>
+	constexpr auto operator*(T2 lambda, Rhs&& rhs)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<concepts::operand_value_type<Rhs>>()
+		* lambda), concepts::operand_value_type<Rhs>>)
+	{
+		return vector_scalar_expression<detail::expression_multiplies_assign, Rhs, T2>(std::forward<Rhs>(rhs), lambda);
+	}
+
+	template<concepts::underlying_vector_type T2, concepts::vector_operand Rhs>
+	[[deprecated("multiplying vector of type unsigned might cause issues!")]]
+	constexpr auto operator*(T2 lambda, Rhs&& rhs)
+	requires (std::is_unsigned<concepts::operand_value_type<Rhs>>::value
+	and concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<concepts::operand_value_type<Rhs>>()
+		* lambda), concepts::operand_value_type<Rhs>>)
+	{
+		return vector_scalar_expression<detail::expression_multiplies_assign, Rhs, T2>(std::forward<Rhs>(rhs), lambda);
+	}
+
+	// Division with a constant/lambda - for precision and correctness, use multiplication instead
+	template<concepts::vector_operand Lhs, concepts::underlying_vector_type T2>
+	constexpr auto operator/(Lhs&& lhs, T2 lambda)
+	requires (concepts::convertible_to_or_not_narrowing_conversion<decltype(std::declval<concepts::operand_value_type<Lhs>>()
+		/ lambda), concepts::operand_value_type<Lhs>>)
+	{
+		detail::assert_div_byzero<concepts::operand_value_type<Lhs>>(static_cast<concepts::operand_value_type<Lhs>>(lambda));
+		return vector_scalar_expression<detail::expression_divides_assign, Lhs, T2>(std::forward<Lhs>(lhs), lambda);
+	}
+
+	template<concepts::vector_operand Lhs, concepts::underlying_vector_type T2>
+	constexpr auto operator%(Lhs&& lhs, T2 lambda)
+	requires (std::is_integral_v<concepts::operand_value_type<Lhs>> and std::is_integral_v<T2>)
+	{
+		detail::assert_div_byzero<concepts::operand_value_type<Lhs>>(lambda);
+		return vector_scalar_expression<detail::expression_modulus_assign, Lhs, T2>(std::forward<Lhs>(lhs), lambda);
+	}
+}
+
+#endif
@@ -0,0 +1,658 @@
+#ifndef VECTORIZED_MATH_HEADER
+#define VECTORIZED_MATH_HEADER
+
+#include "simd.h"
+#include "precision.h"
+#include "constexpr_math.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <type_traits>
+
+
+/*
+	sqrt, sin/cos, atan2 and acos over arrays of float/double, written without branches so that the compiler vectorizes
+	them (libm functions are never vectorized). Range reduction + minimax polynomials (fdlibm/cephes coefficients).
+	Maximum errors measured against long double references:
+		double: sin/cos 0.8 ulp, atan2 1.7 ulp, acos 1.2 ulp
+		float:  sin/cos 0.9 ulp, atan2 3.1 ulp, acos 1.3 ulp
+	With MathLbr::precision::fast_policy (shorter polynomials, no reduction nor division in atan and acos):
+		double: relative error 2.3e-9 (sin/cos), 1.8e-8 (atan2), 1.5e-8 (acos)
+		float:  sin/cos 0.9 ulp, atan2 2.2 ulp, acos 2.8 ulp
+	Inputs the kernels don't handle (angles beyond reduction_limit, infinities, NaNs) are passed to <cmath> afterwards.
+	Other floating point types always use <cmath>.
+	Arrays are processed in blocks of block_size elements: full blocks have a compile-time length, which the compiler
+	always vectorizes, and results are written to local arrays so that inputs and outputs never alias.
+*/
+namespace detail::vectorized
+{
+	inline constexpr std::size_t block_size = 256;
+
+	template<typename T>
+	struct constants;
+
+	template<>
+	struct constants<double>
+	{
+		using bits_type = std::uint64_t;
+
+		// x + round_magic - round_magic rounds x to an integer, which is also found in the low bits of x + round_magic
+		static constexpr double round_magic = 0x1.8p52;
+
+		// pi / 2 split in parts whose products with k < 2^20 are exact (Cody-Waite)
+		static constexpr double pio2_1 = 0x1.921fb544p0;
+		static constexpr double pio2_2 = 0x1.0b4611a6p-34;
+		static constexpr double pio2_3 = 2.02226624879595063154e-21;
+		static constexpr double reduction_limit = 0x1p20;
+	};
+
+	template<>
+	struct constants<float>
+	{
+		using bits_type = std::uint32_t;
+
+		static constexpr float round_magic = 0x1.8p23f;
+
+		// Products with k < 2^11 are exact. Four parts are needed so that angles close to multiples of pi / 2 keep their precision
+		static constexpr float pio2_1 = 0x1.921p0f;
+		static constexpr float pio2_2 = 0x1.f6ap-13f;
+		static constexpr float pio2_3 = 0x1.11p-26f;
+		static constexpr float pio2_4 = 0x1.68c234c4c6629p-39f;
+		static constexpr float reduction_limit = 0x1p11f;
+	};
+
+	// mask ? if_true : if_false, mask being all zeros or all ones. Floating point selects and comparisons may trap
+	// (-ftrapping-math), which stops the compiler from removing branches
+	template<concepts::simd_real_type T>
+	MATHLBR_INLINE T select(typename constants<T>::bits_type mask, T if_true, T if_false) noexcept
+	{
+		using bits_type = typename constants<T>::bits_type;
+		return std::bit_cast<T>((std::bit_cast<bits_type>(if_true) & mask) | (std::bit_cast<bits_type>(if_false) & ~mask));
+	}
+
+	template<concepts::simd_real_type T>
+	MATHLBR_INLINE T select(bool condition, T if_true, T if_false) noexcept
+	{
+		using bits_type = typename constants<T>::bits_type;
+		return select(bits_type{ 0 } - static_cast<bits_type>(condition), if_true, if_false);
+	}
+
+	// All ones when the sign bit of x is set (-0 included). SSE2 has no 64 bit comparisons, but has 64 bit shifts
+	template<concepts::simd_real_type T>
+	MATHLBR_INLINE typename constants<T>::bits_type sign_mask(T x) noexcept
+	{
+		using bits_type = typename constants<T>::bits_type;
+		return bits_type{ 0 } - (std::bit_cast<bits_type>(x) >> (sizeof(T) * 8 - 1));
+	}
+
+	// x = k * pi / 2 + r + tail, |r| <= pi / 4, for |x| <= reduction_limit. The low bits of quadrant are those of k.
+	// r alone would carry the rounding error of the last subtractions (up to an ulp of r for large k): it's kept
+	// in tail, whose first order contribution is added by sin_cos
+	template<concepts::simd_real_type T>
+	MATHLBR_INLINE T reduce(T x, typename constants<T>::bits_type& quadrant, T& tail) noexcept
+	{
+		using traits = constants<T>;
+		using bits_type = typename traits::bits_type;
+
+		const T shifted = x * static_cast<T>(2 / std::numbers::pi) + traits::round_magic;
+		quadrant = std::bit_cast<bits_type>(shifted);
+		const T k = shifted - traits::round_magic;
+		// a and product are exact, a - product is computed with its rounding error (TwoSum)
+		T a, product, rest;
+		if constexpr (std::is_same_v<T, float>)
+		{
+			a = (x - k * traits::pio2_1) - k * traits::pio2_2;
+			product = k * traits::pio2_3;
+			rest = k * traits::pio2_4;
+		}
+		else
+		{
+			a = x - k * traits::pio2_1;
+			product = k * traits::pio2_2;
+			rest = k * traits::pio2_3;
+		}
+		const T difference = a - product;
+		const T rounded = difference - a;
+		const T error = (a - (difference - rounded)) - (product + rounded);
+		const T low = error - rest;
+		const T r = difference + low;
+		tail = (difference - r) + low;
+		return r;
+	}
+
+	// sin(x) and cos(x) for |x| <= reduction_limit
+	template<concepts::precision_policy Precision, concepts::simd_real_type T>
+	MATHLBR_INLINE void sin_cos(T x, T& sin, T& cos) noexcept
+	{
+		using bits_type = typename constants<T>::bits_type;
+		bits_type quadrant;
+		T tail;
+		const T r = reduce(x, quadrant, tail);
+
+		const T z = r * r;
+		T sin_r, cos_r;
+		if constexpr (std::is_same_v<T, double> and not concepts::fast_precision_policy<Precision>)
+		{
+			// sin(r + tail) = sin(r) + tail * cos(r), cos(r + tail) = cos(r) - tail * sin(r), to first order
+			sin_r = r + (r * z * (-1.66666666666666324348e-01 + z * (8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04
+				+ z * (2.75573137070700676789e-06 + z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)))))
+				+ tail * (1 - 0.5 * z));
+			// 1 - z / 2 with its rounding error added back
+			const T half = 0.5 * z;
+			const T w = 1 - half;
+			cos_r = w + ((((1 - w) - half) - r * tail) + z * z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03
+				+ z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07 + z * (2.08757232129817482790e-09
+				+ z * -1.13596475577881948265e-11))))));
+		}
+		else
+		{
+			// The float polynomials, also used by fast double: degree 9 and 10 instead of 13 and 14
+			sin_r = r + (r * z * (static_cast<T>(-0x1.555556p-3f) + z * (static_cast<T>(0x1.11110ep-7f)
+				+ z * (static_cast<T>(-0x1.a01a02p-13f) + z * static_cast<T>(0x1.71de3ap-19f)))) + tail);
+			const T half = static_cast<T>(0.5) * z;
+			const T w = 1 - half;
+			cos_r = w + ((((1 - w) - half) - r * tail) + z * z * (static_cast<T>(0x1.555556p-5f) + z * (static_cast<T>(-0x1.6c16c2p-10f)
+				+ z * (static_cast<T>(0x1.a01a02p-16f) + z * static_cast<T>(-0x1.27e4fcp-22f)))));
+		}
+
+		// Quadrants 1 and 3 swap sin and cos, quadrants 2 and 3 negate sin, quadrants 1 and 2 negate cos
+		constexpr int sign_shift = sizeof(T) * 8 - 2;
+		const bool odd = (quadrant & 1) != 0;
+		sin = std::bit_cast<T>(std::bit_cast<bits_type>(select(odd, cos_r, sin_r)) ^ ((quadrant & 2) << sign_shift));
+		cos = std::bit_cast<T>(std::bit_cast<bits_type>(select(odd, sin_r, cos_r)) ^ (((quadrant + 1) & 2) << sign_shift));
+	}
+
+	// atan(t) for t in [0, 1]
+	template<concepts::precision_policy Precision, concepts::simd_real_type T>
+	MATHLBR_INLINE T atan_unit(T t) noexcept
+	{
+		if constexpr (concepts::fast_precision_policy<Precision>)
+		{
+			// Abramowitz and Stegun 4.4.49, |error| <= 2e-8 on [0, 1]: no reduction, no division
+			const T z = t * t;
+			return t + t * z * (static_cast<T>(-0.3333314528) + z * (static_cast<T>(0.1999355085) + z * (static_cast<T>(-0.1420889944)
+				+ z * (static_cast<T>(0.1065626393) + z * (static_cast<T>(-0.0752896400) + z * (static_cast<T>(0.0429096138)
+				+ z * (static_cast<T>(-0.0161657367) + z * static_cast<T>(0.0028662257))))))));
+		}
+		else if constexpr (std::is_same_v<T, double>)
+		{
+			// atan(t) = pi / 4 + atan((t - 1) / (t + 1))
+			const bool shifted = std::isgreater(t, 0.66);
+			const T reduced = (t - 1) / (t + 1);
+			const T x = select(shifted, reduced, t);
+			const T z = x * x;
+			const T p = (((-8.750608600031904122785e-1 * z - 1.615753718733365076637e1) * z - 7.500855792314704667340e1) * z
+				- 1.228866684490136173410e2) * z - 6.485021904942025371773e1;
+			const T q = ((((z + 2.485846490142306297962e1) * z + 1.650270098316988542046e2) * z + 4.328810604912902668951e2) * z
+				+ 4.853903996359136964868e2) * z + 1.945506571482613964425e2;
+			const T result = x + x * (z * p / q);
+			return select(shifted, (std::numbers::pi / 4 + 3.061616997868382943065e-17) + result, result);
+		}
+		else
+		{
+			const bool shifted = std::isgreater(t, 0.41421356f);
+			const T reduced = (t - 1) / (t + 1);
+			const T x = select(shifted, reduced, t);
+			const T z = x * x;
+			const T result = x + x * z * (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f);
+			return select(shifted, std::numbers::pi_v<float> / 4 + result, result);
+		}
+	}
+
+	// atan2(y, x) for finite x and y, signed zeros included
+	template<concepts::precision_policy Precision, concepts::simd_real_type T>
+	MATHLBR_INLINE T atan2(T y, T x) noexcept
+	{
+		using bits_type = typename constants<T>::bits_type;
+		const T abs_x = std::abs(x);
+		const T abs_y = std::abs(y);
+
+		// atan(|y| / |x|) = pi / 2 - atan(|x| / |y|): the ratio is always in [0, 1]
+		const bool steep = std::isgreater(abs_y, abs_x);
+		const T denominator = select(steep, abs_y, abs_x);
+		const T ratio = select(steep, abs_x, abs_y) / select(denominator == 0, T{ 1 }, denominator);
+		T result = atan_unit<Precision>(ratio);
+		result = select(steep, std::numbers::pi_v<T> / 2 - result, result);
+		result = select(sign_mask(x), std::numbers::pi_v<T> - result, result);
+		constexpr bits_type sign_bit = bits_type{ 1 } << (sizeof(T) * 8 - 1);
+		return std::bit_cast<T>(std::bit_cast<bits_type>(result) | (std::bit_cast<bits_type>(y) & sign_bit));
+	}
+
+	// Argument of the square root computed before acos (see sqrt below)
+	template<concepts::precision_policy Precision, concepts::simd_real_type T>
+	MATHLBR_INLINE T acos_root_argument(T x) noexcept
+	{
+		if constexpr (concepts::fast_precision_policy<Precision>)
+		{
+			return 1 - std::abs(x);
+		}
+		else return (1 - std::abs(x)) * static_cast<T>(0.5);
+	}
+
+	// acos(x) for x in [-1, 1], root being the square root of acos_root_argument(x)
+	template<concepts::precision_policy Precision, concepts::simd_real_type T>
+	MATHLBR_INLINE T acos(T x, T root) noexcept
+	{
+		const T abs_x = std::abs(x);
+		if constexpr (concepts::fast_precision_policy<Precision>)
+		{
+			// Abramowitz and Stegun 4.4.46: acos(|x|) = sqrt(1 - |x|) * p(|x|), |error| <= 2e-8
+			const T result = root * (static_cast<T>(1.5707963050) + abs_x * (static_cast<T>(-0.2145988016)
+				+ abs_x * (static_cast<T>(0.0889789874) + abs_x * (static_cast<T>(-0.0501743046) + abs_x * (static_cast<T>(0.0308918810)
+				+ abs_x * (static_cast<T>(-0.0170881256) + abs_x * (static_cast<T>(0.0066700901) + abs_x * static_cast<T>(-0.0012624911))))))));
+			return select(std::isless(x, T{ 0 }), std::numbers::pi_v<T> - result, result);
+		}
+		else
+		{
+			// |x| <= 0.5: acos(|x|) = pi / 2 - asin(|x|), else acos(|x|) = 2 * asin(sqrt((1 - |x|) / 2))
+			const bool half_angle = std::isgreater(abs_x, static_cast<T>(0.5));
+			const T z = select(half_angle, (1 - abs_x) * static_cast<T>(0.5), abs_x * abs_x);
+			const T s = select(half_angle, root, abs_x);
+
+			// asin(s) = s + s * r(s^2)
+			T r;
+			if constexpr (std::is_same_v<T, double>)
+			{
+				const T p = z * (1.66666666666666657415e-01 + z * (-3.25565818622400915405e-01 + z * (2.01212532134862925881e-01
+					+ z * (-4.00555345006794114027e-02 + z * (7.91534994289814532176e-04 + z * 3.47933107596021167570e-05)))));
+				const T q = 1 + z * (-2.40339491173441421878e+00 + z * (2.02094576023350569471e+00 + z * (-6.88283971605453293030e-01
+					+ z * 7.70381505559019352791e-02)));
+				r = p / q;
+			}
+			else
+			{
+				r = z * (1.6666586697e-01f + z * (-4.2743422091e-02f + z * -8.6563630030e-03f)) / (1 + z * -7.0662963390e-01f);
+			}
+			const T asin_s = s + s * r;
+			const T result = select(half_angle, 2 * asin_s, std::numbers::pi_v<T> / 2 - asin_s);
+			return select(std::isless(x, T{ 0 }), std::numbers::pi_v<T> - result, result);
+		}
+	}
+
+
+	// Functions over arrays of `length` elements, length <= block_size
+
+	// std::sqrt is never vectorized when it may set errno: square roots are computed in place with intrinsics
+	template<std::floating_point T, typename Length>
+	MATHLBR_INLINE void sqrt(T* data, Length length) noexcept
+	{
+#if MATHLBR_SIMD_X86
+		if constexpr (concepts::simd_real_type<T>)
+		{
+			constexpr std::size_t lanes = 16 / sizeof(T);
+			const std::size_t vectorized = length - length % lanes;
+			for (std::size_t i = 0; i < vectorized; i += lanes)
+			{
+				if constexpr (std::is_same_v<T, double>)
+				{
+					_mm_storeu_pd(data + i, _mm_sqrt_pd(_mm_loadu_pd(data + i)));
+				}
+				else _mm_storeu_ps(data + i, _mm_sqrt_ps(_mm_loadu_ps(data + i)));
+			}
+			for (std::size_t i = vectorized; i < length; ++i)
+			{
+				data[i] = std::sqrt(data[i]);
+			}
+			return;
+		}
+#endif
+		for (std::size_t i = 0; i < length; ++i)
+		{
+			data[i] = std::sqrt(data[i]);
+		}
+	}
+
+	template<concepts::precision_policy Precision, std::floating_point T, typename Length>
+	MATHLBR_INLINE void sin_cos(const T* angle, T* sin, T* cos, Length length) noexcept
+	{
+		if constexpr (concepts::simd_real_type<T>)
+		{
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				sin_cos<Precision>(angle[i], sin[i], cos[i]);
+			}
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				if (not (std::abs(angle[i]) <= constants<T>::reduction_limit))
+				{
+					sin[i] = std::sin(angle[i]);
+					cos[i] = std::cos(angle[i]);
+				}
+			}
+		}
+		else
+		{
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				sin[i] = std::sin(angle[i]);
+				cos[i] = std::cos(angle[i]);
+			}
+		}
+	}
+
+	template<concepts::precision_policy Precision, std::floating_point T, typename Length>
+	MATHLBR_INLINE void atan2(const T* y, const T* x, T* result, Length length) noexcept
+	{
+		if constexpr (concepts::simd_real_type<T>)
+		{
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				result[i] = atan2<Precision>(y[i], x[i]);
+			}
+		}
+		for (std::size_t i = 0; i < length; ++i)
+		{
+			// Infinities and NaNs
+			if (not concepts::simd_real_type<T> or not (std::abs(x[i]) <= std::numeric_limits<T>::max()
+				and std::abs(y[i]) <= std::numeric_limits<T>::max()))
+			{
+				result[i] = std::atan2(y[i], x[i]);
+			}
+		}
+	}
+
+	template<concepts::precision_policy Precision, std::floating_point T, typename Length>
+	MATHLBR_INLINE void acos(const T* x, T* result, Length length) noexcept
+	{
+		if constexpr (concepts::simd_real_type<T>)
+		{
+			T roots[block_size];
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				roots[i] = acos_root_argument<Precision>(x[i]);
+			}
+			sqrt(roots, length);
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				result[i] = acos<Precision>(x[i], roots[i]);
+			}
+		}
+		else
+		{
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				result[i] = std::acos(x[i]);
+			}
+		}
+	}
+
+
+	/*
+		Coordinate conversions over structure of arrays, with the same formulas as vector::to_*_coords and vector::from_*.
+		Kernels read the components in[d] and write the components out[d] of `length` points starting at `first`.
+		Every block is read entirely before its results are written: outputs may be the inputs.
+	*/
+	template<std::floating_point T, concepts::precision_policy Precision = MathLbr::precision::exact_policy>
+	struct to_polar
+	{
+		using value_type = T;
+
+		// x, y --> radius, angle
+		std::array<const T*, 2> in;
+		std::array<T*, 2> out;
+
+		template<typename Length>
+		MATHLBR_INLINE void operator()(std::size_t first, Length length) const noexcept
+		{
+			T radii[block_size];
+			T angles[block_size];
+			const T* x = in[0] + first;
+			const T* y = in[1] + first;
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				radii[i] = x[i] * x[i] + y[i] * y[i];
+			}
+			sqrt(radii, length);
+			atan2<Precision>(y, x, angles, length);
+			std::copy_n(radii, static_cast<std::size_t>(length), out[0] + first);
+			std::copy_n(angles, static_cast<std::size_t>(length), out[1] + first);
+		}
+	};
+
+	// The polar angle is atan2(sqrt(x^2 + y^2), z), equal to acos(z / r) but without its loss of precision near the poles
+	template<std::floating_point T, concepts::precision_policy Precision = MathLbr::precision::exact_policy>
+	struct to_spherical
+	{
+		using value_type = T;
+
+		// x, y, z --> radius, azimuth, polar angle
+		std::array<const T*, 3> in;
+		std::array<T*, 3> out;
+
+		template<typename Length>
+		MATHLBR_INLINE void operator()(std::size_t first, Length length) const noexcept
+		{
+			T radii[block_size];
+			T azimuths[block_size];
+			T polars[block_size];
+			const T* x = in[0] + first;
+			const T* y = in[1] + first;
+			const T* z = in[2] + first;
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				polars[i] = x[i] * x[i] + y[i] * y[i];
+				radii[i] = polars[i] + z[i] * z[i];
+			}
+			sqrt(radii, length);
+			sqrt(polars, length);
+			atan2<Precision>(y, x, azimuths, length);
+			atan2<Precision>(polars, z, polars, length);
+			std::copy_n(radii, static_cast<std::size_t>(length), out[0] + first);
+			std::copy_n(azimuths, static_cast<std::size_t>(length), out[1] + first);
+			std::copy_n(polars, static_cast<std::size_t>(length), out[2] + first);
+		}
+	};
+
+	template<std::floating_point T, concepts::precision_policy Precision = MathLbr::precision::exact_policy>
+	struct from_polar
+	{
+		using value_type = T;
+
+		// radius, angle --> x, y
+		std::array<const T*, 2> in;
+		std::array<T*, 2> out;
+
+		template<typename Length>
+		MATHLBR_INLINE void operator()(std::size_t first, Length length) const noexcept
+		{
+			T sines[block_size];
+			T cosines[block_size];
+			const T* radius = in[0] + first;
+			sin_cos<Precision>(in[1] + first, sines, cosines, length);
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				cosines[i] = radius[i] * cosines[i];
+				sines[i] = radius[i] * sines[i];
+			}
+			std::copy_n(cosines, static_cast<std::size_t>(length), out[0] + first);
+			std::copy_n(sines, static_cast<std::size_t>(length), out[1] + first);
+		}
+	};
+
+	template<std::floating_point T, concepts::precision_policy Precision = MathLbr::precision::exact_policy>
+	struct from_spherical
+	{
+		using value_type = T;
+
+		// radius, azimuth, polar angle --> x, y, z
+		std::array<const T*, 3> in;
+		std::array<T*, 3> out;
+
+		template<typename Length>
+		MATHLBR_INLINE void operator()(std::size_t first, Length length) const noexcept
+		{
+			T azimuth_sines[block_size];
+			T azimuth_cosines[block_size];
+			T polar_sines[block_size];
+			T polar_cosines[block_size];
+			const T* radius = in[0] + first;
+			sin_cos<Precision>(in[1] + first, azimuth_sines, azimuth_cosines, length);
+			sin_cos<Precision>(in[2] + first, polar_sines, polar_cosines, length);
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				azimuth_cosines[i] = radius[i] * polar_sines[i] * azimuth_cosines[i];
+				azimuth_sines[i] = radius[i] * polar_sines[i] * azimuth_sines[i];
+				polar_cosines[i] = radius[i] * polar_cosines[i];
+			}
+			std::copy_n(azimuth_cosines, static_cast<std::size_t>(length), out[0] + first);
+			std::copy_n(azimuth_sines, static_cast<std::size_t>(length), out[1] + first);
+			std::copy_n(polar_cosines, static_cast<std::size_t>(length), out[2] + first);
+		}
+	};
+
+
+	inline constexpr std::size_t small_block_size = 16;
+
+	// Full blocks get an std::integral_constant length, and so do the blocks of small_block_size points of the tail.
+	// The last points are copied to a zero-padded small block: scalar code would be much slower than a whole vectorized block
+	template<typename Kernel>
+	MATHLBR_INLINE void for_each_block(const Kernel& kernel, std::size_t count) noexcept
+	{
+		using value_type = typename Kernel::value_type;
+		constexpr std::size_t inputs = std::tuple_size_v<decltype(kernel.in)>;
+		constexpr std::size_t outputs = std::tuple_size_v<decltype(kernel.out)>;
+
+		std::size_t first = 0;
+		for (; first + block_size <= count; first += block_size)
+		{
+			kernel(first, std::integral_constant<std::size_t, block_size>{});
+		}
+		for (; first + small_block_size <= count; first += small_block_size)
+		{
+			kernel(first, std::integral_constant<std::size_t, small_block_size>{});
+		}
+		if (first < count)
+		{
+			const std::size_t rest = count - first;
+			value_type in[inputs][small_block_size]{};
+			value_type out[outputs][small_block_size];
+			Kernel padded = kernel;
+			for (std::size_t d = 0; d < inputs; ++d)
+			{
+				std::copy_n(kernel.in[d] + first, rest, in[d]);
+				padded.in[d] = in[d];
+			}
+			for (std::size_t d = 0; d < outputs; ++d)
+			{
+				padded.out[d] = out[d];
+			}
+			padded(0, std::integral_constant<std::size_t, small_block_size>{});
+			for (std::size_t d = 0; d < outputs; ++d)
+			{
+				std::copy_n(out[d], rest, kernel.out[d] + first);
+			}
+		}
+	}
+
+	template<typename Kernel>
+	void for_each_block_portable(const Kernel& kernel, std::size_t count) noexcept
+	{
+		for_each_block(kernel, count);
+	}
+
+#if MATHLBR_SIMD_X86
+	// The same kernels compiled for AVX2: twice the lanes, and the 64 bit selects of double kernels (not vectorized with SSE2)
+	template<typename Kernel>
+	MATHLBR_TARGET("avx2,fma") void for_each_block_avx2(const Kernel& kernel, std::size_t count) noexcept
+	{
+		for_each_block(kernel, count);
+	}
+#endif
+
+	template<typename Kernel>
+	void run(const Kernel& kernel, std::size_t count) noexcept
+	{
+#if MATHLBR_SIMD_X86
+		const auto level = detail::simd::simd_level();
+		if (level == MathLbr::SimdLevel::AVX2 or level == MathLbr::SimdLevel::AVX512)
+		{
+			return for_each_block_avx2(kernel, count);
+		}
+#endif
+		for_each_block_portable(kernel, count);
+	}
+}
+
+
+/*
+	Scalar functions taking a precision policy, used by the vector members: exact_policy calls those of constexpr_math.h,
+	fast_policy the inlined approximations of detail::vectorized for float and double arguments, at runtime, on the inputs
+	they handle (<cmath> is called for the others). Integral arguments are converted to double, as by <cmath>.
+*/
+namespace detail::math
+{
+	template<concepts::precision_policy Precision, concepts::arithmetic_char_const_excluded T>
+	constexpr auto sin(Precision, T x) -> decltype(std::sin(x))
+	{
+		using R = decltype(std::sin(x));
+		if constexpr (concepts::fast_precision_policy<Precision> and concepts::simd_real_type<R>)
+		{
+			const R value = static_cast<R>(x);
+			if (not std::is_constant_evaluated() and std::abs(value) <= detail::vectorized::constants<R>::reduction_limit)
+			{
+				R sine, cosine;
+				detail::vectorized::sin_cos<Precision>(value, sine, cosine);
+				return sine;
+			}
+		}
+		return detail::math::sin(x);
+	}
+
+	template<concepts::precision_policy Precision, concepts::arithmetic_char_const_excluded T>
+	constexpr auto cos(Precision, T x) -> decltype(std::cos(x))
+	{
+		using R = decltype(std::cos(x));
+		if constexpr (concepts::fast_precision_policy<Precision> and concepts::simd_real_type<R>)
+		{
+			const R value = static_cast<R>(x);
+			if (not std::is_constant_evaluated() and std::abs(value) <= detail::vectorized::constants<R>::reduction_limit)
+			{
+				R sine, cosine;
+				detail::vectorized::sin_cos<Precision>(value, sine, cosine);
+				return cosine;
+			}
+		}
+		return detail::math::cos(x);
+	}
+
+	template<concepts::precision_policy Precision, concepts::arithmetic_char_const_excluded T, concepts::arithmetic_char_const_excluded T2>
+	constexpr auto atan2(Precision, T y, T2 x) -> decltype(std::atan2(y, x))
+	{
+		using R = decltype(std::atan2(y, x));
+		if constexpr (concepts::fast_precision_policy<Precision> and concepts::simd_real_type<R>)
+		{
+			const R y_value = static_cast<R>(y);
+			const R x_value = static_cast<R>(x);
+			if (not std::is_constant_evaluated() and std::abs(y_value) <= std::numeric_limits<R>::max()
+				and std::abs(x_value) <= std::numeric_limits<R>::max())
+			{
+				return detail::vectorized::atan2<Precision>(y_value, x_value);
+			}
+		}
+		return detail::math::atan2(y, x);
+	}
+
+	template<concepts::precision_policy Precision, concepts::arithmetic_char_const_excluded T>
+	constexpr auto acos(Precision, T x) -> decltype(std::acos(x))
+	{
+		using R = decltype(std::acos(x));
+		if constexpr (concepts::fast_precision_policy<Precision> and concepts::simd_real_type<R>)
+		{
+			const R value = static_cast<R>(x);
+			if (not std::is_constant_evaluated() and std::abs(value) <= 1)
+			{
+				return detail::vectorized::acos<Precision>(value, std::sqrt(detail::vectorized::acos_root_argument<Precision>(value)));
+			}
+		}
+		return detail::math::acos(x);
+	}
+}
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef VIEW_HEADER
+#define VIEW_HEADER
+
+#include "utility.h"
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+
+namespace MathLbr
+{
+	/*
+		Non-owning container referring to Size (or size(), for dynamic_extent) contiguous elements owned by someone else,
+		similar to std::span<T, Size>. If Const is true, the elements can only be read.
+		Copies are shallow: they refer to the same elements. Constness and comparisons are deep, like for std::vector.
+		Offers the subset of the std::vector interface used by MathLbr::vector (see view_storage).
+	*/
+	template<typename T, std::size_t Size, bool Const>
+	class view_container
+	{
+	public:
+		using value_type = T;
+		using element_type = std::conditional_t<Const, const T, T>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = element_type&;
+		using const_reference = const T&;
+		using pointer = element_type*;
+		using const_pointer = const T*;
+		using iterator = element_type*;
+		using const_iterator = const T*;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	private:
+		pointer _data = nullptr;
+		size_type _size = concepts::dynamic_extent_enabled<Size> ? 0 : Size;
+
+	public:
+		// Fixed size views always refer to Size elements
+		constexpr view_container() noexcept
+		requires (concepts::dynamic_extent_enabled<Size>) = default;
+
+		constexpr view_container(pointer data, size_type count) noexcept
+			: _data(data), _size(count)
+		{
+			if constexpr (concepts::dynamic_extent_disabled<Size>)
+			{
+				assert(count == Size && "A fixed size view must refer to exactly Size elements!");
+			}
+		}
+
+		constexpr size_type size() const noexcept
+		{
+			return _size;
+		}
+
+		constexpr bool empty() const noexcept
+		{
+			return _size == 0;
+		}
+
+		constexpr reference operator[](size_type index) noexcept
+		{
+			return _data[index];
+		}
+
+		constexpr const_reference operator[](size_type index) const noexcept
+		{
+			return _data[index];
+		}
+
+		constexpr pointer data() noexcept
+		{
+			return _data;
+		}
+
+		constexpr const_pointer data() const noexcept
+		{
+			return _data;
+		}
+
+		constexpr iterator begin() noexcept
+		{
+			return _data;
+		}
+
+		constexpr const_iterator begin() const noexcept
+		{
+			return _data;
+		}
+
+		constexpr const_iterator cbegin() const noexcept
+		{
+			return _data;
+		}
+
+		constexpr iterator end() noexcept
+		{
+			return _data + _size;
+		}
+
+		constexpr const_iterator end() const noexcept
+		{
+			return _data + _size;
+		}
+
+		constexpr const_iterator cend() const noexcept
+		{
+			return _data + _size;
+		}
+
+		constexpr reverse_iterator rbegin() noexcept
+		{
+			return reverse_iterator(end());
+		}
+
+		constexpr const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		constexpr const_reverse_iterator crbegin() const noexcept
+		{
+			return rbegin();
+		}
+
+		constexpr reverse_iterator rend() noexcept
+		{
+			return reverse_iterator(begin());
+		}
+
+		constexpr const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		constexpr const_reverse_iterator crend() const noexcept
+		{
+			return rend();
+		}
+
+		friend constexpr bool operator==(const view_container& lhs, const view_container& rhs)
+		{
+			return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+		}
+
+		friend constexpr auto operator<=>(const view_container& lhs, const view_container& rhs)
+		requires (std::three_way_comparable<T>)
+		{
+			return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+		}
+	};
+}
+
+#endif